@@ -0,0 +1,79 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/async_channel.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+
+#include <fmt/printf.h>
+
+#include <optional>
+#include <regex>
+#include <string>
+#include <utility>
+
+int main(int argc, char* argv[])
+{
+    namespace ex = pika::execution::experimental;
+    namespace tt = pika::this_thread::experimental;
+
+    pika::start(argc, argv);
+    ex::thread_pool_scheduler sched{};
+
+    {
+        // The senders returned by send and receive complete once there is space for the value or
+        // a value is available. Here the receive operation is started first and waits until the
+        // send operation has stored the value in the channel.
+        ex::async_channel<int> ch{1};
+        tt::sync_wait(ex::when_all(ch.receive() | ex::then([](std::optional<int> value) {
+            fmt::print("received {}\n", value.value());
+        }),
+            ch.send(42) | ex::then([](bool sent) { fmt::print("sent: {}\n", sent); })));
+    }
+
+    {
+        // Below we build a pipeline of three stages connected by channels:
+        //
+        // produce ──► lines ──► filter ──► errors ──► print
+        //
+        // The channels hold at most two values. A stage which is ahead of the next one is
+        // suspended in blocking_send until the next stage has received a value. Closing a channel
+        // tells the next stage that no more values will be sent. It still receives the values
+        // that are left in the channel before blocking_receive returns an empty optional.
+        ex::async_channel<std::string> lines{2};
+        ex::async_channel<std::string> errors{2};
+
+        auto produce = ex::schedule(sched) | ex::then([&] {
+            for (std::string line :
+                {"Error: foobar", "Error. foo", " Warning: barbaz", "Notice: qux", "\tError: abc"})
+            {
+                lines.blocking_send(std::move(line));
+            }
+            lines.close();
+        });
+
+        auto filter = ex::schedule(sched) | ex::then([&] {
+            std::regex regex("Error.*");
+            while (auto line = lines.blocking_receive())
+            {
+                if (std::regex_match(*line, regex)) { errors.blocking_send(std::move(*line)); }
+            }
+            errors.close();
+        });
+
+        auto print = ex::schedule(sched) | ex::then([&] {
+            while (auto error = errors.blocking_receive()) { fmt::print("->{}\n", *error); }
+        });
+
+        // Start and wait for all the stages to finish.
+        tt::sync_wait(ex::when_all(std::move(produce), std::move(filter), std::move(print)));
+    }
+
+    pika::finalize();
+    pika::stop();
+
+    return 0;
+}
@@ -135,8 +135,9 @@ namespace pika::detail {
     threads::detail::mask_cref_type affinity_data::get_pu_mask(
         threads::detail::topology const& topo, std::size_t global_thread_num) const
     {
-        // --pika:bind=none disables all affinity
-        if (threads::detail::test(no_affinity_, global_thread_num))
+        // --pika:bind=none disables all affinity, no_affinity_ is indexed by
+        // processing unit since several threads may share a processing unit
+        if (threads::detail::test(no_affinity_, get_pu_num(global_thread_num)))
         {
             static threads::detail::mask_type m = threads::detail::mask_type();
             threads::detail::resize(m, threads::detail::hardware_concurrency());
@@ -9,7 +9,76 @@
 #include <pika/functional/detail/tag_fallback_invoke.hpp>
 #include <pika/functional/tag_invoke.hpp>
 
+#include <cstdint>
+
 namespace pika::execution::experimental {
+    /// The policy used by bulk to split the iteration space into chunks
+    enum class bulk_chunking_policy : std::int8_t
+    {
+        /// Chunks of a power-of-two size such that each worker thread gets
+        /// between four and eight chunks. Only the worker threads that are
+        /// idle when the bulk operation starts, and the calling worker
+        /// thread, are counted.
+        default_ = 0,
+        /// One chunk per worker thread.
+        static_ = 1,
+        /// Each worker thread gets an equal part of the iteration space,
+        /// which is split into chunks of decreasing size. Chunks at the end
+        /// of the parts, which are stolen first, are small.
+        guided = 2,
+        /// Chunks are sized such that each chunk takes a fixed amount of
+        /// time, based on the time per item measured in previous bulk
+        /// operations with the same function type (i.e. the same call site
+        /// for lambdas). At least four chunks are created per worker thread
+        /// that is idle when the bulk operation starts.
+        adaptive = 3,
+        /// Chunks as with default_, but a given index range is always
+        /// assigned to the same worker thread for the same number of items
+        /// and worker threads, and chunks are only stolen by worker threads in
+        /// the same NUMA domain. Data initialized by one bulk operation with
+        /// this policy is processed in the NUMA domain where it was first
+        /// touched in later bulk operations. The task processing the chunks
+        /// of a worker thread is hinted to that worker thread, but a
+        /// scheduler with stealing enabled may still run it on another
+        /// worker thread while its worker thread is busy. Disable stealing in
+        /// the scheduler for a strict assignment.
+        affinity = 4,
+    };
+
+    inline constexpr struct with_bulk_chunking_policy_t final
+      : pika::functional::detail::tag<with_bulk_chunking_policy_t>
+    {
+    } with_bulk_chunking_policy{};
+
+    inline constexpr struct get_bulk_chunking_policy_t final
+      : pika::functional::detail::tag<get_bulk_chunking_policy_t>
+    {
+    } get_bulk_chunking_policy{};
+
+    // A chunk size of zero lets the chunking policy decide. With the guided
+    // policy the chunk size is the minimum chunk size.
+    inline constexpr struct with_bulk_chunk_size_t final
+      : pika::functional::detail::tag<with_bulk_chunk_size_t>
+    {
+    } with_bulk_chunk_size{};
+
+    inline constexpr struct get_bulk_chunk_size_t final
+      : pika::functional::detail::tag<get_bulk_chunk_size_t>
+    {
+    } get_bulk_chunk_size{};
+
+    // When enabled, worker threads in bulk only steal chunks from worker
+    // threads in the same NUMA domain.
+    inline constexpr struct with_bulk_numa_local_stealing_t final
+      : pika::functional::detail::tag<with_bulk_numa_local_stealing_t>
+    {
+    } with_bulk_numa_local_stealing{};
+
+    inline constexpr struct get_bulk_numa_local_stealing_t final
+      : pika::functional::detail::tag<get_bulk_numa_local_stealing_t>
+    {
+    } get_bulk_numa_local_stealing{};
+
     inline constexpr struct with_priority_t final : pika::functional::detail::tag<with_priority_t>
     {
     } with_priority{};
@@ -18,6 +87,17 @@ namespace pika::execution::experimental {
     {
     } get_priority{};
 
+    // The deadline of work spawned by a scheduler. Schedulers ordering work
+    // by deadline, such as the earliest-deadline-first scheduler, run the
+    // work with the earliest deadline first. Other schedulers ignore it.
+    inline constexpr struct with_deadline_t final : pika::functional::detail::tag<with_deadline_t>
+    {
+    } with_deadline{};
+
+    inline constexpr struct get_deadline_t final : pika::functional::detail::tag<get_deadline_t>
+    {
+    } get_deadline{};
+
     inline constexpr struct with_stacksize_t final : pika::functional::detail::tag<with_stacksize_t>
     {
     } with_stacksize{};
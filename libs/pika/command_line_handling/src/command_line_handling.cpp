@@ -557,11 +557,13 @@ namespace pika::detail {
                     "(--pika:threads)");
             }
 
-            if (!(scheduler_ == "local-priority" || scheduler_ == "abp-priority"))
+            if (!(scheduler_ == "local-priority" || scheduler_ == "abp-priority" ||
+                    scheduler_ == "work-stealing-priority" || scheduler_ == "edf"))
             {
                 throw pika::detail::command_line_error(
                     "Invalid command line option --pika:high-priority-threads, valid for "
-                    "--pika:scheduler=local-priority and --pika:scheduler=abp-priority only");
+                    "--pika:scheduler=local-priority, --pika:scheduler=abp-priority, "
+                    "--pika:scheduler=work-stealing-priority, and --pika:scheduler=edf only");
             }
 
             ini_config.emplace_back("pika.thread_queue.high_priority_queues!=" +
@@ -579,6 +581,18 @@ namespace pika::detail {
 
         update_logging_settings(vm, ini_config);
 
+        if (vm.count("pika:metrics-file"))
+        {
+            ini_config.emplace_back(
+                "pika.metrics.file!=" + vm["pika:metrics-file"].as<std::string>());
+        }
+
+        if (vm.count("pika:metrics-interval"))
+        {
+            ini_config.emplace_back("pika.metrics.interval=" +
+                std::to_string(vm["pika:metrics-interval"].as<std::size_t>()));
+        }
+
         if (debug_clp)
         {
             std::cerr << "Configuration before runtime start:\n";
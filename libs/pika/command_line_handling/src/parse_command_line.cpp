@@ -325,8 +325,8 @@ namespace pika::detail {
             ("pika:scheduler", value<std::string>(),
                 "the queue scheduling policy to use, options are "
                 "'local', 'local-priority-fifo','local-priority-lifo', "
-                "'abp-priority-fifo', 'abp-priority-lifo', 'static', and "
-                "'static-priority' (default: 'local-priority'; "
+                "'abp-priority-fifo', 'abp-priority-lifo', 'work-stealing-priority', "
+                "'edf', 'static', and 'static-priority' (default: 'local-priority'; "
                 "all option values can be abbreviated)")
             ("pika:high-priority-threads", value<std::size_t>(),
                 "the number of operating system threads maintaining a high "
@@ -375,6 +375,12 @@ namespace pika::detail {
             ("pika:log-level", value<std::underlying_type_t<spdlog::level::level_enum>>(),
                 log_level_description.c_str())
             ("pika:log-format", value<std::string>(), "set log format string")
+            ("pika:metrics-file", value<std::string>(),
+                "periodically write the scheduler metrics of all thread pools to the "
+                "given file in the OpenMetrics text format")
+            ("pika:metrics-interval", value<std::size_t>(),
+                "the interval in milliseconds between two snapshots written to "
+                "--pika:metrics-file (default: 1000)")
 #if defined(_POSIX_VERSION) || defined(PIKA_WINDOWS)
             ("pika:attach-debugger",
                 value<std::string>()->implicit_value("startup"),
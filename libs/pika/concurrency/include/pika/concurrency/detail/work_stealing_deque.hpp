@@ -0,0 +1,188 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/assert.hpp>
+#include <pika/concurrency/cache_line_data.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace pika::concurrency::detail {
+    /// \brief A work-stealing deque with a single owner and any number of
+    ///        thieves.
+    ///
+    /// This is the Chase-Lev deque (Chase and Lev, "Dynamic Circular
+    /// Work-Stealing Deque", SPAA 2005) with the memory orderings of Lê et
+    /// al. ("Correct and Efficient Work-Stealing for Weak Memory Models",
+    /// PPoPP 2013). Only the owning thread may call push and pop, which push
+    /// and pop at the bottom of the deque without any read-modify-write
+    /// operations unless a single item is left. Any thread may call steal,
+    /// which pops from the top of the deque.
+    ///
+    /// The buffer grows when it is full. Old buffers may still be read by
+    /// concurrent thieves and are only freed when the deque is destroyed.
+    /// Since the buffer size doubles this at most doubles the memory used.
+    template <typename T>
+    class work_stealing_deque
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+            "work_stealing_deque requires trivially copyable items since items may be read "
+            "concurrently while they are being stolen");
+
+        class buffer
+        {
+        public:
+            explicit buffer(std::size_t capacity)
+              : mask_(capacity - 1)
+              , items_(new std::atomic<T>[capacity])
+            {
+                PIKA_ASSERT(capacity != 0 && (capacity & mask_) == 0);
+            }
+
+            std::size_t capacity() const noexcept { return mask_ + 1; }
+
+            T load(std::int64_t i) const noexcept
+            {
+                return items_[static_cast<std::size_t>(i) & mask_].load(std::memory_order_relaxed);
+            }
+
+            void store(std::int64_t i, T item) noexcept
+            {
+                items_[static_cast<std::size_t>(i) & mask_].store(item, std::memory_order_relaxed);
+            }
+
+        private:
+            std::size_t mask_;
+            std::unique_ptr<std::atomic<T>[]> items_;
+        };
+
+        static std::size_t round_up_to_power_of_two(std::size_t n) noexcept
+        {
+            std::size_t capacity = 2;
+            while (capacity < n) { capacity *= 2; }
+            return capacity;
+        }
+
+    public:
+        explicit work_stealing_deque(std::size_t initial_capacity = 64)
+        {
+            buffers_.push_back(
+                std::make_unique<buffer>(round_up_to_power_of_two(initial_capacity)));
+            buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+            top_.data_.store(0, std::memory_order_relaxed);
+            bottom_.data_.store(0, std::memory_order_relaxed);
+        }
+
+        work_stealing_deque(work_stealing_deque const&) = delete;
+        work_stealing_deque(work_stealing_deque&&) = delete;
+        work_stealing_deque& operator=(work_stealing_deque const&) = delete;
+        work_stealing_deque& operator=(work_stealing_deque&&) = delete;
+
+        /// Push an item to the bottom of the deque. May only be called by
+        /// the owning thread.
+        void push(T item)
+        {
+            std::int64_t const b = bottom_.data_.load(std::memory_order_relaxed);
+            std::int64_t const t = top_.data_.load(std::memory_order_acquire);
+            buffer* a = buffer_.load(std::memory_order_relaxed);
+
+            if (b - t > static_cast<std::int64_t>(a->capacity()) - 1) { a = grow(a, t, b); }
+
+            a->store(b, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom_.data_.store(b + 1, std::memory_order_relaxed);
+        }
+
+        /// Pop an item from the bottom of the deque. May only be called by
+        /// the owning thread. Returns false if the deque is empty.
+        bool pop(T& item)
+        {
+            std::int64_t const b = bottom_.data_.load(std::memory_order_relaxed) - 1;
+            buffer* const a = buffer_.load(std::memory_order_relaxed);
+            bottom_.data_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t t = top_.data_.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                // The deque was empty
+                bottom_.data_.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            item = a->load(b);
+            if (t == b)
+            {
+                // This is the last item, race against thieves for it
+                bool const success = top_.data_.compare_exchange_strong(
+                    t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                bottom_.data_.store(b + 1, std::memory_order_relaxed);
+                return success;
+            }
+
+            return true;
+        }
+
+        /// Steal an item from the top of the deque. May be called by any
+        /// thread. Returns false if the deque is empty.
+        bool steal(T& item)
+        {
+            for (;;)
+            {
+                std::int64_t t = top_.data_.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                std::int64_t const b = bottom_.data_.load(std::memory_order_acquire);
+
+                if (t >= b) { return false; }
+
+                buffer* const a = buffer_.load(std::memory_order_acquire);
+                item = a->load(t);
+                if (top_.data_.compare_exchange_strong(
+                        t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    return true;
+                }
+
+                // Another thief or the owner took the item at the top, try
+                // again with the new top and bottom
+            }
+        }
+
+        /// Return true if the deque is empty. The result is only a snapshot
+        /// when called concurrently with other operations.
+        bool empty() const noexcept
+        {
+            std::int64_t const t = top_.data_.load(std::memory_order_relaxed);
+            std::int64_t const b = bottom_.data_.load(std::memory_order_relaxed);
+            return b <= t;
+        }
+
+    private:
+        buffer* grow(buffer* a, std::int64_t t, std::int64_t b)
+        {
+            auto new_buffer = std::make_unique<buffer>(2 * a->capacity());
+            for (std::int64_t i = t; i < b; ++i) { new_buffer->store(i, a->load(i)); }
+
+            buffer* const new_a = new_buffer.get();
+            buffers_.push_back(std::move(new_buffer));
+            buffer_.store(new_a, std::memory_order_release);
+            return new_a;
+        }
+
+        cache_aligned_data<std::atomic<std::int64_t>> top_;
+        cache_aligned_data<std::atomic<std::int64_t>> bottom_;
+        std::atomic<buffer*> buffer_{nullptr};
+
+        // All buffers ever used, only accessed by the owning thread
+        std::vector<std::unique_ptr<buffer>> buffers_;
+    };
+}    // namespace pika::concurrency::detail
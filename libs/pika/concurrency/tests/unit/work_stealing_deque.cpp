@@ -0,0 +1,95 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/concurrency/detail/work_stealing_deque.hpp>
+#include <pika/testing.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using deque_type = pika::concurrency::detail::work_stealing_deque<std::uint64_t>;
+
+void test_sequential()
+{
+    deque_type d(2);
+    std::uint64_t item = 0;
+
+    PIKA_TEST(d.empty());
+    PIKA_TEST(!d.pop(item));
+    PIKA_TEST(!d.steal(item));
+
+    // Grow the buffer several times
+    for (std::uint64_t i = 0; i < 100; ++i) { d.push(i); }
+    PIKA_TEST(!d.empty());
+
+    // The owner pops in LIFO order, thieves steal in FIFO order
+    PIKA_TEST(d.pop(item));
+    PIKA_TEST_EQ(item, std::uint64_t(99));
+    PIKA_TEST(d.steal(item));
+    PIKA_TEST_EQ(item, std::uint64_t(0));
+
+    for (std::uint64_t i = 98; i > 0; --i)
+    {
+        PIKA_TEST(d.pop(item));
+        PIKA_TEST_EQ(item, i);
+    }
+
+    PIKA_TEST(d.empty());
+    PIKA_TEST(!d.pop(item));
+    PIKA_TEST(!d.steal(item));
+}
+
+void test_concurrent(std::size_t num_thieves)
+{
+    constexpr std::uint64_t num_items = 1000000;
+
+    deque_type d;
+    std::vector<std::atomic<int>> seen(num_items);
+    std::atomic<bool> done{false};
+
+    auto record = [&](std::uint64_t item) {
+        PIKA_TEST_LT(item, num_items);
+        ++seen[item];
+    };
+
+    std::vector<std::thread> thieves;
+    for (std::size_t i = 0; i < num_thieves; ++i)
+    {
+        thieves.emplace_back([&] {
+            std::uint64_t item = 0;
+            while (!done.load())
+            {
+                if (d.steal(item)) { record(item); }
+            }
+            while (d.steal(item)) { record(item); }
+        });
+    }
+
+    // The owner pushes all items, popping some of them itself in between
+    std::uint64_t item = 0;
+    for (std::uint64_t i = 0; i < num_items; ++i)
+    {
+        d.push(i);
+        if (i % 3 == 0 && d.pop(item)) { record(item); }
+    }
+    while (d.pop(item)) { record(item); }
+
+    done = true;
+    for (auto& t : thieves) { t.join(); }
+
+    for (std::uint64_t i = 0; i < num_items; ++i) { PIKA_TEST_EQ(seen[i].load(), 1); }
+}
+
+int main()
+{
+    test_sequential();
+    for (std::size_t num_thieves : {1, 2, 4}) { test_concurrent(num_thieves); }
+
+    return 0;
+}
@@ -173,6 +173,21 @@
 #  define PIKA_THREAD_QUEUE_INIT_THREADS_COUNT 10
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+// Maximum number of consecutive threads a worker thread runs from its run-next
+// slot before it takes a thread from its regular queue. Zero disables the
+// run-next slot.
+#if !defined(PIKA_THREAD_QUEUE_MAX_RUN_NEXT_COUNT)
+#  define PIKA_THREAD_QUEUE_MAX_RUN_NEXT_COUNT 8
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Time in microseconds a thread has to wait in the run-next slot of a worker
+// thread before other worker threads are allowed to steal it.
+#if !defined(PIKA_THREAD_QUEUE_RUN_NEXT_STEAL_DELAY)
+#  define PIKA_THREAD_QUEUE_RUN_NEXT_STEAL_DELAY 20
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 // Maximum sleep time for idle backoff in milliseconds (used only if
 // PIKA_HAVE_THREAD_MANAGER_IDLE_BACKOFF is defined).
@@ -180,6 +195,13 @@
 #  define PIKA_IDLE_BACKOFF_TIME_MAX 1000
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+// Resolution of the per-pool timer wheel used for timed suspension of pika
+// threads in microseconds.
+#if !defined(PIKA_TIMER_WHEEL_RESOLUTION)
+#  define PIKA_TIMER_WHEEL_RESOLUTION 100
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 // This limits how deep the internal recursion of future continuations will go
 // before a new operation is re-spawned.
@@ -23,6 +23,7 @@
 
 #if defined(_POSIX_VERSION)
 # include <pika/coroutines/detail/posix_utility.hpp>
+# include <pika/coroutines/detail/stack_pool.hpp>
 #endif
 
 #include <boost/context/detail/fcontext.hpp>
@@ -83,7 +84,7 @@ namespace pika::threads::coroutines {
             void* allocate(std::size_t size) const
             {
 # if defined(_POSIX_VERSION)
-                void* limit = posix::alloc_stack(size);
+                void* limit = posix::alloc_pooled_stack(size);
                 posix::watermark_stack(limit, size);
 # else
                 void* limit = std::calloc(size, sizeof(char));
@@ -97,7 +98,7 @@ namespace pika::threads::coroutines {
                 PIKA_ASSERT(vp);
                 void* limit = static_cast<char*>(vp) - size;
 # if defined(_POSIX_VERSION)
-                posix::free_stack(limit, size);
+                posix::free_pooled_stack(limit, size);
 # else
                 std::free(limit);
 # endif
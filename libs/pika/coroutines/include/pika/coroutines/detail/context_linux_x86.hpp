@@ -18,6 +18,7 @@
 # include <pika/assert.hpp>
 # include <pika/coroutines/detail/get_stack_pointer.hpp>
 # include <pika/coroutines/detail/posix_utility.hpp>
+# include <pika/coroutines/detail/stack_pool.hpp>
 # include <pika/coroutines/detail/swap_context.hpp>
 # include <pika/util/get_and_reset_value.hpp>
 
@@ -197,7 +198,7 @@ namespace pika::threads::coroutines {
             {
                 if (m_stack != nullptr) return;
 
-                m_stack = posix::alloc_stack(static_cast<std::size_t>(m_stack_size));
+                m_stack = posix::alloc_pooled_stack(static_cast<std::size_t>(m_stack_size));
                 if (m_stack == nullptr)
                 {
                     throw std::runtime_error("could not allocate memory for stack");
@@ -235,7 +236,7 @@ namespace pika::threads::coroutines {
 # if defined(PIKA_HAVE_VALGRIND) && !defined(NVALGRIND)
                     VALGRIND_STACK_DEREGISTER(reinterpret_cast<std::size_t>(m_sp[valgrind_id_idx]));
 # endif
-                    posix::free_stack(m_stack, static_cast<std::size_t>(m_stack_size));
+                    posix::free_pooled_stack(m_stack, static_cast<std::size_t>(m_stack_size));
                 }
             }
 
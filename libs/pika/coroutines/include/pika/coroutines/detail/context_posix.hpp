@@ -145,6 +145,7 @@ namespace pika::threads::coroutines::detail::posix::ucontext {
 
 # include <pika/coroutines/detail/get_stack_pointer.hpp>
 # include <pika/coroutines/detail/posix_utility.hpp>
+# include <pika/coroutines/detail/stack_pool.hpp>
 # include <pika/coroutines/detail/swap_context.hpp>
 # include <atomic>
 # include <signal.h>    // SIGSTKSZ
@@ -237,7 +238,7 @@ namespace pika::threads::coroutines {
             {
                 if (m_stack != nullptr) return;
 
-                m_stack = alloc_stack(static_cast<std::size_t>(m_stack_size));
+                m_stack = alloc_pooled_stack(static_cast<std::size_t>(m_stack_size));
                 if (m_stack == nullptr)
                 {
                     throw std::runtime_error("could not allocate memory for stack");
@@ -256,7 +257,7 @@ namespace pika::threads::coroutines {
 
             ~ucontext_context_impl()
             {
-                if (m_stack) free_stack(m_stack, m_stack_size);
+                if (m_stack) free_pooled_stack(m_stack, m_stack_size);
             }
 
             // Return the size of the reserved stack address space.
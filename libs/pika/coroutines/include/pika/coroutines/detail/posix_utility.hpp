@@ -144,11 +144,9 @@ namespace pika::threads::coroutines::detail::posix {
         return size;
     }
 
-    inline void* alloc_stack(std::size_t size)
+    inline void* map_stack_memory(std::size_t size)
     {
-        check_stack_size(size);
-
-        void* real_stack = ::mmap(nullptr, stack_size_with_guard_page(size), PROT_READ | PROT_WRITE,
+        void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
 #  if defined(__APPLE__)
             MAP_PRIVATE | MAP_ANON | MAP_NORESERVE,
 #  elif defined(__FreeBSD__)
@@ -158,7 +156,7 @@ namespace pika::threads::coroutines::detail::posix {
 #  endif
             -1, 0);
 
-        if (real_stack == MAP_FAILED)
+        if (memory == MAP_FAILED)
         {
             if (ENOMEM == errno && use_guard_pages)
             {
@@ -175,10 +173,39 @@ namespace pika::threads::coroutines::detail::posix {
             throw std::runtime_error(error_message);
         }
 
+        return memory;
+    }
+
+    inline void* alloc_stack(std::size_t size)
+    {
+        check_stack_size(size);
+
+        void* real_stack = map_stack_memory(stack_size_with_guard_page(size));
+
         add_guard_page(real_stack);
         return to_stack_without_guard_page(real_stack);
     }
 
+    // Allocate count stacks of the given size with a single mapping. Each
+    // stack is preceded by its own guard page, i.e. the stacks are laid out
+    // exactly as if they had been allocated by alloc_stack and can be freed
+    // individually with free_stack.
+    inline void alloc_stacks(std::size_t size, std::size_t count, void** stacks)
+    {
+        check_stack_size(size);
+        PIKA_ASSERT(count > 0);
+
+        std::size_t const stride = stack_size_with_guard_page(size);
+        char* memory = static_cast<char*>(map_stack_memory(stride * count));
+
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            void* real_stack = memory + i * stride;
+            add_guard_page(real_stack);
+            stacks[i] = to_stack_without_guard_page(real_stack);
+        }
+    }
+
     inline void watermark_stack(void* stack, std::size_t size)
     {
         PIKA_ASSERT(size >= PIKA_EXEC_PAGESIZE);
@@ -250,6 +277,14 @@ namespace pika::threads::coroutines::detail::posix {
         return new stack_aligner[size / sizeof(stack_aligner)];
     }
 
+    inline void alloc_stacks(std::size_t size, std::size_t count, void** stacks)
+    {
+        for (std::size_t i = 0; i != count; ++i) { stacks[i] = alloc_stack(size); }
+    }
+
+    // stacks allocated with new/delete have no guard pages
+    inline std::size_t stack_size_with_guard_page(std::size_t size) { return size; }
+
     inline void watermark_stack(void* /* stack */, std::size_t /* size */) {}    // no-op
 
     inline bool reset_stack(void* /* stack */, std::size_t /* size */) { return false; }
@@ -0,0 +1,45 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/coroutines/detail/posix_utility.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pika::threads::coroutines::detail::posix {
+    /// The maximum number of bytes of unused stacks kept in the shared part of
+    /// the stack pool per stack size. Stacks freed beyond this limit are
+    /// returned to the operating system. A value of zero disables pooling.
+    PIKA_EXPORT extern std::size_t stack_pool_max_cached_size;
+
+    struct stack_pool_statistics
+    {
+        /// The number of stack allocations served from the pool
+        std::uint64_t hits = 0;
+        /// The number of stack allocations that had to map new memory
+        std::uint64_t misses = 0;
+        /// The number of bytes of stacks currently unused and held by the
+        /// pool, including their guard pages
+        std::size_t cached_bytes = 0;
+        /// The number of bytes of stacks currently mapped through the pool,
+        /// whether in use or not, including their guard pages
+        std::size_t mapped_bytes = 0;
+    };
+
+    /// Allocate a stack of the given size. Stacks are taken from a cache local
+    /// to the calling OS thread, then from a cache shared between all OS
+    /// threads. If both are empty, a batch of stacks is mapped at once.
+    /// Stacks are pooled separately per stack size.
+    PIKA_EXPORT void* alloc_pooled_stack(std::size_t size);
+
+    /// Return a stack allocated with alloc_pooled_stack to the pool.
+    PIKA_EXPORT void free_pooled_stack(void* stack, std::size_t size);
+
+    PIKA_EXPORT stack_pool_statistics get_stack_pool_statistics();
+}    // namespace pika::threads::coroutines::detail::posix
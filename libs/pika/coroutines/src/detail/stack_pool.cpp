@@ -0,0 +1,354 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#if defined(__linux) || defined(linux) || defined(__linux__) || defined(__FreeBSD__) ||            \
+    defined(__APPLE__)
+# include <pika/assert.hpp>
+# include <pika/coroutines/detail/posix_utility.hpp>
+# include <pika/coroutines/detail/stack_pool.hpp>
+
+# include <algorithm>
+# include <array>
+# include <atomic>
+# include <cstddef>
+# include <cstdint>
+# include <exception>
+# include <mutex>
+# include <vector>
+
+namespace pika::threads::coroutines::detail::posix {
+    std::size_t stack_pool_max_cached_size = 0x4000000;    // 64MByte
+
+    namespace {
+        // The number of distinct stack sizes that are pooled. Stacks of other
+        // sizes are allocated and freed directly.
+        constexpr std::size_t max_size_classes = 8;
+
+        // Stacks are mapped in batches of roughly this many bytes
+        constexpr std::size_t batch_bytes = 0x400000;    // 4MByte
+        constexpr std::size_t max_batch_size = 32;
+
+        // Unused stacks in the local caches keep their memory resident. The
+        // local caches are kept small so that they don't hold on to large
+        // amounts of memory.
+        constexpr std::size_t local_cache_bytes = 0x800000;    // 8MByte
+
+        std::size_t batch_size(std::size_t size)
+        {
+            return std::clamp(
+                batch_bytes / stack_size_with_guard_page(size), std::size_t(1), max_batch_size);
+        }
+
+        std::size_t local_capacity(std::size_t size)
+        {
+            return std::clamp(local_cache_bytes / size, std::size_t(1), 2 * batch_size(size));
+        }
+
+        template <typename SizeClass>
+        SizeClass* find_size_class(
+            std::array<SizeClass, max_size_classes>& classes, std::size_t size) noexcept
+        {
+            for (auto& c : classes)
+            {
+                std::size_t const class_size = c.size.load(std::memory_order_relaxed);
+                if (class_size == size) { return &c; }
+                if (class_size == 0)
+                {
+                    c.size.store(size, std::memory_order_relaxed);
+                    return &c;
+                }
+            }
+            return nullptr;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Stacks cached by a single OS thread. Only the owning OS thread
+        // modifies the cache, the atomics are only there to allow reading
+        // statistics from other threads.
+        struct local_size_class
+        {
+            std::atomic<std::size_t> size{0};
+            std::atomic<std::size_t> count{0};
+            std::vector<void*> stacks;
+        };
+
+        struct local_cache
+        {
+            std::array<local_size_class, max_size_classes> classes;
+            std::atomic<std::uint64_t> hits{0};
+            std::atomic<std::uint64_t> misses{0};
+        };
+
+        // Stacks shared between all OS threads, protected by mtx
+        struct shared_size_class
+        {
+            std::atomic<std::size_t> size{0};
+            std::vector<void*> stacks;
+        };
+
+        struct shared_pool
+        {
+            std::mutex mtx;
+            std::array<shared_size_class, max_size_classes> classes;
+
+            // local caches registered for statistics
+            std::vector<local_cache*> caches;
+
+            std::uint64_t hits = 0;
+            std::uint64_t misses = 0;
+            std::atomic<std::size_t> mapped_bytes{0};
+        };
+
+        // The shared pool is intentionally never destroyed as stacks may still
+        // be freed during static destruction.
+        shared_pool& get_shared_pool()
+        {
+            static shared_pool* pool = new shared_pool();
+            return *pool;
+        }
+
+        void release_stacks(shared_pool& pool, std::size_t size, void** stacks, std::size_t count)
+        {
+            for (std::size_t i = 0; i != count; ++i) { free_stack(stacks[i], size); }
+            pool.mapped_bytes.fetch_sub(
+                count * stack_size_with_guard_page(size), std::memory_order_relaxed);
+        }
+
+        // Move stacks to the shared pool, freeing the ones that exceed the
+        // cache limit. Stacks in the shared pool may not be reused for a while,
+        // their memory is released back to the operating system.
+        void give_to_shared(shared_pool& pool, std::size_t size, void** stacks, std::size_t count)
+        {
+            if (stack_pool_max_cached_size != 0)
+            {
+                for (std::size_t i = 0; i != count; ++i) { reset_stack(stacks[i], size); }
+            }
+
+            std::size_t num_kept = 0;
+            {
+                std::lock_guard<std::mutex> l(pool.mtx);
+                if (shared_size_class* c = find_size_class(pool.classes, size))
+                {
+                    std::size_t const max_count = stack_pool_max_cached_size / size;
+                    if (c->stacks.size() < max_count)
+                    {
+                        num_kept = (std::min)(count, max_count - c->stacks.size());
+                        c->stacks.insert(c->stacks.end(), stacks, stacks + num_kept);
+                    }
+                }
+            }
+
+            release_stacks(pool, size, stacks + num_kept, count - num_kept);
+        }
+
+        // Take up to count stacks from the shared pool, returns the number of
+        // stacks taken
+        std::size_t take_from_shared(
+            shared_pool& pool, std::size_t size, void** stacks, std::size_t count)
+        {
+            std::lock_guard<std::mutex> l(pool.mtx);
+            shared_size_class* c = find_size_class(pool.classes, size);
+            if (c == nullptr) { return 0; }
+
+            std::size_t const num_taken = (std::min)(count, c->stacks.size());
+            std::copy(c->stacks.end() - num_taken, c->stacks.end(), stacks);
+            c->stacks.resize(c->stacks.size() - num_taken);
+            return num_taken;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The local cache is reached through a trivially destructible pointer
+        // to be able to detect accesses after the OS thread has started
+        // destroying its thread local objects.
+        thread_local local_cache* local_cache_ptr = nullptr;
+        thread_local bool local_cache_destroyed = false;
+
+        struct local_cache_holder
+        {
+            local_cache cache;
+
+            local_cache_holder()
+            {
+                shared_pool& pool = get_shared_pool();
+                std::lock_guard<std::mutex> l(pool.mtx);
+                pool.caches.push_back(&cache);
+            }
+
+            ~local_cache_holder()
+            {
+                local_cache_ptr = nullptr;
+                local_cache_destroyed = true;
+
+                shared_pool& pool = get_shared_pool();
+                for (auto& c : cache.classes)
+                {
+                    if (!c.stacks.empty())
+                    {
+                        give_to_shared(pool, c.size, c.stacks.data(), c.stacks.size());
+                        c.stacks.clear();
+                        c.count.store(0, std::memory_order_relaxed);
+                    }
+                }
+
+                std::lock_guard<std::mutex> l(pool.mtx);
+                pool.hits += cache.hits.load(std::memory_order_relaxed);
+                pool.misses += cache.misses.load(std::memory_order_relaxed);
+                pool.caches.erase(std::find(pool.caches.begin(), pool.caches.end(), &cache));
+            }
+
+            local_cache_holder(local_cache_holder const&) = delete;
+            local_cache_holder(local_cache_holder&&) = delete;
+            local_cache_holder& operator=(local_cache_holder const&) = delete;
+            local_cache_holder& operator=(local_cache_holder&&) = delete;
+        };
+
+        local_cache* get_local_cache()
+        {
+            if (PIKA_LIKELY(local_cache_ptr != nullptr)) { return local_cache_ptr; }
+            if (local_cache_destroyed) { return nullptr; }
+
+            thread_local local_cache_holder holder;
+            local_cache_ptr = &holder.cache;
+            return local_cache_ptr;
+        }
+
+        void increment(std::atomic<std::uint64_t>& counter) noexcept
+        {
+            // only the owning thread modifies the counters
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        // Stacks of sizes which are not pooled, or which are freed after the
+        // local cache of the calling OS thread has been destroyed, bypass the
+        // local cache.
+        void* alloc_unpooled_stack(shared_pool& pool, std::size_t size)
+        {
+            void* stack = nullptr;
+            if (stack_pool_max_cached_size != 0 && take_from_shared(pool, size, &stack, 1) != 0)
+            {
+                std::lock_guard<std::mutex> l(pool.mtx);
+                ++pool.hits;
+                return stack;
+            }
+
+            stack = alloc_stack(size);
+            pool.mapped_bytes.fetch_add(
+                stack_size_with_guard_page(size), std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> l(pool.mtx);
+            ++pool.misses;
+            return stack;
+        }
+    }    // namespace
+
+    void* alloc_pooled_stack(std::size_t size)
+    {
+        shared_pool& pool = get_shared_pool();
+
+        local_cache* cache = stack_pool_max_cached_size != 0 ? get_local_cache() : nullptr;
+        local_size_class* c = cache != nullptr ? find_size_class(cache->classes, size) : nullptr;
+        if (c == nullptr) { return alloc_unpooled_stack(pool, size); }
+
+        if (c->stacks.empty())
+        {
+            // Refill the local cache from the shared pool, or map a new batch
+            // of stacks if the shared pool is empty as well.
+            std::size_t const count = batch_size(size);
+            c->stacks.reserve(local_capacity(size));
+            c->stacks.resize(count);
+
+            std::size_t const num_taken = take_from_shared(pool, size, c->stacks.data(), count);
+            if (num_taken != 0)
+            {
+                c->stacks.resize(num_taken);
+                increment(cache->hits);
+            }
+            else
+            {
+                try
+                {
+                    alloc_stacks(size, count, c->stacks.data());
+                }
+                catch (...)
+                {
+                    c->stacks.clear();
+                    throw;
+                }
+                pool.mapped_bytes.fetch_add(
+                    count * stack_size_with_guard_page(size), std::memory_order_relaxed);
+                increment(cache->misses);
+            }
+        }
+        else { increment(cache->hits); }
+
+        void* stack = c->stacks.back();
+        c->stacks.pop_back();
+        c->count.store(c->stacks.size(), std::memory_order_relaxed);
+        return stack;
+    }
+
+    void free_pooled_stack(void* stack, std::size_t size)
+    {
+        shared_pool& pool = get_shared_pool();
+
+        local_cache* cache = stack_pool_max_cached_size != 0 ? get_local_cache() : nullptr;
+        local_size_class* c = cache != nullptr ? find_size_class(cache->classes, size) : nullptr;
+        if (c == nullptr)
+        {
+            give_to_shared(pool, size, &stack, 1);
+            return;
+        }
+
+        std::size_t const capacity = local_capacity(size);
+        if (c->stacks.size() >= capacity)
+        {
+            // Move the least recently freed stacks to the shared pool, the
+            // most recently freed stacks are more likely to still be in the
+            // cache
+            std::size_t const count = (std::min)(batch_size(size), c->stacks.size());
+            give_to_shared(pool, size, c->stacks.data(), count);
+            c->stacks.erase(c->stacks.begin(), c->stacks.begin() + count);
+        }
+
+        c->stacks.reserve(capacity);
+        c->stacks.push_back(stack);
+        c->count.store(c->stacks.size(), std::memory_order_relaxed);
+    }
+
+    stack_pool_statistics get_stack_pool_statistics()
+    {
+        shared_pool& pool = get_shared_pool();
+        stack_pool_statistics stats;
+
+        std::lock_guard<std::mutex> l(pool.mtx);
+        stats.hits = pool.hits;
+        stats.misses = pool.misses;
+        stats.mapped_bytes = pool.mapped_bytes.load(std::memory_order_relaxed);
+
+        for (auto const& c : pool.classes)
+        {
+            stats.cached_bytes +=
+                stack_size_with_guard_page(c.size.load(std::memory_order_relaxed)) *
+                c.stacks.size();
+        }
+
+        for (local_cache const* cache : pool.caches)
+        {
+            stats.hits += cache->hits.load(std::memory_order_relaxed);
+            stats.misses += cache->misses.load(std::memory_order_relaxed);
+            for (auto const& c : cache->classes)
+            {
+                stats.cached_bytes +=
+                    stack_size_with_guard_page(c.size.load(std::memory_order_relaxed)) *
+                    c.count.load(std::memory_order_relaxed);
+            }
+        }
+
+        return stats;
+    }
+}    // namespace pika::threads::coroutines::detail::posix
+#endif
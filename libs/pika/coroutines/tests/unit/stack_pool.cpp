@@ -0,0 +1,138 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test verifies that stacks are reused by the stack pool, that stacks of
+// different sizes are kept apart, and that the statistics of the pool are
+// consistent when stacks are allocated and freed by many threads.
+
+#include <pika/config.hpp>
+#include <pika/coroutines/detail/stack_pool.hpp>
+#include <pika/testing.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace posix = pika::threads::coroutines::detail::posix;
+
+constexpr std::size_t small_size = 16 * PIKA_EXEC_PAGESIZE;
+constexpr std::size_t large_size = 64 * PIKA_EXEC_PAGESIZE;
+
+void test_reuse()
+{
+    auto const before = posix::get_stack_pool_statistics();
+
+    // The first allocation maps a batch of stacks
+    void* stack = posix::alloc_pooled_stack(small_size);
+    std::memset(stack, 0xff, small_size);
+
+    auto const after_alloc = posix::get_stack_pool_statistics();
+    PIKA_TEST_EQ(after_alloc.misses, before.misses + 1);
+    PIKA_TEST_LT(before.mapped_bytes, after_alloc.mapped_bytes);
+
+    // Freeing and allocating again reuses the stack without mapping memory
+    posix::free_pooled_stack(stack, small_size);
+    void* stack2 = posix::alloc_pooled_stack(small_size);
+    PIKA_TEST_EQ(stack, stack2);
+
+    auto const after_reuse = posix::get_stack_pool_statistics();
+    PIKA_TEST_EQ(after_reuse.misses, after_alloc.misses);
+    PIKA_TEST_EQ(after_reuse.hits, after_alloc.hits + 1);
+    PIKA_TEST_EQ(after_reuse.mapped_bytes, after_alloc.mapped_bytes);
+
+    posix::free_pooled_stack(stack2, small_size);
+}
+
+void test_size_classes()
+{
+    std::vector<void*> small_stacks;
+    std::vector<void*> large_stacks;
+    std::set<void*> unique_stacks;
+
+    for (std::size_t i = 0; i != 100; ++i)
+    {
+        small_stacks.push_back(posix::alloc_pooled_stack(small_size));
+        large_stacks.push_back(posix::alloc_pooled_stack(large_size));
+
+        // The whole stack must be usable
+        std::memset(small_stacks.back(), 0xff, small_size);
+        std::memset(large_stacks.back(), 0xff, large_size);
+
+        unique_stacks.insert(small_stacks.back());
+        unique_stacks.insert(large_stacks.back());
+    }
+
+    PIKA_TEST_EQ(unique_stacks.size(), std::size_t(200));
+
+    for (void* stack : small_stacks) { posix::free_pooled_stack(stack, small_size); }
+    for (void* stack : large_stacks) { posix::free_pooled_stack(stack, large_size); }
+
+    // Stacks of different sizes are never handed out for each other
+    void* stack = posix::alloc_pooled_stack(large_size);
+    PIKA_TEST(std::find(small_stacks.begin(), small_stacks.end(), stack) == small_stacks.end());
+    std::memset(stack, 0xff, large_size);
+    posix::free_pooled_stack(stack, large_size);
+}
+
+void test_threads()
+{
+    std::size_t const num_threads = (std::max)(std::thread::hardware_concurrency(), 4u);
+    std::vector<std::thread> threads;
+
+    // Stacks allocated on one thread are freed on another one
+    std::vector<std::vector<void*>> stacks(num_threads);
+    for (std::size_t i = 0; i != num_threads; ++i)
+    {
+        threads.emplace_back([&, i] {
+            for (std::size_t j = 0; j != 1000; ++j)
+            {
+                stacks[i].push_back(posix::alloc_pooled_stack(small_size));
+                if (j % 3 == 0)
+                {
+                    posix::free_pooled_stack(stacks[i].back(), small_size);
+                    stacks[i].pop_back();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) { t.join(); }
+    threads.clear();
+
+    for (std::size_t i = 0; i != num_threads; ++i)
+    {
+        threads.emplace_back([&, i] {
+            for (void* stack : stacks[(i + 1) % num_threads])
+            {
+                posix::free_pooled_stack(stack, small_size);
+            }
+        });
+    }
+    for (auto& t : threads) { t.join(); }
+
+    // All stacks are unused, i.e. all stacks mapped by the pool are either
+    // cached or have been returned to the operating system
+    auto const stats = posix::get_stack_pool_statistics();
+    PIKA_TEST_EQ(stats.cached_bytes, stats.mapped_bytes);
+
+    // The caches of the threads that have exited have been flushed to the
+    // shared pool, which is bounded per stack size. The bound applies to the
+    // usable part of the stacks, the statistics include the guard pages.
+    std::size_t const max_cached_bytes = 2 * (posix::stack_pool_max_cached_size + 0x800000);
+    PIKA_TEST_LTE(
+        stats.cached_bytes, max_cached_bytes / small_size * (small_size + PIKA_EXEC_PAGESIZE));
+}
+
+int main()
+{
+    test_reuse();
+    test_size_classes();
+    test_threads();
+
+    return pika::detail::report_errors();
+}
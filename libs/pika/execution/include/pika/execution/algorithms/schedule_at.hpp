@@ -0,0 +1,34 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/functional/tag_invoke.hpp>
+
+namespace pika::execution::experimental {
+    /// \brief Returns a sender that completes on the given scheduler once the given point in time
+    /// has been reached.
+    ///
+    /// Takes a scheduler and a \a pika::chrono::steady_time_point. The returned sender completes
+    /// with \a set_value on an execution agent of the scheduler once the time point has been
+    /// reached. If the scheduler stops before that, the sender may complete with \a set_stopped
+    /// instead. Schedulers have to customize \a schedule_at to support it.
+    inline constexpr struct schedule_at_t final : pika::functional::detail::tag<schedule_at_t>
+    {
+    } schedule_at{};
+
+    /// \brief Returns a sender that completes on the given scheduler once the given duration has
+    /// passed since the operation has been started.
+    ///
+    /// Takes a scheduler and a \a pika::chrono::steady_duration. The returned sender completes
+    /// with \a set_value on an execution agent of the scheduler once the duration has passed. If
+    /// the scheduler stops before that, the sender may complete with \a set_stopped instead.
+    /// Schedulers have to customize \a schedule_after to support it.
+    inline constexpr struct schedule_after_t final : pika::functional::detail::tag<schedule_after_t>
+    {
+    } schedule_after{};
+}    // namespace pika::execution::experimental
@@ -15,12 +15,14 @@
 #include <pika/concepts/concepts.hpp>
 #include <pika/concurrency/spinlock.hpp>
 #include <pika/datastructures/variant.hpp>
+#include <pika/errors/throw_exception.hpp>
 #include <pika/execution/algorithms/detail/helpers.hpp>
 #include <pika/execution_base/operation_state.hpp>
 #include <pika/execution_base/receiver.hpp>
 #include <pika/execution_base/sender.hpp>
 #include <pika/functional/detail/tag_fallback_invoke.hpp>
 #include <pika/synchronization/counting_semaphore.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
 #include <pika/type_support/pack.hpp>
 
 #include <atomic>
@@ -29,6 +31,19 @@
 #include <utility>
 
 namespace pika::sync_wait_detail {
+    // Inline tasks can not suspend, and an operation state which is still
+    // running must not be destroyed, so waiting is rejected before the sender
+    // is started
+    inline void check_not_inline_task()
+    {
+        if (PIKA_UNLIKELY(pika::threads::detail::scheduler_base::is_running_inline_task()))
+        {
+            PIKA_THROW_EXCEPTION(pika::error::invalid_status, "sync_wait",
+                "sync_wait can not be called from inline tasks, schedule work calling sync_wait "
+                "with a thread_stacksize other than nostack");
+        }
+    }
+
     struct sync_wait_error_visitor
     {
         void PIKA_STATIC_CALL_OPERATOR(std::exception_ptr ep) { std::rethrow_exception(ep); }
@@ -203,6 +218,8 @@ namespace pika::this_thread::experimental {
             using receiver_type = sync_wait_detail::sync_wait_receiver<Sender>;
             using state_type = typename receiver_type::shared_state;
 
+            sync_wait_detail::check_not_inline_task();
+
             state_type state{};
             auto op_state = pika::execution::experimental::connect(
                 std::forward<Sender>(sender), receiver_type{state});
@@ -0,0 +1,44 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/execution/algorithms/detail/partial_algorithm.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/functional/detail/tag_fallback_invoke.hpp>
+
+#include <type_traits>
+#include <utility>
+
+namespace pika::execution::experimental {
+    struct timeout_t final : pika::functional::detail::tag_fallback<timeout_t>
+    {
+    private:
+        template <typename Scheduler, typename Deadline,
+            PIKA_CONCEPT_REQUIRES_(is_scheduler_v<Scheduler>)>
+        friend constexpr PIKA_FORCEINLINE auto
+        tag_fallback_invoke(timeout_t, Scheduler&& scheduler, Deadline&& deadline)
+        {
+            return detail::partial_algorithm<timeout_t, Scheduler, Deadline>{
+                std::forward<Scheduler>(scheduler), std::forward<Deadline>(deadline)};
+        }
+    };
+
+    /// \brief Races a sender against a deadline.
+    ///
+    /// Sender adaptor that takes a sender, a scheduler, and either a
+    /// \a pika::chrono::steady_time_point or a \a pika::chrono::steady_duration relative to the
+    /// start of the operation. The returned sender forwards the completion of the predecessor
+    /// sender if it completes before the deadline. Otherwise the returned sender completes with
+    /// \a set_stopped on an execution agent of the scheduler once the deadline has been reached.
+    /// The predecessor sender is not cancelled in that case, but its completion is ignored. If the
+    /// scheduler stops before the deadline, the returned sender may complete with \a set_stopped
+    /// early instead of delaying the shutdown of the scheduler until the deadline.
+    /// Schedulers have to customize \a timeout to support it.
+    inline constexpr timeout_t timeout{};
+}    // namespace pika::execution::experimental
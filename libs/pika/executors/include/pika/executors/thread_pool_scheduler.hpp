@@ -17,14 +17,27 @@
 #include <pika/execution_base/sender.hpp>
 #include <pika/threading_base/annotated_function.hpp>
 #include <pika/threading_base/register_thread.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/scoped_annotation.hpp>
 #include <pika/threading_base/thread_description.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+namespace pika::thread_pool_timed_detail {
+    template <typename Deadline>
+    struct schedule_at_sender;
+
+    template <typename Sender, typename Deadline>
+    struct timeout_sender;
+}    // namespace pika::thread_pool_timed_detail
 
 namespace pika::execution::experimental {
     struct thread_pool_scheduler
@@ -39,7 +52,11 @@ namespace pika::execution::experimental {
         bool operator==(thread_pool_scheduler const& rhs) const noexcept
         {
             return pool_ == rhs.pool_ && priority_ == rhs.priority_ &&
-                stacksize_ == rhs.stacksize_ && schedulehint_ == rhs.schedulehint_;
+                deadline_ == rhs.deadline_ && stacksize_ == rhs.stacksize_ &&
+                schedulehint_ == rhs.schedulehint_ &&
+                bulk_chunking_policy_ == rhs.bulk_chunking_policy_ &&
+                bulk_chunk_size_ == rhs.bulk_chunk_size_ &&
+                bulk_numa_local_stealing_ == rhs.bulk_numa_local_stealing_;
         }
 
         bool operator!=(thread_pool_scheduler const& rhs) const noexcept { return !(*this == rhs); }
@@ -65,6 +82,21 @@ namespace pika::execution::experimental {
             return scheduler.priority_;
         }
 
+        // support with_deadline property
+        friend thread_pool_scheduler tag_invoke(pika::execution::experimental::with_deadline_t,
+            thread_pool_scheduler const& scheduler, std::chrono::steady_clock::time_point deadline)
+        {
+            auto sched_with_deadline = scheduler;
+            sched_with_deadline.deadline_ = deadline;
+            return sched_with_deadline;
+        }
+
+        friend std::chrono::steady_clock::time_point tag_invoke(
+            pika::execution::experimental::get_deadline_t, thread_pool_scheduler const& scheduler)
+        {
+            return scheduler.deadline_;
+        }
+
         // support with_stacksize property
         friend thread_pool_scheduler tag_invoke(pika::execution::experimental::with_stacksize_t,
             thread_pool_scheduler const& scheduler, pika::execution::thread_stacksize stacksize)
@@ -95,6 +127,55 @@ namespace pika::execution::experimental {
             return scheduler.schedulehint_;
         }
 
+        // support with_bulk_chunking_policy property
+        friend thread_pool_scheduler tag_invoke(
+            pika::execution::experimental::with_bulk_chunking_policy_t,
+            thread_pool_scheduler const& scheduler,
+            pika::execution::experimental::bulk_chunking_policy policy)
+        {
+            auto sched_with_policy = scheduler;
+            sched_with_policy.bulk_chunking_policy_ = policy;
+            return sched_with_policy;
+        }
+
+        friend pika::execution::experimental::bulk_chunking_policy tag_invoke(
+            pika::execution::experimental::get_bulk_chunking_policy_t,
+            thread_pool_scheduler const& scheduler)
+        {
+            return scheduler.bulk_chunking_policy_;
+        }
+
+        // support with_bulk_chunk_size property
+        friend thread_pool_scheduler tag_invoke(pika::execution::experimental::with_bulk_chunk_size_t,
+            thread_pool_scheduler const& scheduler, std::uint32_t chunk_size)
+        {
+            auto sched_with_chunk_size = scheduler;
+            sched_with_chunk_size.bulk_chunk_size_ = chunk_size;
+            return sched_with_chunk_size;
+        }
+
+        friend std::uint32_t tag_invoke(pika::execution::experimental::get_bulk_chunk_size_t,
+            thread_pool_scheduler const& scheduler)
+        {
+            return scheduler.bulk_chunk_size_;
+        }
+
+        // support with_bulk_numa_local_stealing property
+        friend thread_pool_scheduler tag_invoke(
+            pika::execution::experimental::with_bulk_numa_local_stealing_t,
+            thread_pool_scheduler const& scheduler, bool numa_local_stealing)
+        {
+            auto sched_with_stealing = scheduler;
+            sched_with_stealing.bulk_numa_local_stealing_ = numa_local_stealing;
+            return sched_with_stealing;
+        }
+
+        friend bool tag_invoke(pika::execution::experimental::get_bulk_numa_local_stealing_t,
+            thread_pool_scheduler const& scheduler)
+        {
+            return scheduler.bulk_numa_local_stealing_;
+        }
+
         // support with_annotation property
         friend constexpr thread_pool_scheduler tag_invoke(
             pika::execution::experimental::with_annotation_t,
@@ -124,11 +205,33 @@ namespace pika::execution::experimental {
         template <typename F>
         void execute(F&& f, char const* fallback_annotation) const
         {
-            pika::detail::thread_description desc(f, fallback_annotation);
-            threads::detail::thread_init_data data(
-                threads::detail::make_thread_function_nullary(std::forward<F>(f)), desc, priority_,
-                schedulehint_, stacksize_);
-            threads::detail::register_work(data, pool_);
+            // Work without a stack runs to completion, it is run directly by a
+            // worker thread without creating a pika thread for it. Inline tasks
+            // are run in the order they are scheduled on each worker thread,
+            // so work with a priority other than normal or with a deadline is
+            // still run on a pika thread to be scheduled accordingly.
+            if (stacksize_ == pika::execution::thread_stacksize::nostack &&
+                (priority_ == pika::execution::thread_priority::normal ||
+                    priority_ == pika::execution::thread_priority::default_) &&
+                deadline_ == (std::chrono::steady_clock::time_point::max)())
+            {
+                if (auto* scheduler = pool_->get_scheduler(); scheduler != nullptr)
+                {
+                    // The annotation is kept with the task so that it shows up
+                    // in the running task and task trace of the worker thread
+                    char const* annotation =
+                        pika::detail::get_function_annotation<std::decay_t<F>>::call(f);
+                    pika::threads::detail::scheduler_base::inline_task_type task(
+                        pika::annotated_function(std::forward<F>(f),
+                            annotation != nullptr ? annotation : fallback_annotation));
+                    if (scheduler->schedule_inline_task(std::move(task), schedulehint_)) return;
+
+                    register_thread_work(std::move(task), fallback_annotation);
+                    return;
+                }
+            }
+
+            register_thread_work(std::forward<F>(f), fallback_annotation);
         }
 
         template <typename F>
@@ -137,6 +240,48 @@ namespace pika::execution::experimental {
             sched.execute(std::forward<F>(f), sched.get_fallback_annotation());
         }
 
+        /// Spawn n tasks at once, calling f(i) for each i in [0, n) on its own
+        /// task. The tasks are enqueued in batches with one operation per
+        /// worker thread, which is considerably cheaper than calling execute
+        /// n times. f is copied into each task.
+        template <typename F>
+        void execute_bulk(std::size_t n, F&& f) const
+        {
+            using function_type = std::decay_t<F>;
+            function_type func(std::forward<F>(f));
+
+            if (stacksize_ == pika::execution::thread_stacksize::nostack)
+            {
+                for (std::size_t i = 0; i != n; ++i)
+                {
+                    execute([func, i]() mutable { func(i); }, get_fallback_annotation());
+                }
+                return;
+            }
+
+            pika::detail::thread_description desc(func, get_fallback_annotation());
+
+            // Limit the number of tasks prepared at once to bound the memory
+            // used for preparing them
+            constexpr std::size_t max_batch_size = 1024;
+            std::vector<threads::detail::thread_init_data> tasks;
+            tasks.reserve((std::min)(n, max_batch_size));
+
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                tasks.emplace_back(
+                    threads::detail::make_thread_function_nullary([func, i]() mutable { func(i); }),
+                    desc, priority_, schedulehint_, stacksize_);
+                tasks.back().deadline = deadline_;
+
+                if (tasks.size() == max_batch_size || i + 1 == n)
+                {
+                    threads::detail::register_work_bulk(tasks.data(), tasks.size(), pool_);
+                    tasks.clear();
+                }
+            }
+        }
+
         template <typename Scheduler, typename Receiver>
         struct operation_state
         {
@@ -282,6 +427,14 @@ namespace pika::execution::experimental {
 
     private:
         /// \cond NOINTERNAL
+        // The timed senders in thread_pool_scheduler_timed.hpp spawn their
+        // tasks with the fallback annotation of the scheduler
+        template <typename Deadline>
+        friend struct pika::thread_pool_timed_detail::schedule_at_sender;
+
+        template <typename Sender, typename Deadline>
+        friend struct pika::thread_pool_timed_detail::timeout_sender;
+
         char const* get_fallback_annotation() const
         {
             // Scheduler annotations have priority
@@ -306,11 +459,28 @@ namespace pika::execution::experimental {
             return "<unknown>";
         }
 
+        template <typename F>
+        void register_thread_work(F&& f, char const* fallback_annotation) const
+        {
+            pika::detail::thread_description desc(f, fallback_annotation);
+            threads::detail::thread_init_data data(
+                threads::detail::make_thread_function_nullary(std::forward<F>(f)), desc, priority_,
+                schedulehint_, stacksize_);
+            data.deadline = deadline_;
+            threads::detail::register_work(data, pool_);
+        }
+
         pika::threads::detail::thread_pool_base* pool_ =
             pika::threads::detail::get_self_or_default_pool();
         pika::execution::thread_priority priority_ = pika::execution::thread_priority::normal;
+        std::chrono::steady_clock::time_point deadline_ =
+            (std::chrono::steady_clock::time_point::max)();
         pika::execution::thread_stacksize stacksize_ = pika::execution::thread_stacksize::small_;
         pika::execution::thread_schedule_hint schedulehint_{};
+        pika::execution::experimental::bulk_chunking_policy bulk_chunking_policy_ =
+            pika::execution::experimental::bulk_chunking_policy::default_;
+        std::uint32_t bulk_chunk_size_ = 0;
+        bool bulk_numa_local_stealing_ = false;
         char const* annotation_ = nullptr;
         /// \endcond
     };
@@ -12,6 +12,7 @@
 #endif
 
 #include <pika/assert.hpp>
+#include <pika/async_base/scheduling_properties.hpp>
 #include <pika/concepts/concepts.hpp>
 #include <pika/concurrency/detail/contiguous_index_queue.hpp>
 #include <pika/coroutines/thread_enums.hpp>
@@ -28,12 +29,17 @@
 #include <pika/threading_base/annotated_function.hpp>
 #include <pika/threading_base/register_thread.hpp>
 #include <pika/threading_base/thread_description.hpp>
+#include <pika/threading_base/thread_init_data.hpp>
 #include <pika/threading_base/thread_num_tss.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <memory>
 #include <optional>
 #include <string>
 #include <tuple>
@@ -72,6 +78,30 @@ namespace pika::thread_pool_bulk_detail {
 #endif
     };
 
+    // Measurements used by the adaptive chunking policy. The data is kept per
+    // type of the bulk function, i.e. per call site for lambdas.
+    template <typename F>
+    struct adaptive_chunking_data
+    {
+        // Exponential moving average of the time per item in nanoseconds,
+        // zero until the first bulk operation has completed
+        static inline std::atomic<double> ns_per_item{0.0};
+
+        // Bulk operations with the same function may complete concurrently,
+        // the average is updated with a CAS loop so that no measurement is
+        // lost
+        static void update(double measured_ns_per_item) noexcept
+        {
+            double previous = ns_per_item.load(std::memory_order_relaxed);
+            double updated = 0.0;
+            do {
+                updated = previous == 0.0 ? measured_ns_per_item :
+                                            (previous + measured_ns_per_item) / 2;
+            } while (!ns_per_item.compare_exchange_weak(
+                previous, updated, std::memory_order_relaxed));
+        }
+    };
+
     template <typename Sender, typename Shape, typename F, typename Receiver>
     struct operation_state
     {
@@ -110,11 +140,20 @@ namespace pika::thread_pool_bulk_detail {
                 template <typename Ts>
                 void do_work_chunk(Ts& ts, std::uint32_t const index) const
                 {
-                    auto const i_begin =
-                        static_cast<Shape>(index) * static_cast<Shape>(task_f->chunk_size);
-                    auto const i_end = (std::min)(
-                        (static_cast<Shape>(index) + 1) * static_cast<Shape>(task_f->chunk_size),
-                        task_f->n);
+                    Shape i_begin;
+                    Shape i_end;
+                    if (!op_state->chunk_bounds.empty())
+                    {
+                        i_begin = op_state->chunk_bounds[index];
+                        i_end = op_state->chunk_bounds[index + 1];
+                    }
+                    else
+                    {
+                        i_begin = static_cast<Shape>(index) * static_cast<Shape>(task_f->chunk_size);
+                        i_end = (std::min)((static_cast<Shape>(index) + 1) *
+                                static_cast<Shape>(task_f->chunk_size),
+                            task_f->n);
+                    }
                     for (auto i = i_begin; i < i_end; ++i)
                     {
                         std::apply(pika::util::detail::bind_front(op_state->f, i), ts);
@@ -140,11 +179,9 @@ namespace pika::thread_pool_bulk_detail {
                         do_work_chunk(ts, *index);
                     }
 
-                    // Then steal from neighboring queues
-                    for (std::uint32_t offset = 1; offset < op_state->num_worker_threads; ++offset)
-                    {
-                        std::size_t neighbor_worker_thread =
-                            (task_f->worker_thread + offset) % op_state->num_worker_threads;
+                    // Then steal from neighboring queues, closest worker
+                    // threads first
+                    auto steal_from = [&](std::size_t neighbor_worker_thread) {
                         auto& neighbor_queue = op_state->queues[neighbor_worker_thread].data_;
 
                         while ((index = neighbor_queue.pop_right()))
@@ -152,6 +189,37 @@ namespace pika::thread_pool_bulk_detail {
                             // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
                             do_work_chunk(ts, *index);
                         }
+                    };
+
+                    bool const numa_local_stealing = op_state->numa_local_stealing ||
+                        op_state->chunking_policy ==
+                            pika::execution::experimental::bulk_chunking_policy::affinity;
+                    auto const& steal_orders = op_state->steal_orders;
+                    if (steal_orders && steal_orders->size() == op_state->num_worker_threads)
+                    {
+                        auto const& steal_order = (*steal_orders)[task_f->worker_thread];
+                        std::size_t const num_neighbors = numa_local_stealing ?
+                            steal_order.numa_local_count :
+                            steal_order.threads.size();
+                        for (std::size_t i = 0; i < num_neighbors; ++i)
+                        {
+                            steal_from(steal_order.threads[i]);
+                        }
+                    }
+                    else if (!numa_local_stealing)
+                    {
+                        // Without a steal order all other worker threads are
+                        // visited in round-robin order. It is unknown which
+                        // of them are in the same NUMA domain, so with
+                        // NUMA-local stealing only the local queue is
+                        // handled and the other queues are left to their own
+                        // tasks.
+                        for (std::uint32_t offset = 1; offset < op_state->num_worker_threads;
+                             ++offset)
+                        {
+                            steal_from(
+                                (task_f->worker_thread + offset) % op_state->num_worker_threads);
+                        }
                     }
                 }
             };
@@ -214,6 +282,15 @@ namespace pika::thread_pool_bulk_detail {
                 {
                     if (--(op_state->tasks_remaining) == 0)
                     {
+                        if (op_state->chunking_policy ==
+                                pika::execution::experimental::bulk_chunking_policy::adaptive &&
+                            !op_state->exception_thrown)
+                        {
+                            adaptive_chunking_data<F>::update(
+                                double(op_state->elapsed_ns.load(std::memory_order_relaxed)) /
+                                double(op_state->shape));
+                        }
+
                         if (op_state->exception_thrown)
                         {
                             PIKA_ASSERT(op_state->exception.has_value());
@@ -243,7 +320,18 @@ namespace pika::thread_pool_bulk_detail {
                         // Otherwise the current annotation will be
                         // used.
                         pika::scoped_annotation ann(op_state->f);
-                        do_work();
+                        if (op_state->chunking_policy ==
+                            pika::execution::experimental::bulk_chunking_policy::adaptive)
+                        {
+                            auto const start = std::chrono::steady_clock::now();
+                            do_work();
+                            op_state->elapsed_ns.fetch_add(
+                                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - start)
+                                    .count(),
+                                std::memory_order_relaxed);
+                        }
+                        else { do_work(); }
                     }
                     catch (...)
                     {
@@ -258,7 +346,7 @@ namespace pika::thread_pool_bulk_detail {
             // a total number of items n. Returns a power-of-2 chunk
             // size that produces at most 8 and at least 4 chunks per
             // worker thread.
-            static constexpr std::uint32_t get_chunk_size(
+            static constexpr std::uint32_t get_default_chunk_size(
                 std::uint32_t const num_threads, Shape const n)
             {
                 std::uint32_t chunk_size = 1;
@@ -269,6 +357,74 @@ namespace pika::thread_pool_bulk_detail {
                 return chunk_size;
             }
 
+            // Compute a chunk size such that each chunk takes roughly
+            // target_chunk_time, based on the time per item measured in
+            // previous bulk operations. At least four chunks are created
+            // per worker thread to allow balancing the load.
+            static std::uint32_t get_adaptive_chunk_size(
+                std::uint32_t const num_threads, Shape const n)
+            {
+                constexpr double target_chunk_time_ns = 20000.0;
+
+                double const ns_per_item =
+                    adaptive_chunking_data<F>::ns_per_item.load(std::memory_order_relaxed);
+                if (ns_per_item == 0.0) { return get_default_chunk_size(num_threads, n); }
+
+                double const max_chunk_size =
+                    (std::max)(1.0, double(n) / (4.0 * double(num_threads)));
+                return static_cast<std::uint32_t>(
+                    std::clamp(target_chunk_time_ns / ns_per_item, 1.0, max_chunk_size));
+            }
+
+            // The number of worker threads expected to start working on the
+            // chunks right away: the idle worker threads of the pool and the
+            // calling worker thread, which handles its queue inline. The pool
+            // counts suspended worker threads as idle, they are left out.
+            // Busy worker threads join later by stealing chunks.
+            std::uint32_t get_num_available_threads() const
+            {
+                auto const* pool = op_state->scheduler.get_thread_pool();
+                auto const num_threads = static_cast<std::int64_t>(op_state->num_worker_threads);
+                auto const num_suspended =
+                    num_threads - static_cast<std::int64_t>(pool->get_active_os_thread_count());
+                std::int64_t const num_idle =
+                    (std::max)(std::int64_t(0), pool->get_idle_core_count() - num_suspended);
+                std::int64_t const num_local =
+                    pika::get_local_worker_thread_num() != std::size_t(-1) ? 1 : 0;
+                return static_cast<std::uint32_t>(
+                    std::clamp(num_idle + num_local, std::int64_t(1), num_threads));
+            }
+
+            std::uint32_t get_chunk_size(std::uint32_t const num_threads, Shape const n) const
+            {
+                using pika::execution::experimental::bulk_chunking_policy;
+
+                // A user-provided chunk size is only a minimum chunk size
+                // for the guided policy
+                if (op_state->chunk_size != 0 &&
+                    op_state->chunking_policy != bulk_chunking_policy::guided)
+                {
+                    return op_state->chunk_size;
+                }
+
+                switch (op_state->chunking_policy)
+                {
+                case bulk_chunking_policy::static_:
+                    return static_cast<std::uint32_t>((n + num_threads - 1) / num_threads);
+                case bulk_chunking_policy::guided:
+                    return (std::max)(op_state->chunk_size, std::uint32_t(1));
+                // Chunks for the balancing policies are sized for the worker
+                // threads that are actually available. The affinity policy
+                // keeps a fixed assignment of items to worker threads.
+                case bulk_chunking_policy::adaptive:
+                    return get_adaptive_chunk_size(get_num_available_threads(), n);
+                case bulk_chunking_policy::affinity:
+                    return get_default_chunk_size(num_threads, n);
+                case bulk_chunking_policy::default_: [[fallthrough]];
+                default: return get_default_chunk_size(get_num_available_threads(), n);
+                }
+            }
+
             // Initialize a queue for a worker thread.
             void init_queue(std::uint32_t const worker_thread, std::uint32_t const num_chunks)
             {
@@ -280,10 +436,44 @@ namespace pika::thread_pool_bulk_detail {
                 queue.reset(part_begin, part_end);
             }
 
-            // Spawn a task which will process a number of chunks. If
+            // Initialize the queues for all worker threads for the guided
+            // policy. Each worker thread gets an equal part of the items,
+            // split into chunks of halving size but at least
+            // min_chunk_size. Returns the total number of chunks.
+            std::uint32_t init_guided_queues(Shape const n, std::uint32_t const min_chunk_size)
+            {
+                auto& bounds = op_state->chunk_bounds;
+                bounds.clear();
+                bounds.push_back(0);
+
+                std::size_t const num_threads = op_state->num_worker_threads;
+                for (std::size_t worker_thread = 0; worker_thread < num_threads; ++worker_thread)
+                {
+                    auto const first_chunk = static_cast<std::uint32_t>(bounds.size() - 1);
+                    auto const part_end = static_cast<Shape>(
+                        (static_cast<std::uint64_t>(n) * (worker_thread + 1)) / num_threads);
+
+                    Shape begin = bounds.back();
+                    while (begin < part_end)
+                    {
+                        Shape const size =
+                            (std::max)(static_cast<Shape>(min_chunk_size), (part_end - begin + 1) / 2);
+                        begin = (std::min)(part_end, static_cast<Shape>(begin + size));
+                        bounds.push_back(begin);
+                    }
+
+                    op_state->queues[worker_thread].data_.reset(
+                        first_chunk, static_cast<std::uint32_t>(bounds.size() - 1));
+                }
+
+                return static_cast<std::uint32_t>(bounds.size() - 1);
+            }
+
+            // Prepare a task which will process a number of chunks. If
             // the queue contains no chunks no task will be spawned.
             void do_work_task(Shape const n, std::uint32_t const chunk_size,
-                std::uint32_t const worker_thread) const
+                std::uint32_t const worker_thread,
+                std::vector<threads::detail::thread_init_data>& tasks) const
             {
                 task_function task_f{this->op_state, n, chunk_size, worker_thread};
 
@@ -296,9 +486,13 @@ namespace pika::thread_pool_bulk_detail {
                     return;
                 }
 
-                // Only apply hint if none was given.
+                // Only apply hint if none was given, unless the chunks
+                // must be processed on the worker thread they are assigned
+                // to.
                 auto hint = pika::execution::experimental::get_hint(op_state->scheduler);
-                if (hint == pika::execution::thread_schedule_hint())
+                if (hint == pika::execution::thread_schedule_hint() ||
+                    op_state->chunking_policy ==
+                        pika::execution::experimental::bulk_chunking_policy::affinity)
                 {
                     hint = pika::execution::thread_schedule_hint(
                         pika::execution::thread_schedule_hint_mode::thread, worker_thread);
@@ -313,12 +507,13 @@ namespace pika::thread_pool_bulk_detail {
                     pika::threads::detail::get_thread_description(
                         pika::threads::detail::get_self_id());
 
-                // Spawn the task.
-                threads::detail::thread_init_data data(
-                    threads::detail::make_thread_function_nullary(std::move(task_f)), desc,
-                    pika::execution::experimental::get_priority(op_state->scheduler), hint,
+                // The tasks are spawned together once all have been
+                // prepared.
+                tasks.emplace_back(threads::detail::make_thread_function_nullary(std::move(task_f)),
+                    desc, pika::execution::experimental::get_priority(op_state->scheduler), hint,
                     pika::execution::experimental::get_stacksize(op_state->scheduler));
-                threads::detail::register_work(data, op_state->scheduler.get_thread_pool());
+                tasks.back().deadline =
+                    pika::execution::experimental::get_deadline(op_state->scheduler);
             }
 
             // Do the work on the worker thread that called set_value
@@ -344,24 +539,40 @@ namespace pika::thread_pool_bulk_detail {
 
                 // Calculate chunk size and number of chunks
                 auto const chunk_size =
-                    get_chunk_size(r.op_state->num_worker_threads, r.op_state->shape);
-                auto const num_chunks = (r.op_state->shape + chunk_size - 1) / chunk_size;
+                    r.get_chunk_size(r.op_state->num_worker_threads, r.op_state->shape);
 
                 // Store sent values in the operation state
                 r.op_state->ts.template emplace<std::tuple<std::decay_t<Ts>...>>(
                     std::forward<Ts>(ts)...);
 
+                // All tasks of this operation use the steal orders that are
+                // current when the work starts
+                r.op_state->steal_orders =
+                    r.op_state->scheduler.get_thread_pool()->get_steal_orders();
+
                 // Initialize the queues for all worker threads so that
                 // worker threads can start stealing immediately when
                 // they start.
-                for (std::size_t worker_thread = 0; worker_thread < r.op_state->num_worker_threads;
-                     ++worker_thread)
+                if (r.op_state->chunking_policy ==
+                    pika::execution::experimental::bulk_chunking_policy::guided)
                 {
-                    r.init_queue(worker_thread, num_chunks);
+                    r.init_guided_queues(r.op_state->shape, chunk_size);
+                }
+                else
+                {
+                    auto const num_chunks = (r.op_state->shape + chunk_size - 1) / chunk_size;
+                    for (std::size_t worker_thread = 0;
+                         worker_thread < r.op_state->num_worker_threads; ++worker_thread)
+                    {
+                        r.init_queue(worker_thread, num_chunks);
+                    }
                 }
 
-                // Spawn the worker threads for all except the local queue.
+                // Spawn the worker threads for all except the local queue
+                // with a single batched operation.
                 auto const local_worker_thread = pika::get_local_worker_thread_num();
+                std::vector<threads::detail::thread_init_data> tasks;
+                tasks.reserve(r.op_state->num_worker_threads);
                 for (std::size_t worker_thread = 0; worker_thread < r.op_state->num_worker_threads;
                      ++worker_thread)
                 {
@@ -369,8 +580,10 @@ namespace pika::thread_pool_bulk_detail {
                     // inline.
                     if (worker_thread == local_worker_thread) { continue; }
 
-                    r.do_work_task(r.op_state->shape, chunk_size, worker_thread);
+                    r.do_work_task(r.op_state->shape, chunk_size, worker_thread, tasks);
                 }
+                threads::detail::register_work_bulk(
+                    tasks.data(), tasks.size(), r.op_state->scheduler.get_thread_pool());
 
                 // Handle the queue for the local thread.
                 r.do_work_local(r.op_state->shape, chunk_size, local_worker_thread);
@@ -402,6 +615,18 @@ namespace pika::thread_pool_bulk_detail {
             ts;
         std::atomic<bool> exception_thrown{false};
         std::optional<std::exception_ptr> exception;
+        pika::execution::experimental::bulk_chunking_policy chunking_policy =
+            pika::execution::experimental::get_bulk_chunking_policy(scheduler);
+        std::uint32_t chunk_size = pika::execution::experimental::get_bulk_chunk_size(scheduler);
+        bool numa_local_stealing =
+            pika::execution::experimental::get_bulk_numa_local_stealing(scheduler);
+        std::shared_ptr<std::vector<threads::detail::thread_pool_base::steal_order> const>
+            steal_orders;
+        // The bounds of the chunks if the chunks are not all of the same
+        // size, chunk i covers the items [chunk_bounds[i], chunk_bounds[i + 1])
+        std::vector<Shape> chunk_bounds;
+        // The total time spent by all tasks, for the adaptive policy
+        std::atomic<std::int64_t> elapsed_ns{0};
 
         template <typename Sender_, typename Shape_, typename F_, typename Receiver_>
         operation_state(pika::execution::experimental::thread_pool_scheduler scheduler,
@@ -428,7 +653,10 @@ namespace pika::thread_pool_bulk_detail {
     /// thread. The pika thread is responsible for work in one queue. If the
     /// queue is empty, no pika thread will be spawned. Once the pika thread
     /// has finished working on its own queue, it will attempt to steal work
-    /// from other queues. Since predecessor sender must complete on a pika
+    /// from other queues, starting with the queues of worker threads that
+    /// share the most hardware resources with it. With the
+    /// bulk_numa_local_stealing property only queues of worker threads in the
+    /// same NUMA domain are considered. Since predecessor sender must complete on a pika
     /// thread (the completion scheduler is a thread_pool_scheduler;
     /// otherwise the customization defined in this file is not chosen) it
     /// will be reused as one of the worker threads.
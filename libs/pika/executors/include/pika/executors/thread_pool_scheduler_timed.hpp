@@ -0,0 +1,450 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#if defined(PIKA_HAVE_STDEXEC)
+# include <pika/execution_base/stdexec_forward.hpp>
+#endif
+
+#include <pika/assert.hpp>
+#include <pika/concepts/concepts.hpp>
+#include <pika/errors/try_catch_exception_ptr.hpp>
+#include <pika/execution/algorithms/schedule_at.hpp>
+#include <pika/execution/algorithms/timeout.hpp>
+#include <pika/execution_base/completion_scheduler.hpp>
+#include <pika/execution_base/operation_state.hpp>
+#include <pika/execution_base/receiver.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/executors/thread_pool_scheduler.hpp>
+#include <pika/memory/intrusive_ptr.hpp>
+#include <pika/thread_support/atomic_count.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+#include <pika/timing/steady_clock.hpp>
+#include <pika/type_support/detail/with_result_of.hpp>
+#include <pika/type_support/pack.hpp>
+
+#include <atomic>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace pika::thread_pool_timed_detail {
+    using pika::execution::experimental::thread_pool_scheduler;
+
+    inline pika::chrono::steady_time_point get_deadline(
+        pika::chrono::steady_time_point const& abs_time) noexcept
+    {
+        return abs_time;
+    }
+
+    inline pika::chrono::steady_time_point get_deadline(
+        pika::chrono::steady_duration const& rel_time)
+    {
+        return rel_time.from_now();
+    }
+
+    // Arm a timer on the scheduler of the thread pool the given scheduler
+    // refers to. The timer is fired from the scheduling loop of the pool. If
+    // the pool stops before the deadline, on_stop is called instead of f from
+    // the scheduling loop. No new tasks can be spawned at that point.
+    template <typename F, typename OnStop>
+    pika::threads::detail::timer_handle add_timer(thread_pool_scheduler& scheduler,
+        pika::chrono::steady_time_point const& abs_time, F&& f, OnStop&& on_stop)
+    {
+        pika::threads::detail::scheduler_base* sched = scheduler.get_thread_pool()->get_scheduler();
+        PIKA_ASSERT(sched != nullptr);
+        return sched->add_timer(
+            abs_time.value(), std::forward<F>(f), std::forward<OnStop>(on_stop));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename Deadline, typename Receiver>
+    struct schedule_at_operation_state
+    {
+        thread_pool_scheduler scheduler;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Receiver> receiver;
+        Deadline deadline;
+        char const* fallback_annotation;
+
+        template <typename Receiver_>
+        schedule_at_operation_state(thread_pool_scheduler scheduler, Receiver_&& receiver,
+            Deadline deadline, char const* fallback_annotation)
+          : scheduler(std::move(scheduler))
+          , receiver(std::forward<Receiver_>(receiver))
+          , deadline(std::move(deadline))
+          , fallback_annotation(fallback_annotation)
+        {
+            PIKA_ASSERT(fallback_annotation != nullptr);
+        }
+
+        schedule_at_operation_state(schedule_at_operation_state&&) = delete;
+        schedule_at_operation_state(schedule_at_operation_state const&) = delete;
+        schedule_at_operation_state& operator=(schedule_at_operation_state&&) = delete;
+        schedule_at_operation_state& operator=(schedule_at_operation_state const&) = delete;
+
+        void set_error(std::exception_ptr ep) noexcept
+        {
+            pika::execution::experimental::set_error(std::move(receiver), std::move(ep));
+        }
+
+        // Invoked from the scheduling loop once the timer expired. A new
+        // task is spawned to signal the receiver, just like for schedule.
+        void on_timer() noexcept
+        {
+            pika::detail::try_catch_exception_ptr(
+                [&]() {
+                    scheduler.execute(
+                        [this]() mutable {
+                            pika::execution::experimental::set_value(std::move(receiver));
+                        },
+                        fallback_annotation);
+                },
+                [&](std::exception_ptr ep) { set_error(std::move(ep)); });
+        }
+
+        // Invoked from the scheduling loop if the thread pool stops before
+        // the timer expired.
+        void on_stop() noexcept { pika::execution::experimental::set_stopped(std::move(receiver)); }
+
+        void start() & noexcept
+        {
+            pika::detail::try_catch_exception_ptr(
+                [&]() {
+                    add_timer(scheduler, get_deadline(deadline), [this]() { on_timer(); },
+                        [this]() { on_stop(); });
+                },
+                [&](std::exception_ptr ep) { set_error(std::move(ep)); });
+        }
+    };
+
+    template <typename Deadline>
+    struct schedule_at_sender
+    {
+        PIKA_STDEXEC_SENDER_CONCEPT
+
+        thread_pool_scheduler scheduler;
+        Deadline deadline;
+        char const* fallback_annotation = scheduler.get_fallback_annotation();
+
+        template <template <typename...> class Tuple, template <typename...> class Variant>
+        using value_types = Variant<Tuple<>>;
+
+        template <template <typename...> class Variant>
+        using error_types = Variant<std::exception_ptr>;
+
+        static constexpr bool sends_done = true;
+
+        using completion_signatures = pika::execution::experimental::completion_signatures<
+            pika::execution::experimental::set_value_t(),
+            pika::execution::experimental::set_error_t(std::exception_ptr),
+            pika::execution::experimental::set_stopped_t()>;
+
+        template <typename Receiver>
+        schedule_at_operation_state<Deadline, Receiver> connect(Receiver&& receiver) const
+        {
+            return {scheduler, std::forward<Receiver>(receiver), deadline, fallback_annotation};
+        }
+
+        struct env
+        {
+            thread_pool_scheduler scheduler;
+
+            friend thread_pool_scheduler tag_invoke(
+                pika::execution::experimental::get_completion_scheduler_t<
+                    pika::execution::experimental::set_value_t>,
+                env const& e) noexcept
+            {
+                return e.scheduler;
+            }
+        };
+
+        env get_env() const& noexcept { return {scheduler}; }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename Sender, typename Deadline, typename Receiver>
+    struct timeout_shared_state
+    {
+        struct timeout_receiver
+        {
+            PIKA_STDEXEC_RECEIVER_CONCEPT
+
+            // The receiver does not own the shared state, which owns the
+            // operation state holding the receiver. The shared state is kept
+            // alive by a reference added when the predecessor is started.
+            timeout_shared_state* state;
+
+            template <typename Error>
+            friend void tag_invoke(pika::execution::experimental::set_error_t,
+                timeout_receiver r, Error&& error) noexcept
+            {
+                if (r.state->try_complete_predecessor())
+                {
+                    pika::execution::experimental::set_error(
+                        std::move(r.state->receiver), std::forward<Error>(error));
+                }
+                r.state->finish_predecessor();
+            }
+
+            friend void tag_invoke(
+                pika::execution::experimental::set_stopped_t, timeout_receiver r) noexcept
+            {
+                if (r.state->try_complete_predecessor())
+                {
+                    pika::execution::experimental::set_stopped(std::move(r.state->receiver));
+                }
+                r.state->finish_predecessor();
+            }
+
+            template <typename... Ts>
+            void set_value(Ts&&... ts) && noexcept
+            {
+                auto r = std::move(*this);
+                if (r.state->try_complete_predecessor())
+                {
+                    pika::execution::experimental::set_value(
+                        std::move(r.state->receiver), std::forward<Ts>(ts)...);
+                }
+                r.state->finish_predecessor();
+            }
+
+            constexpr pika::execution::experimental::empty_env get_env() const& noexcept
+            {
+                return {};
+            }
+        };
+
+        pika::detail::atomic_count reference_count{0};
+        std::atomic<bool> completed{false};
+        thread_pool_scheduler scheduler;
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Receiver> receiver;
+        Deadline deadline;
+        char const* fallback_annotation;
+        pika::threads::detail::timer_handle timer;
+
+        using operation_state_type = std::decay_t<
+            pika::execution::experimental::connect_result_t<Sender, timeout_receiver>>;
+        // The operation state of the predecessor sender is reset as soon as
+        // the predecessor has completed. A started operation state has to
+        // stay alive until then, also if the timer has expired before.
+        std::optional<operation_state_type> os;
+
+        template <typename Sender_, typename Receiver_>
+        timeout_shared_state(Sender_&& sender, thread_pool_scheduler scheduler,
+            Receiver_&& receiver, Deadline deadline, char const* fallback_annotation)
+          : scheduler(std::move(scheduler))
+          , receiver(std::forward<Receiver_>(receiver))
+          , deadline(std::move(deadline))
+          , fallback_annotation(fallback_annotation)
+        {
+            os.emplace(pika::detail::with_result_of([&]() {
+                return pika::execution::experimental::connect(
+                    std::forward<Sender_>(sender), timeout_receiver{this});
+            }));
+        }
+
+        // Returns true for the first of the predecessor and the timer to
+        // complete, which is the one to signal the receiver.
+        bool try_complete() noexcept
+        {
+            return !completed.exchange(true, std::memory_order_acq_rel);
+        }
+
+        // Called when the predecessor completes. The predecessor is started
+        // only after the timer has been armed, so the timer handle can be
+        // safely accessed here.
+        bool try_complete_predecessor() noexcept
+        {
+            if (!try_complete()) { return false; }
+
+            timer.cancel();
+            return true;
+        }
+
+        // Called last when the predecessor completes. Releases the operation
+        // state of the predecessor and the reference held on its behalf.
+        void finish_predecessor() noexcept
+        {
+            os.reset();
+            intrusive_ptr_release(this);
+        }
+
+        // The timer handle must not be accessed here as the timer may expire
+        // before the handle has been stored.
+        void on_timer() noexcept
+        {
+            if (!try_complete()) { return; }
+
+            pika::detail::try_catch_exception_ptr(
+                [&]() {
+                    scheduler.execute(
+                        [state = pika::intrusive_ptr<timeout_shared_state>(this)]() mutable {
+                            pika::execution::experimental::set_stopped(std::move(state->receiver));
+                        },
+                        fallback_annotation);
+                },
+                [&](std::exception_ptr ep) {
+                    pika::execution::experimental::set_error(std::move(receiver), std::move(ep));
+                });
+        }
+
+        // Invoked from the scheduling loop if the thread pool stops before
+        // the timer expired. The receiver is signalled inline as no new tasks
+        // can be spawned at that point.
+        void on_stop() noexcept
+        {
+            if (!try_complete()) { return; }
+
+            pika::execution::experimental::set_stopped(std::move(receiver));
+        }
+
+        void start() noexcept
+        {
+            // The timer is armed before the predecessor is started so that it
+            // can be safely cancelled once the predecessor completes.
+            pika::detail::try_catch_exception_ptr(
+                [&]() {
+                    timer = add_timer(scheduler, get_deadline(deadline),
+                        [state = pika::intrusive_ptr<timeout_shared_state>(this)]() {
+                            state->on_timer();
+                        },
+                        [state = pika::intrusive_ptr<timeout_shared_state>(this)]() {
+                            state->on_stop();
+                        });
+                },
+                [&](std::exception_ptr ep) {
+                    completed.store(true, std::memory_order_relaxed);
+                    pika::execution::experimental::set_error(std::move(receiver), std::move(ep));
+                });
+
+            // The predecessor is started even if arming the timer failed, its
+            // completion is ignored in that case. The shared state is kept
+            // alive until the predecessor has completed.
+            intrusive_ptr_add_ref(this);
+            pika::execution::experimental::start(*os);
+        }
+
+        friend void intrusive_ptr_add_ref(timeout_shared_state* p) { ++p->reference_count; }
+
+        friend void intrusive_ptr_release(timeout_shared_state* p)
+        {
+            if (--p->reference_count == 0) { delete p; }
+        }
+    };
+
+    template <typename Sender, typename Deadline, typename Receiver>
+    struct timeout_operation_state
+    {
+        using shared_state_type = timeout_shared_state<Sender, Deadline, Receiver>;
+        pika::intrusive_ptr<shared_state_type> state;
+
+        template <typename Sender_, typename Receiver_>
+        timeout_operation_state(Sender_&& sender, thread_pool_scheduler scheduler,
+            Receiver_&& receiver, Deadline deadline, char const* fallback_annotation)
+          : state(new shared_state_type(std::forward<Sender_>(sender), std::move(scheduler),
+                std::forward<Receiver_>(receiver), std::move(deadline), fallback_annotation))
+        {
+        }
+
+        timeout_operation_state(timeout_operation_state&&) = delete;
+        timeout_operation_state(timeout_operation_state const&) = delete;
+        timeout_operation_state& operator=(timeout_operation_state&&) = delete;
+        timeout_operation_state& operator=(timeout_operation_state const&) = delete;
+
+        void start() & noexcept { state->start(); }
+    };
+
+    template <typename Sender, typename Deadline>
+    struct timeout_sender
+    {
+        PIKA_STDEXEC_SENDER_CONCEPT
+
+        PIKA_NO_UNIQUE_ADDRESS std::decay_t<Sender> sender;
+        thread_pool_scheduler scheduler;
+        Deadline deadline;
+        char const* fallback_annotation = scheduler.get_fallback_annotation();
+
+#if defined(PIKA_HAVE_STDEXEC)
+        using completion_signatures =
+            pika::execution::experimental::transform_completion_signatures_of<Sender,
+                pika::execution::experimental::empty_env,
+                pika::execution::experimental::completion_signatures<
+                    pika::execution::experimental::set_stopped_t(),
+                    pika::execution::experimental::set_error_t(std::exception_ptr)>>;
+#else
+        template <template <typename...> class Tuple, template <typename...> class Variant>
+        using value_types = typename pika::execution::experimental::sender_traits<
+            Sender>::template value_types<Tuple, Variant>;
+
+        template <template <typename...> class Variant>
+        using error_types = pika::util::detail::unique_t<
+            pika::util::detail::prepend_t<typename pika::execution::experimental::sender_traits<
+                                              Sender>::template error_types<Variant>,
+                std::exception_ptr>>;
+
+        static constexpr bool sends_done = true;
+#endif
+
+        template <typename Receiver>
+        timeout_operation_state<Sender, Deadline, Receiver> connect(Receiver&& receiver) &&
+        {
+            return {std::move(sender), scheduler, std::forward<Receiver>(receiver), deadline,
+                fallback_annotation};
+        }
+
+        template <typename Receiver>
+        timeout_operation_state<Sender const&, Deadline, Receiver>
+        connect(Receiver&& receiver) const&
+        {
+            return {
+                sender, scheduler, std::forward<Receiver>(receiver), deadline, fallback_annotation};
+        }
+
+        decltype(auto) get_env() const& noexcept
+        {
+            return pika::execution::experimental::get_env(sender);
+        }
+    };
+}    // namespace pika::thread_pool_timed_detail
+
+namespace pika::execution::experimental {
+    inline thread_pool_timed_detail::schedule_at_sender<pika::chrono::steady_time_point>
+    tag_invoke(schedule_at_t, thread_pool_scheduler scheduler,
+        pika::chrono::steady_time_point const& abs_time)
+    {
+        return {std::move(scheduler), abs_time};
+    }
+
+    inline thread_pool_timed_detail::schedule_at_sender<pika::chrono::steady_duration>
+    tag_invoke(schedule_after_t, thread_pool_scheduler scheduler,
+        pika::chrono::steady_duration const& rel_time)
+    {
+        return {std::move(scheduler), rel_time};
+    }
+
+    template <typename Sender, PIKA_CONCEPT_REQUIRES_(is_sender_v<Sender>)>
+    auto tag_invoke(timeout_t, Sender&& sender, thread_pool_scheduler scheduler,
+        pika::chrono::steady_time_point const& abs_time)
+    {
+        return thread_pool_timed_detail::timeout_sender<std::decay_t<Sender>,
+            pika::chrono::steady_time_point>{
+            std::forward<Sender>(sender), std::move(scheduler), abs_time};
+    }
+
+    template <typename Sender, PIKA_CONCEPT_REQUIRES_(is_sender_v<Sender>)>
+    auto tag_invoke(timeout_t, Sender&& sender, thread_pool_scheduler scheduler,
+        pika::chrono::steady_duration const& rel_time)
+    {
+        return thread_pool_timed_detail::timeout_sender<std::decay_t<Sender>,
+            pika::chrono::steady_duration>{
+            std::forward<Sender>(sender), std::move(scheduler), rel_time};
+    }
+}    // namespace pika::execution::experimental
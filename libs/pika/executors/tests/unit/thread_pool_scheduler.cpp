@@ -7,14 +7,21 @@
 #include <pika/condition_variable.hpp>
 #include <pika/execution.hpp>
 #include <pika/init.hpp>
+#include <pika/latch.hpp>
 #include <pika/mutex.hpp>
 #include <pika/testing.hpp>
 #include <pika/thread.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+#include <pika/threading_base/scheduler_mode.hpp>
+#include <pika/threading_base/thread_num_tss.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
 #include <stdexcept>
@@ -54,6 +61,62 @@ void test_execute()
     ex::execute(sched, [parent_id]() { PIKA_TEST_NEQ(pika::this_thread::get_id(), parent_id); });
 }
 
+void test_execute_bulk()
+{
+    pika::thread::id parent_id = pika::this_thread::get_id();
+    ex::thread_pool_scheduler sched{};
+
+    for (std::size_t n : {0, 1, 7, 10000})
+    {
+        std::vector<std::atomic<std::size_t>> counts(n);
+        pika::latch l(n + 1);
+
+        sched.execute_bulk(n, [&, parent_id](std::size_t i) {
+            PIKA_TEST_NEQ(pika::this_thread::get_id(), parent_id);
+            ++counts[i];
+            l.count_down(1);
+        });
+
+        l.arrive_and_wait();
+        for (auto const& count : counts) { PIKA_TEST_EQ(count.load(), std::size_t(1)); }
+    }
+
+    // Work items of all priorities and with and without hints can be created
+    // together
+    {
+        using pika::execution::thread_priority;
+        using pika::threads::detail::thread_init_data;
+
+        constexpr std::size_t n = 1000;
+        std::size_t const num_threads = pika::get_num_worker_threads();
+        std::atomic<std::size_t> count{0};
+        pika::latch l(n + 1);
+
+        std::vector<thread_init_data> data;
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            thread_priority const priority = i % 3 == 0 ?
+                thread_priority::high :
+                (i % 3 == 1 ? thread_priority::low : thread_priority::normal);
+            pika::execution::thread_schedule_hint const hint = i % 2 == 0 ?
+                pika::execution::thread_schedule_hint(std::int16_t(i % num_threads)) :
+                pika::execution::thread_schedule_hint();
+
+            data.emplace_back(pika::threads::detail::make_thread_function_nullary([&] {
+                ++count;
+                l.count_down(1);
+            }),
+                pika::detail::thread_description("test_execute_bulk"), priority, hint,
+                pika::execution::thread_stacksize::default_);
+        }
+
+        pika::threads::detail::register_work_bulk(data.data(), data.size());
+
+        l.arrive_and_wait();
+        PIKA_TEST_EQ(count.load(), n);
+    }
+}
+
 struct check_context_receiver
 {
     PIKA_STDEXEC_RECEIVER_CONCEPT
@@ -312,6 +375,31 @@ void test_properties()
         // thread_pool_scheduler holds the property.
     }
 
+    {
+        PIKA_TEST(ex::get_deadline(sched) == (std::chrono::steady_clock::time_point::max)());
+
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        auto exec_prop = ex::with_deadline(sched, deadline);
+        PIKA_TEST(ex::get_deadline(exec_prop) == deadline);
+        PIKA_TEST(exec_prop != sched);
+
+        auto check = [deadline]() {
+            PIKA_TEST(deadline ==
+                pika::threads::detail::get_thread_id_data(pika::threads::detail::get_self_id())
+                    ->get_deadline());
+        };
+        executed = false;
+        auto os = ex::connect(ex::schedule(exec_prop),
+            callback_receiver<decltype(check)>{check, mtx, cond, executed});
+        ex::start(os);
+        {
+            std::unique_lock l{mtx};
+            cond.wait(l, [&]() { return executed; });
+        }
+
+        PIKA_TEST(executed);
+    }
+
     {
         char const* annotation = "<test>";
         auto exec_prop = ex::with_annotation(sched, annotation);
@@ -1306,6 +1394,134 @@ void test_bulk()
     }
 }
 
+void test_bulk_chunking()
+{
+    constexpr std::array<ex::bulk_chunking_policy, 5> policies{
+        {ex::bulk_chunking_policy::default_, ex::bulk_chunking_policy::static_,
+            ex::bulk_chunking_policy::guided, ex::bulk_chunking_policy::adaptive,
+            ex::bulk_chunking_policy::affinity}};
+    constexpr std::array<std::uint32_t, 3> chunk_sizes{{0, 1, 7}};
+    std::vector<int> const ns = {0, 1, 10, 43, 1000, 12345};
+
+    for (auto const policy : policies)
+    {
+        for (auto const chunk_size : chunk_sizes)
+        {
+            auto sched = ex::with_bulk_chunk_size(
+                ex::with_bulk_chunking_policy(ex::thread_pool_scheduler{}, policy), chunk_size);
+            PIKA_TEST(ex::get_bulk_chunking_policy(sched) == policy);
+            PIKA_TEST_EQ(ex::get_bulk_chunk_size(sched), chunk_size);
+
+            // Run repeatedly so that the adaptive policy uses measurements
+            // from previous iterations
+            for (int repetition = 0; repetition < 3; ++repetition)
+            {
+                for (int n : ns)
+                {
+                    std::vector<std::atomic<int>> v(n);
+
+                    tt::sync_wait(ex::schedule(sched) | ex::bulk(n, [&](int i) { ++v[i]; }));
+
+                    for (int i = 0; i < n; ++i) { PIKA_TEST_EQ(v[i].load(), 1); }
+                }
+            }
+        }
+    }
+
+    PIKA_TEST(ex::get_bulk_chunking_policy(ex::thread_pool_scheduler{}) ==
+        ex::bulk_chunking_policy::default_);
+    PIKA_TEST_EQ(ex::get_bulk_chunk_size(ex::thread_pool_scheduler{}), std::uint32_t(0));
+    PIKA_TEST(ex::with_bulk_chunk_size(ex::thread_pool_scheduler{}, 3) !=
+        ex::thread_pool_scheduler{});
+}
+
+// The affinity policy always assigns the same index ranges to the same worker threads. Chunks are
+// normally also stolen by other worker threads in the same NUMA domain, and the tasks processing
+// the chunks by idle worker threads. To observe the assignment, stealing is disabled in the
+// scheduler and each chunk waits for all chunks to be started, so that no worker thread runs out
+// of chunks and steals one.
+void test_bulk_affinity()
+{
+    using pika::threads::scheduler_mode;
+
+    constexpr int chunk_size = 5;
+    constexpr int num_repetitions = 3;
+
+    auto sched = ex::with_bulk_chunking_policy(
+        ex::with_bulk_chunk_size(ex::thread_pool_scheduler{}, chunk_size),
+        ex::bulk_chunking_policy::affinity);
+    auto* pool = sched.get_thread_pool();
+    auto* scheduler = pool->get_scheduler();
+    std::size_t const num_threads = pool->get_os_thread_count();
+
+    scheduler_mode const mode = scheduler->get_scheduler_mode();
+    scheduler->remove_scheduler_mode(
+        scheduler_mode::enable_stealing | scheduler_mode::enable_stealing_numa);
+
+    // One chunk per worker thread, chunk i is assigned to worker thread i
+    int const n = static_cast<int>(num_threads) * chunk_size;
+    for (int repetition = 0; repetition < num_repetitions; ++repetition)
+    {
+        std::vector<std::size_t> worker_threads(n, std::size_t(-1));
+        std::atomic<std::size_t> num_chunks_started{0};
+
+        tt::sync_wait(ex::schedule(sched) | ex::bulk(n, [&](int i) {
+            if (i % chunk_size == 0)
+            {
+                ++num_chunks_started;
+                while (num_chunks_started.load() != num_threads) {}
+            }
+            worker_threads[i] = pika::get_local_worker_thread_num();
+        }));
+
+        for (int i = 0; i < n; ++i)
+        {
+            PIKA_TEST_EQ(worker_threads[i], static_cast<std::size_t>(i / chunk_size));
+        }
+    }
+
+    scheduler->set_scheduler_mode(mode);
+}
+
+void test_bulk_stealing()
+{
+    ex::thread_pool_scheduler sched{};
+    PIKA_TEST(!ex::get_bulk_numa_local_stealing(sched));
+    PIKA_TEST(ex::get_bulk_numa_local_stealing(ex::with_bulk_numa_local_stealing(sched, true)));
+
+    // Each worker thread steals from all other worker threads exactly once
+    auto* pool = sched.get_thread_pool();
+    std::size_t const num_threads = pool->get_os_thread_count();
+    auto const steal_orders = pool->get_steal_orders();
+    PIKA_TEST(steal_orders != nullptr);
+    PIKA_TEST_EQ(steal_orders->size(), num_threads);
+    for (std::size_t thread_num = 0; thread_num < num_threads; ++thread_num)
+    {
+        auto const& steal_order = (*steal_orders)[thread_num];
+        PIKA_TEST_EQ(steal_order.threads.size(), num_threads - 1);
+        PIKA_TEST_LTE(steal_order.numa_local_count, steal_order.threads.size());
+
+        std::vector<std::uint32_t> threads = steal_order.threads;
+        threads.push_back(static_cast<std::uint32_t>(thread_num));
+        std::sort(threads.begin(), threads.end());
+        for (std::size_t i = 0; i < num_threads; ++i) { PIKA_TEST_EQ(threads[i], i); }
+    }
+
+    for (bool numa_local_stealing : {false, true})
+    {
+        for (int n : {0, 1, 10, 43, 1000})
+        {
+            std::vector<std::atomic<int>> v(n);
+
+            tt::sync_wait(ex::schedule(ex::with_bulk_numa_local_stealing(sched,
+                              numa_local_stealing)) |
+                ex::bulk(n, [&](int i) { ++v[i]; }));
+
+            for (int i = 0; i < n; ++i) { PIKA_TEST_EQ(v[i].load(), 1); }
+        }
+    }
+}
+
 void test_completion_scheduler()
 {
     {
@@ -1484,6 +1700,7 @@ void test_scheduler_queries()
 int pika_main()
 {
     test_execute();
+    test_execute_bulk();
     test_sender_receiver_basic();
     test_sender_receiver_then();
     test_sender_receiver_then_wait();
@@ -1508,6 +1725,9 @@ int pika_main()
     test_let_error();
     test_detach();
     test_bulk();
+    test_bulk_chunking();
+    test_bulk_affinity();
+    test_bulk_stealing();
     test_drop_value();
     test_split_tuple();
     test_completion_scheduler();
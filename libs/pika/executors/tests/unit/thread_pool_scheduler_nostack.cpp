@@ -0,0 +1,224 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test verifies that work scheduled without a stack runs directly on the
+// worker threads without creating pika threads, and that the runtime waits for
+// such work to complete.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/mutex.hpp>
+#include <pika/runtime.hpp>
+#include <pika/semaphore.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+using namespace std::chrono_literals;
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+ex::thread_pool_scheduler nostack_scheduler()
+{
+    return ex::with_stacksize(
+        ex::thread_pool_scheduler{}, pika::execution::thread_stacksize::nostack);
+}
+
+void check_inline_task()
+{
+    PIKA_TEST(pika::threads::detail::get_self_ptr() == nullptr);
+    PIKA_TEST(pika::threads::detail::scheduler_base::is_running_inline_task());
+    PIKA_TEST_NEQ(pika::get_worker_thread_num(), std::size_t(-1));
+}
+
+void test_schedule()
+{
+    tt::sync_wait(ex::schedule(nostack_scheduler()) | ex::then(check_inline_task));
+    PIKA_TEST(!pika::threads::detail::scheduler_base::is_running_inline_task());
+
+    PIKA_TEST_EQ(tt::sync_wait(ex::just(42) | ex::continues_on(nostack_scheduler()) |
+                     ex::then([](int x) {
+                         check_inline_task();
+                         return x + 1;
+                     })),
+        43);
+
+    // Other stack sizes still create pika threads
+    tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) | ex::then([] {
+        PIKA_TEST(pika::threads::detail::get_self_ptr() != nullptr);
+        PIKA_TEST(!pika::threads::detail::scheduler_base::is_running_inline_task());
+    }));
+}
+
+void test_fallback()
+{
+    // Work with a priority other than normal or with a deadline still runs on
+    // pika threads
+    auto check_pika_thread = [] {
+        PIKA_TEST(pika::threads::detail::get_self_ptr() != nullptr);
+        PIKA_TEST(!pika::threads::detail::scheduler_base::is_running_inline_task());
+    };
+
+    tt::sync_wait(ex::schedule(ex::with_priority(nostack_scheduler(),
+                      pika::execution::thread_priority::high)) |
+        ex::then(check_pika_thread));
+
+    tt::sync_wait(ex::schedule(ex::with_deadline(nostack_scheduler(),
+                      std::chrono::steady_clock::now() + 1s)) |
+        ex::then(check_pika_thread));
+
+    tt::sync_wait(ex::schedule(ex::with_priority(nostack_scheduler(),
+                      pika::execution::thread_priority::normal)) |
+        ex::then(check_inline_task));
+}
+
+void test_execute()
+{
+    constexpr std::size_t num_tasks = 10000;
+    std::atomic<std::size_t> num_run{0};
+    pika::latch l(num_tasks + 1);
+
+    for (std::size_t i = 0; i != num_tasks; ++i)
+    {
+        ex::execute(nostack_scheduler(), [&] {
+            check_inline_task();
+            ++num_run;
+            l.count_down(1);
+        });
+    }
+
+    l.arrive_and_wait();
+    PIKA_TEST_EQ(num_run.load(), num_tasks);
+}
+
+void test_chain()
+{
+    // Long chains of continuations hopping between the lanes of different
+    // worker threads
+    constexpr std::size_t num_chains = 100;
+    constexpr std::size_t chain_length = 100;
+    std::atomic<std::size_t> num_run{0};
+    std::size_t const num_threads = pika::get_num_worker_threads();
+
+    for (std::size_t i = 0; i != num_chains; ++i)
+    {
+        ex::unique_any_sender<> s = ex::just();
+        for (std::size_t j = 0; j != chain_length; ++j)
+        {
+            auto sched = ex::with_hint(nostack_scheduler(),
+                pika::execution::thread_schedule_hint(std::int16_t((i + j) % num_threads)));
+            s = std::move(s) | ex::continues_on(sched) | ex::then([&] { ++num_run; });
+        }
+        ex::start_detached(std::move(s));
+    }
+
+    pika::wait();
+    PIKA_TEST_EQ(num_run.load(), num_chains * chain_length);
+}
+
+void test_wait()
+{
+    // The runtime waits for inline tasks that are still queued or running
+    constexpr std::size_t num_tasks = 100;
+    std::atomic<std::size_t> num_run{0};
+
+    for (std::size_t i = 0; i != num_tasks; ++i)
+    {
+        ex::execute(nostack_scheduler(), [&] {
+            std::this_thread::sleep_for(100us);
+            ++num_run;
+        });
+    }
+
+    pika::wait();
+    PIKA_TEST_EQ(num_run.load(), num_tasks);
+}
+
+void test_error()
+{
+    bool exception_thrown = false;
+    try
+    {
+        tt::sync_wait(ex::schedule(nostack_scheduler()) |
+            ex::then([] { throw std::runtime_error("error"); }));
+        PIKA_TEST(false);
+    }
+    catch (std::runtime_error const&)
+    {
+        exception_thrown = true;
+    }
+    PIKA_TEST(exception_thrown);
+}
+
+template <typename F>
+void test_cannot_suspend(F&& f)
+{
+    // Suspending an inline task reports an error instead of blocking the
+    // worker thread
+    tt::sync_wait(ex::schedule(nostack_scheduler()) | ex::then([&] {
+        check_inline_task();
+
+        bool exception_thrown = false;
+        try
+        {
+            f();
+            PIKA_TEST(false);
+        }
+        catch (pika::exception const& e)
+        {
+            PIKA_TEST_EQ(e.get_error(), pika::error::invalid_status);
+            exception_thrown = true;
+        }
+        PIKA_TEST(exception_thrown);
+    }));
+}
+
+void test_suspend()
+{
+    test_cannot_suspend([] {
+        pika::binary_semaphore<> sem{0};
+        sem.acquire();
+    });
+
+    test_cannot_suspend([] {
+        pika::mutex mtx;
+        std::lock_guard<pika::mutex> l(mtx);
+    });
+
+    test_cannot_suspend([] { tt::sync_wait(ex::just()); });
+}
+
+int pika_main()
+{
+    test_schedule();
+    test_fallback();
+    test_execute();
+    test_chain();
+    test_wait();
+    test_error();
+    test_suspend();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv), 0);
+    return 0;
+}
@@ -0,0 +1,321 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/type_support/detail/with_result_of.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+// Receiver recording which completion signal has been called
+struct signal_receiver
+{
+    PIKA_STDEXEC_RECEIVER_CONCEPT
+
+    std::atomic<std::size_t>& num_values;
+    std::atomic<std::size_t>& num_stopped;
+    pika::latch& l;
+
+    template <typename E>
+    friend void tag_invoke(ex::set_error_t, signal_receiver&&, E&&) noexcept
+    {
+        PIKA_TEST(false);
+    }
+
+    friend void tag_invoke(ex::set_stopped_t, signal_receiver&& r) noexcept
+    {
+        ++r.num_stopped;
+        r.l.count_down(1);
+    }
+
+    template <typename... Ts>
+    void set_value(Ts&&...) && noexcept
+    {
+        ++num_values;
+        l.count_down(1);
+    }
+
+    constexpr ex::empty_env get_env() const& noexcept { return {}; }
+};
+
+// Receiver keeping an object alive for as long as the receiver exists
+struct lifetime_receiver
+{
+    PIKA_STDEXEC_RECEIVER_CONCEPT
+
+    std::shared_ptr<int> p;
+
+    template <typename E>
+    friend void tag_invoke(ex::set_error_t, lifetime_receiver&&, E&&) noexcept
+    {
+        PIKA_TEST(false);
+    }
+
+    friend void tag_invoke(ex::set_stopped_t, lifetime_receiver&&) noexcept { PIKA_TEST(false); }
+
+    template <typename... Ts>
+    void set_value(Ts&&...) && noexcept
+    {
+        PIKA_TEST(false);
+    }
+
+    constexpr ex::empty_env get_env() const& noexcept { return {}; }
+};
+
+// Receiver counting senders which have been stopped when the runtime shut down
+std::atomic<std::size_t> num_stopped_at_shutdown{0};
+
+struct shutdown_receiver
+{
+    PIKA_STDEXEC_RECEIVER_CONCEPT
+
+    template <typename E>
+    friend void tag_invoke(ex::set_error_t, shutdown_receiver&&, E&&) noexcept
+    {
+        PIKA_TEST(false);
+    }
+
+    friend void tag_invoke(ex::set_stopped_t, shutdown_receiver&&) noexcept
+    {
+        ++num_stopped_at_shutdown;
+    }
+
+    template <typename... Ts>
+    void set_value(Ts&&...) && noexcept
+    {
+        PIKA_TEST(false);
+    }
+
+    constexpr ex::empty_env get_env() const& noexcept { return {}; }
+};
+
+using shutdown_schedule_after_sender_type =
+    decltype(ex::schedule_after(ex::thread_pool_scheduler{}, 1h));
+using shutdown_timeout_sender_type = decltype(ex::schedule_after(ex::thread_pool_scheduler{}, 1h) |
+    ex::timeout(ex::thread_pool_scheduler{}, 2h));
+using shutdown_schedule_after_type =
+    ex::connect_result_t<shutdown_schedule_after_sender_type, shutdown_receiver>;
+using shutdown_timeout_type = ex::connect_result_t<shutdown_timeout_sender_type, shutdown_receiver>;
+
+std::optional<shutdown_schedule_after_type> shutdown_schedule_after_os;
+std::optional<shutdown_timeout_type> shutdown_timeout_os;
+
+///////////////////////////////////////////////////////////////////////////////
+void test_schedule_after()
+{
+    ex::thread_pool_scheduler sched{};
+
+    auto const start = std::chrono::steady_clock::now();
+    tt::sync_wait(ex::schedule_after(sched, 20ms));
+    PIKA_TEST(std::chrono::steady_clock::now() - start >= 20ms);
+
+    // The sender is only completed on a pika thread of the scheduler
+    pika::thread::id parent_id = pika::this_thread::get_id();
+    tt::sync_wait(ex::schedule_after(sched, 1ms) |
+        ex::then([parent_id]() { PIKA_TEST_NEQ(pika::this_thread::get_id(), parent_id); }));
+}
+
+void test_schedule_at()
+{
+    ex::thread_pool_scheduler sched{};
+
+    auto const deadline = std::chrono::steady_clock::now() + 20ms;
+    tt::sync_wait(ex::schedule_at(sched, deadline));
+    PIKA_TEST(std::chrono::steady_clock::now() >= deadline);
+
+    // Deadlines in the past complete as soon as possible
+    tt::sync_wait(ex::schedule_at(sched, std::chrono::steady_clock::now() - 1s));
+}
+
+void test_schedule_after_many()
+{
+    constexpr std::size_t num_senders = 1000;
+    ex::thread_pool_scheduler sched{};
+
+    std::atomic<std::size_t> num_values{0};
+    std::atomic<std::size_t> num_stopped{0};
+    pika::latch l(num_senders + 1);
+
+    using operation_state_type =
+        ex::connect_result_t<decltype(ex::schedule_after(sched, 1ms)), signal_receiver>;
+    std::vector<std::optional<operation_state_type>> oss(num_senders);
+
+    for (std::size_t i = 0; i != num_senders; ++i)
+    {
+        oss[i].emplace(pika::detail::with_result_of([&]() {
+            return ex::connect(ex::schedule_after(sched, std::chrono::microseconds(10 * i)),
+                signal_receiver{num_values, num_stopped, l});
+        }));
+        ex::start(*oss[i]);
+    }
+
+    l.arrive_and_wait();
+    PIKA_TEST_EQ(num_values.load(), num_senders);
+    PIKA_TEST_EQ(num_stopped.load(), std::size_t(0));
+}
+
+void test_timeout_value()
+{
+    ex::thread_pool_scheduler sched{};
+
+    auto const start = std::chrono::steady_clock::now();
+    PIKA_TEST_EQ(tt::sync_wait(ex::just(42) | ex::timeout(sched, 10s)), 42);
+    PIKA_TEST_EQ(tt::sync_wait(ex::schedule(sched) | ex::then([] { return 43; }) |
+                     ex::timeout(sched, std::chrono::steady_clock::now() + 10s)),
+        43);
+    PIKA_TEST(std::chrono::steady_clock::now() - start < 10s);
+}
+
+void test_timeout_error()
+{
+    ex::thread_pool_scheduler sched{};
+
+    bool exception_thrown = false;
+    try
+    {
+        tt::sync_wait(ex::schedule(sched) | ex::then([] { throw std::runtime_error("error"); }) |
+            ex::timeout(sched, 10s));
+        PIKA_TEST(false);
+    }
+    catch (std::runtime_error const& e)
+    {
+        PIKA_TEST_EQ(std::string(e.what()), std::string("error"));
+        exception_thrown = true;
+    }
+    PIKA_TEST(exception_thrown);
+}
+
+void test_timeout_stopped()
+{
+    ex::thread_pool_scheduler sched{};
+
+    std::atomic<std::size_t> num_values{0};
+    std::atomic<std::size_t> num_stopped{0};
+    pika::latch l(2);
+
+    auto const start = std::chrono::steady_clock::now();
+    auto os = ex::connect(ex::schedule_after(sched, 200ms) | ex::timeout(sched, 10ms),
+        signal_receiver{num_values, num_stopped, l});
+    ex::start(os);
+
+    l.arrive_and_wait();
+    PIKA_TEST(std::chrono::steady_clock::now() - start >= 10ms);
+    PIKA_TEST_EQ(num_values.load(), std::size_t(0));
+    PIKA_TEST_EQ(num_stopped.load(), std::size_t(1));
+}
+
+void test_timeout_race()
+{
+    // The predecessor and the timeout expire at roughly the same time. The
+    // receiver must be signaled exactly once.
+    constexpr std::size_t num_senders = 1000;
+    ex::thread_pool_scheduler sched{};
+
+    std::atomic<std::size_t> num_values{0};
+    std::atomic<std::size_t> num_stopped{0};
+    pika::latch l(num_senders + 1);
+
+    using operation_state_type =
+        ex::connect_result_t<decltype(ex::schedule_after(sched, 1ms) | ex::timeout(sched, 1ms)),
+            signal_receiver>;
+    std::vector<std::optional<operation_state_type>> oss(num_senders);
+
+    for (std::size_t i = 0; i != num_senders; ++i)
+    {
+        oss[i].emplace(pika::detail::with_result_of([&]() {
+            return ex::connect(ex::schedule_after(sched, std::chrono::microseconds(i % 100)) |
+                    ex::timeout(sched, std::chrono::microseconds(50)),
+                signal_receiver{num_values, num_stopped, l});
+        }));
+        ex::start(*oss[i]);
+    }
+
+    l.arrive_and_wait();
+    PIKA_TEST_EQ(num_values.load() + num_stopped.load(), num_senders);
+}
+
+void test_timeout_not_started()
+{
+    // The receiver is released when an operation state that has not been
+    // started is destroyed
+    ex::thread_pool_scheduler sched{};
+    auto p = std::make_shared<int>(42);
+    std::weak_ptr<int> const w = p;
+
+    {
+        auto os = ex::connect(
+            ex::schedule_after(sched, 10ms) | ex::timeout(sched, 10s), lifetime_receiver{p});
+        p.reset();
+        PIKA_TEST(!w.expired());
+    }
+
+    PIKA_TEST(w.expired());
+}
+
+void test_pending_at_shutdown()
+{
+    // Timers which are still pending when the runtime stops do not delay the
+    // shutdown until their deadline. The senders complete with set_stopped
+    // instead, see main.
+    ex::thread_pool_scheduler sched{};
+
+    shutdown_schedule_after_os.emplace(pika::detail::with_result_of(
+        [&]() { return ex::connect(ex::schedule_after(sched, 1h), shutdown_receiver{}); }));
+    ex::start(*shutdown_schedule_after_os);
+
+    shutdown_timeout_os.emplace(pika::detail::with_result_of([&]() {
+        return ex::connect(
+            ex::schedule_after(sched, 1h) | ex::timeout(sched, 2h), shutdown_receiver{});
+    }));
+    ex::start(*shutdown_timeout_os);
+}
+
+int pika_main()
+{
+    test_schedule_after();
+    test_schedule_at();
+    test_schedule_after_many();
+    test_timeout_value();
+    test_timeout_error();
+    test_timeout_stopped();
+    test_timeout_race();
+    test_timeout_not_started();
+    test_pending_at_shutdown();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    auto const start = std::chrono::steady_clock::now();
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv), 0);
+    PIKA_TEST(std::chrono::steady_clock::now() - start < 1min);
+    PIKA_TEST_EQ(num_stopped_at_shutdown.load(), std::size_t(2));
+
+    shutdown_schedule_after_os.reset();
+    shutdown_timeout_os.reset();
+
+    return 0;
+}
@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <pika/synchronization/async_mutex.hpp>
 #include <pika/synchronization/mutex.hpp>
 #include <pika/synchronization/no_mutex.hpp>
 #include <pika/synchronization/once.hpp>
 #include <pika/synchronization/recursive_mutex.hpp>
+#include <pika/synchronization/shared_mutex.hpp>
 #include <pika/thread_support/unlock_guard.hpp>
@@ -7,4 +7,5 @@
 #pragma once
 
 #include <pika/config.hpp>
+#include <pika/synchronization/async_semaphore.hpp>
 #include <pika/synchronization/counting_semaphore.hpp>
@@ -117,6 +117,8 @@ namespace pika {
 #if defined(__linux) || defined(linux) || defined(__linux__) || defined(__FreeBSD__)
             pika::threads::coroutines::detail::posix::use_guard_pages =
                 cmdline.rtcfg_.use_stack_guard_pages();
+            pika::threads::coroutines::detail::posix::stack_pool_max_cached_size =
+                cmdline.rtcfg_.get_stack_pool_max_cached_size();
 #endif
 #ifdef PIKA_HAVE_VERIFY_LOCKS
             if (cmdline.rtcfg_.enable_lock_detection())
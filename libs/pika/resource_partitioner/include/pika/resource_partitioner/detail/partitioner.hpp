@@ -33,7 +33,8 @@ namespace pika::resource::detail {
     {
     public:
         // mechanism for adding resources (zero-based index)
-        void add_resource(std::size_t pu_index, bool exclusive, std::size_t num_threads);
+        void add_resource(std::size_t pu_index, bool exclusive, std::size_t num_threads,
+            bool start_suspended = false);
 
         void print_pool(std::ostream&) const;
 
@@ -43,6 +44,15 @@ namespace pika::resource::detail {
         bool pu_is_exclusive(std::size_t virt_core) const;
         bool pu_is_assigned(std::size_t virt_core) const;
 
+        // Return the worker thread running on the processing unit pu_num if
+        // the processing unit has been added non-exclusively to this pool,
+        // std::size_t(-1) otherwise
+        std::size_t get_shared_virt_core(std::size_t pu_num) const;
+
+        // Return whether the worker thread virt_core runs on a processing unit
+        // shared with another pool which owns it initially
+        bool starts_suspended(std::size_t virt_core) const;
+
         void assign_first_core(std::size_t first_core);
 
         friend class resource::detail::partitioner;
@@ -66,6 +76,9 @@ namespace pika::resource::detail {
         // pu index/exclusive/assigned
         std::vector<std::tuple<std::size_t, bool, bool>> assigned_pu_nums_;
 
+        // worker threads which are suspended once the pool has started
+        std::vector<bool> start_suspended_;
+
         // counter for number of threads bound to this pool
         std::size_t num_threads_;
         pika::threads::scheduler_mode mode_;
@@ -164,6 +177,17 @@ namespace pika::resource::detail {
         std::size_t expand_pool(
             std::string const& pool_name, util::detail::function<void(std::size_t)> const& add_pu);
 
+        // Return the worker thread of the given pool running on the processing
+        // unit pu_num if the processing unit is shared with other pools,
+        // std::size_t(-1) otherwise
+        std::size_t get_shared_virt_core(std::string const& pool_name, std::size_t pu_num) const;
+
+        // Return whether the worker thread virt_core of the given pool has to
+        // be suspended once the pool has started. A processing unit shared by
+        // several pools is initially used only by the first pool it was added
+        // to.
+        bool starts_suspended(std::string const& pool_name, std::size_t virt_core) const;
+
         void set_default_pool_name(std::string const& name)
         {
             initial_thread_pools_[0].pool_name_ = name;
@@ -178,6 +202,10 @@ namespace pika::resource::detail {
         ////////////////////////////////////////////////////////////////////////
         void fill_topology_vectors();
         bool pu_exposed(std::size_t pid);
+        bool pu_is_shareable(
+            std::unique_lock<mutex_type>& l, std::size_t pu_num, std::string const& pool_name);
+        bool pu_pools_are_elastic(
+            std::unique_lock<mutex_type>& l, std::size_t pu_num, std::string const& pool_name);
 
         ////////////////////////////////////////////////////////////////////////
         // called in pika_init run_or_start
@@ -223,6 +251,10 @@ namespace pika::resource::detail {
         // store policy flags determining the general behavior of the resource_partitioner
         resource::partitioner_mode mode_;
 
+        // number of worker threads on processing units which are shared
+        // between pools, in addition to the first pool using them
+        std::size_t num_shared_threads_;
+
         // topology information
         threads::detail::topology& topo_;
 
@@ -71,6 +71,8 @@ namespace pika::resource {
         abp_priority_fifo = 5,
         abp_priority_lifo = 6,
         shared_priority = 7,
+        work_stealing_priority = 8,
+        edf = 9,
     };
 
     namespace detail {
@@ -78,7 +78,8 @@ namespace pika::resource::detail {
     // mechanism for adding resources
     // num threads = number of threads desired on a PU. defaults to 1.
     // note: if num_threads > 1 => oversubscription
-    void init_pool_data::add_resource(std::size_t pu_index, bool exclusive, std::size_t num_threads)
+    void init_pool_data::add_resource(
+        std::size_t pu_index, bool exclusive, std::size_t num_threads, bool start_suspended)
     {
         if (pu_index >= pika::threads::detail::hardware_concurrency())
         {
@@ -102,6 +103,7 @@ namespace pika::resource::detail {
         {
             assigned_pus_.push_back(pu_mask);
             assigned_pu_nums_.push_back(std::make_tuple(pu_index, exclusive, false));
+            start_suspended_.push_back(start_suspended);
         }
     }
 
@@ -122,6 +124,8 @@ namespace pika::resource::detail {
         case resource::abp_priority_fifo: sched = "abp_priority_fifo"; break;
         case resource::abp_priority_lifo: sched = "abp_priority_lifo"; break;
         case resource::shared_priority: sched = "shared_priority"; break;
+        case resource::work_stealing_priority: sched = "work_stealing_priority"; break;
+        case resource::edf: sched = "edf"; break;
         }
 
         os << "\"" << sched << "\" is running on PUs : \n";
@@ -164,6 +168,23 @@ namespace pika::resource::detail {
         return std::get<2>(assigned_pu_nums_[virt_core]);
     }
 
+    std::size_t init_pool_data::get_shared_virt_core(std::size_t pu_num) const
+    {
+        for (std::size_t i = 0; i != assigned_pu_nums_.size(); ++i)
+        {
+            if (std::get<0>(assigned_pu_nums_[i]) == pu_num)
+            {
+                return std::get<1>(assigned_pu_nums_[i]) ? std::size_t(-1) : i;
+            }
+        }
+        return std::size_t(-1);
+    }
+
+    bool init_pool_data::starts_suspended(std::size_t virt_core) const
+    {
+        return virt_core < start_suspended_.size() && start_suspended_[virt_core];
+    }
+
     // 'shift' all thread assignments up by the first_core offset
     void init_pool_data::assign_first_core(std::size_t first_core)
     {
@@ -182,6 +203,7 @@ namespace pika::resource::detail {
       : rtcfg_()
       , first_core_(std::size_t(-1))
       , mode_(mode_default)
+      , num_shared_threads_(0)
       , topo_(threads::detail::get_topology())
       , default_scheduler_mode_(threads::scheduler_mode::default_mode)
     {
@@ -434,6 +456,14 @@ namespace pika::resource::detail {
         {
             default_scheduler = scheduling_policy::shared_priority;
         }
+        else if (0 == std::string("work-stealing-priority").find(default_scheduler_str))
+        {
+            default_scheduler = scheduling_policy::work_stealing_priority;
+        }
+        else if (0 == std::string("edf").find(default_scheduler_str))
+        {
+            default_scheduler = scheduling_policy::edf;
+        }
         else
         {
             throw pika::detail::command_line_error(
@@ -598,6 +628,34 @@ namespace pika::resource::detail {
                                         "enabled for this partitioner");
         }
 
+        // With dynamic pools, processing units may be added non-exclusively to
+        // several pools. Each pool gets its own worker thread on the
+        // processing unit, and processing units can be moved between the
+        // pools by suspending the worker thread of one pool and resuming the
+        // worker thread of another (see migrate_processing_unit). The first
+        // pool the processing unit was added to uses it initially, the worker
+        // threads of the other pools start suspended. This requires all pools
+        // sharing the processing unit to support suspending processing units.
+        // Otherwise the processing unit is oversubscribed, if allowed.
+        if (!exclusive && p.thread_occupancy_count_ != 0 && pu_is_shareable(l, p.id_, pool_name))
+        {
+            if (pu_pools_are_elastic(l, p.id_, pool_name))
+            {
+                get_pool_data(l, pool_name).add_resource(p.id_, exclusive, num_threads, true);
+                num_shared_threads_ += num_threads;
+                return;
+            }
+
+            if (!(mode_ & mode_allow_oversubscription))
+            {
+                l.unlock();
+                throw std::invalid_argument("partitioner::add_resource: PU #" +
+                    std::to_string(p.id_) + " is already used by another pool. Sharing it with "
+                    "pool '" + pool_name + "' requires scheduler_mode::enable_elasticity in "
+                    "all pools using it, or mode_allow_oversubscription.");
+            }
+        }
+
         if (mode_ & mode_allow_oversubscription)
         {
             // increment occupancy counter
@@ -618,11 +676,12 @@ namespace pika::resource::detail {
                 ::pika::detail::get_entry_as<std::size_t>(rtcfg_, "pika.os_threads", 0);
             PIKA_ASSERT(num_threads != 0);
 
-            if (detail::init_pool_data::num_threads_overall > num_threads)
+            if (detail::init_pool_data::num_threads_overall - num_shared_threads_ > num_threads)
             {
                 l.unlock();
                 throw std::runtime_error("partitioner::add_resource: Creation of " +
-                    std::to_string(detail::init_pool_data::num_threads_overall) +
+                    std::to_string(
+                        detail::init_pool_data::num_threads_overall - num_shared_threads_) +
                     " threads requested by the resource partitioner, but only " +
                     std::to_string(num_threads) + " provided on the command-line.");
             }
@@ -711,9 +770,10 @@ namespace pika::resource::detail {
         }
 
         // the number of allocated threads should be the same as the number of
-        // threads to create (if no over-subscription is allowed)
+        // threads to create (if no over-subscription is allowed), apart from
+        // the additional threads on processing units shared between pools
         PIKA_ASSERT(mode_ & mode_allow_oversubscription ||
-            num_threads ==
+            num_threads - num_shared_threads_ ==
                 ::pika::detail::get_entry_as<std::size_t>(
                     rtcfg_, "pika.os_threads", std::size_t(-1)));
 
@@ -895,6 +955,59 @@ namespace pika::resource::detail {
         return pu_nums_to_add.size();
     }
 
+    std::size_t partitioner::get_shared_virt_core(
+        std::string const& pool_name, std::size_t pu_num) const
+    {
+        std::unique_lock<mutex_type> l(mtx_);
+        return get_pool_data(l, pool_name).get_shared_virt_core(pu_num);
+    }
+
+    bool partitioner::starts_suspended(std::string const& pool_name, std::size_t virt_core) const
+    {
+        std::unique_lock<mutex_type> l(mtx_);
+        return get_pool_data(l, pool_name).starts_suspended(virt_core);
+    }
+
+    // A processing unit can be shared by a pool if all pools using it so far
+    // use it non-exclusively, and the pool does not use it yet
+    bool partitioner::pu_is_shareable(
+        std::unique_lock<mutex_type>& l, std::size_t pu_num, std::string const& pool_name)
+    {
+        if (!(mode_ & mode_allow_dynamic_pools)) { return false; }
+
+        detail::init_pool_data const& pool = get_pool_data(l, pool_name);
+        for (detail::init_pool_data const& data : initial_thread_pools_)
+        {
+            for (auto const& assigned_pu_num : data.assigned_pu_nums_)
+            {
+                if (std::get<0>(assigned_pu_num) != pu_num) { continue; }
+                if (std::get<1>(assigned_pu_num) || &data == &pool) { return false; }
+            }
+        }
+        return true;
+    }
+
+    bool partitioner::pu_pools_are_elastic(
+        std::unique_lock<mutex_type>& l, std::size_t pu_num, std::string const& pool_name)
+    {
+        using pika::threads::scheduler_mode;
+
+        auto const is_elastic = [](detail::init_pool_data const& data) {
+            return (data.mode_ & scheduler_mode::enable_elasticity) ==
+                scheduler_mode::enable_elasticity;
+        };
+
+        if (!is_elastic(get_pool_data(l, pool_name))) { return false; }
+        for (detail::init_pool_data const& data : initial_thread_pools_)
+        {
+            for (auto const& assigned_pu_num : data.assigned_pu_nums_)
+            {
+                if (std::get<0>(assigned_pu_num) == pu_num && !is_elastic(data)) { return false; }
+            }
+        }
+        return true;
+    }
+
     ////////////////////////////////////////////////////////////////////////
     std::size_t partitioner::get_pool_index(std::string const& pool_name) const
     {
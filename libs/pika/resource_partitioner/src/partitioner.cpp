@@ -224,6 +224,8 @@ namespace pika::resource {
             case scheduling_policy::abp_priority_fifo: return "abp_priority_fifo";
             case scheduling_policy::abp_priority_lifo: return "abp_priority_lifo";
             case scheduling_policy::shared_priority: return "shared_priority";
+            case scheduling_policy::work_stealing_priority: return "work_stealing_priority";
+            case scheduling_policy::edf: return "edf";
             default: return "unknown";
             }
         }
@@ -259,6 +259,8 @@ int main(int argc, char* argv[])
         pika::resource::scheduling_policy::abp_priority_fifo,
         pika::resource::scheduling_policy::abp_priority_lifo,
 #endif
+        pika::resource::scheduling_policy::work_stealing_priority,
+        pika::resource::scheduling_policy::edf,
         pika::resource::scheduling_policy::static_,
         pika::resource::scheduling_policy::static_priority,
         // The shared_priority scheduler sometimes hangs in this test.
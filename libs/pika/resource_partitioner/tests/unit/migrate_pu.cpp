@@ -0,0 +1,224 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Processing units added non-exclusively to several pools can be moved between
+// the pools at runtime if the pools support elasticity. Otherwise they are
+// oversubscribed.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/resource_partitioner.hpp>
+#include <pika/testing.hpp>
+#include <pika/threading_base/scheduler_mode.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <fmt/ostream.h>
+#include <fmt/printf.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+std::size_t const max_threads =
+    (std::min)(std::size_t(4), std::size_t(pika::threads::detail::hardware_concurrency()));
+
+std::size_t exclusive_pu = std::size_t(-1);
+std::size_t shared_pu = std::size_t(-1);
+
+// Return true if the worker thread of the pool on the shared processing unit
+// is running
+bool is_running(std::string const& pool_name)
+{
+    auto& pool = pika::resource::get_thread_pool(pool_name);
+    std::size_t const virt_core =
+        pika::resource::get_partitioner().get_shared_virt_core(pool_name, shared_pu);
+    PIKA_TEST_NEQ(virt_core, std::size_t(-1));
+    return pool.get_state(virt_core) == pika::runtime_state::running;
+}
+
+// Check that exactly the worker thread of the given pool is running on the
+// shared processing unit
+void check_running(std::string const& pool_name)
+{
+    PIKA_TEST_EQ(is_running("default"), pool_name == "default");
+    PIKA_TEST_EQ(is_running("io"), pool_name == "io");
+}
+
+// Check that the other worker threads of the pool steal from the worker thread
+// on the shared processing unit last while it is suspended
+void check_steal_order(std::string const& pool_name)
+{
+    auto& pool = pika::resource::get_thread_pool(pool_name);
+    std::size_t const virt_core =
+        pika::resource::get_partitioner().get_shared_virt_core(pool_name, shared_pu);
+    bool const running = is_running(pool_name);
+
+    auto const steal_orders = pool.get_steal_orders();
+    PIKA_TEST(steal_orders != nullptr);
+    PIKA_TEST_EQ(steal_orders->size(), pool.get_os_thread_count());
+
+    for (std::size_t thread_num = 0; thread_num != pool.get_os_thread_count(); ++thread_num)
+    {
+        if (thread_num == virt_core) { continue; }
+
+        auto const& steal_order = (*steal_orders)[thread_num];
+        PIKA_TEST_EQ(steal_order.threads.size() + 1, pool.get_os_thread_count());
+        if (!running)
+        {
+            PIKA_TEST_EQ(std::size_t(steal_order.threads.back()), virt_core);
+            PIKA_TEST_LT(steal_order.numa_local_count, steal_order.threads.size());
+        }
+    }
+}
+
+void run_tasks(std::string const& pool_name)
+{
+    constexpr std::size_t num_tasks = 100;
+
+    std::atomic<std::size_t> num_executed{0};
+    std::vector<ex::unique_any_sender<>> senders;
+    for (std::size_t i = 0; i < num_tasks; ++i)
+    {
+        senders.emplace_back(
+            ex::schedule(ex::thread_pool_scheduler{&pika::resource::get_thread_pool(pool_name)}) |
+            ex::then([&] { ++num_executed; }));
+    }
+    tt::sync_wait(ex::when_all_vector(std::move(senders)));
+
+    PIKA_TEST_EQ(num_executed.load(), num_tasks);
+}
+
+int pika_main()
+{
+    // Exclusive processing units can not be moved
+    bool caught_exception = false;
+    try
+    {
+        pika::resource::migrate_processing_unit(exclusive_pu, "default", "default");
+    }
+    catch (pika::exception const&)
+    {
+        caught_exception = true;
+    }
+    PIKA_TEST(caught_exception);
+
+    if (shared_pu != std::size_t(-1))
+    {
+        // Only the pool the shared processing unit was first added to
+        // initially runs a worker thread on it
+        check_running("default");
+        check_steal_order("default");
+        run_tasks("default");
+
+        pika::resource::migrate_processing_unit(shared_pu, "default", "io");
+        check_running("io");
+        check_steal_order("default");
+        run_tasks("default");
+        run_tasks("io");
+
+        // The io pool has no other processing units
+        pika::resource::migrate_processing_unit(shared_pu, "io", "default");
+        check_running("default");
+        check_steal_order("default");
+        run_tasks("default");
+
+        pika::resource::migrate_processing_unit(shared_pu, "default", "io");
+        check_running("io");
+        check_steal_order("default");
+        run_tasks("default");
+        run_tasks("io");
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+// Without elasticity the shared processing unit is oversubscribed, both pools
+// run a worker thread on it
+int pika_main_oversubscribed()
+{
+    if (shared_pu != std::size_t(-1))
+    {
+        PIKA_TEST(is_running("default"));
+        PIKA_TEST(is_running("io"));
+        run_tasks("default");
+        run_tasks("io");
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+void test_scheduler(
+    int argc, char* argv[], pika::resource::scheduling_policy scheduler, bool elastic)
+{
+    fmt::print(std::cerr, "Testing scheduler: {}, elastic: {}\n", scheduler, elastic);
+
+    using ::pika::threads::scheduler_mode;
+
+    pika::init_params init_args;
+
+    init_args.cfg = {"pika.os_threads=" + std::to_string(max_threads)};
+    init_args.rp_mode = elastic ? pika::resource::mode_allow_dynamic_pools :
+                                  pika::resource::partitioner_mode(
+                                      pika::resource::mode_allow_dynamic_pools |
+                                      pika::resource::mode_allow_oversubscription);
+    init_args.rp_callback = [scheduler, elastic](
+                                auto& rp, pika::program_options::variables_map const&) {
+        auto const mode = elastic ?
+            scheduler_mode::default_mode | scheduler_mode::enable_elasticity :
+            scheduler_mode::default_mode;
+        rp.create_thread_pool("default", scheduler, mode);
+
+        std::vector<pika::resource::pu const*> pus;
+        for (pika::resource::socket const& d : rp.sockets())
+        {
+            for (pika::resource::core const& c : d.cores())
+            {
+                for (pika::resource::pu const& p : c.pus()) { pus.push_back(&p); }
+            }
+        }
+
+        // The remaining processing units are added to the default pool, the
+        // first one exclusively
+        exclusive_pu = pus.front()->id();
+        if (pus.size() < 2) { return; }
+
+        shared_pu = pus.back()->id();
+        rp.create_thread_pool("io", scheduler, mode);
+        rp.add_resource(*pus.back(), "default", false);
+        rp.add_resource(*pus.back(), "io", false);
+    };
+
+    PIKA_TEST_EQ(pika::init(elastic ? pika_main : pika_main_oversubscribed, argc, argv, init_args),
+        0);
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<pika::resource::scheduling_policy> const schedulers = {
+        pika::resource::scheduling_policy::local,
+        pika::resource::scheduling_policy::local_priority_fifo,
+#if defined(PIKA_HAVE_CXX11_STD_ATOMIC_128BIT)
+        pika::resource::scheduling_policy::local_priority_lifo,
+#endif
+        pika::resource::scheduling_policy::work_stealing_priority,
+    };
+
+    for (auto const scheduler : schedulers)
+    {
+        test_scheduler(argc, argv, scheduler, true);
+        test_scheduler(argc, argv, scheduler, false);
+    }
+
+    return 0;
+}
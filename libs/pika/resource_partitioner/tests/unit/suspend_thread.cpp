@@ -14,12 +14,15 @@
 #include <pika/modules/schedulers.hpp>
 #include <pika/testing.hpp>
 #include <pika/thread.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/scheduler_mode.hpp>
 #include <pika/threading_base/thread_pool_base.hpp>
 
 #include <fmt/ostream.h>
 #include <fmt/printf.h>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdlib>
 #include <iostream>
@@ -62,6 +65,30 @@ int pika_main()
         }
     }
 
+    {
+        // Check that a pending timer does not prevent suspending processing units. The timer is
+        // cancelled before shutting down as it would otherwise keep the runtime alive.
+        auto& timers = tp.get_scheduler()->get_timer_wheel();
+        auto handle = timers.add(
+            pika::threads::detail::timer_wheel::clock_type::now() + std::chrono::hours(1), [] {});
+        PIKA_TEST(!timers.empty());
+
+        for (std::size_t thread_num = 0; thread_num < num_threads - 1; ++thread_num)
+        {
+            tp.suspend_processing_unit_direct(thread_num);
+            PIKA_TEST_EQ(
+                std::size_t(num_threads - thread_num - 1), tp.get_active_os_thread_count());
+        }
+
+        for (std::size_t thread_num = 0; thread_num < num_threads - 1; ++thread_num)
+        {
+            tp.resume_processing_unit_direct(thread_num);
+        }
+
+        PIKA_TEST(handle.cancel());
+        PIKA_TEST(timers.empty());
+    }
+
     {
         // Check suspending pu on which current thread is running.
 
@@ -72,6 +99,25 @@ int pika_main()
         tp.resume_processing_unit_direct(worker_thread_num);
     }
 
+    {
+        // Check suspending and resuming pus from inline tasks. The inline task
+        // running on one worker thread must not prevent other worker threads
+        // from suspending.
+        auto nostack_sched = ex::with_stacksize(sched, pika::execution::thread_stacksize::nostack);
+        for (std::size_t i = 0; i < num_threads; ++i)
+        {
+            tt::sync_wait(ex::schedule(nostack_sched) | ex::then([&] {
+                PIKA_TEST(pika::threads::detail::scheduler_base::is_running_inline_task());
+
+                std::size_t const thread_num =
+                    (pika::get_worker_thread_num() - tp.get_thread_offset() + 1) % num_threads;
+                tp.suspend_processing_unit_direct(thread_num);
+                PIKA_TEST_EQ(std::size_t(num_threads - 1), tp.get_active_os_thread_count());
+                tp.resume_processing_unit_direct(thread_num);
+            }));
+        }
+    }
+
     {
         // Check when suspending all but one, we end up on the same thread
         std::size_t thread_num = 0;
@@ -232,6 +278,8 @@ int main(int argc, char* argv[])
             pika::resource::scheduling_policy::abp_priority_fifo,
             pika::resource::scheduling_policy::abp_priority_lifo,
 #endif
+            pika::resource::scheduling_policy::work_stealing_priority,
+            pika::resource::scheduling_policy::edf,
             // This is disabled because it frequently fails with
             // std::system_error "Resource temporarily unavailable"
             // pika::resource::scheduling_policy::shared_priority,
@@ -52,4 +52,22 @@ namespace pika::resource {
 
     /// Return true if the pool with the given index exists
     PIKA_EXPORT bool pool_exists(std::size_t pool_index);
+
+    /// Move the processing unit with the given index from one thread pool to
+    /// another. The processing unit must have been added non-exclusively to
+    /// both pools, which requires the resource partitioner to be created with
+    /// \a mode_allow_dynamic_pools, and both pools must have
+    /// \a scheduler_mode::enable_elasticity set. Each of the pools has its
+    /// own worker thread on the processing unit. The worker thread of the
+    /// source pool is suspended once it has no more work, and then the worker
+    /// thread of the target pool is resumed. Blocks until the processing unit
+    /// has been moved. If the worker thread of the target pool can not be
+    /// resumed the worker thread of the source pool is resumed again before
+    /// the exception is rethrown.
+    ///
+    /// Only the pool a shared processing unit was first added to initially
+    /// runs its worker thread on it, the worker threads of the other pools
+    /// start suspended.
+    PIKA_EXPORT void migrate_processing_unit(
+        std::size_t pu_num, std::string const& from_pool_name, std::string const& to_pool_name);
 }    // namespace pika::resource
@@ -5,6 +5,7 @@
 //  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
 #include <pika/config.hpp>
+#include <pika/modules/errors.hpp>
 #include <pika/modules/resource_partitioner.hpp>
 #include <pika/modules/thread_manager.hpp>
 #include <pika/runtime/runtime.hpp>
@@ -64,4 +65,42 @@ namespace pika::resource {
     {
         return pika::detail::get_runtime().get_thread_manager().pool_exists(pool_index);
     }
+
+    void migrate_processing_unit(
+        std::size_t pu_num, std::string const& from_pool_name, std::string const& to_pool_name)
+    {
+        auto& rp = get_partitioner();
+        std::size_t const from_virt_core = rp.get_shared_virt_core(from_pool_name, pu_num);
+        std::size_t const to_virt_core = rp.get_shared_virt_core(to_pool_name, pu_num);
+
+        if (from_virt_core == std::size_t(-1) || to_virt_core == std::size_t(-1))
+        {
+            PIKA_THROW_EXCEPTION(pika::error::bad_parameter,
+                "pika::resource::migrate_processing_unit",
+                "processing unit {} has not been added non-exclusively to both pool '{}' and "
+                "pool '{}'",
+                pu_num, from_pool_name, to_pool_name);
+        }
+
+        // The worker thread of the source pool is suspended first so that the
+        // processing unit is never used by both pools at the same time. If the
+        // worker thread of the target pool can not be resumed the processing
+        // unit is given back to the source pool.
+        auto& from_pool = get_thread_pool(from_pool_name);
+        auto& to_pool = get_thread_pool(to_pool_name);
+        from_pool.suspend_processing_unit_direct(from_virt_core);
+        try
+        {
+            to_pool.resume_processing_unit_direct(to_virt_core);
+        }
+        catch (...)
+        {
+            from_pool.resume_processing_unit_direct(from_virt_core);
+            throw;
+        }
+
+        // Worker threads steal from the worker threads that are running first
+        from_pool.update_steal_orders();
+        to_pool.update_steal_orders();
+    }
 }    // namespace pika::resource
@@ -65,6 +65,7 @@ namespace pika::util {
 
 #if defined(__linux) || defined(linux) || defined(__linux__) || defined(__FreeBSD__)
         bool use_stack_guard_pages() const;
+        std::size_t get_stack_pool_max_cached_size() const;
 #endif
 
         // return trace_depth for stack-backtraces
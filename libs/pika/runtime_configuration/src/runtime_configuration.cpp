@@ -287,6 +287,7 @@ namespace pika::util {
                 PIKA_PP_EXPAND(PIKA_IDLE_BACKOFF_TIME_MAX)) "}",
 #endif
             "default_scheduler_mode = ${PIKA_DEFAULT_SCHEDULER_MODE}",
+            "scheduler_counters = ${PIKA_SCHEDULER_COUNTERS:0}",
 
             "install_signal_handlers = ${PIKA_INSTALL_SIGNAL_HANDLERS:0}",
             "diagnostics_on_terminate = ${PIKA_DIAGNOSTICS_ON_TERMINATE:1}",
@@ -307,6 +308,7 @@ namespace pika::util {
 #if defined(__linux) || defined(linux) || defined(__linux__) ||                \
     defined(__FreeBSD__)
             "use_guard_pages = ${PIKA_USE_GUARD_PAGES:0}",
+            "pool_max_cached_size = ${PIKA_STACK_POOL_MAX_CACHED_SIZE:0x4000000}",
 #endif
 
             "[pika.thread_queue]",
@@ -336,6 +338,34 @@ namespace pika::util {
             "init_threads_count = "
             "${PIKA_THREAD_QUEUE_INIT_THREADS_COUNT:" PIKA_PP_STRINGIZE(
                 PIKA_PP_EXPAND(PIKA_THREAD_QUEUE_INIT_THREADS_COUNT)) "}",
+            "max_run_next_count = "
+            "${PIKA_THREAD_QUEUE_MAX_RUN_NEXT_COUNT:" PIKA_PP_STRINGIZE(
+                PIKA_PP_EXPAND(PIKA_THREAD_QUEUE_MAX_RUN_NEXT_COUNT)) "}",
+            "run_next_steal_delay = "
+            "${PIKA_THREAD_QUEUE_RUN_NEXT_STEAL_DELAY:" PIKA_PP_STRINGIZE(
+                PIKA_PP_EXPAND(PIKA_THREAD_QUEUE_RUN_NEXT_STEAL_DELAY)) "}",
+
+            "[pika.elasticity]",
+            "enable = ${PIKA_ELASTICITY_ENABLE:0}",
+            "interval = ${PIKA_ELASTICITY_INTERVAL:100}",
+            "high_queue_length = ${PIKA_ELASTICITY_HIGH_QUEUE_LENGTH:4}",
+            "low_queue_length = ${PIKA_ELASTICITY_LOW_QUEUE_LENGTH:0}",
+            "hysteresis = ${PIKA_ELASTICITY_HYSTERESIS:3}",
+            "min_threads = ${PIKA_ELASTICITY_MIN_THREADS:1}",
+
+            "[pika.watchdog]",
+            "enable = ${PIKA_WATCHDOG_ENABLE:0}",
+            "interval = ${PIKA_WATCHDOG_INTERVAL:100}",
+            "budget = ${PIKA_WATCHDOG_BUDGET:1000}",
+
+            "[pika.metrics]",
+            "file = ${PIKA_METRICS_FILE:}",
+            "interval = ${PIKA_METRICS_INTERVAL:1000}",
+
+            "[pika.trace]",
+            "file = ${PIKA_TRACE_FILE:}",
+            "buffer_size = ${PIKA_TRACE_BUFFER_SIZE:65536}",
+            "flush_signal = ${PIKA_TRACE_FLUSH_SIGNAL:0}",
 
 #if defined(PIKA_HAVE_MPI)
             "[pika.mpi]",
@@ -601,6 +631,12 @@ namespace pika::util {
         }
         return true;    // default is true
     }
+
+    std::size_t runtime_configuration::get_stack_pool_max_cached_size() const
+    {
+        return static_cast<std::size_t>(
+            init_stack_size("pool_max_cached_size", "0x4000000", 0x4000000));
+    }
 #endif
 
     std::ptrdiff_t runtime_configuration::init_small_stack_size() const
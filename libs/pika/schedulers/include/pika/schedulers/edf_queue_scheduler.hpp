@@ -0,0 +1,361 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/modules/errors.hpp>
+#include <pika/schedulers/local_priority_queue_scheduler.hpp>
+#include <pika/schedulers/lockfree_queue_backends.hpp>
+#include <pika/thread_support/spinlock.hpp>
+#include <pika/threading_base/thread_data.hpp>
+#include <pika/threading_base/thread_init_data.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <pika/config/warnings_prefix.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace pika::threads::detail {
+    ////////////////////////////////////////////////////////////////////////////
+    // Earliest deadline first. Items are threads (or thread descriptions
+    // referring to threads) and are ordered by the deadline of the thread at
+    // the time it is pushed, and in FIFO order for equal deadlines. Threads
+    // without a deadline have the maximum deadline and run after all threads
+    // with a deadline. Both popping and stealing take the item with the
+    // earliest deadline.
+    template <typename T>
+    struct edf_backend
+    {
+        using value_type = T;
+        using reference = T&;
+        using const_reference = T const&;
+        using rvalue_reference = T&&;
+        using size_type = std::uint64_t;
+
+        using deadline_type = std::chrono::steady_clock::time_point;
+
+        edf_backend(size_type initial_size = 0, size_type /* num_thread */ = size_type(-1))
+        {
+            heap_.reserve(std::size_t(initial_size));
+        }
+
+        bool push(const_reference val, bool /* other_end */ = false)
+        {
+            deadline_type const deadline = get_deadline(val);
+
+            std::lock_guard<pika::detail::spinlock> l(mtx_);
+            push_locked(val, deadline);
+            update_earliest_deadline();
+            return true;
+        }
+
+        bool push(rvalue_reference val, bool other_end = false)
+        {
+            return push(const_reference(val), other_end);
+        }
+
+        // Push count items at once, copying them from the range starting at
+        // first
+        template <typename Iterator>
+        bool push_bulk(Iterator first, std::size_t count)
+        {
+            std::lock_guard<pika::detail::spinlock> l(mtx_);
+            for (std::size_t i = 0; i != count; ++i, ++first)
+            {
+                push_locked(*first, get_deadline(*first));
+            }
+            update_earliest_deadline();
+            return true;
+        }
+
+        bool pop(reference val, bool /* steal */ = true)
+        {
+            if (empty()) { return false; }
+
+            std::lock_guard<pika::detail::spinlock> l(mtx_);
+            if (heap_.empty()) { return false; }
+
+            std::pop_heap(heap_.begin(), heap_.end(), later{});
+            val = heap_.back().value;
+            heap_.pop_back();
+            update_earliest_deadline();
+            return true;
+        }
+
+        bool empty() { return size_.load(std::memory_order_relaxed) == 0; }
+
+        // Return the earliest deadline of the items in the queue, or the
+        // maximum time point if the queue is empty. The result is only a
+        // snapshot when called concurrently with other operations.
+        deadline_type earliest_deadline() const noexcept
+        {
+            return deadline_type(deadline_type::duration(
+                earliest_deadline_.load(std::memory_order_relaxed)));
+        }
+
+    private:
+        struct entry
+        {
+            deadline_type deadline;
+            std::uint64_t sequence;
+            T value;
+        };
+
+        // std::push_heap and std::pop_heap maintain a max-heap, order entries
+        // such that the entry with the earliest deadline is at the top
+        struct later
+        {
+            bool operator()(entry const& lhs, entry const& rhs) const noexcept
+            {
+                if (lhs.deadline != rhs.deadline) { return lhs.deadline > rhs.deadline; }
+                return lhs.sequence > rhs.sequence;
+            }
+        };
+
+        static deadline_type get_deadline(const_reference val) noexcept
+        {
+            if constexpr (std::is_convertible_v<T, thread_data_reference_counting const*>)
+            {
+                return static_cast<thread_data const*>(val)->get_deadline();
+            }
+            else
+            {
+                // thread descriptions used for maintaining queue wait times
+                return get_thread_id_data(val->data)->get_deadline();
+            }
+        }
+
+        void push_locked(const_reference val, deadline_type deadline)
+        {
+            heap_.push_back(entry{deadline, sequence_++, val});
+            std::push_heap(heap_.begin(), heap_.end(), later{});
+        }
+
+        void update_earliest_deadline() noexcept
+        {
+            size_.store(heap_.size(), std::memory_order_relaxed);
+            earliest_deadline_.store(heap_.empty() ?
+                    (deadline_type::max)().time_since_epoch().count() :
+                    heap_.front().deadline.time_since_epoch().count(),
+                std::memory_order_relaxed);
+        }
+
+        pika::detail::spinlock mtx_;
+        std::vector<entry> heap_;
+        std::uint64_t sequence_ = 0;
+
+        std::atomic<std::size_t> size_{0};
+        std::atomic<deadline_type::rep> earliest_deadline_{
+            (deadline_type::max)().time_since_epoch().count()};
+    };
+
+    struct edf
+    {
+        template <typename T>
+        struct apply
+        {
+            using type = edf_backend<T>;
+        };
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// The edf_queue_scheduler maintains one queue of work items (threads) per
+    /// OS thread, ordered by the deadline of the threads. Threads get their
+    /// deadline from the with_deadline property of the scheduler spawning
+    /// them, threads without a deadline run after all threads with a deadline.
+    /// Each OS thread runs the thread with the earliest deadline from its own
+    /// queue, and when its queue is empty, steals the thread with the earliest
+    /// deadline from all other queues. High and low priority threads are
+    /// handled as in the local_priority_queue_scheduler, with each of the
+    /// priority queues also ordered by deadline.
+    ///
+    /// New threads are put in the pending queues right away instead of being
+    /// staged first so that threads with an early deadline do not wait for
+    /// staged threads to be converted.
+    template <typename Mutex = std::mutex>
+    class PIKA_EXPORT edf_queue_scheduler
+      : public local_priority_queue_scheduler<Mutex, edf, lockfree_fifo, lockfree_fifo>
+    {
+    public:
+        using base_type = local_priority_queue_scheduler<Mutex, edf, lockfree_fifo, lockfree_fifo>;
+
+        using init_parameter_type = typename base_type::init_parameter_type;
+        using thread_queue_type = typename base_type::thread_queue_type;
+
+        edf_queue_scheduler(init_parameter_type const& init, bool deferred_initialization = true)
+          : base_type(disable_run_next(init), deferred_initialization)
+        {
+        }
+
+        static std::string get_scheduler_name() { return "edf_queue_scheduler"; }
+
+        void create_thread(threads::detail::thread_init_data& data,
+            threads::detail::thread_id_ref_type* id, error_code& ec) override
+        {
+            data.run_now = true;
+            base_type::create_thread(data, id, ec);
+        }
+
+        // Threads are not staged, so there is nothing to gain from the
+        // batched creation of staged threads
+        void create_threads(
+            threads::detail::thread_init_data* data, std::size_t count, error_code& ec) override
+        {
+            scheduler_base::create_threads(data, count, ec);
+        }
+
+        /// Return the next thread to be executed, return false if none is
+        /// available
+        bool get_next_thread(std::size_t num_thread, bool running,
+            threads::detail::thread_id_ref_type& thrd, bool enable_stealing) override
+        {
+            PIKA_ASSERT(num_thread < this->num_queues_);
+
+            thread_queue_type* this_high_priority_queue = nullptr;
+            if (num_thread < this->num_high_priority_queues_)
+            {
+                this_high_priority_queue = this->high_priority_queues_[num_thread].data_;
+                bool result = this_high_priority_queue->get_next_thread(thrd);
+
+                this_high_priority_queue->increment_num_pending_accesses();
+                if (result) return true;
+                this_high_priority_queue->increment_num_pending_misses();
+            }
+
+            thread_queue_type* this_queue = this->queues_[num_thread].data_;
+            {
+                bool result = this_queue->get_next_thread(thrd);
+
+                this_queue->increment_num_pending_accesses();
+                if (result) return true;
+                this_queue->increment_num_pending_misses();
+            }
+
+            if (!running) { return false; }
+
+#if !defined(PIKA_HAVE_THREAD_SANITIZER)
+            if (enable_stealing)
+            {
+                auto const& victims = this->victim_threads_[num_thread].data_;
+
+                if (this_high_priority_queue != nullptr &&
+                    steal_earliest(this->high_priority_queues_, victims,
+                        this->num_high_priority_queues_, this_high_priority_queue, running, thrd))
+                {
+                    this->add_stolen_threads(num_thread);
+                    return true;
+                }
+
+                if (steal_earliest(
+                        this->queues_, victims, this->num_queues_, this_queue, running, thrd))
+                {
+                    this->add_stolen_threads(num_thread);
+                    return true;
+                }
+            }
+
+            return this->low_priority_queue_.get_next_thread(thrd);
+#else
+            PIKA_UNUSED(enable_stealing);
+
+            if (num_thread == this->num_queues_ - 1)
+            {
+                return this->low_priority_queue_.get_next_thread(thrd);
+            }
+
+            return false;
+#endif
+        }
+
+    private:
+        static init_parameter_type disable_run_next(init_parameter_type const& init)
+        {
+            // Running woken threads before other threads would bypass the
+            // deadline order
+            thread_queue_init_parameters const& p = init.thread_queue_init_;
+            return init_parameter_type(init.num_queues_, init.affinity_data_,
+                init.num_high_priority_queues_,
+                thread_queue_init_parameters(p.max_thread_count_, p.min_tasks_to_steal_pending_,
+                    p.min_tasks_to_steal_staged_, p.min_add_new_count_, p.max_add_new_count_,
+                    p.min_delete_count_, p.max_delete_count_, p.max_terminated_threads_,
+                    p.init_threads_count_, p.max_idle_backoff_time_, p.small_stacksize_,
+                    p.medium_stacksize_, p.large_stacksize_, p.huge_stacksize_, 0,
+                    p.run_next_steal_delay_),
+                init.description_);
+        }
+
+        // Steal the thread with the earliest deadline from the queues of the
+        // victim worker threads. If another worker thread takes that thread
+        // first, the victims are tried in their usual order.
+        template <typename Queues>
+        static bool steal_earliest(Queues const& queues, std::vector<std::size_t> const& victims,
+            std::size_t num_queues, thread_queue_type* this_queue, bool running,
+            threads::detail::thread_id_ref_type& thrd)
+        {
+            auto const try_steal = [&](thread_queue_type* q) {
+                if (q->get_next_thread(thrd, running, true))
+                {
+                    q->increment_num_stolen_from_pending();
+                    this_queue->increment_num_stolen_to_pending();
+                    return true;
+                }
+                return false;
+            };
+
+            thread_queue_type* earliest_queue = nullptr;
+            auto earliest_deadline = (std::chrono::steady_clock::time_point::max)();
+            for (std::size_t idx : victims)
+            {
+                if (idx >= num_queues) { continue; }
+
+                thread_queue_type* q = queues[idx].data_;
+                if (q->get_pending_queue_length(std::memory_order_relaxed) == 0) { continue; }
+
+                auto const deadline = q->get_earliest_pending_deadline();
+                if (earliest_queue == nullptr || deadline < earliest_deadline)
+                {
+                    earliest_queue = q;
+                    earliest_deadline = deadline;
+                }
+            }
+
+            if (earliest_queue == nullptr) { return false; }
+            if (try_steal(earliest_queue)) { return true; }
+
+            for (std::size_t idx : victims)
+            {
+                if (idx < num_queues && try_steal(queues[idx].data_)) { return true; }
+            }
+
+            return false;
+        }
+    };
+}    // namespace pika::threads::detail
+
+template <typename Mutex>
+struct fmt::formatter<pika::threads::detail::edf_queue_scheduler<Mutex>>
+  : fmt::formatter<pika::threads::detail::scheduler_base>
+{
+    template <typename FormatContext>
+    auto format(pika::threads::detail::scheduler_base const& scheduler, FormatContext& ctx) const
+    {
+        return fmt::formatter<pika::threads::detail::scheduler_base>::format(scheduler, ctx);
+    }
+};
+
+#include <pika/config/warnings_suffix.hpp>
@@ -134,6 +134,13 @@ namespace pika::threads::detail {
 
         ~local_priority_queue_scheduler() override
         {
+            // Threads left in the run-next slots may belong to any of the
+            // queues, release them before deleting the queues
+            for (std::size_t i = 0; i != num_queues_; ++i)
+            {
+                if (queues_[i].data_ != nullptr) { queues_[i].data_->release_run_next_thread(); }
+            }
+
             for (std::size_t i = 0; i != num_queues_; ++i) { delete queues_[i].data_; }
 
             for (std::size_t i = 0; i != num_high_priority_queues_; ++i)
@@ -500,6 +507,108 @@ namespace pika::threads::detail {
                 data.get_description());
         }
 
+        // Create count staged threads at once. Normal priority threads are
+        // grouped by their target queue and enqueued with a single operation
+        // per queue, all other threads are created one by one.
+        void create_threads(threads::detail::thread_init_data* data, std::size_t count,
+            error_code& ec) override
+        {
+            // Suspended processing units have to be avoided for every single
+            // thread when elasticity is enabled
+            if (has_scheduler_mode(scheduler_mode::enable_elasticity))
+            {
+                scheduler_base::create_threads(data, count, ec);
+                return;
+            }
+
+            auto const is_batched = [](threads::detail::thread_init_data const& d) {
+                return !d.run_now && d.priority == execution::thread_priority::normal &&
+                    d.initial_state == threads::detail::thread_schedule_state::pending;
+            };
+
+            // Threads without a hint are distributed round-robin, starting
+            // from a single update of the shared counter
+            std::size_t next_queue = curr_queue_.fetch_add(count, std::memory_order_relaxed);
+
+            // Sort the batched threads by target queue (counting sort). A
+            // single buffer holds the offsets of the queues in its first
+            // num_queues_ + 1 elements, followed by the indices of the
+            // batched threads grouped by queue.
+            std::vector<std::size_t> buffer;
+            buffer.reserve(num_queues_ + 1 + count);
+            buffer.resize(num_queues_ + 1, 0);
+            std::size_t num_batched = 0;
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                threads::detail::thread_init_data& d = data[i];
+                if (!is_batched(d)) { continue; }
+
+                // NOTE: This scheduler ignores NUMA hints.
+                std::size_t num_thread =
+                    d.schedulehint.mode == execution::thread_schedule_hint_mode::thread ?
+                    d.schedulehint.hint :
+                    std::size_t(-1);
+
+                if (std::size_t(-1) == num_thread) { num_thread = next_queue++ % num_queues_; }
+                else if (num_thread >= num_queues_) { num_thread %= num_queues_; }
+
+                d.schedulehint.mode = execution::thread_schedule_hint_mode::thread;
+                d.schedulehint.hint = static_cast<std::int16_t>(num_thread);
+
+                if (d.stacksize == execution::thread_stacksize::current)
+                {
+                    d.stacksize = threads::detail::get_self_stacksize_enum();
+                }
+
+                ++buffer[num_thread + 1];
+                ++num_batched;
+            }
+
+            // buffer[i + 1] is the start of the range of queue i. Placing the
+            // indices moves it to the end of the range, i.e. buffer[i] is the
+            // start of the range of queue i afterwards.
+            std::size_t offset = 0;
+            for (std::size_t i = 0; i != num_queues_; ++i)
+            {
+                std::size_t const num_threads = buffer[i + 1];
+                buffer[i + 1] = offset;
+                offset += num_threads;
+            }
+
+            buffer.resize(num_queues_ + 1 + num_batched);
+            std::size_t* const indices = buffer.data() + num_queues_ + 1;
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                if (is_batched(data[i])) { indices[buffer[data[i].schedulehint.hint + 1]++] = i; }
+            }
+
+            for (std::size_t i = 0; i != num_queues_; ++i)
+            {
+                std::size_t const num_threads = buffer[i + 1] - buffer[i];
+                if (num_threads == 0) { continue; }
+
+                pika::threads::detail::increment_global_activity_count(num_threads);
+                queues_[i].data_->create_threads(data, indices + buffer[i], num_threads);
+
+                PIKA_LOG(debug,
+                    "local_priority_queue_scheduler::create_threads normal priority queue: "
+                    "pool({}), scheduler({}), worker_thread({}), count({})",
+                    *this->get_parent_pool(), *this, i, num_threads);
+            }
+
+            // Create the remaining threads one by one
+            if (num_batched != count)
+            {
+                for (std::size_t i = 0; i != count; ++i)
+                {
+                    if (is_batched(data[i])) { continue; }
+
+                    create_thread(data[i], nullptr, ec);
+                    if (ec) { return; }
+                }
+            }
+        }
+
         /// Return the next thread to be executed, return false if none is
         /// available
         bool get_next_thread(std::size_t num_thread, bool running,
@@ -549,6 +658,7 @@ namespace pika::threads::detail {
                         {
                             q->increment_num_stolen_from_pending();
                             this_high_priority_queue->increment_num_stolen_to_pending();
+                            this->add_stolen_threads(num_thread);
                             return true;
                         }
                     }
@@ -557,6 +667,7 @@ namespace pika::threads::detail {
                     {
                         queues_[idx].data_->increment_num_stolen_from_pending();
                         this_queue->increment_num_stolen_to_pending();
+                        this->add_stolen_threads(num_thread);
                         return true;
                     }
                 }
@@ -577,6 +688,38 @@ namespace pika::threads::detail {
             execution::thread_schedule_hint schedulehint, bool allow_fallback = false,
             execution::thread_priority priority = execution::thread_priority::normal) override
         {
+            // A thread woken up by a pika thread running on this scheduler is
+            // put in the run-next slot of the current worker thread if it has
+            // no hint or is hinted to the current worker thread anyway. It then
+            // runs while the data it shares with the waking thread is still in
+            // cache. Without stealing only the current worker thread could run
+            // the thread in the slot, which may be busy waiting for it, so the
+            // slot is not used.
+            if (priority == execution::thread_priority::normal &&
+                schedulehint.mode != execution::thread_schedule_hint_mode::numa &&
+                thread_queue_init_.max_run_next_count_ > 0 &&
+                has_scheduler_mode(scheduler_mode::enable_stealing))
+            {
+                auto* self = threads::detail::get_self_id_data();
+                std::size_t const local_num_thread = pika::get_local_worker_thread_num();
+                if (self != nullptr && self->get_scheduler_base() == this &&
+                    local_num_thread < num_queues_ &&
+                    (schedulehint.mode == execution::thread_schedule_hint_mode::none ||
+                        std::size_t(schedulehint.hint) == local_num_thread))
+                {
+                    PIKA_LOG(debug,
+                        "local_priority_queue_scheduler::schedule_thread, run-next slot: "
+                        "pool({}), scheduler({}), worker_thread({}), thread({}), "
+                        "description({})",
+                        *this->get_parent_pool(), *this, local_num_thread,
+                        get_thread_id_data(thrd)->get_thread_id(),
+                        get_thread_id_data(thrd)->get_description());
+
+                    queues_[local_num_thread].data_->schedule_thread_next(thrd);
+                    return;
+                }
+            }
+
             // NOTE: This scheduler ignores NUMA hints.
             std::size_t num_thread = std::size_t(-1);
             if (schedulehint.mode == execution::thread_schedule_hint_mode::thread)
@@ -998,6 +1141,7 @@ namespace pika::threads::detail {
                         {
                             q->increment_num_stolen_from_staged(added);
                             this_high_priority_queue->increment_num_stolen_to_staged(added);
+                            this->add_stolen_threads(num_thread, added);
                             return result;
                         }
                     }
@@ -1008,6 +1152,7 @@ namespace pika::threads::detail {
                     {
                         queues_[idx].data_->increment_num_stolen_from_staged(added);
                         this_queue->increment_num_stolen_to_staged(added);
+                        this->add_stolen_threads(num_thread, added);
                         return result;
                     }
                 }
@@ -337,6 +337,7 @@ namespace pika::threads::detail {
                         {
                             q->increment_num_stolen_from_pending();
                             queues_[num_thread]->increment_num_stolen_to_pending();
+                            this->add_stolen_threads(num_thread);
                             return true;
                         }
                     }
@@ -367,6 +368,7 @@ namespace pika::threads::detail {
                         {
                             q->increment_num_stolen_from_pending();
                             queues_[num_thread]->increment_num_stolen_to_pending();
+                            this->add_stolen_threads(num_thread);
                             return true;
                         }
                     }
@@ -387,6 +389,7 @@ namespace pika::threads::detail {
                     {
                         q->increment_num_stolen_from_pending();
                         queues_[num_thread]->increment_num_stolen_to_pending();
+                        this->add_stolen_threads(num_thread);
                         return true;
                     }
                 }
@@ -674,6 +677,7 @@ namespace pika::threads::detail {
                         {
                             queues_[idx]->increment_num_stolen_from_staged(added);
                             queues_[num_thread]->increment_num_stolen_to_staged(added);
+                            this->add_stolen_threads(num_thread, added);
                             return result;
                         }
                     }
@@ -705,6 +709,7 @@ namespace pika::threads::detail {
                         {
                             queues_[idx]->increment_num_stolen_from_staged(added);
                             queues_[num_thread]->increment_num_stolen_to_staged(added);
+                            this->add_stolen_threads(num_thread, added);
                             return result;
                         }
                     }
@@ -726,6 +731,7 @@ namespace pika::threads::detail {
                     {
                         queues_[idx]->increment_num_stolen_from_staged(added);
                         queues_[num_thread]->increment_num_stolen_to_staged(added);
+                        this->add_stolen_threads(num_thread, added);
                         return result;
                     }
                 }
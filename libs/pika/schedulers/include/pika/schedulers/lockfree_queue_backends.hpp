@@ -21,9 +21,12 @@
 
 // Does not rely on CXX11_STD_ATOMIC_128BIT
 #include <pika/concurrency/concurrentqueue.hpp>
+#include <pika/concurrency/detail/work_stealing_deque.hpp>
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <thread>
 #include <utility>
 
 namespace pika::threads::detail {
@@ -54,6 +57,14 @@ namespace pika::threads::detail {
             return queue_.enqueue(std::move(val));
         }
 
+        // Push count items at once, copying them from the range starting at
+        // first
+        template <typename Iterator>
+        bool push_bulk(Iterator first, std::size_t count)
+        {
+            return queue_.enqueue_bulk(first, count);
+        }
+
         bool pop(reference val, bool /* steal */ = true) { return queue_.try_dequeue(val); }
 
         bool empty() { return (queue_.size_approx() == 0); }
@@ -71,6 +82,148 @@ namespace pika::threads::detail {
         };
     };
 
+    ////////////////////////////////////////////////////////////////////////////
+    // LIFO for the owning worker thread + stealing at opposite end, based on a
+    // Chase-Lev deque.
+    //
+    // The owning thread is the first thread that pops without stealing. It
+    // pushes and pops at the bottom of the deque without read-modify-write
+    // operations. Items pushed by other threads, and items pushed to the other
+    // end, go through a separate FIFO which the owning thread takes items from
+    // when its deque is empty, or periodically to avoid starving them. Other
+    // threads steal from the top of the deque, then from the FIFO. Unlike the
+    // other LIFO backends this does not require 128-bit atomics.
+    template <typename T>
+    struct lockfree_work_stealing_backend
+    {
+        using container_type = pika::concurrency::detail::work_stealing_deque<T>;
+        using inbox_type = pika::concurrency::detail::ConcurrentQueue<T>;
+
+        using value_type = T;
+        using reference = T&;
+        using const_reference = T const&;
+        using rvalue_reference = T&&;
+        using size_type = std::uint64_t;
+
+        lockfree_work_stealing_backend(
+            size_type initial_size = 0, size_type /* num_thread */ = size_type(-1))
+          : queue_(std::size_t(initial_size))
+          , inbox_(std::size_t(initial_size))
+        {
+        }
+
+        bool push(const_reference val, bool other_end = false)
+        {
+            if (!other_end && is_owner())
+            {
+                queue_.push(val);
+                return true;
+            }
+
+            return push_inbox(val);
+        }
+
+        bool push(rvalue_reference val, bool other_end = false)
+        {
+            return push(const_reference(val), other_end);
+        }
+
+        template <typename Iterator>
+        bool push_bulk(Iterator first, std::size_t count)
+        {
+            if (is_owner())
+            {
+                for (std::size_t i = 0; i != count; ++i, ++first) { queue_.push(*first); }
+                return true;
+            }
+
+            inbox_count_.fetch_add(std::int64_t(count), std::memory_order_relaxed);
+            if (!inbox_.enqueue_bulk(first, count))
+            {
+                inbox_count_.fetch_sub(std::int64_t(count), std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        }
+
+        bool pop(reference val, bool steal = true)
+        {
+            if (!steal && claim_owner())
+            {
+                // Take from the inbox first now and then so that items
+                // pushed by other threads are not starved by items pushed
+                // by this thread
+                if (++owner_pops_ % inbox_poll_interval == 0 && pop_inbox(val)) { return true; }
+                return queue_.pop(val) || pop_inbox(val);
+            }
+
+            return queue_.steal(val) || pop_inbox(val);
+        }
+
+        bool empty()
+        {
+            return queue_.empty() && inbox_count_.load(std::memory_order_relaxed) <= 0;
+        }
+
+    private:
+        static constexpr std::uint32_t inbox_poll_interval = 64;
+
+        bool is_owner() const noexcept
+        {
+            return owner_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+        }
+
+        // Make the calling thread the owner if there is none yet. Returns
+        // true if the calling thread is the owner.
+        bool claim_owner() noexcept
+        {
+            std::thread::id owner = owner_.load(std::memory_order_relaxed);
+            if (owner == std::thread::id())
+            {
+                owner_.compare_exchange_strong(owner, std::this_thread::get_id());
+                return owner_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+            }
+            return owner == std::this_thread::get_id();
+        }
+
+        bool push_inbox(const_reference val)
+        {
+            inbox_count_.fetch_add(1, std::memory_order_relaxed);
+            if (!inbox_.enqueue(val))
+            {
+                inbox_count_.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        }
+
+        bool pop_inbox(reference val)
+        {
+            if (inbox_count_.load(std::memory_order_relaxed) <= 0 || !inbox_.try_dequeue(val))
+            {
+                return false;
+            }
+            inbox_count_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        container_type queue_;
+        inbox_type inbox_;
+        std::atomic<std::int64_t> inbox_count_{0};
+        std::atomic<std::thread::id> owner_{};
+        // Only accessed by the owning thread
+        std::uint32_t owner_pops_ = 0;
+    };
+
+    struct lockfree_work_stealing
+    {
+        template <typename T>
+        struct apply
+        {
+            using type = lockfree_work_stealing_backend<T>;
+        };
+    };
+
     // LIFO
 #if defined(PIKA_HAVE_CXX11_STD_ATOMIC_128BIT)
     template <typename T>
@@ -103,6 +256,16 @@ namespace pika::threads::detail {
             return queue_.push_left(std::move(val));
         }
 
+        template <typename Iterator>
+        bool push_bulk(Iterator first, std::size_t count)
+        {
+            for (std::size_t i = 0; i != count; ++i, ++first)
+            {
+                if (!push(*first)) return false;
+            }
+            return true;
+        }
+
         bool pop(reference val, bool /* steal */ = true) { return queue_.pop_left(val); }
 
         bool empty() { return queue_.empty(); }
@@ -146,6 +309,16 @@ namespace pika::threads::detail {
             return queue_.push_left(std::move(val));
         }
 
+        template <typename Iterator>
+        bool push_bulk(Iterator first, std::size_t count)
+        {
+            for (std::size_t i = 0; i != count; ++i, ++first)
+            {
+                if (!push(*first)) return false;
+            }
+            return true;
+        }
+
         bool pop(reference val, bool steal = true)
         {
             if (steal) return queue_.pop_left(val);
@@ -201,6 +374,16 @@ namespace pika::threads::detail {
             return queue_.push_left(val);
         }
 
+        template <typename Iterator>
+        bool push_bulk(Iterator first, std::size_t count)
+        {
+            for (std::size_t i = 0; i != count; ++i, ++first)
+            {
+                if (!push(*first)) return false;
+            }
+            return true;
+        }
+
         bool pop(reference val, bool steal = true)
         {
             if (steal) return queue_.pop_right(val);
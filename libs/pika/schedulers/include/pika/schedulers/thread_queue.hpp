@@ -32,6 +32,8 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
@@ -457,8 +459,21 @@ namespace pika::threads::detail {
 
         static void deallocate(threads::detail::thread_data* p) { p->destroy(); }
 
+        /// Release the reference held by a thread left in the run-next slot.
+        /// The thread is destroyed if this was the last reference.
+        void release_run_next_thread() noexcept
+        {
+            threads::detail::thread_id_ref_type thrd;
+            get_run_next_thread(thrd);
+        }
+
         ~thread_queue()
         {
+            // The thread is recycled by cleanup_terminated if it belonged to
+            // this queue
+            release_run_next_thread();
+            cleanup_terminated(true);
+
             for (auto t : thread_heap_small_) deallocate(threads::detail::get_thread_id_data(t));
 
             for (auto t : thread_heap_medium_) deallocate(threads::detail::get_thread_id_data(t));
@@ -482,6 +497,43 @@ namespace pika::threads::detail {
         }
 #endif
 
+    private:
+        using thread_repr = threads::detail::thread_id_ref_type::thread_repr;
+
+        static std::int64_t get_run_next_time() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        bool get_run_next_thread(threads::detail::thread_id_ref_type& thrd) noexcept
+        {
+            thread_repr* next = next_thread_.exchange(nullptr, std::memory_order_acq_rel);
+            if (next == nullptr) { return false; }
+
+            thrd.reset(next, false);    // do not addref!
+            --work_items_count_.data_;
+            return true;
+        }
+
+        void push_work_item(threads::detail::thread_id_ref_type thrd, bool other_end)
+        {
+#ifdef PIKA_HAVE_THREAD_QUEUE_WAITTIME
+            using namespace std::chrono;
+            work_items_.push(new thread_description{std::move(thrd),
+                                 duration<std::uint64_t, std::nano>(
+                                     high_resolution_clock::now().time_since_epoch())
+                                     .count()},
+                other_end);
+#else
+            // detach the thread from the id_ref without decrementing
+            // the reference count
+            work_items_.push(thrd.detach(), other_end);
+#endif
+        }
+
+    public:
         ///////////////////////////////////////////////////////////////////////
         // This returns the current length of the queues (work items and new items)
         std::int64_t get_queue_length(std::memory_order order = std::memory_order_acquire) const
@@ -489,6 +541,14 @@ namespace pika::threads::detail {
             return work_items_count_.data_.load(order) + new_tasks_count_.data_.load(order);
         }
 
+        // This returns the earliest deadline of the threads in the pending
+        // queue. Only available with queue backends ordering threads by
+        // deadline.
+        auto get_earliest_pending_deadline() const noexcept
+        {
+            return work_items_.earliest_deadline();
+        }
+
         // This returns the current length of the pending queue
         std::int64_t get_pending_queue_length(
             std::memory_order order = std::memory_order_acquire) const
@@ -685,6 +745,48 @@ namespace pika::threads::detail {
             if (&ec != &throws) ec = make_success_code();
         }
 
+        // Register task descriptions for the later creation of the count
+        // threads data[indices[0]], ..., data[indices[count - 1]] at once. The
+        // task descriptions are pushed to the staged queue in batches, the
+        // threads must be pending and not run immediately.
+        void create_threads(threads::detail::thread_init_data* data, std::size_t const* indices,
+            std::size_t count)
+        {
+            constexpr std::size_t batch_size = 64;
+            std::array<task_description*, batch_size> batch;
+
+            new_tasks_count_.data_ += count;
+
+            while (count != 0)
+            {
+                std::size_t const num_tasks = (std::min)(count, batch_size);
+                for (std::size_t i = 0; i != num_tasks; ++i)
+                {
+                    threads::detail::thread_init_data& d = data[indices[i]];
+                    PIKA_ASSERT(!d.run_now);
+                    PIKA_ASSERT(d.initial_state == threads::detail::thread_schedule_state::pending);
+                    PIKA_ASSERT(d.stacksize != execution::thread_stacksize::current);
+
+                    task_description* td = task_description_alloc_.allocate(1);
+#ifdef PIKA_HAVE_THREAD_QUEUE_WAITTIME
+                    using namespace std::chrono;
+                    new (td) task_description{std::move(d),
+                        duration<std::uint64_t, std::nano>(
+                            high_resolution_clock::now().time_since_epoch())
+                            .count()};
+#else
+                    new (td) task_description{std::move(d)};    //-V106
+#endif
+                    batch[i] = td;
+                }
+
+                new_tasks_.push_bulk(batch.begin(), num_tasks);
+
+                indices += num_tasks;
+                count -= num_tasks;
+            }
+        }
+
         void move_work_items_from(thread_queue* src, std::int64_t count)
         {
             thread_description_ptr trd;
@@ -751,6 +853,22 @@ namespace pika::threads::detail {
                 return false;
             }
 
+            // The owning worker thread prefers the thread in the run-next
+            // slot, but only up to max_run_next_count_ times in a row to avoid
+            // starving the threads in the regular queue.
+            if (!steal && next_thread_.load(std::memory_order_relaxed) != nullptr)
+            {
+                if (run_next_count_ < parameters_.max_run_next_count_)
+                {
+                    if (get_run_next_thread(thrd))
+                    {
+                        ++run_next_count_;
+                        return true;
+                    }
+                }
+                else { run_next_count_ = 0; }
+            }
+
 #ifdef PIKA_HAVE_THREAD_QUEUE_WAITTIME
             thread_description_ptr tdesc;
             if (0 != work_items_count && work_items_.pop(tdesc, steal))
@@ -768,6 +886,7 @@ namespace pika::threads::detail {
                 thrd = std::move(tdesc->data);
                 delete tdesc;
 
+                if (!steal && run_next_count_ != 0) { run_next_count_ = 0; }
                 return true;
             }
 #else
@@ -776,28 +895,51 @@ namespace pika::threads::detail {
             {
                 thrd.reset(next_thrd, false);    // do not addref!
                 --work_items_count_.data_;
+
+                if (!steal && run_next_count_ != 0) { run_next_count_ = 0; }
                 return true;
             }
 #endif
-            return false;
+
+            // Other worker threads may only take the thread in the run-next
+            // slot once it has waited for at least run_next_steal_delay_
+            // microseconds, giving the owning worker thread a chance to run it
+            // while its data is still in cache.
+            if (steal)
+            {
+                if (next_thread_.load(std::memory_order_relaxed) == nullptr) { return false; }
+
+                std::int64_t const waited = get_run_next_time() -
+                    next_thread_time_.load(std::memory_order_relaxed);
+                if (waited < parameters_.run_next_steal_delay_ * 1000) { return false; }
+            }
+
+            return get_run_next_thread(thrd);
         }
 
         /// Schedule the passed thread
         void schedule_thread(threads::detail::thread_id_ref_type thrd, bool other_end = false)
         {
             ++work_items_count_.data_;
-#ifdef PIKA_HAVE_THREAD_QUEUE_WAITTIME
-            using namespace std::chrono;
-            work_items_.push(new thread_description{std::move(thrd),
-                                 duration<std::uint64_t, std::nano>(
-                                     high_resolution_clock::now().time_since_epoch())
-                                     .count()},
-                other_end);
-#else
-            // detach the thread from the id_ref without decrementing
-            // the reference count
-            work_items_.push(thrd.detach(), other_end);
-#endif
+            push_work_item(std::move(thrd), other_end);
+        }
+
+        /// Schedule the passed thread in the run-next slot of this queue. A
+        /// thread already in the slot is moved to the regular queue. May only
+        /// be called from the worker thread owning this queue.
+        void schedule_thread_next(threads::detail::thread_id_ref_type thrd)
+        {
+            ++work_items_count_.data_;
+            next_thread_time_.store(get_run_next_time(), std::memory_order_relaxed);
+
+            thread_repr* evicted = next_thread_.exchange(thrd.detach(), std::memory_order_acq_rel);
+            if (evicted != nullptr)
+            {
+                // the evicted thread keeps the reference the slot was holding
+                push_work_item(threads::detail::thread_id_ref_type(
+                                   evicted, threads::detail::thread_id_addref::no),
+                    false);
+            }
         }
 
         /// Destroy the passed thread as it has been terminated
@@ -1167,6 +1309,14 @@ namespace pika::threads::detail {
 
         // count of active work items
         pika::concurrency::detail::cache_line_data<std::atomic<std::int64_t>> work_items_count_;
+
+        // single thread to run next on the owning worker thread, and the time
+        // in nanoseconds at which it was put there
+        std::atomic<thread_repr*> next_thread_{nullptr};
+        std::atomic<std::int64_t> next_thread_time_{0};
+        // number of consecutive threads taken from the run-next slot, only
+        // accessed by the owning worker thread
+        std::int64_t run_next_count_ = 0;
     };
 
     ///////////////////////////////////////////////////////////////////////////
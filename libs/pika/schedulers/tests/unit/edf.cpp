@@ -0,0 +1,81 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The earliest-deadline-first scheduler runs threads in the order of their
+// deadlines, and threads without a deadline after all threads with a deadline.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/mutex.hpp>
+#include <pika/testing.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+void test_deadline_order()
+{
+    constexpr std::size_t num_tasks = 20;
+    constexpr std::size_t num_tasks_without_deadline = 5;
+
+    pika::mutex mtx;
+    std::vector<std::size_t> order;
+    auto record = [&](std::size_t i) {
+        std::lock_guard<pika::mutex> l(mtx);
+        order.push_back(i);
+    };
+
+    // The tasks are only started once this thread suspends in sync_wait
+    // below, since this is the only worker thread
+    auto const now = std::chrono::steady_clock::now();
+    std::vector<ex::unique_any_sender<>> senders;
+    for (std::size_t i = 0; i < num_tasks_without_deadline; ++i)
+    {
+        senders.emplace_back(ex::schedule(ex::thread_pool_scheduler{}) |
+            ex::then([&, i] { record(num_tasks + i); }));
+    }
+
+    // Spawn tasks in the opposite order of their deadlines, task i has the
+    // i-th earliest deadline
+    for (std::size_t i = num_tasks; i > 0; --i)
+    {
+        auto sched = ex::with_deadline(
+            ex::thread_pool_scheduler{}, now + std::chrono::milliseconds(i - 1));
+        senders.emplace_back(ex::schedule(sched) | ex::then([&, i] { record(i - 1); }));
+    }
+
+    std::vector<ex::unique_any_sender<>> started;
+    for (auto& s : senders) { started.emplace_back(ex::ensure_started(std::move(s))); }
+    for (auto& s : started) { tt::sync_wait(std::move(s)); }
+
+    PIKA_TEST_EQ(order.size(), num_tasks + num_tasks_without_deadline);
+    for (std::size_t i = 0; i < order.size(); ++i) { PIKA_TEST_EQ(order[i], i); }
+}
+
+int pika_main()
+{
+    test_deadline_order();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    pika::init_params init_args;
+    init_args.cfg = {"pika.os_threads=1", "pika.scheduler=edf"};
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Threads woken up by other pika threads are put in the run-next slot of the
+// waking worker thread. This tests that ping-ponging threads still complete
+// with the run-next slot enabled and disabled, and that a pair of threads
+// continuously waking each other through the run-next slot does not starve
+// other threads.
+
+#include <pika/condition_variable.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/mutex.hpp>
+#include <pika/testing.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+bool run_next_enabled = false;
+
+struct ping_pong
+{
+    pika::mutex mtx;
+    pika::condition_variable cv;
+    std::size_t turn = 0;
+    std::size_t count = 0;
+
+    // Alternate with the other player until done returns true or
+    // num_iterations turns have been played
+    template <typename F>
+    void play(std::size_t player, std::size_t num_iterations, F&& done)
+    {
+        std::unique_lock<pika::mutex> l(mtx);
+        while (count < num_iterations && !done())
+        {
+            cv.wait(l, [&] { return turn == player || count >= num_iterations || done(); });
+            if (count >= num_iterations || done()) { break; }
+
+            ++count;
+            turn = 1 - player;
+            cv.notify_all();
+        }
+
+        // Make sure the other player also sees that the game is over
+        count = num_iterations;
+        cv.notify_all();
+    }
+};
+
+void test_ping_pong()
+{
+    // Without stealing every turn has to wait for the worker thread of the
+    // woken player, which is slow when worker threads share cores
+    constexpr std::size_t num_iterations = 1000;
+    ping_pong p;
+
+    auto player = [&](std::size_t i) {
+        return ex::schedule(ex::thread_pool_scheduler{}) |
+            ex::then([&p, i] { p.play(i, num_iterations, [] { return false; }); });
+    };
+    tt::sync_wait(ex::when_all(player(0), player(1)));
+
+    PIKA_TEST_EQ(p.count, num_iterations);
+}
+
+void test_no_starvation()
+{
+    // The players stop only once the third thread has run. With a single
+    // worker thread this requires the worker thread to eventually take a
+    // thread from its regular queue instead of the run-next slot.
+    std::atomic<bool> other_ran{false};
+    ping_pong p;
+
+    auto player = [&](std::size_t i) {
+        return ex::schedule(ex::thread_pool_scheduler{}) | ex::then([&p, &other_ran, i] {
+            p.play(i, std::size_t(-1), [&] { return other_ran.load(); });
+        });
+    };
+    auto other = ex::schedule(ex::thread_pool_scheduler{}) |
+        ex::then([&other_ran] { other_ran = true; });
+    tt::sync_wait(ex::when_all(player(0), player(1), std::move(other)));
+
+    PIKA_TEST(other_ran);
+}
+
+int pika_main()
+{
+    test_ping_pong();
+
+    // Without the run-next slot the order of the regular queue decides
+    // whether the other thread runs, and LIFO queues may starve it
+    if (run_next_enabled) { test_no_starvation(); }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> const schedulers = {
+        "local-priority-fifo", "local-priority-lifo", "work-stealing-priority", "static-priority"};
+
+    for (auto const& scheduler : schedulers)
+    {
+        for (std::string const max_run_next_count : {"0", "1", "8"})
+        {
+            // The run-next slot is not used by schedulers without stealing
+            run_next_enabled = max_run_next_count != "0" && scheduler != "static-priority";
+
+            // The number of worker threads is given on the command line
+            pika::init_params init_args;
+            init_args.cfg = {"pika.scheduler=" + scheduler,
+                "pika.thread_queue.max_run_next_count=" + max_run_next_count};
+
+            PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+        }
+    }
+
+    return 0;
+}
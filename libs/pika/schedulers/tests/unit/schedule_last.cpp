@@ -99,5 +99,12 @@ int main(int argc, char* argv[])
     }
 #endif
 
+    {
+        using scheduler_type = pika::threads::detail::local_priority_queue_scheduler<std::mutex,
+            pika::threads::detail::lockfree_work_stealing,
+            pika::threads::detail::lockfree_work_stealing>;
+        test_scheduler<scheduler_type>(argc, argv);
+    }
+
     return 0;
 }
@@ -0,0 +1,705 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/concurrency/cache_line_data.hpp>
+#include <pika/concurrency/spinlock.hpp>
+#include <pika/errors/throw_exception.hpp>
+#include <pika/execution_base/this_thread.hpp>
+#include <pika/execution_base/operation_state.hpp>
+#include <pika/execution_base/receiver.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/synchronization/counting_semaphore.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace pika::execution::experimental::detail {
+    // An operation waiting for space in an async_channel. The value is moved into the channel
+    // when space becomes available, or left in the waiter if the channel is closed first.
+    template <typename T>
+    struct async_channel_send_waiter
+    {
+        using complete_function_type = void (*)(async_channel_send_waiter*) noexcept;
+
+        complete_function_type const complete_function;
+        async_channel_send_waiter* next = nullptr;
+        T value;
+        bool sent = false;
+    };
+
+    // An operation waiting for a value in an async_channel. The value is empty if the channel is
+    // closed before a value becomes available.
+    template <typename T>
+    struct async_channel_receive_waiter
+    {
+        using complete_function_type = void (*)(async_channel_receive_waiter*) noexcept;
+
+        complete_function_type const complete_function;
+        async_channel_receive_waiter* next = nullptr;
+        std::optional<T> value = std::nullopt;
+    };
+
+    // Waiters are stored in the operation states of the senders and queued in the order in which
+    // the operations are started, so waiting does not allocate.
+    template <typename Waiter>
+    struct async_channel_waiter_queue
+    {
+        Waiter* head = nullptr;
+        Waiter* tail = nullptr;
+
+        bool empty() const noexcept { return head == nullptr; }
+
+        void push_back(Waiter* waiter) noexcept
+        {
+            waiter->next = nullptr;
+            if (tail != nullptr) { tail->next = waiter; }
+            else { head = waiter; }
+            tail = waiter;
+        }
+
+        Waiter* pop_front() noexcept
+        {
+            Waiter* waiter = head;
+            head = waiter->next;
+            if (head == nullptr) { tail = nullptr; }
+            waiter->next = nullptr;
+            return waiter;
+        }
+
+        void append(async_channel_waiter_queue& other) noexcept
+        {
+            if (other.empty()) { return; }
+            if (tail != nullptr) { tail->next = other.head; }
+            else { head = other.head; }
+            tail = other.tail;
+            other.head = other.tail = nullptr;
+        }
+
+        void complete_all() noexcept
+        {
+            Waiter* waiter = std::exchange(head, nullptr);
+            tail = nullptr;
+            while (waiter != nullptr)
+            {
+                // The operation state holding the waiter may be destroyed by the completion
+                Waiter* next = waiter->next;
+                waiter->complete_function(waiter);
+                waiter = next;
+            }
+        }
+    };
+
+    // The implementation of async_channel. Values are stored in a bounded ring buffer where each
+    // slot carries a sequence number telling producers and consumers whether the slot is free or
+    // filled for their position, so that sending and receiving do not take a lock unless an
+    // operation has to wait. The slot for position pos has the sequence number 2 * pos when it is
+    // free and 2 * pos + 1 when it is filled. Doubling the positions keeps the two states apart
+    // even when the capacity is one. The ring buffer positions and the slots are padded to
+    // separate cache lines to avoid false sharing between producers and consumers.
+    //
+    // Operations which have to wait are queued under a lock. After a value has been pushed
+    // (popped), the queue of waiting receivers (senders) is checked. Both sides publish their
+    // change before checking the other side, with sequentially consistent fences in between, so
+    // that either the waiter sees the new value or free slot, or the other side sees the waiter.
+    //
+    // Sends which do not take the lock are counted while they push. Closing the channel waits for
+    // them before the waiting receivers are completed, so that a value pushed by a send which
+    // started before the channel was closed is not missed by a receiver seeing the channel closed
+    // and empty.
+    template <typename T>
+    class async_channel_state
+    {
+    public:
+        using send_waiter_type = async_channel_send_waiter<T>;
+        using receive_waiter_type = async_channel_receive_waiter<T>;
+
+        explicit async_channel_state(std::size_t capacity)
+          : capacity_(capacity)
+          , slots_(new padded_slot_type[capacity])
+        {
+            if (capacity == 0)
+            {
+                PIKA_THROW_EXCEPTION(pika::error::bad_parameter,
+                    "async_channel_state::async_channel_state",
+                    "the capacity of an async_channel must be greater than zero");
+            }
+
+            for (std::size_t i = 0; i < capacity_; ++i)
+            {
+                slots_[i].data_.sequence.store(2 * i, std::memory_order_relaxed);
+            }
+        }
+
+        async_channel_state(async_channel_state&&) = delete;
+        async_channel_state& operator=(async_channel_state&&) = delete;
+        async_channel_state(async_channel_state const&) = delete;
+        async_channel_state& operator=(async_channel_state const&) = delete;
+
+        ~async_channel_state()
+        {
+            PIKA_ASSERT_MSG(senders_.empty() && receivers_.empty(),
+                "async_channel_state::~async_channel_state: the channel is destroyed while "
+                "operations are waiting for it");
+
+            std::optional<T> value;
+            while (try_pop(value)) { value.reset(); }
+        }
+
+        std::size_t capacity() const noexcept { return capacity_; }
+
+        bool is_closed() const noexcept { return closed_.load(std::memory_order_acquire); }
+
+        // The value is only moved from if it was sent
+        bool try_send(T& value) noexcept
+        {
+            // Either close sees this send in flight and waits for it, or this send sees the
+            // channel closed
+            num_pushing_.fetch_add(1, std::memory_order_seq_cst);
+            bool const pushed = !closed_.load(std::memory_order_seq_cst) && try_push(value);
+            num_pushing_.fetch_sub(1, std::memory_order_release);
+
+            if (!pushed) { return false; }
+            notify_receivers();
+            return true;
+        }
+
+        bool try_receive(std::optional<T>& value) noexcept
+        {
+            if (!try_pop(value)) { return false; }
+            notify_senders();
+            return true;
+        }
+
+        // Send the value of the waiter and return true, or queue the waiter and return false.
+        // waiter->sent is false if the channel has been closed. A queued waiter is completed once
+        // its value has been sent or the channel has been closed.
+        bool send_or_enqueue(send_waiter_type* waiter) noexcept
+        {
+            if (try_send(waiter->value))
+            {
+                waiter->sent = true;
+                return true;
+            }
+
+            std::unique_lock<mutex_type> l(mtx_);
+
+            if (closed_.load(std::memory_order_relaxed))
+            {
+                waiter->sent = false;
+                return true;
+            }
+
+            num_waiting_senders_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (try_push(waiter->value))
+            {
+                num_waiting_senders_.fetch_sub(1, std::memory_order_relaxed);
+                l.unlock();
+
+                waiter->sent = true;
+                notify_receivers();
+                return true;
+            }
+
+            senders_.push_back(waiter);
+            return false;
+        }
+
+        // Receive a value into the waiter and return true, or queue the waiter and return false.
+        // waiter->value is empty if the channel has been closed and no values are left. A queued
+        // waiter is completed once it has received a value or the channel has been closed.
+        bool receive_or_enqueue(receive_waiter_type* waiter) noexcept
+        {
+            if (try_receive(waiter->value)) { return true; }
+
+            std::unique_lock<mutex_type> l(mtx_);
+
+            num_waiting_receivers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // Values sent before the channel was closed are still received
+            if (try_pop(waiter->value))
+            {
+                num_waiting_receivers_.fetch_sub(1, std::memory_order_relaxed);
+                l.unlock();
+
+                notify_senders();
+                return true;
+            }
+
+            // Sends in flight when the channel was closed may still push a value until close has
+            // waited for them. Until then the waiter is queued and completed by close.
+            if (drained_)
+            {
+                num_waiting_receivers_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            receivers_.push_back(waiter);
+            return false;
+        }
+
+        void close() noexcept
+        {
+            {
+                std::lock_guard<mutex_type> l(mtx_);
+                closed_.store(true, std::memory_order_seq_cst);
+            }
+
+            // Wait for the sends which did not see the channel closed. Their values are still
+            // received.
+            pika::util::yield_while(
+                [this] { return num_pushing_.load(std::memory_order_acquire) != 0; },
+                "async_channel::close");
+
+            async_channel_waiter_queue<send_waiter_type> completed_senders;
+            async_channel_waiter_queue<receive_waiter_type> completed_receivers;
+            {
+                std::lock_guard<mutex_type> l(mtx_);
+
+                drained_ = true;
+                match_waiters(completed_senders, completed_receivers);
+
+                // Whatever is still waiting is completed without a value
+                completed_senders.append(senders_);
+                completed_receivers.append(receivers_);
+                num_waiting_senders_.store(0, std::memory_order_relaxed);
+                num_waiting_receivers_.store(0, std::memory_order_relaxed);
+            }
+
+            completed_senders.complete_all();
+            completed_receivers.complete_all();
+        }
+
+    private:
+        struct slot
+        {
+            std::atomic<std::size_t> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T* get() noexcept { return std::launder(reinterpret_cast<T*>(&storage)); }
+        };
+
+        using padded_slot_type = pika::concurrency::detail::cache_aligned_data<slot>;
+        using padded_position_type =
+            pika::concurrency::detail::cache_aligned_data<std::atomic<std::size_t>>;
+        using mutex_type = pika::concurrency::detail::spinlock;
+
+        bool try_push(T& value) noexcept
+        {
+            std::size_t pos = enqueue_position_.data_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                slot& s = slots_[pos % capacity_].data_;
+                auto const diff = static_cast<std::intptr_t>(
+                                      s.sequence.load(std::memory_order_acquire)) -
+                    static_cast<std::intptr_t>(2 * pos);
+
+                if (diff == 0)
+                {
+                    if (enqueue_position_.data_.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        new (&s.storage) T(std::move(value));
+                        s.sequence.store(2 * pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                // The slot still holds the value from the previous round
+                else if (diff < 0) { return false; }
+                else { pos = enqueue_position_.data_.load(std::memory_order_relaxed); }
+            }
+        }
+
+        bool try_pop(std::optional<T>& value) noexcept
+        {
+            std::size_t pos = dequeue_position_.data_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                slot& s = slots_[pos % capacity_].data_;
+                auto const diff = static_cast<std::intptr_t>(
+                                      s.sequence.load(std::memory_order_acquire)) -
+                    static_cast<std::intptr_t>(2 * pos + 1);
+
+                if (diff == 0)
+                {
+                    if (dequeue_position_.data_.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        T* p = s.get();
+                        value.emplace(std::move(*p));
+                        p->~T();
+                        s.sequence.store(2 * (pos + capacity_), std::memory_order_release);
+                        return true;
+                    }
+                }
+                // The slot has not been filled for this round
+                else if (diff < 0) { return false; }
+                else { pos = dequeue_position_.data_.load(std::memory_order_relaxed); }
+            }
+        }
+
+        void notify_receivers() noexcept
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (num_waiting_receivers_.load(std::memory_order_relaxed) != 0) { process_waiters(); }
+        }
+
+        void notify_senders() noexcept
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (num_waiting_senders_.load(std::memory_order_relaxed) != 0) { process_waiters(); }
+        }
+
+        void process_waiters() noexcept
+        {
+            // Waiters are completed after releasing the lock, since completing an operation may
+            // send or receive again
+            async_channel_waiter_queue<send_waiter_type> completed_senders;
+            async_channel_waiter_queue<receive_waiter_type> completed_receivers;
+            {
+                std::lock_guard<mutex_type> l(mtx_);
+                match_waiters(completed_senders, completed_receivers);
+            }
+
+            completed_senders.complete_all();
+            completed_receivers.complete_all();
+        }
+
+        // Move values from waiting senders into the ring buffer and values from the ring buffer
+        // into waiting receivers for as long as either is possible. A push or pop may fail
+        // because another operation is in the middle of using the slot. That operation checks
+        // the waiters again once it is done.
+        void match_waiters(async_channel_waiter_queue<send_waiter_type>& completed_senders,
+            async_channel_waiter_queue<receive_waiter_type>& completed_receivers) noexcept
+        {
+            bool progress = true;
+            while (progress)
+            {
+                progress = false;
+
+                while (!receivers_.empty() && try_pop(receivers_.head->value))
+                {
+                    completed_receivers.push_back(receivers_.pop_front());
+                    num_waiting_receivers_.fetch_sub(1, std::memory_order_relaxed);
+                    progress = true;
+                }
+
+                while (!senders_.empty() && try_push(senders_.head->value))
+                {
+                    send_waiter_type* waiter = senders_.pop_front();
+                    waiter->sent = true;
+                    completed_senders.push_back(waiter);
+                    num_waiting_senders_.fetch_sub(1, std::memory_order_relaxed);
+                    progress = true;
+                }
+            }
+        }
+
+        std::size_t const capacity_;
+        std::unique_ptr<padded_slot_type[]> slots_;
+        padded_position_type enqueue_position_;
+        padded_position_type dequeue_position_;
+
+        // Read on every send and receive, written only when operations start or stop waiting
+        std::atomic<std::size_t> num_waiting_senders_{0};
+        std::atomic<std::size_t> num_waiting_receivers_{0};
+        std::atomic<bool> closed_{false};
+        // The number of sends pushing a value without holding the lock
+        std::atomic<std::size_t> num_pushing_{0};
+
+        mutex_type mtx_;
+        // Set once the channel is closed and no more values can be pushed, protected by mtx_
+        bool drained_ = false;
+        async_channel_waiter_queue<send_waiter_type> senders_;
+        async_channel_waiter_queue<receive_waiter_type> receivers_;
+    };
+
+    template <typename T>
+    struct async_channel_send_sender
+    {
+        PIKA_STDEXEC_SENDER_CONCEPT
+
+        async_channel_state<T>* state;
+        T value;
+
+        template <template <typename...> class Tuple, template <typename...> class Variant>
+        using value_types = Variant<Tuple<bool>>;
+
+        template <template <typename...> class Variant>
+        using error_types = Variant<>;
+
+        static constexpr bool sends_done = false;
+
+        using completion_signatures = pika::execution::experimental::completion_signatures<
+            pika::execution::experimental::set_value_t(bool)>;
+
+        template <typename R>
+        struct operation_state : async_channel_send_waiter<T>
+        {
+            std::decay_t<R> r;
+            async_channel_state<T>* state;
+
+            template <typename R_>
+            operation_state(R_&& r, async_channel_state<T>* state, T value)
+              : async_channel_send_waiter<T>{&complete, nullptr, std::move(value)}
+              , r(std::forward<R_>(r))
+              , state(state)
+            {
+            }
+
+            operation_state(operation_state&&) = delete;
+            operation_state& operator=(operation_state&&) = delete;
+            operation_state(operation_state const&) = delete;
+            operation_state& operator=(operation_state const&) = delete;
+
+            static void complete(async_channel_send_waiter<T>* waiter) noexcept
+            {
+                auto& op_state = static_cast<operation_state&>(*waiter);
+                pika::execution::experimental::set_value(std::move(op_state.r), op_state.sent);
+            }
+
+            void start() & noexcept
+            {
+                // A queued waiter may already have been completed and this operation state
+                // destroyed when send_or_enqueue returns
+                if (state->send_or_enqueue(this))
+                {
+                    pika::execution::experimental::set_value(std::move(r), this->sent);
+                }
+            }
+        };
+
+        template <typename R>
+        auto connect(R&& r) &&
+        {
+            return operation_state<R>{std::forward<R>(r), state, std::move(value)};
+        }
+
+        template <typename R>
+        auto connect(R&& r) const&
+        {
+            return operation_state<R>{std::forward<R>(r), state, value};
+        }
+    };
+
+    template <typename T>
+    struct async_channel_receive_sender
+    {
+        PIKA_STDEXEC_SENDER_CONCEPT
+
+        async_channel_state<T>* state;
+
+        template <template <typename...> class Tuple, template <typename...> class Variant>
+        using value_types = Variant<Tuple<std::optional<T>>>;
+
+        template <template <typename...> class Variant>
+        using error_types = Variant<>;
+
+        static constexpr bool sends_done = false;
+
+        using completion_signatures = pika::execution::experimental::completion_signatures<
+            pika::execution::experimental::set_value_t(std::optional<T>)>;
+
+        template <typename R>
+        struct operation_state : async_channel_receive_waiter<T>
+        {
+            std::decay_t<R> r;
+            async_channel_state<T>* state;
+
+            template <typename R_>
+            operation_state(R_&& r, async_channel_state<T>* state)
+              : async_channel_receive_waiter<T>{&complete}
+              , r(std::forward<R_>(r))
+              , state(state)
+            {
+            }
+
+            operation_state(operation_state&&) = delete;
+            operation_state& operator=(operation_state&&) = delete;
+            operation_state(operation_state const&) = delete;
+            operation_state& operator=(operation_state const&) = delete;
+
+            static void complete(async_channel_receive_waiter<T>* waiter) noexcept
+            {
+                auto& op_state = static_cast<operation_state&>(*waiter);
+                pika::execution::experimental::set_value(
+                    std::move(op_state.r), std::move(op_state.value));
+            }
+
+            void start() & noexcept
+            {
+                // A queued waiter may already have been completed and this operation state
+                // destroyed when receive_or_enqueue returns
+                if (state->receive_or_enqueue(this))
+                {
+                    pika::execution::experimental::set_value(std::move(r), std::move(this->value));
+                }
+            }
+        };
+
+        template <typename R>
+        auto connect(R&& r) const
+        {
+            return operation_state<R>{std::forward<R>(r), state};
+        }
+    };
+
+    // Waiters used by the blocking operations of async_channel. They suspend the calling pika
+    // thread, or block the calling OS thread, until the operation has completed.
+    template <typename T>
+    struct async_channel_blocking_send_waiter : async_channel_send_waiter<T>
+    {
+        pika::binary_semaphore<> sem{0};
+
+        explicit async_channel_blocking_send_waiter(T value)
+          : async_channel_send_waiter<T>{&complete, nullptr, std::move(value)}
+        {
+        }
+
+        static void complete(async_channel_send_waiter<T>* waiter) noexcept
+        {
+            static_cast<async_channel_blocking_send_waiter&>(*waiter).sem.release();
+        }
+    };
+
+    template <typename T>
+    struct async_channel_blocking_receive_waiter : async_channel_receive_waiter<T>
+    {
+        pika::binary_semaphore<> sem{0};
+
+        async_channel_blocking_receive_waiter()
+          : async_channel_receive_waiter<T>{&complete}
+        {
+        }
+
+        static void complete(async_channel_receive_waiter<T>* waiter) noexcept
+        {
+            static_cast<async_channel_blocking_receive_waiter&>(*waiter).sem.release();
+        }
+    };
+}    // namespace pika::execution::experimental::detail
+
+namespace pika::execution::experimental {
+    /// \brief A bounded multi-producer multi-consumer channel with sender-based send and receive.
+    ///
+    /// Values are stored in a ring buffer with room for \ref capacity values. \ref send returns a
+    /// sender which completes once the value has been stored in the channel, waiting for space if
+    /// the channel is full. \ref receive returns a sender which completes with the next value,
+    /// waiting for one if the channel is empty. Sending and receiving do not take a lock as long
+    /// as no operation has to wait. Waiting operations do not block or suspend any thread. They
+    /// are queued, and completed in the order in which they were started on the thread which
+    /// makes space or a value available. Use \ref continues_on to continue elsewhere.
+    ///
+    /// A channel can be closed with \ref close. Sending to a closed channel fails. Receiving from
+    /// a closed channel receives the values which are still in the channel, and then fails.
+    /// Operations waiting when the channel is closed fail immediately.
+    ///
+    /// The channel must outlive all senders referring to it, and no operations may be waiting
+    /// when it is destroyed. Closing the channel before destroying it completes all waiting
+    /// operations.
+    ///
+    /// \tparam T The type of values sent through the channel. T must be nothrow move
+    ///         constructible.
+    template <typename T>
+    class async_channel
+    {
+        static_assert(std::is_nothrow_move_constructible_v<T>,
+            "async_channel requires the value type to be nothrow move constructible");
+
+    private:
+        detail::async_channel_state<T> state;
+
+    public:
+        using value_type = T;
+
+        /// \brief Construct an open channel with room for \p capacity values.
+        ///
+        /// \p capacity must be greater than zero, otherwise a \ref pika::exception with the
+        /// error code \ref pika::error::bad_parameter is thrown.
+        explicit async_channel(std::size_t capacity)
+          : state(capacity)
+        {
+        }
+        async_channel(async_channel&&) = delete;
+        async_channel& operator=(async_channel&&) = delete;
+        async_channel(async_channel const&) = delete;
+        async_channel& operator=(async_channel const&) = delete;
+
+        /// \brief The maximum number of values stored in the channel.
+        std::size_t capacity() const noexcept { return state.capacity(); }
+
+        /// \brief Send a value through a sender.
+        ///
+        /// The sender sends true once the value has been stored in the channel, or false if the
+        /// channel is closed before that. The value is discarded in the latter case.
+        detail::async_channel_send_sender<T> send(T value) { return {&state, std::move(value)}; }
+
+        /// \brief Receive a value through a sender.
+        ///
+        /// The sender sends the next value from the channel, or an empty optional if the channel
+        /// is closed and no values are left.
+        detail::async_channel_receive_sender<T> receive() { return {&state}; }
+
+        /// \brief Send a value, suspending the calling thread while the channel is full.
+        ///
+        /// Returns true if the value was sent, or false if the channel is closed before that.
+        /// When called on a pika thread the pika thread is suspended, otherwise the OS thread is
+        /// blocked.
+        bool blocking_send(T value)
+        {
+            detail::async_channel_blocking_send_waiter<T> waiter{std::move(value)};
+            if (!state.send_or_enqueue(&waiter)) { waiter.sem.acquire(); }
+            return waiter.sent;
+        }
+
+        /// \brief Receive a value, suspending the calling thread while the channel is empty.
+        ///
+        /// Returns the next value, or an empty optional if the channel is closed and no values are
+        /// left. When called on a pika thread the pika thread is suspended, otherwise the OS
+        /// thread is blocked.
+        std::optional<T> blocking_receive()
+        {
+            detail::async_channel_blocking_receive_waiter<T> waiter{};
+            if (!state.receive_or_enqueue(&waiter)) { waiter.sem.acquire(); }
+            return std::move(waiter.value);
+        }
+
+        /// \brief Send a value if there is space for it in the channel.
+        ///
+        /// Returns true if the value was sent. \p value is only moved from if true is returned.
+        bool try_send(T&& value) noexcept { return state.try_send(value); }
+
+        /// \brief Receive a value if one is available.
+        std::optional<T> try_receive() noexcept
+        {
+            std::optional<T> value;
+            state.try_receive(value);
+            return value;
+        }
+
+        /// \brief Close the channel, completing all waiting operations.
+        ///
+        /// Sends which are concurrently storing a value in the channel are waited for, and their
+        /// values can still be received. Closing an already closed channel has no effect.
+        void close() noexcept { state.close(); }
+
+        /// \brief Whether the channel has been closed.
+        bool is_closed() const noexcept { return state.is_closed(); }
+    };
+}    // namespace pika::execution::experimental
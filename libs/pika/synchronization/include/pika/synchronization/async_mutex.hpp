@@ -0,0 +1,99 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/synchronization/detail/async_semaphore.hpp>
+#include <pika/synchronization/stop_token.hpp>
+
+#include <utility>
+
+namespace pika::execution::experimental {
+    /// \brief A lock of an \ref async_mutex, sent by the senders returned from \ref
+    /// async_mutex::lock.
+    ///
+    /// The guard unlocks the mutex when it is destroyed. The guard is move-only.
+    class async_mutex_guard
+    {
+    private:
+        detail::async_semaphore* sem;
+
+    public:
+        async_mutex_guard() = delete;
+        explicit async_mutex_guard(detail::async_semaphore* sem) noexcept
+          : sem(sem)
+        {
+        }
+        async_mutex_guard(async_mutex_guard&& other) noexcept
+          : sem(std::exchange(other.sem, nullptr))
+        {
+        }
+        async_mutex_guard& operator=(async_mutex_guard&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (sem != nullptr) { sem->release(); }
+                sem = std::exchange(other.sem, nullptr);
+            }
+            return *this;
+        }
+        async_mutex_guard(async_mutex_guard const&) = delete;
+        async_mutex_guard& operator=(async_mutex_guard const&) = delete;
+
+        ~async_mutex_guard()
+        {
+            if (sem != nullptr) { sem->release(); }
+        }
+    };
+
+    /// \brief A mutex which is locked through senders.
+    ///
+    /// \ref lock returns a sender which sends an \ref async_mutex_guard once the mutex has been
+    /// locked. Operations waiting for the mutex do not block or suspend any thread. They are queued
+    /// and acquire the mutex in the order in which they are started. The next operation is
+    /// completed on the thread which unlocks the mutex, use \ref continues_on to continue
+    /// elsewhere.
+    ///
+    /// The mutex must outlive all senders and guards referring to it.
+    class async_mutex
+    {
+    private:
+        detail::async_semaphore sem{1};
+
+    public:
+        using guard_type = async_mutex_guard;
+
+        async_mutex() = default;
+        async_mutex(async_mutex&&) = delete;
+        async_mutex& operator=(async_mutex&&) = delete;
+        async_mutex(async_mutex const&) = delete;
+        async_mutex& operator=(async_mutex const&) = delete;
+
+        /// \brief Lock the mutex through a sender.
+        ///
+        /// The sender sends an \ref async_mutex_guard once the mutex has been locked.
+        detail::async_semaphore_sender<guard_type> lock() { return {&sem, pika::stop_token{}}; }
+
+        /// \brief Lock the mutex through a sender, unless stop is requested first.
+        ///
+        /// The sender sends an \ref async_mutex_guard once the mutex has been locked. If stop is
+        /// requested through \p stop_token before that, the operation stops waiting and completes
+        /// with set_stopped.
+        detail::async_semaphore_sender<guard_type> lock(pika::stop_token stop_token)
+        {
+            return {&sem, std::move(stop_token)};
+        }
+
+        /// \brief Lock the mutex if it is not locked and no operation is waiting for it.
+        ///
+        /// A successful call must be paired with a call to \ref unlock.
+        bool try_lock() noexcept { return sem.try_acquire(); }
+
+        /// \brief Unlock a mutex locked by \ref try_lock.
+        void unlock() noexcept { sem.release(); }
+    };
+}    // namespace pika::execution::experimental
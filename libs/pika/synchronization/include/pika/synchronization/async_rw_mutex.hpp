@@ -8,19 +8,17 @@
 
 #include <pika/allocator_support/internal_allocator.hpp>
 #include <pika/assert.hpp>
-#include <pika/concurrency/spinlock.hpp>
-#include <pika/datastructures/detail/small_vector.hpp>
 #include <pika/execution_base/operation_state.hpp>
 #include <pika/execution_base/receiver.hpp>
 #include <pika/execution_base/sender.hpp>
 #include <pika/execution_base/this_thread.hpp>
-#include <pika/functional/unique_function.hpp>
+#include <pika/memory/intrusive_ptr.hpp>
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <memory>
-#include <mutex>
 #include <optional>
 #include <type_traits>
 #include <utility>
@@ -37,54 +35,72 @@ namespace pika::execution::experimental {
 
     namespace detail {
         template <typename T>
-        struct async_rw_mutex_shared_state
+        struct async_rw_mutex_shared_state;
+
+        // A continuation waiting for a shared state to be released. Continuations are stored in the
+        // operation states of the senders and linked into a list in the shared state that they are
+        // waiting for, so adding a continuation does not allocate.
+        struct async_rw_mutex_continuation
         {
-            using mutex_type = pika::concurrency::detail::spinlock;
-            using shared_state_ptr_type = std::shared_ptr<async_rw_mutex_shared_state>;
-            std::atomic<bool> value_set{false};
-            std::optional<T> value{std::nullopt};
-            shared_state_ptr_type next_state{nullptr};
-            mutex_type mtx{};
-            pika::detail::small_vector<
-                pika::util::detail::unique_function<void(shared_state_ptr_type)>, 1>
-                continuations{};
+            using continue_function_type = void (*)(async_rw_mutex_continuation*) noexcept;
 
-            async_rw_mutex_shared_state() = default;
-            async_rw_mutex_shared_state(async_rw_mutex_shared_state&&) = delete;
-            async_rw_mutex_shared_state& operator=(async_rw_mutex_shared_state&&) = delete;
-            async_rw_mutex_shared_state(async_rw_mutex_shared_state const&) = delete;
-            async_rw_mutex_shared_state& operator=(async_rw_mutex_shared_state const&) = delete;
+            continue_function_type const continue_function;
+            async_rw_mutex_continuation* next = nullptr;
+        };
 
-            ~async_rw_mutex_shared_state()
+        // Shared states are recycled through a pool which belongs to one mutex. States are
+        // returned to the pool from any thread, but only the mutex takes states from the pool. The
+        // pool is reference counted by the mutex and by all states which are in use, since the
+        // states may outlive the mutex.
+        template <typename T>
+        class async_rw_mutex_shared_state_pool
+        {
+        public:
+            async_rw_mutex_shared_state_pool() = default;
+            async_rw_mutex_shared_state_pool(async_rw_mutex_shared_state_pool&&) = delete;
+            async_rw_mutex_shared_state_pool& operator=(
+                async_rw_mutex_shared_state_pool&&) = delete;
+            async_rw_mutex_shared_state_pool(async_rw_mutex_shared_state_pool const&) = delete;
+            async_rw_mutex_shared_state_pool& operator=(
+                async_rw_mutex_shared_state_pool const&) = delete;
+
+            void recycle(async_rw_mutex_shared_state<T>* state) noexcept
             {
-                // If there is no next state the continuations must be empty.
-                PIKA_ASSERT(next_state || continuations.empty());
-
-                // This state must always have the value set by the time it is
-                // destructed. If there is no next state the value is destructed
-                // with this state.
-                PIKA_ASSERT(value);
+                auto* head = released_states.load(std::memory_order_relaxed);
+                do {
+                    state->next_released = head;
+                } while (!released_states.compare_exchange_weak(
+                    head, state, std::memory_order_release, std::memory_order_relaxed));
 
-                if (PIKA_LIKELY(next_state))
-                {
-                    // The current state has now finished all accesses to the
-                    // wrapped value, so we move the value to the next state.
-                    PIKA_ASSERT(value.has_value());
-                    // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
-                    next_state->set_value(std::move(*value));
+                intrusive_ptr_release(this);
+            }
 
-                    if (!continuations.empty())
-                    {
-                        auto const size = continuations.size();
-                        for (std::size_t i = 0; i < size - 1; ++i) { continuations[i](next_state); }
+            friend void intrusive_ptr_add_ref(async_rw_mutex_shared_state_pool* p) noexcept
+            {
+                p->ref_count.fetch_add(1, std::memory_order_relaxed);
+            }
 
-                        // Move shared state into the last continuation to ensure that the
-                        // continuations release the last reference and not this destructor.
-                        continuations[size - 1](std::move(next_state));
-                    }
-                }
+            friend void intrusive_ptr_release(async_rw_mutex_shared_state_pool* p) noexcept
+            {
+                if (p->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) { p->destroy(); }
             }
 
+        protected:
+            virtual ~async_rw_mutex_shared_state_pool() = default;
+
+            // Destroy all states in the pool and the pool itself
+            virtual void destroy() noexcept = 0;
+
+            std::atomic<std::size_t> ref_count{0};
+            std::atomic<async_rw_mutex_shared_state<T>*> released_states{nullptr};
+        };
+
+        template <typename T>
+        struct async_rw_mutex_value
+        {
+            std::atomic<bool> value_set{false};
+            std::optional<T> value{std::nullopt};
+
             template <typename U>
             void set_value(U&& u)
             {
@@ -103,56 +119,71 @@ namespace pika::execution::experimental {
                 return *value;
             }
 
-            void set_next_state(std::shared_ptr<async_rw_mutex_shared_state> state)
+            void move_value_to(async_rw_mutex_value& next)
             {
-                // The next state should only be set once
-                PIKA_ASSERT(!next_state);
-                PIKA_ASSERT(state);
-                next_state = std::move(state);
+                PIKA_ASSERT(value.has_value());
+                // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+                next.set_value(std::move(*value));
             }
 
-            template <typename F>
-            void add_continuation(F&& continuation)
+            void reset_value() noexcept
             {
-                std::lock_guard<mutex_type> l(mtx);
-                continuations.emplace_back(std::forward<F>(continuation));
+                // The value must always be set by the time the state is released. If there is no
+                // next state the value is destroyed with this state.
+                PIKA_ASSERT(value);
+                value.reset();
+                value_set.store(false, std::memory_order_relaxed);
             }
         };
 
         template <>
-        struct async_rw_mutex_shared_state<void>
+        struct async_rw_mutex_value<void>
+        {
+            void move_value_to(async_rw_mutex_value&) noexcept {}
+            void reset_value() noexcept {}
+        };
+
+        template <typename T>
+        struct async_rw_mutex_shared_state : async_rw_mutex_value<T>
         {
-            using mutex_type = pika::concurrency::detail::spinlock;
-            using shared_state_ptr_type = std::shared_ptr<async_rw_mutex_shared_state>;
+            using pool_type = async_rw_mutex_shared_state_pool<T>;
+            using shared_state_ptr_type = pika::memory::intrusive_ptr<async_rw_mutex_shared_state>;
+
+            // The number of references to the access guarded by this state, held by the mutex,
+            // senders, access wrappers, and the previous state
+            std::atomic<std::size_t> access_count{1};
+            // The number of references keeping the state from being recycled, held once by all
+            // accesses together, and by senders referring to this as the previous state
+            std::atomic<std::size_t> ref_count{1};
+            std::atomic<async_rw_mutex_continuation*> continuations{nullptr};
             shared_state_ptr_type next_state{nullptr};
-            mutex_type mtx{};
-            pika::detail::small_vector<
-                pika::util::detail::unique_function<void(shared_state_ptr_type)>, 1>
-                continuations{};
+            async_rw_mutex_shared_state* next_released = nullptr;
+            pool_type* const pool;
 
-            async_rw_mutex_shared_state() = default;
+            explicit async_rw_mutex_shared_state(pool_type* pool) noexcept
+              : pool(pool)
+            {
+            }
             async_rw_mutex_shared_state(async_rw_mutex_shared_state&&) = delete;
             async_rw_mutex_shared_state& operator=(async_rw_mutex_shared_state&&) = delete;
             async_rw_mutex_shared_state(async_rw_mutex_shared_state const&) = delete;
             async_rw_mutex_shared_state& operator=(async_rw_mutex_shared_state const&) = delete;
 
-            ~async_rw_mutex_shared_state()
+            // Marks the list of continuations once the state has been released
+            static async_rw_mutex_continuation* released_marker() noexcept
             {
-                // If there is no next state the continuations must be empty.
-                PIKA_ASSERT(next_state || continuations.empty());
-
-                if (!continuations.empty())
-                {
-                    auto const size = continuations.size();
-                    for (std::size_t i = 0; i < size - 1; ++i) { continuations[i](next_state); }
+                return reinterpret_cast<async_rw_mutex_continuation*>(std::uintptr_t(1));
+            }
 
-                    // Move shared state into the last continuation to ensure that the continuations
-                    // release the last reference and not this destructor.
-                    continuations[size - 1](std::move(next_state));
-                }
+            // Prepare a recycled state for a new access
+            void reinitialize() noexcept
+            {
+                access_count.store(1, std::memory_order_relaxed);
+                ref_count.store(1, std::memory_order_relaxed);
+                continuations.store(nullptr, std::memory_order_relaxed);
             }
 
-            void set_next_state(std::shared_ptr<async_rw_mutex_shared_state> state)
+            void set_next_state(shared_state_ptr_type state)
             {
                 // The next state should only be set once
                 PIKA_ASSERT(!next_state);
@@ -160,11 +191,200 @@ namespace pika::execution::experimental {
                 next_state = std::move(state);
             }
 
-            template <typename F>
-            void add_continuation(F&& continuation)
+            // Returns false without adding the continuation if the state has already been
+            // released.
+            bool add_continuation(async_rw_mutex_continuation* continuation) noexcept
             {
-                std::lock_guard<mutex_type> l(mtx);
-                continuations.emplace_back(std::forward<F>(continuation));
+                auto* head = continuations.load(std::memory_order_acquire);
+                do {
+                    if (head == released_marker()) { return false; }
+                    continuation->next = head;
+                } while (!continuations.compare_exchange_weak(
+                    head, continuation, std::memory_order_release, std::memory_order_acquire));
+
+                return true;
+            }
+
+            void add_ref() noexcept { ref_count.fetch_add(1, std::memory_order_relaxed); }
+
+            void release_ref() noexcept
+            {
+                if (ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) { pool->recycle(this); }
+            }
+
+            // Called when all accesses to this state have finished
+            void release() noexcept
+            {
+                // If there is no next state there can be no continuations.
+                PIKA_ASSERT(
+                    next_state || continuations.load(std::memory_order_relaxed) == nullptr);
+
+                // The current state has now finished all accesses to the wrapped value, so we move
+                // the value to the next state before triggering any continuations.
+                if (PIKA_LIKELY(next_state)) { this->move_value_to(*next_state); }
+                this->reset_value();
+
+                auto* continuation =
+                    continuations.exchange(released_marker(), std::memory_order_acq_rel);
+                while (continuation != nullptr)
+                {
+                    // The operation state holding the continuation may be destroyed by the
+                    // continuation
+                    auto* next = continuation->next;
+                    continuation->continue_function(continuation);
+                    continuation = next;
+                }
+
+                next_state.reset();
+                release_ref();
+            }
+
+            friend void intrusive_ptr_add_ref(async_rw_mutex_shared_state* p) noexcept
+            {
+                p->access_count.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            friend void intrusive_ptr_release(async_rw_mutex_shared_state* p) noexcept
+            {
+                if (p->access_count.fetch_sub(1, std::memory_order_acq_rel) == 1) { p->release(); }
+            }
+        };
+
+        // A reference to a shared state which does not keep the access guarded by the state
+        // alive, but keeps the state from being recycled. Senders refer to the state of the
+        // previous access through this to add continuations to it, if it has not been released
+        // by the time the sender is started.
+        template <typename T>
+        class async_rw_mutex_shared_state_weak_ptr
+        {
+        private:
+            async_rw_mutex_shared_state<T>* state = nullptr;
+
+        public:
+            async_rw_mutex_shared_state_weak_ptr() = default;
+            explicit async_rw_mutex_shared_state_weak_ptr(
+                async_rw_mutex_shared_state<T>* state) noexcept
+              : state(state)
+            {
+                if (state != nullptr) { state->add_ref(); }
+            }
+            async_rw_mutex_shared_state_weak_ptr(
+                async_rw_mutex_shared_state_weak_ptr&& other) noexcept
+              : state(std::exchange(other.state, nullptr))
+            {
+            }
+            async_rw_mutex_shared_state_weak_ptr& operator=(
+                async_rw_mutex_shared_state_weak_ptr&& other) noexcept
+            {
+                async_rw_mutex_shared_state_weak_ptr(std::move(other)).swap(*this);
+                return *this;
+            }
+            async_rw_mutex_shared_state_weak_ptr(
+                async_rw_mutex_shared_state_weak_ptr const& other) noexcept
+              : state(other.state)
+            {
+                if (state != nullptr) { state->add_ref(); }
+            }
+            async_rw_mutex_shared_state_weak_ptr& operator=(
+                async_rw_mutex_shared_state_weak_ptr const& other) noexcept
+            {
+                async_rw_mutex_shared_state_weak_ptr(other).swap(*this);
+                return *this;
+            }
+            ~async_rw_mutex_shared_state_weak_ptr()
+            {
+                if (state != nullptr) { state->release_ref(); }
+            }
+
+            void swap(async_rw_mutex_shared_state_weak_ptr& other) noexcept
+            {
+                std::swap(state, other.state);
+            }
+
+            async_rw_mutex_shared_state<T>* operator->() const noexcept { return state; }
+
+            explicit operator bool() const noexcept { return state != nullptr; }
+        };
+
+        template <typename T, typename Allocator>
+        class async_rw_mutex_shared_state_pool_impl final
+          : public async_rw_mutex_shared_state_pool<T>
+        {
+        private:
+            using state_type = async_rw_mutex_shared_state<T>;
+            using state_allocator_type =
+                typename std::allocator_traits<Allocator>::template rebind_alloc<state_type>;
+            using state_allocator_traits = std::allocator_traits<state_allocator_type>;
+            using pool_allocator_type = typename std::allocator_traits<
+                Allocator>::template rebind_alloc<async_rw_mutex_shared_state_pool_impl>;
+            using pool_allocator_traits = std::allocator_traits<pool_allocator_type>;
+
+            PIKA_NO_UNIQUE_ADDRESS state_allocator_type alloc;
+
+            // States taken from released_states which have not been reused yet. Only accessed
+            // by the mutex.
+            state_type* available_states = nullptr;
+
+            void destroy_states(state_type* state) noexcept
+            {
+                while (state != nullptr)
+                {
+                    state_type* next = state->next_released;
+                    state_allocator_traits::destroy(alloc, state);
+                    state_allocator_traits::deallocate(alloc, state, 1);
+                    state = next;
+                }
+            }
+
+            void destroy() noexcept override
+            {
+                destroy_states(available_states);
+                destroy_states(this->released_states.load(std::memory_order_acquire));
+
+                pool_allocator_type pool_alloc(alloc);
+                pool_allocator_traits::destroy(pool_alloc, this);
+                pool_allocator_traits::deallocate(pool_alloc, this, 1);
+            }
+
+        public:
+            explicit async_rw_mutex_shared_state_pool_impl(Allocator const& alloc)
+              : alloc(alloc)
+            {
+            }
+
+            static pika::memory::intrusive_ptr<async_rw_mutex_shared_state_pool_impl> create(
+                Allocator const& alloc)
+            {
+                pool_allocator_type pool_alloc(alloc);
+                auto* p = pool_allocator_traits::allocate(pool_alloc, 1);
+                pool_allocator_traits::construct(pool_alloc, p, alloc);
+                return p;
+            }
+
+            // Return a state with one access reference, reusing a released state if possible
+            state_type* allocate()
+            {
+                if (available_states == nullptr)
+                {
+                    available_states =
+                        this->released_states.exchange(nullptr, std::memory_order_acquire);
+                }
+
+                state_type* state = available_states;
+                if (state != nullptr)
+                {
+                    available_states = state->next_released;
+                    state->reinitialize();
+                }
+                else
+                {
+                    state = state_allocator_traits::allocate(alloc, 1);
+                    state_allocator_traits::construct(alloc, state, this);
+                }
+
+                // Every state in use keeps the pool alive
+                intrusive_ptr_add_ref(this);
+                return state;
             }
         };
     }    // namespace detail
@@ -188,7 +408,8 @@ namespace pika::execution::experimental {
     class async_rw_mutex_access_wrapper<ReadWriteT, ReadT, async_rw_mutex_access_type::read>
     {
     private:
-        using shared_state_type = std::shared_ptr<detail::async_rw_mutex_shared_state<ReadWriteT>>;
+        using shared_state_type =
+            pika::memory::intrusive_ptr<detail::async_rw_mutex_shared_state<ReadWriteT>>;
         shared_state_type state;
 
     public:
@@ -224,7 +445,8 @@ namespace pika::execution::experimental {
             "Cannot mix void and non-void type in async_rw_mutex_access_wrapper wrapper (ReadT "
             "is void, ReadWriteT is non-void)");
 
-        using shared_state_type = std::shared_ptr<detail::async_rw_mutex_shared_state<ReadWriteT>>;
+        using shared_state_type =
+            pika::memory::intrusive_ptr<detail::async_rw_mutex_shared_state<ReadWriteT>>;
         shared_state_type state;
 
     public:
@@ -257,7 +479,8 @@ namespace pika::execution::experimental {
     class async_rw_mutex_access_wrapper<void, void, async_rw_mutex_access_type::read>
     {
     private:
-        using shared_state_type = std::shared_ptr<detail::async_rw_mutex_shared_state<void>>;
+        using shared_state_type =
+            pika::memory::intrusive_ptr<detail::async_rw_mutex_shared_state<void>>;
         shared_state_type state;
 
     public:
@@ -279,7 +502,8 @@ namespace pika::execution::experimental {
     class async_rw_mutex_access_wrapper<void, void, async_rw_mutex_access_type::readwrite>
     {
     private:
-        using shared_state_type = std::shared_ptr<detail::async_rw_mutex_shared_state<void>>;
+        using shared_state_type =
+            pika::memory::intrusive_ptr<detail::async_rw_mutex_shared_state<void>>;
         shared_state_type state;
 
     public:
@@ -323,7 +547,7 @@ namespace pika::execution::experimental {
     /// \tparam ReadWriteT The type of the wrapped type.
     /// \tparam ReadT The type to use for read-only accesses of the wrapped type. Defaults to \ref
     /// ReadWriteT.
-    /// \tparam Allocator The allocator to use for allocating the internal shared state.
+    /// \tparam Allocator The allocator to use for allocating the internal shared states.
     template <typename ReadWriteT = void, typename ReadT = ReadWriteT,
         typename Allocator = pika::detail::internal_allocator<>>
     class async_rw_mutex;
@@ -337,12 +561,13 @@ namespace pika::execution::experimental {
     //
     // When read-write access is required a sender is created which holds on to
     // the newly created shared state for the read-write access and the previous
-    // state. When the sender is connected to a receiver, a callback is added to
-    // the previous shared state's destructor. The callback holds the new state,
-    // and passes a wrapper holding the shared state to set_value. Once the
-    // receiver which receives the wrapper has let the wrapper go out of scope
-    // (and all other references to the shared state are out of scope), the new
-    // shared state will again trigger its continuations.
+    // state. When the sender is started, the operation state adds itself as a
+    // continuation to the previous shared state. The continuation is triggered
+    // when all references to the accesses of the previous state have been
+    // released, and passes a wrapper holding the new shared state to set_value.
+    // Once the receiver which receives the wrapper has let the wrapper go out of
+    // scope (and all other references to the shared state are out of scope),
+    // the new shared state will again trigger its continuations.
     //
     // When read-only access is required and the previous access was read-only
     // the procedure is the same as for read-write access. When read-only access
@@ -352,7 +577,16 @@ namespace pika::execution::experimental {
     // triggered once all instances of that shared state have gone out of scope.
     //
     // The protected value is moved from state to state and is released when the
-    // last shared state is destroyed.
+    // last shared state is released.
+    //
+    // The shared states are intrusively reference counted. Senders refer to the
+    // previous state only through a second count, which keeps the state from
+    // being reused but does not delay the release of its accesses. Released
+    // states are recycled through a pool owned by the mutex, so that
+    // alternating between read-only and read-write accesses does not allocate
+    // once the pool holds as many states as there are accesses in flight. The
+    // pool is only freed when the mutex and all its shared states have been
+    // released.
 
     template <typename Allocator>
     class async_rw_mutex<void, void, Allocator>
@@ -362,13 +596,15 @@ namespace pika::execution::experimental {
         struct sender;
 
         using shared_state_type = detail::async_rw_mutex_shared_state<void>;
-        using shared_state_weak_ptr_type = std::weak_ptr<shared_state_type>;
+        using shared_state_weak_ptr_type = detail::async_rw_mutex_shared_state_weak_ptr<void>;
+        using shared_state_pool_type =
+            detail::async_rw_mutex_shared_state_pool_impl<void, Allocator>;
 
         // nvc++ is not able to see this typedef unless it's public
 #if defined(PIKA_NVHPC_VERSION)
     public:
 #endif
-        using shared_state_ptr_type = std::shared_ptr<shared_state_type>;
+        using shared_state_ptr_type = pika::memory::intrusive_ptr<shared_state_type>;
 
     public:
         using read_type = void;
@@ -394,8 +630,7 @@ namespace pika::execution::experimental {
         {
             if (prev_access == async_rw_mutex_access_type::readwrite)
             {
-                auto shared_prev_state = std::move(state);
-                state = std::allocate_shared<shared_state_type, allocator_type>(alloc);
+                auto shared_prev_state = std::exchange(state, allocate_state());
                 prev_access = async_rw_mutex_access_type::read;
 
                 // Only the first access has no previous shared state. When
@@ -405,7 +640,7 @@ namespace pika::execution::experimental {
                 if (PIKA_LIKELY(shared_prev_state))
                 {
                     shared_prev_state->set_next_state(state);
-                    prev_state = shared_prev_state;
+                    prev_state = shared_state_weak_ptr_type(shared_prev_state.get());
                 }
             }
 
@@ -414,8 +649,7 @@ namespace pika::execution::experimental {
 
         sender<async_rw_mutex_access_type::readwrite> readwrite()
         {
-            auto shared_prev_state = std::move(state);
-            state = std::allocate_shared<shared_state_type, allocator_type>(alloc);
+            auto shared_prev_state = std::exchange(state, allocate_state());
             prev_access = async_rw_mutex_access_type::readwrite;
 
             // Only the first access has no previous shared state. When there is
@@ -424,7 +658,7 @@ namespace pika::execution::experimental {
             if (PIKA_LIKELY(shared_prev_state))
             {
                 shared_prev_state->set_next_state(state);
-                prev_state = shared_prev_state;
+                prev_state = shared_state_weak_ptr_type(shared_prev_state.get());
             }
 
             return {prev_state, state};
@@ -454,7 +688,7 @@ namespace pika::execution::experimental {
                 pika::execution::experimental::set_error_t(std::exception_ptr)>;
 
             template <typename R>
-            struct operation_state
+            struct operation_state : detail::async_rw_mutex_continuation
             {
                 std::decay_t<R> r;
                 shared_state_weak_ptr_type prev_state;
@@ -463,7 +697,8 @@ namespace pika::execution::experimental {
                 template <typename R_>
                 operation_state(
                     R_&& r, shared_state_weak_ptr_type prev_state, shared_state_ptr_type state)
-                  : r(std::forward<R_>(r))
+                  : detail::async_rw_mutex_continuation{&continue_operation}
+                  , r(std::forward<R_>(r))
                   , prev_state(std::move(prev_state))
                   , state(std::move(state))
                 {
@@ -474,42 +709,48 @@ namespace pika::execution::experimental {
                 operation_state(operation_state const&) = delete;
                 operation_state& operator=(operation_state const&) = delete;
 
-                void start() & noexcept
+                static void continue_operation(
+                    detail::async_rw_mutex_continuation* continuation) noexcept
                 {
-                    PIKA_ASSERT_MSG(state,
-                        "async_rw_lock::sender::operation_state state is empty, was the sender "
-                        "already started?");
+                    static_cast<operation_state*>(continuation)->set_value_with_access();
+                }
 
-                    auto continuation = [&](shared_state_ptr_type state) mutable {
-                        try
-                        {
-                            pika::execution::experimental::set_value(
-                                std::move(r), access_type{std::move(state)});
-                        }
-                        catch (...)
-                        {
-                            pika::execution::experimental::set_error(
-                                std::move(r), std::current_exception());
-                        }
-                    };
-
-                    if (auto p = prev_state.lock())
+                void set_value_with_access() noexcept
+                {
+                    try
                     {
-                        // If the previous state is set and it's still alive,
-                        // add a continuation to be triggered when the previous
-                        // state is released.
-                        p->add_continuation(std::move(continuation));
-                        state.reset();
-                        prev_state.reset();
+                        pika::execution::experimental::set_value(
+                            std::move(r), access_type{std::move(state)});
                     }
-                    else
+                    catch (...)
                     {
-                        // There is no previous state on the first access or the
-                        // previous state has already been released. We can run
-                        // the continuation immediately.
-                        continuation(std::move(state));
+                        pika::execution::experimental::set_error(
+                            std::move(r), std::current_exception());
                     }
                 }
+
+                void start() & noexcept
+                {
+                    PIKA_ASSERT_MSG(state,
+                        "async_rw_lock::sender::operation_state state is empty, was the sender "
+                        "already started?");
+
+                    // The continuation may be triggered, and this operation
+                    // state destroyed, as soon as it has been added to the
+                    // previous state. The previous state is moved out so that
+                    // this operation state is not accessed after that.
+                    auto p = std::move(prev_state);
+
+                    // If the previous state is set and it hasn't been released
+                    // yet, add a continuation to be triggered when the previous
+                    // state is released.
+                    if (p && p->add_continuation(this)) { return; }
+
+                    // There is no previous state on the first access or the
+                    // previous state has already been released. We can run the
+                    // continuation immediately.
+                    set_value_with_access();
+                }
             };
 
             template <typename R>
@@ -520,10 +761,17 @@ namespace pika::execution::experimental {
             }
         };
 
+        shared_state_ptr_type allocate_state()
+        {
+            if (!pool) { pool = shared_state_pool_type::create(alloc); }
+            return shared_state_ptr_type(pool->allocate(), false);
+        }
+
         PIKA_NO_UNIQUE_ADDRESS allocator_type alloc;
 
         async_rw_mutex_access_type prev_access = async_rw_mutex_access_type::readwrite;
 
+        pika::memory::intrusive_ptr<shared_state_pool_type> pool;
         shared_state_weak_ptr_type prev_state;
         shared_state_ptr_type state;
     };
@@ -586,8 +834,7 @@ namespace pika::execution::experimental {
         {
             if (prev_access == async_rw_mutex_access_type::readwrite)
             {
-                auto shared_prev_state = std::move(state);
-                state = std::allocate_shared<shared_state_type, allocator_type>(alloc);
+                auto shared_prev_state = std::exchange(state, allocate_state());
                 prev_access = async_rw_mutex_access_type::read;
 
                 // Only the first access has no previous shared state. When
@@ -598,7 +845,7 @@ namespace pika::execution::experimental {
                 if (PIKA_LIKELY(shared_prev_state))
                 {
                     shared_prev_state->set_next_state(state);
-                    prev_state = shared_prev_state;
+                    prev_state = shared_state_weak_ptr_type(shared_prev_state.get());
                 }
                 else { state->set_value(std::move(value)); }
             }
@@ -609,8 +856,7 @@ namespace pika::execution::experimental {
         /// \brief Access the wrapped value in read-write mode through a sender.
         sender<async_rw_mutex_access_type::readwrite> readwrite()
         {
-            auto shared_prev_state = std::move(state);
-            state = std::allocate_shared<shared_state_type, allocator_type>(alloc);
+            auto shared_prev_state = std::exchange(state, allocate_state());
             prev_access = async_rw_mutex_access_type::readwrite;
 
             // Only the first access has no previous shared state. When there is
@@ -620,7 +866,7 @@ namespace pika::execution::experimental {
             if (PIKA_LIKELY(shared_prev_state))
             {
                 shared_prev_state->set_next_state(state);
-                prev_state = shared_prev_state;
+                prev_state = shared_state_weak_ptr_type(shared_prev_state.get());
             }
             else { state->set_value(std::move(value)); }
 
@@ -629,13 +875,16 @@ namespace pika::execution::experimental {
 
     private:
         using shared_state_type = detail::async_rw_mutex_shared_state<readwrite_type>;
-        using shared_state_weak_ptr_type = std::weak_ptr<shared_state_type>;
+        using shared_state_weak_ptr_type =
+            detail::async_rw_mutex_shared_state_weak_ptr<readwrite_type>;
+        using shared_state_pool_type =
+            detail::async_rw_mutex_shared_state_pool_impl<readwrite_type, Allocator>;
 
         // nvc++ is not able to see this typedef unless it's public
 #if defined(PIKA_NVHPC_VERSION)
     public:
 #endif
-        using shared_state_ptr_type = std::shared_ptr<shared_state_type>;
+        using shared_state_ptr_type = pika::memory::intrusive_ptr<shared_state_type>;
 
     private:
         template <async_rw_mutex_access_type AccessType>
@@ -661,7 +910,7 @@ namespace pika::execution::experimental {
                 pika::execution::experimental::set_error_t(std::exception_ptr)>;
 
             template <typename R>
-            struct operation_state
+            struct operation_state : detail::async_rw_mutex_continuation
             {
                 std::decay_t<R> r;
                 shared_state_weak_ptr_type prev_state;
@@ -670,7 +919,8 @@ namespace pika::execution::experimental {
                 template <typename R_>
                 operation_state(
                     R_&& r, shared_state_weak_ptr_type prev_state, shared_state_ptr_type state)
-                  : r(std::forward<R_>(r))
+                  : detail::async_rw_mutex_continuation{&continue_operation}
+                  , r(std::forward<R_>(r))
                   , prev_state(std::move(prev_state))
                   , state(std::move(state))
                 {
@@ -681,42 +931,48 @@ namespace pika::execution::experimental {
                 operation_state(operation_state const&) = delete;
                 operation_state& operator=(operation_state const&) = delete;
 
-                void start() & noexcept
+                static void continue_operation(
+                    detail::async_rw_mutex_continuation* continuation) noexcept
                 {
-                    PIKA_ASSERT_MSG(state,
-                        "async_rw_lock::sender::operation_state state is empty, was the sender "
-                        "already started?");
+                    static_cast<operation_state*>(continuation)->set_value_with_access();
+                }
 
-                    auto continuation = [&](shared_state_ptr_type state) mutable {
-                        try
-                        {
-                            pika::execution::experimental::set_value(
-                                std::move(r), access_type{std::move(state)});
-                        }
-                        catch (...)
-                        {
-                            pika::execution::experimental::set_error(
-                                std::move(r), std::current_exception());
-                        }
-                    };
-
-                    if (auto p = prev_state.lock())
+                void set_value_with_access() noexcept
+                {
+                    try
                     {
-                        // If the previous state is set and it's still alive,
-                        // add a continuation to be triggered when the previous
-                        // state is released.
-                        p->add_continuation(std::move(continuation));
-                        state.reset();
-                        prev_state.reset();
+                        pika::execution::experimental::set_value(
+                            std::move(r), access_type{std::move(state)});
                     }
-                    else
+                    catch (...)
                     {
-                        // There is no previous state on the first access or the
-                        // previous state has already been released. We can run
-                        // the continuation immediately.
-                        continuation(std::move(state));
+                        pika::execution::experimental::set_error(
+                            std::move(r), std::current_exception());
                     }
                 }
+
+                void start() & noexcept
+                {
+                    PIKA_ASSERT_MSG(state,
+                        "async_rw_lock::sender::operation_state state is empty, was the sender "
+                        "already started?");
+
+                    // The continuation may be triggered, and this operation
+                    // state destroyed, as soon as it has been added to the
+                    // previous state. The previous state is moved out so that
+                    // this operation state is not accessed after that.
+                    auto p = std::move(prev_state);
+
+                    // If the previous state is set and it hasn't been released
+                    // yet, add a continuation to be triggered when the previous
+                    // state is released.
+                    if (p && p->add_continuation(this)) { return; }
+
+                    // There is no previous state on the first access or the
+                    // previous state has already been released. We can run the
+                    // continuation immediately.
+                    set_value_with_access();
+                }
             };
 
             template <typename R>
@@ -741,10 +997,17 @@ namespace pika::execution::experimental {
         };
 
         PIKA_NO_UNIQUE_ADDRESS readwrite_type value;
+        shared_state_ptr_type allocate_state()
+        {
+            if (!pool) { pool = shared_state_pool_type::create(alloc); }
+            return shared_state_ptr_type(pool->allocate(), false);
+        }
+
         PIKA_NO_UNIQUE_ADDRESS allocator_type alloc;
 
         async_rw_mutex_access_type prev_access = async_rw_mutex_access_type::readwrite;
 
+        pika::memory::intrusive_ptr<shared_state_pool_type> pool;
         shared_state_weak_ptr_type prev_state;
         shared_state_ptr_type state;
     };
@@ -0,0 +1,128 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/synchronization/detail/async_semaphore.hpp>
+#include <pika/synchronization/stop_token.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace pika::execution::experimental {
+    /// \brief A unit of an \ref async_counting_semaphore, sent by the senders returned from \ref
+    /// async_counting_semaphore::acquire.
+    ///
+    /// The guard releases the unit when it is destroyed, unless \ref dismiss has been called. The
+    /// guard is move-only.
+    class async_semaphore_guard
+    {
+    private:
+        detail::async_semaphore* sem;
+
+    public:
+        async_semaphore_guard() = delete;
+        explicit async_semaphore_guard(detail::async_semaphore* sem) noexcept
+          : sem(sem)
+        {
+        }
+        async_semaphore_guard(async_semaphore_guard&& other) noexcept
+          : sem(std::exchange(other.sem, nullptr))
+        {
+        }
+        async_semaphore_guard& operator=(async_semaphore_guard&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (sem != nullptr) { sem->release(); }
+                sem = std::exchange(other.sem, nullptr);
+            }
+            return *this;
+        }
+        async_semaphore_guard(async_semaphore_guard const&) = delete;
+        async_semaphore_guard& operator=(async_semaphore_guard const&) = delete;
+
+        ~async_semaphore_guard()
+        {
+            if (sem != nullptr) { sem->release(); }
+        }
+
+        /// \brief Keep the unit acquired when the guard is destroyed.
+        ///
+        /// This is used when the semaphore signals events instead of bounding the number of
+        /// concurrent accesses to a resource, in which case units are released separately through
+        /// \ref async_counting_semaphore::release.
+        void dismiss() noexcept { sem = nullptr; }
+    };
+
+    /// \brief A counting semaphore whose units are acquired through senders.
+    ///
+    /// \ref acquire returns a sender which sends an \ref async_semaphore_guard once a unit has been
+    /// acquired. Operations waiting for a unit do not block or suspend any thread. They are queued
+    /// and acquire units in the order in which they are started. Waiting operations are completed
+    /// on the thread which releases units, use \ref continues_on to continue elsewhere.
+    ///
+    /// The semaphore must outlive all senders and guards referring to it.
+    ///
+    /// \tparam LeastMaxValue The maximum value of the counter.
+    template <std::ptrdiff_t LeastMaxValue = PTRDIFF_MAX>
+    class async_counting_semaphore
+    {
+    private:
+        detail::async_semaphore sem;
+
+    public:
+        using guard_type = async_semaphore_guard;
+
+        /// \brief The maximum value of the counter.
+        static constexpr std::ptrdiff_t(max)() noexcept { return LeastMaxValue; }
+
+        /// \brief Construct a new semaphore with \p value units available.
+        explicit async_counting_semaphore(std::ptrdiff_t value) noexcept
+          : sem(value)
+        {
+            PIKA_ASSERT(value >= 0 && value <= (max)());
+        }
+        async_counting_semaphore(async_counting_semaphore&&) = delete;
+        async_counting_semaphore& operator=(async_counting_semaphore&&) = delete;
+        async_counting_semaphore(async_counting_semaphore const&) = delete;
+        async_counting_semaphore& operator=(async_counting_semaphore const&) = delete;
+
+        /// \brief Acquire a unit through a sender.
+        ///
+        /// The sender sends an \ref async_semaphore_guard once a unit has been acquired.
+        detail::async_semaphore_sender<guard_type> acquire()
+        {
+            return {&sem, pika::stop_token{}};
+        }
+
+        /// \brief Acquire a unit through a sender, unless stop is requested first.
+        ///
+        /// The sender sends an \ref async_semaphore_guard once a unit has been acquired. If stop
+        /// is requested through \p stop_token before that, the operation stops waiting and
+        /// completes with set_stopped.
+        detail::async_semaphore_sender<guard_type> acquire(pika::stop_token stop_token)
+        {
+            return {&sem, std::move(stop_token)};
+        }
+
+        /// \brief Acquire a unit if one is available and no operation is waiting for one.
+        bool try_acquire() noexcept { return sem.try_acquire(); }
+
+        /// \brief Release \p update units, completing waiting operations.
+        void release(std::ptrdiff_t update = 1) noexcept
+        {
+            PIKA_ASSERT(update >= 0 && update <= (max)());
+            sem.release(update);
+        }
+    };
+
+    /// \brief A semaphore with at most one unit.
+    using async_binary_semaphore = async_counting_semaphore<1>;
+}    // namespace pika::execution::experimental
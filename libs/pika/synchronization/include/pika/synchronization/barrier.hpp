@@ -16,6 +16,8 @@
 // - pika thread ids are used before std::thread ids are used for the tree index
 // - Waiting is done with pika's yield_while, spinning until the expected result (yielding done
 //   after some time)
+// - Timed waits of pika threads park on a condition variable instead, the lowest bit of the phase
+//   (unused by the original) tells the thread completing the phase to notify them
 //
 // This implementation was last updated with
 // - https://github.com/llvm/llvm-project/blob/dc57752031fb14166dff2174b36c28d27d742382/libcxx/include/barrier
@@ -33,7 +35,11 @@
 
 #include <pika/config.hpp>
 #include <pika/assert.hpp>
+#include <pika/concurrency/cache_line_data.hpp>
+#include <pika/concurrency/spinlock.hpp>
 #include <pika/execution_base/this_thread.hpp>
+#include <pika/synchronization/detail/condition_variable.hpp>
+#include <pika/timing/steady_clock.hpp>
 
 #include <atomic>
 #include <chrono>
@@ -80,6 +86,37 @@ namespace pika {
             explicit barrier_algorithm_base(std::ptrdiff_t expected);
             bool arrive(std::ptrdiff_t expected, detail::barrier_phase_t old_phase);
         };
+
+        // Phases advance in steps of two, the lowest bit of the phase is set
+        // while timed waiters are parked on barrier_timed_waiters
+        inline constexpr barrier_phase_t barrier_parked_bit = 1;
+
+        constexpr barrier_phase_t barrier_phase_of(barrier_phase_t phase) noexcept
+        {
+            return static_cast<barrier_phase_t>(phase & ~barrier_parked_bit);
+        }
+
+        // Timed waits of pika threads park on a condition variable instead of
+        // polling the phase until the deadline. A parked waiter sets
+        // barrier_parked_bit in the phase, the thread completing the phase
+        // calls notify_all only if the bit is set. Outside of pika threads
+        // timed waits poll the phase as there is no timer wheel to wake them.
+        class PIKA_EXPORT barrier_timed_waiters
+        {
+        public:
+            // Returns whether the phase has moved on from old_phase before
+            // abs_time has been reached
+            bool wait_until(std::atomic<barrier_phase_t>& phase, barrier_phase_t old_phase,
+                pika::chrono::steady_time_point const& abs_time);
+
+            void notify_all();
+
+        private:
+            using mutex_type = pika::concurrency::detail::spinlock;
+
+            pika::concurrency::detail::cache_line_data<mutex_type> mtx;
+            pika::concurrency::detail::cache_line_data<condition_variable> cond;
+        };
     }    // namespace detail
 
     // A barrier is a thread coordination mechanism whose lifetime consists of
@@ -142,8 +179,11 @@ namespace pika {
         std::ptrdiff_t expected;
         std::atomic<std::ptrdiff_t> expected_adjustment;
         std::decay_t<Completion> completion;
-        std::atomic<detail::barrier_phase_t> phase;
+        // Timed waiters set barrier_parked_bit in the phase, see
+        // barrier_timed_waiters
+        mutable std::atomic<detail::barrier_phase_t> phase;
         detail::barrier_algorithm_base base;
+        mutable detail::barrier_timed_waiters timed_waiters;
 
     public:
         using arrival_token = detail::barrier_phase_t;
@@ -195,7 +235,7 @@ namespace pika {
         {
             PIKA_ASSERT(update <= expected);
 
-            auto const old_phase = phase.load(std::memory_order_relaxed);
+            auto const old_phase = detail::barrier_phase_of(phase.load(std::memory_order_relaxed));
             while (update != 0)
             {
                 if (base.arrive(expected, old_phase))
@@ -203,7 +243,11 @@ namespace pika {
                     completion();
                     expected += expected_adjustment.load(std::memory_order_relaxed);
                     expected_adjustment.store(0, std::memory_order_relaxed);
-                    phase.store(old_phase + 2, std::memory_order_release);
+                    if (phase.exchange(old_phase + 2, std::memory_order_acq_rel) &
+                        detail::barrier_parked_bit)
+                    {
+                        timed_waiters.notify_all();
+                    }
                 }
 
                 --update;
@@ -232,7 +276,7 @@ namespace pika {
             auto const poll = [&]() {
                 // The original libc++ implementation uses the inverse condition here, since it
                 // polls until the condition is true. Here we poll as long as the condition is true.
-                return phase.load(std::memory_order_acquire) == old_phase;
+                return detail::barrier_phase_of(phase.load(std::memory_order_acquire)) == old_phase;
             };
 
             bool const do_busy_wait = busy_wait_timeout > std::chrono::duration<double>(0.0);
@@ -246,6 +290,30 @@ namespace pika {
             pika::util::yield_while(poll, "barrier::wait", true);
         }
 
+        // Effects:        Blocks at the synchronization point associated with
+        //                 std::move(arrival) until the phase completion step
+        //                 of the synchronization point's phase is run or until
+        //                 abs_time has been reached.
+        // Returns:        Whether the phase completion step has been run.
+        [[nodiscard]] bool try_wait_until(
+            arrival_token&& old_phase, pika::chrono::steady_time_point const& abs_time) const
+        {
+            if (detail::barrier_phase_of(phase.load(std::memory_order_acquire)) != old_phase)
+            {
+                return true;
+            }
+
+            return timed_waiters.wait_until(phase, old_phase, abs_time);
+        }
+
+        // Effects:        Equivalent to:
+        //                 try_wait_until(std::move(arrival), rel_time.from_now()).
+        [[nodiscard]] bool try_wait_for(
+            arrival_token&& old_phase, pika::chrono::steady_duration const& rel_time) const
+        {
+            return try_wait_until(std::move(old_phase), rel_time.from_now());
+        }
+
         // Effects:        Equivalent to: wait(arrive()).
         void arrive_and_wait(
             std::chrono::duration<double> busy_wait_timeout = std::chrono::duration<double>(0.0))
@@ -0,0 +1,211 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/concurrency/spinlock.hpp>
+#include <pika/execution_base/operation_state.hpp>
+#include <pika/execution_base/receiver.hpp>
+#include <pika/execution_base/sender.hpp>
+#include <pika/synchronization/stop_token.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace pika::execution::experimental::detail {
+    // An operation waiting for a unit of an async_semaphore. Waiters are stored in the operation
+    // states of the senders and queued in the order in which the operations are started, so
+    // waiting does not allocate.
+    struct async_semaphore_waiter
+    {
+        using grant_function_type = void (*)(async_semaphore_waiter*) noexcept;
+
+        grant_function_type const grant_function;
+        async_semaphore_waiter* prev = nullptr;
+        async_semaphore_waiter* next = nullptr;
+        bool queued = false;
+    };
+
+    // The implementation of async_mutex and async_counting_semaphore. Units are granted to waiters
+    // on the thread which releases them. Releases in the continuation of a granted waiter grant
+    // their waiters after the continuation has returned, which bounds the stack depth.
+    class async_semaphore
+    {
+    public:
+        PIKA_NON_COPYABLE(async_semaphore);
+
+        explicit async_semaphore(std::ptrdiff_t value) noexcept
+          : count_(value)
+        {
+        }
+
+        PIKA_EXPORT ~async_semaphore();
+
+        // Acquire a unit if one is available and no other operation is waiting
+        PIKA_EXPORT bool try_acquire() noexcept;
+
+        // Acquire a unit as try_acquire and return true, or queue the waiter and return false. A
+        // queued waiter is granted a unit by a later call to release, unless it is removed first.
+        PIKA_EXPORT bool try_acquire_or_enqueue(async_semaphore_waiter* waiter) noexcept;
+
+        // Remove a queued waiter. Returns false if the waiter has already been granted a unit.
+        PIKA_EXPORT bool remove(async_semaphore_waiter* waiter) noexcept;
+
+        PIKA_EXPORT void release(std::ptrdiff_t update = 1) noexcept;
+
+    private:
+        using mutex_type = pika::concurrency::detail::spinlock;
+
+        mutex_type mtx_;
+        std::ptrdiff_t count_;
+        async_semaphore_waiter* head_ = nullptr;
+        async_semaphore_waiter* tail_ = nullptr;
+    };
+
+    template <typename Guard>
+    struct async_semaphore_sender
+    {
+        PIKA_STDEXEC_SENDER_CONCEPT
+
+        async_semaphore* sem;
+        pika::stop_token stop_token;
+
+        template <template <typename...> class Tuple, template <typename...> class Variant>
+        using value_types = Variant<Tuple<Guard>>;
+
+        template <template <typename...> class Variant>
+        using error_types = Variant<std::exception_ptr>;
+
+        static constexpr bool sends_done = true;
+
+        using completion_signatures = pika::execution::experimental::completion_signatures<
+            pika::execution::experimental::set_value_t(Guard),
+            pika::execution::experimental::set_error_t(std::exception_ptr),
+            pika::execution::experimental::set_stopped_t()>;
+
+        template <typename R>
+        struct operation_state : async_semaphore_waiter
+        {
+            struct stop_callback_function
+            {
+                operation_state& op_state;
+
+                void operator()() noexcept { op_state.request_stop(); }
+            };
+
+            std::decay_t<R> r;
+            async_semaphore* sem;
+            pika::stop_token stop_token;
+            std::optional<pika::stop_callback<stop_callback_function>> stop_callback;
+            bool use_stop_callback = false;
+            bool stopped = false;
+            // With a stop callback the operation completes once start has registered the
+            // callback, and the waiter has been granted a unit or removed because of a stop
+            // request. Whichever happens last completes the operation.
+            std::atomic<bool> registered_or_completed{false};
+
+            template <typename R_>
+            operation_state(R_&& r, async_semaphore* sem, pika::stop_token stop_token)
+              : async_semaphore_waiter{&grant}
+              , r(std::forward<R_>(r))
+              , sem(sem)
+              , stop_token(std::move(stop_token))
+            {
+            }
+
+            operation_state(operation_state&&) = delete;
+            operation_state& operator=(operation_state&&) = delete;
+            operation_state(operation_state const&) = delete;
+            operation_state& operator=(operation_state const&) = delete;
+
+            static void grant(async_semaphore_waiter* waiter) noexcept
+            {
+                auto& op_state = static_cast<operation_state&>(*waiter);
+                if (!op_state.use_stop_callback ||
+                    op_state.registered_or_completed.exchange(true, std::memory_order_acq_rel))
+                {
+                    op_state.complete();
+                }
+            }
+
+            void request_stop() noexcept
+            {
+                // The waiter has already been granted a unit, the grant completes the operation
+                if (!sem->remove(this)) { return; }
+
+                stopped = true;
+                if (registered_or_completed.exchange(true, std::memory_order_acq_rel))
+                {
+                    complete();
+                }
+            }
+
+            void complete() noexcept
+            {
+                stop_callback.reset();
+
+                if (stopped) { pika::execution::experimental::set_stopped(std::move(r)); }
+                else { set_value_with_guard(); }
+            }
+
+            void set_value_with_guard() noexcept
+            {
+                try
+                {
+                    pika::execution::experimental::set_value(std::move(r), Guard{sem});
+                }
+                catch (...)
+                {
+                    pika::execution::experimental::set_error(
+                        std::move(r), std::current_exception());
+                }
+            }
+
+            void start() & noexcept
+            {
+                if (stop_token.stop_requested())
+                {
+                    pika::execution::experimental::set_stopped(std::move(r));
+                    return;
+                }
+
+                use_stop_callback = stop_token.stop_possible();
+                if (sem->try_acquire_or_enqueue(this))
+                {
+                    set_value_with_guard();
+                    return;
+                }
+
+                // Without a stop callback the waiter may already have been granted a unit and
+                // this operation state destroyed
+                if (!use_stop_callback) { return; }
+
+                stop_callback.emplace(stop_token, stop_callback_function{*this});
+                if (registered_or_completed.exchange(true, std::memory_order_acq_rel))
+                {
+                    complete();
+                }
+            }
+        };
+
+        template <typename R>
+        auto connect(R&& r) &&
+        {
+            return operation_state<R>{std::forward<R>(r), sem, std::move(stop_token)};
+        }
+
+        template <typename R>
+        auto connect(R&& r) const&
+        {
+            return operation_state<R>{std::forward<R>(r), sem, stop_token};
+        }
+    };
+}    // namespace pika::execution::experimental::detail
@@ -18,6 +18,7 @@
 
 #include <boost/intrusive/slist.hpp>
 
+#include <atomic>
 #include <cstddef>
 #include <mutex>
 #include <utility>
@@ -49,6 +50,10 @@ namespace pika::detail {
             pika::execution::detail::agent_ref ctx_;
             void* q_;
             hook_type slist_hook_;
+
+            // only used by timed waits, see condition_variable::wait_until
+            bool timed_out_ = false;
+            std::atomic<bool> timer_done_{false};
         };
 
         using slist_option_type = boost::intrusive::member_hook<queue_entry, queue_entry::hook_type,
@@ -11,7 +11,9 @@
 #include <pika/assert.hpp>
 #include <pika/concurrency/cache_line_data.hpp>
 #include <pika/concurrency/spinlock.hpp>
+#include <pika/coroutines/thread_enums.hpp>
 #include <pika/synchronization/detail/condition_variable.hpp>
+#include <pika/timing/steady_clock.hpp>
 
 #include <atomic>
 #include <cstddef>
@@ -127,6 +129,35 @@ namespace pika {
             }
         }
 
+        /// If counter_ is 0, returns immediately. Otherwise, blocks the
+        /// calling thread at the synchronization point until counter_
+        /// reaches 0 or until \a abs_time has been reached.
+        ///
+        /// Returns:        Whether counter_ has reached 0.
+        ///
+        /// \throws Nothing.
+        ///
+        bool try_wait_until(pika::chrono::steady_time_point const& abs_time) const
+        {
+            std::unique_lock l(mtx_.data_);
+            while (counter_.load(std::memory_order_relaxed) > 0 || !notified_)
+            {
+                if (cond_.data_.wait_until(l, abs_time, "pika::latch::try_wait_until") ==
+                    threads::detail::thread_restart_state::timeout)
+                {
+                    return counter_.load(std::memory_order_relaxed) == 0 && notified_;
+                }
+            }
+            return true;
+        }
+
+        /// Effects: Equivalent to:
+        ///             try_wait_until(rel_time.from_now());
+        bool try_wait_for(pika::chrono::steady_duration const& rel_time) const
+        {
+            return try_wait_until(rel_time.from_now());
+        }
+
         /// Effects: Equivalent to:
         ///             count_down(update);
         ///             wait();
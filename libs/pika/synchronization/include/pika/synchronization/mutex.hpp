@@ -17,8 +17,24 @@
 #include <pika/threading_base/threading_base_fwd.hpp>
 #include <pika/timing/steady_clock.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
 namespace pika {
     ///////////////////////////////////////////////////////////////////////////
+    /// Uncontended lock and unlock only use a single atomic operation on the
+    /// state of the mutex. A contended lock spins for a bounded, adaptive
+    /// number of iterations before suspending the calling thread. Unlock
+    /// resumes one suspended thread, which competes for the mutex with
+    /// running threads. Once a suspended thread has been waiting for longer
+    /// than a millisecond, unlock instead hands the mutex over directly to
+    /// the first suspended thread, until none of them has been waiting for
+    /// that long, to prevent suspended threads from starving.
+    ///
+    /// The mutex may be held while the owning thread suspends, it is not
+    /// registered with the lock verification.
     class mutex
     {
     public:
@@ -43,9 +59,32 @@ namespace pika {
         PIKA_EXPORT void unlock(error_code& ec = throws);
 
     protected:
+        // Try to acquire the mutex by spinning, return true if successful
+        bool spin_lock(std::uintptr_t self) noexcept;
+
+        // Acquire the mutex if it is available, otherwise mark it as having
+        // waiters so that the owner resumes a waiting thread on unlock
+        bool try_lock_or_announce_waiter(
+            std::unique_lock<mutex_type> const& l, std::uintptr_t self) noexcept;
+
+        // Called after being resumed while waiting for the mutex, return true
+        // if the mutex was handed over to the calling thread. Otherwise the
+        // calling thread asks for the mutex to be handed over to the waiting
+        // threads if it has been waiting since wait_start for too long.
+        bool take_handed_over_lock(std::unique_lock<mutex_type> const& l, std::uintptr_t self,
+            std::chrono::steady_clock::time_point wait_start);
+
+        // The pika thread owning the mutex combined with the has_waiters and
+        // handed_over flags, see mutex.cpp
+        std::atomic<std::uintptr_t> state_;
+        // Running average of the number of iterations spinning took to
+        // acquire the mutex
+        std::atomic<std::uint32_t> spin_count_;
         mutable mutex_type mtx_;
-        threads::detail::thread_id_type owner_id_;
         pika::detail::condition_variable cond_;
+        // Set while the mutex is handed over to waiting threads on unlock,
+        // protected by mtx_
+        bool handoff_;
     };
 
     ///////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,94 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/concurrency/cache_line_data.hpp>
+#include <pika/concurrency/spinlock.hpp>
+#include <pika/synchronization/detail/condition_variable.hpp>
+#include <pika/synchronization/mutex.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace pika {
+    ///////////////////////////////////////////////////////////////////////////
+    /// A reader-writer mutex which suspends the calling pika thread instead of
+    /// blocking the worker thread when it has to wait.
+    ///
+    /// Readers are counted in one counter per worker thread, each on a
+    /// separate cache line, so that readers on different worker threads do
+    /// not contend on a shared counter. This makes acquiring and releasing a
+    /// shared lock cheap as long as no writer is present, at the expense of
+    /// exclusive locks having to inspect all counters, and of one cache line
+    /// per worker thread of memory per mutex. The mutex is intended for read
+    /// mostly data.
+    ///
+    /// With preference::writers (the default) a writer waiting for the
+    /// current readers to release the mutex keeps new readers from acquiring
+    /// it. With preference::readers new readers can acquire the mutex until
+    /// the writer has acquired it, writers may then starve.
+    class shared_mutex
+    {
+    public:
+        PIKA_NON_COPYABLE(shared_mutex);
+
+        enum class preference
+        {
+            writers,
+            readers,
+        };
+
+        PIKA_EXPORT explicit shared_mutex(preference p = preference::writers);
+
+        PIKA_EXPORT ~shared_mutex();
+
+        PIKA_EXPORT void lock();
+
+        PIKA_EXPORT bool try_lock();
+
+        PIKA_EXPORT void unlock();
+
+        PIKA_EXPORT void lock_shared();
+
+        PIKA_EXPORT bool try_lock_shared();
+
+        PIKA_EXPORT void unlock_shared();
+
+    private:
+        using mutex_type = pika::concurrency::detail::spinlock;
+        using reader_count =
+            pika::concurrency::detail::cache_aligned_data<std::atomic<std::int64_t>>;
+
+        // Return the reader counter of the calling worker thread
+        std::atomic<std::int64_t>& get_reader_count() noexcept;
+
+        // Return the total number of readers
+        std::int64_t get_readers() const noexcept;
+
+        // Writers first take writer_mtx_, which is held until unlock
+        pika::mutex writer_mtx_;
+
+        // Set while a writer holds writer_mtx_, readers are blocked by
+        // writer_waiting with preference::writers, and by writer_active
+        // otherwise
+        std::atomic<std::uint32_t> writer_state_;
+        std::uint32_t const blocking_writer_state_;
+
+        std::size_t const num_reader_counts_;
+        std::unique_ptr<reader_count[]> reader_counts_;
+
+        // Protects waiting on readers_cond_ and writer_cond_
+        mutable mutex_type mtx_;
+        // Readers waiting for the writer to release the mutex
+        pika::detail::condition_variable readers_cond_;
+        // The writer waiting for the readers to release the mutex
+        pika::detail::condition_variable writer_cond_;
+    };
+}    // namespace pika
@@ -21,8 +21,10 @@
 #include <pika/threading_base/thread_data.hpp>
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <thread>
 
 namespace pika::detail {
@@ -80,4 +82,59 @@ namespace pika::detail {
             current >>= 1;
         }
     }
+
+    bool barrier_timed_waiters::wait_until(std::atomic<barrier_phase_t>& phase,
+        barrier_phase_t old_phase, pika::chrono::steady_time_point const& abs_time)
+    {
+        auto const completed = [&](barrier_phase_t current) {
+            return barrier_phase_of(current) != old_phase;
+        };
+
+        // There is no timer wheel outside of pika threads to wake up a parked
+        // waiter at the deadline, poll the phase instead
+        if (!pika::threads::detail::get_self_id())
+        {
+            auto const timeout = abs_time.value() - std::chrono::steady_clock::now();
+            if (timeout <= std::chrono::steady_clock::duration::zero())
+            {
+                return completed(phase.load(std::memory_order_acquire));
+            }
+
+            return pika::util::detail::yield_while_timeout(
+                [&]() { return !completed(phase.load(std::memory_order_acquire)); }, timeout,
+                "barrier::try_wait_until", true);
+        }
+
+        std::unique_lock<mutex_type> l(mtx.data_);
+        barrier_phase_t current = phase.load(std::memory_order_acquire);
+        while (!completed(current))
+        {
+            // The parked bit is set while holding the lock. The thread
+            // completing the phase takes the lock before notifying, so this
+            // thread is already enqueued on the condition variable by then.
+            if (!(current & barrier_parked_bit) &&
+                !phase.compare_exchange_weak(current,
+                    static_cast<barrier_phase_t>(current | barrier_parked_bit),
+                    std::memory_order_acq_rel))
+            {
+                continue;
+            }
+
+            if (cond.data_.wait_until(l, abs_time, "barrier::try_wait_until") ==
+                pika::threads::detail::thread_restart_state::timeout)
+            {
+                return completed(phase.load(std::memory_order_acquire));
+            }
+
+            current = phase.load(std::memory_order_acquire);
+        }
+
+        return true;
+    }
+
+    void barrier_timed_waiters::notify_all()
+    {
+        std::unique_lock<mutex_type> l(mtx.data_);
+        cond.data_.notify_all(std::move(l));
+    }
 }    // namespace pika::detail
@@ -0,0 +1,184 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/synchronization/detail/async_semaphore.hpp>
+#include <pika/threading_base/thread_data.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+namespace pika::execution::experimental::detail {
+    namespace {
+        // Waiters granted a unit by a release nested in the grant of another waiter, e.g. by a
+        // continuation dropping its guard. They are granted by the outermost release on the same
+        // thread once the current grant has returned, so that a chain of waiters does not grow
+        // the stack. The semaphore itself is not accessed after granting, as the last grant may
+        // destroy it.
+        struct deferred_grants
+        {
+            // The pika thread, or the OS thread if not on a pika thread, running the outermost
+            // release. A pika thread suspended in a grant may resume on another OS thread, the
+            // owner prevents other pika threads from using the list in the meantime.
+            std::atomic<void const*> owner{nullptr};
+            async_semaphore_waiter* head = nullptr;
+            async_semaphore_waiter* tail = nullptr;
+
+            void push(async_semaphore_waiter* first, async_semaphore_waiter* last) noexcept
+            {
+                if (tail != nullptr) { tail->next = first; }
+                else { head = first; }
+                tail = last;
+            }
+
+            async_semaphore_waiter* pop() noexcept
+            {
+                async_semaphore_waiter* waiter = head;
+                head = waiter->next;
+                if (head == nullptr) { tail = nullptr; }
+                return waiter;
+            }
+        };
+
+        thread_local deferred_grants deferred_grants_tss;
+
+        void const* get_deferred_grants_owner() noexcept
+        {
+            if (auto const* self = pika::threads::detail::get_self_ptr()) { return self; }
+            return &deferred_grants_tss;
+        }
+
+        void grant(async_semaphore_waiter* granted) noexcept
+        {
+            while (granted != nullptr)
+            {
+                // The operation state holding the waiter may be destroyed by the grant
+                async_semaphore_waiter* next = granted->next;
+                granted->grant_function(granted);
+                granted = next;
+            }
+        }
+    }    // namespace
+
+    async_semaphore::~async_semaphore()
+    {
+        PIKA_ASSERT_MSG(head_ == nullptr,
+            "async_semaphore::~async_semaphore: the semaphore is destroyed while operations are "
+            "waiting for it");
+    }
+
+    bool async_semaphore::try_acquire() noexcept
+    {
+        std::lock_guard<mutex_type> l(mtx_);
+
+        // Units are not taken from operations which are already waiting
+        if (count_ > 0 && head_ == nullptr)
+        {
+            --count_;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool async_semaphore::try_acquire_or_enqueue(async_semaphore_waiter* waiter) noexcept
+    {
+        std::lock_guard<mutex_type> l(mtx_);
+
+        if (count_ > 0 && head_ == nullptr)
+        {
+            --count_;
+            return true;
+        }
+
+        waiter->prev = tail_;
+        waiter->next = nullptr;
+        waiter->queued = true;
+        if (tail_ != nullptr) { tail_->next = waiter; }
+        else { head_ = waiter; }
+        tail_ = waiter;
+
+        return false;
+    }
+
+    bool async_semaphore::remove(async_semaphore_waiter* waiter) noexcept
+    {
+        std::lock_guard<mutex_type> l(mtx_);
+
+        if (!waiter->queued) { return false; }
+
+        if (waiter->prev != nullptr) { waiter->prev->next = waiter->next; }
+        else { head_ = waiter->next; }
+        if (waiter->next != nullptr) { waiter->next->prev = waiter->prev; }
+        else { tail_ = waiter->prev; }
+        waiter->queued = false;
+
+        return true;
+    }
+
+    void async_semaphore::release(std::ptrdiff_t update) noexcept
+    {
+        PIKA_ASSERT(update >= 0);
+
+        // Waiters are granted their units after releasing the lock, since granting a unit
+        // completes the operation, which may release units again
+        async_semaphore_waiter* granted = nullptr;
+        async_semaphore_waiter* granted_tail = nullptr;
+        {
+            std::lock_guard<mutex_type> l(mtx_);
+
+            count_ += update;
+
+            while (count_ > 0 && head_ != nullptr)
+            {
+                async_semaphore_waiter* waiter = head_;
+                head_ = waiter->next;
+                if (head_ != nullptr) { head_->prev = nullptr; }
+                else { tail_ = nullptr; }
+
+                waiter->queued = false;
+                waiter->next = nullptr;
+                if (granted_tail != nullptr) { granted_tail->next = waiter; }
+                else { granted = waiter; }
+                granted_tail = waiter;
+
+                --count_;
+            }
+        }
+
+        if (granted == nullptr) { return; }
+
+        // The list of the current OS thread is used until the end, also if the pika thread
+        // resumes on another OS thread in between
+        deferred_grants& grants = deferred_grants_tss;
+        void const* const owner = get_deferred_grants_owner();
+        void const* current_owner = grants.owner.load(std::memory_order_acquire);
+        if (current_owner == owner)
+        {
+            grants.push(granted, granted_tail);
+            return;
+        }
+
+        if (current_owner != nullptr ||
+            !grants.owner.compare_exchange_strong(current_owner, owner, std::memory_order_acq_rel))
+        {
+            // Another pika thread has been suspended in a grant on this OS thread
+            grant(granted);
+            return;
+        }
+
+        grants.push(granted, granted_tail);
+        while (grants.head != nullptr)
+        {
+            async_semaphore_waiter* waiter = grants.pop();
+            waiter->next = nullptr;
+            waiter->grant_function(waiter);
+        }
+        grants.owner.store(nullptr, std::memory_order_release);
+    }
+}    // namespace pika::execution::experimental::detail
@@ -13,15 +13,45 @@
 #include <pika/synchronization/detail/condition_variable.hpp>
 #include <pika/synchronization/no_mutex.hpp>
 #include <pika/thread_support/unlock_guard.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
+#include <pika/threading_base/thread_data.hpp>
 #include <pika/threading_base/thread_helpers.hpp>
 #include <pika/timing/steady_clock.hpp>
 
+#include <atomic>
 #include <cstddef>
 #include <exception>
 #include <mutex>
 #include <utility>
 
 namespace pika::detail {
+    namespace {
+        // Cancel the timer of a timed wait when leaving the wait. If the timer
+        // has expired already, wait for its callback to stop accessing the
+        // queue entry of the waiting thread.
+        struct cancel_timer_on_exit
+        {
+            cancel_timer_on_exit(
+                pika::threads::detail::timer_handle& timer, std::atomic<bool>& done) noexcept
+              : timer_(timer)
+              , done_(done)
+            {
+            }
+
+            ~cancel_timer_on_exit()
+            {
+                if (!timer_.cancel())
+                {
+                    pika::util::yield_while(
+                        [this] { return !done_.load(std::memory_order_acquire); },
+                        "condition_variable::wait_until");
+                }
+            }
+
+            pika::threads::detail::timer_handle& timer_;
+            std::atomic<bool>& done_;
+        };
+    }    // namespace
 
     ///////////////////////////////////////////////////////////////////////////
     condition_variable::condition_variable() {}
@@ -152,14 +182,48 @@ namespace pika::detail {
         queue_.push_back(f);
 
         reset_queue_entry r(f, queue_);
+
+        pika::threads::detail::thread_id_type self_id = pika::threads::detail::get_self_id();
+        if (!self_id)
         {
-            // suspend this thread
+            // there is no timer wheel outside of pika threads, sleep instead
             ::pika::detail::unlock_guard<std::unique_lock<mutex_type>> ul(lock);
             this_ctx.sleep_until(abs_time.value());
         }
+        else
+        {
+            // The expired timer resumes this thread only if the entry is still
+            // enqueued. Both the timer and the notifying threads remove the
+            // entry from the queue before resuming the thread while holding
+            // the lock, which guarantees that the thread is resumed exactly
+            // once.
+            pika::threads::detail::timer_handle timer = pika::threads::detail::add_timer(self_id,
+                abs_time, [mtx = lock.mutex(), &f]() {
+                    std::unique_lock<mutex_type> l(*mtx);
+
+                    auto ctx = f.ctx_;
+                    if (ctx)
+                    {
+                        f.ctx_.reset();
+                        f.timed_out_ = true;
+                        static_cast<queue_type*>(f.q_)->erase(queue_type::s_iterator_to(f));
+                    }
+
+                    // f must not be accessed anymore after this
+                    f.timer_done_.store(true, std::memory_order_release);
+                    l.unlock();
+
+                    if (ctx) { ctx.resume(); }
+                });
 
-        return f.ctx_ ? pika::threads::detail::thread_restart_state::timeout :
-                        pika::threads::detail::thread_restart_state::signaled;
+            // suspend this thread
+            ::pika::detail::unlock_guard<std::unique_lock<mutex_type>> ul(lock);
+            cancel_timer_on_exit on_exit(timer, f.timer_done_);
+            this_ctx.suspend();
+        }
+
+        return (f.timed_out_ || f.ctx_) ? pika::threads::detail::thread_restart_state::timeout :
+                                          pika::threads::detail::thread_restart_state::signaled;
     }
 
     template <typename Mutex>
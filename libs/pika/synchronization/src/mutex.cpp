@@ -13,78 +13,246 @@
 #include <pika/lock_registration/detail/register_locks.hpp>
 #include <pika/modules/errors.hpp>
 #include <pika/synchronization/condition_variable.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/thread_data.hpp>
 #include <pika/timing/steady_clock.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <mutex>
 #include <utility>
 
 namespace pika {
+    namespace {
+        // The state of the mutex is the address of the thread_data of the
+        // owning thread, which is always sufficiently aligned for the two
+        // least significant bits to be used as flags:
+        // - has_waiters is set while threads may be suspended waiting for the
+        //   mutex, the owner then has to resume one of them on unlock
+        // - handed_over is set instead of an owner while the mutex is being
+        //   handed over to a resumed thread, no other thread may acquire it
+        // The mutex is available when there is neither an owner nor
+        // handed_over set.
+        constexpr std::uintptr_t has_waiters = 1;
+        constexpr std::uintptr_t handed_over = 2;
+        constexpr std::uintptr_t owner_mask = ~(has_waiters | handed_over);
+
+        constexpr bool is_available(std::uintptr_t s) noexcept
+        {
+            return (s & ~has_waiters) == 0;
+        }
+
+        // Upper bound for the number of iterations spent spinning before
+        // suspending
+        constexpr std::uint32_t max_spin_count = 100;
+
+        // Suspended threads waiting for longer than this make unlock hand
+        // over the mutex
+        constexpr std::chrono::milliseconds handoff_threshold{1};
+
+        std::uintptr_t get_self_state() noexcept
+        {
+            return reinterpret_cast<std::uintptr_t>(threads::detail::get_self_id_data());
+        }
+
+        // Inline tasks have no thread_data to identify the owner and can not
+        // suspend to wait for the mutex
+        bool check_not_inline_task(char const* description, error_code& ec)
+        {
+            if (PIKA_UNLIKELY(threads::detail::scheduler_base::is_running_inline_task()))
+            {
+                PIKA_THROWS_IF(ec, pika::error::invalid_status, description,
+                    "pika::mutex can not be used from inline tasks, schedule work using the mutex "
+                    "with a thread_stacksize other than nostack");
+                return false;
+            }
+            return true;
+        }
+    }    // namespace
+
     ///////////////////////////////////////////////////////////////////////////
     mutex::mutex(char const* const /* description */)
-      : owner_id_(threads::detail::invalid_thread_id)
+      : state_(0)
+      , spin_count_(0)
+      , handoff_(false)
     {
     }
 
     mutex::~mutex() {}
 
+    bool mutex::spin_lock(std::uintptr_t self) noexcept
+    {
+        // Spin for up to twice the number of iterations it took on average to
+        // acquire the mutex, so that the spinning adapts to the length of the
+        // critical sections protected by the mutex. Only successful attempts
+        // enter the average. A failed attempt halves it instead, so that
+        // spinning quickly stops being tried for long critical sections.
+        std::uint32_t const spin_count = spin_count_.load(std::memory_order_relaxed);
+        std::uint32_t const max_spins = (std::min)(max_spin_count, 2 * spin_count + 10);
+
+        std::uint32_t i = 0;
+        bool locked = false;
+        for (; i != max_spins; ++i)
+        {
+            std::uintptr_t s = state_.load(std::memory_order_relaxed);
+
+            // The mutex will not become available until the waiting threads
+            // are done with it
+            if (s & handed_over) { break; }
+
+            if (is_available(s) &&
+                state_.compare_exchange_strong(
+                    s, self | s, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                locked = true;
+                break;
+            }
+
+            PIKA_SMT_PAUSE;
+        }
+
+        if (locked)
+        {
+            spin_count_.store(static_cast<std::uint32_t>(static_cast<std::int64_t>(spin_count) +
+                                  (static_cast<std::int64_t>(i) - spin_count) / 8),
+                std::memory_order_relaxed);
+        }
+        else { spin_count_.store(spin_count / 2, std::memory_order_relaxed); }
+        return locked;
+    }
+
+    bool mutex::try_lock_or_announce_waiter(
+        std::unique_lock<mutex_type> const& l, std::uintptr_t self) noexcept
+    {
+        std::uintptr_t s = state_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            if (is_available(s))
+            {
+                std::uintptr_t const waiters = cond_.empty(l) ? 0 : has_waiters;
+                if (state_.compare_exchange_weak(
+                        s, self | waiters, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            // The thread the mutex is handed over to takes care of announcing
+            // the waiting threads
+            else if ((s & (has_waiters | handed_over)) ||
+                state_.compare_exchange_weak(
+                    s, s | has_waiters, std::memory_order_relaxed, std::memory_order_relaxed))
+            {
+                return false;
+            }
+        }
+    }
+
+    bool mutex::take_handed_over_lock(std::unique_lock<mutex_type> const& l, std::uintptr_t self,
+        std::chrono::steady_clock::time_point wait_start)
+    {
+        bool const waited_too_long =
+            std::chrono::steady_clock::now() - wait_start > handoff_threshold;
+
+        if (state_.load(std::memory_order_relaxed) != handed_over)
+        {
+            if (waited_too_long) { handoff_ = true; }
+            return false;
+        }
+
+        // Stop handing over the mutex once the waiting threads have not been
+        // waiting for too long anymore
+        bool const empty = cond_.empty(l);
+        if (empty || !waited_too_long) { handoff_ = false; }
+
+        state_.store(self | (empty ? 0 : has_waiters), std::memory_order_relaxed);
+        return true;
+    }
+
     void mutex::lock(char const* description, error_code& ec)
     {
+        if (!check_not_inline_task(description, ec)) { return; }
         PIKA_ASSERT(threads::detail::get_self_ptr() != nullptr);
 
-        std::unique_lock<mutex_type> l(mtx_);
+        std::uintptr_t const self = get_self_state();
+        std::uintptr_t s = 0;
+        if (PIKA_LIKELY(state_.compare_exchange_strong(
+                s, self, std::memory_order_acquire, std::memory_order_relaxed)))
+        {
+            return;
+        }
 
-        threads::detail::thread_id_type self_id = pika::threads::detail::get_self_id();
-        if (owner_id_ == self_id)
+        if ((s & owner_mask) == self)
         {
-            l.unlock();
             PIKA_THROWS_IF(ec, pika::error::deadlock, description,
                 "The calling thread already owns the mutex");
             return;
         }
 
-        while (owner_id_ != threads::detail::invalid_thread_id)
+        if (spin_lock(self)) { return; }
+
+        auto const wait_start = std::chrono::steady_clock::now();
+
+        std::unique_lock<mutex_type> l(mtx_);
+        while (!try_lock_or_announce_waiter(l, self))
         {
-            cond_.wait(l, ec);
+            pika::threads::detail::thread_restart_state const reason =
+                cond_.wait(l, description, ec);
             if (ec) { return; }
-        }
 
-        util::register_lock(this);
-        owner_id_ = self_id;
+            if (reason == pika::threads::detail::thread_restart_state::signaled &&
+                take_handed_over_lock(l, self, wait_start))
+            {
+                return;
+            }
+        }
     }
 
-    bool mutex::try_lock(char const* /* description */, error_code& /* ec */)
+    bool mutex::try_lock(char const* description, error_code& ec)
     {
+        if (!check_not_inline_task(description, ec)) { return false; }
         PIKA_ASSERT(threads::detail::get_self_ptr() != nullptr);
 
-        std::unique_lock<mutex_type> l(mtx_);
-
-        if (owner_id_ != threads::detail::invalid_thread_id) { return false; }
-
-        threads::detail::thread_id_type self_id = pika::threads::detail::get_self_id();
-        util::register_lock(this);
-        owner_id_ = self_id;
-        return true;
+        std::uintptr_t s = state_.load(std::memory_order_relaxed);
+        return is_available(s) &&
+            state_.compare_exchange_strong(
+                s, get_self_state() | s, std::memory_order_acquire, std::memory_order_relaxed);
     }
 
     void mutex::unlock(error_code& ec)
     {
         PIKA_ASSERT(threads::detail::get_self_ptr() != nullptr);
 
-        // Unregister lock early as the lock guard below may suspend.
-        util::unregister_lock(this);
-        std::unique_lock<mutex_type> l(mtx_);
+        std::uintptr_t const self = get_self_state();
+        std::uintptr_t s = self;
+        if (PIKA_LIKELY(state_.compare_exchange_strong(
+                s, 0, std::memory_order_release, std::memory_order_relaxed)))
+        {
+            return;
+        }
 
-        threads::detail::thread_id_type self_id = pika::threads::detail::get_self_id();
-        if (PIKA_UNLIKELY(owner_id_ != self_id))
+        if (PIKA_UNLIKELY((s & owner_mask) != self))
         {
-            l.unlock();
             PIKA_THROWS_IF(ec, pika::error::lock_error, "mutex::unlock",
                 "The calling thread does not own the mutex");
             return;
         }
 
-        owner_id_ = threads::detail::invalid_thread_id;
+        std::unique_lock<mutex_type> l(mtx_);
+
+        // The waiting threads may have timed out
+        if (cond_.empty(l))
+        {
+            handoff_ = false;
+            state_.store(0, std::memory_order_release);
+            return;
+        }
+
+        // Either hand the mutex over to the first waiting thread, which owns
+        // the mutex once it is resumed, or release it and let the resumed
+        // thread compete for it
+        state_.store(handoff_ ? handed_over : has_waiters, std::memory_order_release);
 
         {
             [[maybe_unused]] util::ignore_while_checking il(&l);
@@ -102,32 +270,40 @@ namespace pika {
     timed_mutex::~timed_mutex() {}
 
     bool timed_mutex::try_lock_until(pika::chrono::steady_time_point const& abs_time,
-        char const* /* description */, error_code& ec)
+        char const* description, error_code& ec)
     {
+        if (!check_not_inline_task(description, ec)) { return false; }
         PIKA_ASSERT(threads::detail::get_self_ptr() != nullptr);
 
-        std::unique_lock<mutex_type> l(mtx_);
+        std::uintptr_t const self = get_self_state();
+        std::uintptr_t s = 0;
+        if (state_.compare_exchange_strong(
+                s, self, std::memory_order_acquire, std::memory_order_relaxed) ||
+            spin_lock(self))
+        {
+            return true;
+        }
+
+        auto const wait_start = std::chrono::steady_clock::now();
 
-        threads::detail::thread_id_type self_id = pika::threads::detail::get_self_id();
-        if (owner_id_ != threads::detail::invalid_thread_id)
+        std::unique_lock<mutex_type> l(mtx_);
+        while (!try_lock_or_announce_waiter(l, self))
         {
             pika::threads::detail::thread_restart_state const reason =
                 cond_.wait_until(l, abs_time, ec);
             if (ec) { return false; }
 
-            if (reason == pika::threads::detail::thread_restart_state::timeout)    //-V110
+            if (reason == pika::threads::detail::thread_restart_state::signaled)
             {
-                return false;
+                if (take_handed_over_lock(l, self, wait_start)) { return true; }
+                continue;
             }
 
-            if (owner_id_ != threads::detail::invalid_thread_id)    //-V110
-            {
-                return false;
-            }
+            // another thread may have released the mutex after the wait
+            // timed out, take it if it is available but do not wait again
+            return try_lock_or_announce_waiter(l, self);
         }
 
-        util::register_lock(this);
-        owner_id_ = self_id;
         return true;
     }
 }    // namespace pika
@@ -0,0 +1,159 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/synchronization/shared_mutex.hpp>
+#include <pika/threading_base/thread_data.hpp>
+#include <pika/threading_base/thread_num_tss.hpp>
+#include <pika/topology/topology.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace pika {
+    namespace {
+        // A writer holds writer_mtx_ and is waiting for the readers to
+        // release the mutex
+        constexpr std::uint32_t writer_waiting = 1;
+        // A writer holds the mutex, no readers are present
+        constexpr std::uint32_t writer_active = 2;
+    }    // namespace
+
+    // The reader counters are updated and the writer state is inspected
+    // with sequentially consistent operations: either a reader sees the
+    // state set by a writer, or the writer sees the reader in the counters.
+    // A reader may release the mutex on a different worker thread than it
+    // acquired it on, only the sum of the counters is meaningful.
+    shared_mutex::shared_mutex(preference p)
+      : writer_state_(0)
+      , blocking_writer_state_(
+            p == preference::writers ? (writer_waiting | writer_active) : writer_active)
+      , num_reader_counts_((std::max)(1u, threads::detail::hardware_concurrency()))
+      , reader_counts_(new reader_count[num_reader_counts_])
+    {
+    }
+
+    shared_mutex::~shared_mutex() = default;
+
+    std::atomic<std::int64_t>& shared_mutex::get_reader_count() noexcept
+    {
+        // Threads which are not worker threads share the last counter
+        std::size_t const thread_num = threads::detail::get_global_thread_num_tss();
+        return reader_counts_[(std::min)(thread_num, num_reader_counts_ - 1)].data_;
+    }
+
+    std::int64_t shared_mutex::get_readers() const noexcept
+    {
+        std::int64_t readers = 0;
+        for (std::size_t i = 0; i != num_reader_counts_; ++i)
+        {
+            readers += reader_counts_[i].data_.load(std::memory_order_seq_cst);
+        }
+        return readers;
+    }
+
+    void shared_mutex::lock()
+    {
+        PIKA_ASSERT(threads::detail::get_self_ptr() != nullptr);
+
+        writer_mtx_.lock();
+
+        std::unique_lock<mutex_type> l(mtx_);
+        writer_state_.store(writer_waiting, std::memory_order_seq_cst);
+        while (true)
+        {
+            // Readers releasing the mutex notify the writer while it is
+            // waiting
+            while (get_readers() != 0) { writer_cond_.wait(l, "shared_mutex::lock"); }
+
+            writer_state_.store(writer_waiting | writer_active, std::memory_order_seq_cst);
+
+            // With preference::readers, new readers may have acquired the
+            // mutex before they could see writer_active
+            if (get_readers() == 0) { break; }
+
+            // Readers which have seen writer_active wait for mtx_ to be
+            // released before checking the writer state again, they do not
+            // need to be notified
+            writer_state_.store(writer_waiting, std::memory_order_seq_cst);
+        }
+    }
+
+    bool shared_mutex::try_lock()
+    {
+        PIKA_ASSERT(threads::detail::get_self_ptr() != nullptr);
+
+        if (!writer_mtx_.try_lock()) { return false; }
+
+        writer_state_.store(writer_waiting | writer_active, std::memory_order_seq_cst);
+        if (get_readers() == 0) { return true; }
+
+        std::unique_lock<mutex_type> l(mtx_);
+        writer_state_.store(0, std::memory_order_seq_cst);
+        readers_cond_.notify_all(std::move(l));
+        writer_mtx_.unlock();
+        return false;
+    }
+
+    void shared_mutex::unlock()
+    {
+        PIKA_ASSERT(threads::detail::get_self_ptr() != nullptr);
+
+        {
+            std::unique_lock<mutex_type> l(mtx_);
+            writer_state_.store(0, std::memory_order_seq_cst);
+            readers_cond_.notify_all(std::move(l));
+        }
+        writer_mtx_.unlock();
+    }
+
+    void shared_mutex::lock_shared()
+    {
+        PIKA_ASSERT(threads::detail::get_self_ptr() != nullptr);
+
+        while (!try_lock_shared())
+        {
+            // The writer notifies the waiting readers when it releases the
+            // mutex, which it does while holding mtx_
+            std::unique_lock<mutex_type> l(mtx_);
+            if (writer_state_.load(std::memory_order_seq_cst) & blocking_writer_state_)
+            {
+                readers_cond_.wait(l, "shared_mutex::lock_shared");
+            }
+        }
+    }
+
+    bool shared_mutex::try_lock_shared()
+    {
+        std::atomic<std::int64_t>& count = get_reader_count();
+        count.fetch_add(1, std::memory_order_seq_cst);
+        if (PIKA_LIKELY(
+                !(writer_state_.load(std::memory_order_seq_cst) & blocking_writer_state_)))
+        {
+            return true;
+        }
+
+        unlock_shared();
+        return false;
+    }
+
+    void shared_mutex::unlock_shared()
+    {
+        get_reader_count().fetch_sub(1, std::memory_order_seq_cst);
+
+        // A writer may be waiting for the readers to release the mutex
+        if (PIKA_UNLIKELY(writer_state_.load(std::memory_order_seq_cst) != 0))
+        {
+            std::unique_lock<mutex_type> l(mtx_);
+            writer_cond_.notify_one(std::move(l));
+        }
+    }
+}    // namespace pika
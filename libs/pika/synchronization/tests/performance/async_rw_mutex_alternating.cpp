@@ -0,0 +1,181 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test measures the overhead of async_rw_mutex itself for chains of alternating read-write and
+// read-only accesses. The operation states of one read-write access and the read-only accesses
+// following it are connected and started in reverse order, so that all but the first access have to
+// wait for the previous access to be released. Accesses complete inline on the calling thread, no
+// new tasks are created.
+
+#include <pika/config.hpp>
+#include <pika/async_rw_mutex.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <fmt/printf.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using pika::program_options::bool_switch;
+using pika::program_options::options_description;
+using pika::program_options::value;
+using pika::program_options::variables_map;
+
+namespace ex = pika::execution::experimental;
+
+struct receiver
+{
+    PIKA_STDEXEC_RECEIVER_CONCEPT
+
+    template <typename E>
+    friend void tag_invoke(ex::set_error_t, receiver&&, E&&) noexcept
+    {
+        std::terminate();
+    }
+
+    friend void tag_invoke(ex::set_stopped_t, receiver&&) noexcept { std::terminate(); }
+
+    // The access wrapper is released when this returns
+    template <typename Access>
+    void set_value(Access&&) && noexcept
+    {
+    }
+
+    constexpr ex::empty_env get_env() const& noexcept { return {}; }
+};
+
+template <typename Sender>
+struct operation_state_holder
+{
+    ex::connect_result_t<Sender, receiver> op_state;
+
+    explicit operation_state_holder(Sender&& sender)
+      : op_state(ex::connect(std::move(sender), receiver{}))
+    {
+    }
+};
+
+template <typename T>
+ex::async_rw_mutex<T> make_mutex()
+{
+    if constexpr (std::is_void_v<T>) { return ex::async_rw_mutex<T>{}; }
+    else { return ex::async_rw_mutex<T>{T{}}; }
+}
+
+template <typename T>
+double test_async_rw_mutex(std::uint64_t num_iterations, std::uint64_t num_ro_accesses)
+{
+    using mutex_type = ex::async_rw_mutex<T>;
+    using rw_holder_type =
+        operation_state_holder<decltype(std::declval<mutex_type&>().readwrite())>;
+    using ro_holder_type = operation_state_holder<decltype(std::declval<mutex_type&>().read())>;
+
+    auto m = make_mutex<T>();
+    std::optional<rw_holder_type> rw;
+    std::vector<std::optional<ro_holder_type>> ro(num_ro_accesses);
+
+    pika::chrono::detail::high_resolution_timer timer;
+
+    for (std::uint64_t i = 0; i < num_iterations; ++i)
+    {
+        rw.emplace(m.readwrite());
+        for (auto& r : ro) { r.emplace(m.read()); }
+
+        for (auto it = ro.rbegin(); it != ro.rend(); ++it) { ex::start((*it)->op_state); }
+        ex::start(rw->op_state);
+    }
+
+    return timer.elapsed();
+}
+
+template <typename T>
+void run_test(std::string const& name, std::uint64_t num_iterations,
+    std::uint64_t num_ro_accesses, std::uint64_t repetitions, bool perftest_json)
+{
+    double time_avg_s = 0.0;
+    double time_min_s = (std::numeric_limits<double>::max)();
+    double time_max_s = (std::numeric_limits<double>::min)();
+
+    for (std::uint64_t i = 0; i < repetitions; ++i)
+    {
+        double time_s = test_async_rw_mutex<T>(num_iterations, num_ro_accesses);
+
+        time_avg_s += time_s;
+        time_max_s = (std::max)(time_max_s, time_s);
+        time_min_s = (std::min)(time_min_s, time_s);
+    }
+
+    time_avg_s /= repetitions;
+
+    double const num_accesses = static_cast<double>(num_iterations * (num_ro_accesses + 1));
+    double const time_avg_ns = time_avg_s * 1e9 / num_accesses;
+    double const time_min_ns = time_min_s * 1e9 / num_accesses;
+    double const time_max_ns = time_max_s * 1e9 / num_accesses;
+
+    if (perftest_json)
+    {
+        pika::util::detail::json_perf_times t;
+        t.add(fmt::format("async_rw_mutex<{}> alternating - 1:{}", name, num_ro_accesses),
+            time_avg_ns);
+        std::cout << t;
+    }
+    else
+    {
+        fmt::print("{},{},{},{},{},{},{}\n", name, repetitions, num_iterations, num_ro_accesses,
+            time_avg_ns, time_min_ns, time_max_ns);
+    }
+}
+
+int pika_main(variables_map& vm)
+{
+    auto const num_iterations = vm["num-iterations"].as<std::uint64_t>();
+    auto const num_ro_accesses = vm["num-ro-accesses"].as<std::uint64_t>();
+    auto const repetitions = vm["repetitions"].as<std::uint64_t>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+
+    if (!perftest_json)
+    {
+        fmt::print("type,repetitions,iterations,ro_accesses,time_avg_ns,time_min_ns,time_max_ns\n");
+    }
+
+    run_test<void>("void", num_iterations, num_ro_accesses, repetitions, perftest_json);
+    run_test<std::size_t>("size_t", num_iterations, num_ro_accesses, repetitions, perftest_json);
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+    // clang-format off
+    cmdline.add_options()
+        ("num-iterations", value<std::uint64_t>()->default_value(100000), "number of read-write accesses, each followed by num-ro-accesses read-only accesses")
+        ("num-ro-accesses", value<std::uint64_t>()->default_value(4), "number of consecutive read-only accesses")
+        ("repetitions", value<std::uint64_t>()->default_value(1), "number of repetitions of the full benchmark")
+        ("perftest-json", bool_switch(), "print final task size in json format for use with performance CI.")
+        // clang-format on
+        ;
+
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+    return pika::init(pika_main, argc, argv, init_args);
+}
@@ -0,0 +1,309 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/async_channel.hpp>
+#include <pika/exception.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/testing.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+///////////////////////////////////////////////////////////////////////////////
+void test_try_send_receive()
+{
+    ex::async_channel<int> ch(2);
+    PIKA_TEST_EQ(ch.capacity(), std::size_t(2));
+    PIKA_TEST(!ch.try_receive());
+
+    PIKA_TEST(ch.try_send(1));
+    PIKA_TEST(ch.try_send(2));
+    PIKA_TEST(!ch.try_send(3));
+
+    // The value is not moved from if it could not be sent
+    auto p = std::make_unique<int>(42);
+    ex::async_channel<std::unique_ptr<int>> ch_ptr(1);
+    PIKA_TEST(ch_ptr.try_send(std::make_unique<int>(0)));
+    PIKA_TEST(!ch_ptr.try_send(std::move(p)));
+    PIKA_TEST(p);
+    PIKA_TEST_EQ(*ch_ptr.try_receive().value(), 0);
+    PIKA_TEST(ch_ptr.try_send(std::move(p)));
+    PIKA_TEST(!p);
+
+    PIKA_TEST_EQ(ch.try_receive().value(), 1);
+    PIKA_TEST(ch.try_send(3));
+    PIKA_TEST_EQ(ch.try_receive().value(), 2);
+    PIKA_TEST_EQ(ch.try_receive().value(), 3);
+    PIKA_TEST(!ch.try_receive());
+}
+
+void test_send_receive()
+{
+    ex::async_channel<int> ch(4);
+
+    for (int i = 0; i < 4; ++i) { PIKA_TEST(tt::sync_wait(ch.send(i))); }
+    for (int i = 0; i < 4; ++i) { PIKA_TEST_EQ(tt::sync_wait(ch.receive()).value(), i); }
+
+    PIKA_TEST(ch.blocking_send(4));
+    PIKA_TEST_EQ(ch.blocking_receive().value(), 4);
+}
+
+// Senders wait while the channel is full and are completed in order as space becomes available
+void test_waiting_senders()
+{
+    constexpr int num_values = 5;
+
+    ex::async_channel<int> ch(2);
+    std::atomic<int> num_sent{0};
+
+    std::vector<ex::unique_any_sender<>> senders;
+    for (int i = 0; i < num_values; ++i)
+    {
+        senders.emplace_back(ch.send(i) | ex::then([&](bool sent) {
+            PIKA_TEST(sent);
+            ++num_sent;
+        }) | ex::ensure_started());
+    }
+    PIKA_TEST_EQ(num_sent.load(), 2);
+
+    for (int i = 0; i < num_values; ++i)
+    {
+        PIKA_TEST_EQ(ch.try_receive().value(), i);
+        PIKA_TEST_EQ(num_sent.load(), (std::min)(i + 3, num_values));
+    }
+
+    tt::sync_wait(ex::when_all_vector(std::move(senders)));
+}
+
+// Receivers wait while the channel is empty and are completed in order as values become available
+void test_waiting_receivers()
+{
+    constexpr int num_values = 5;
+
+    ex::async_channel<int> ch(1);
+    std::vector<int> received;
+
+    std::vector<ex::unique_any_sender<>> senders;
+    for (int i = 0; i < num_values; ++i)
+    {
+        senders.emplace_back(ch.receive() | ex::then([&](std::optional<int> value) {
+            received.push_back(value.value());
+        }) | ex::ensure_started());
+    }
+    PIKA_TEST(received.empty());
+
+    for (int i = 0; i < num_values; ++i)
+    {
+        PIKA_TEST(ch.try_send(i * 10));
+        PIKA_TEST_EQ(received.size(), std::size_t(i + 1));
+    }
+
+    tt::sync_wait(ex::when_all_vector(std::move(senders)));
+    for (int i = 0; i < num_values; ++i) { PIKA_TEST_EQ(received[i], i * 10); }
+}
+
+void test_close()
+{
+    // Waiting receivers complete without a value
+    {
+        ex::async_channel<int> ch(1);
+        std::atomic<int> num_closed{0};
+
+        std::vector<ex::unique_any_sender<>> senders;
+        for (int i = 0; i < 3; ++i)
+        {
+            senders.emplace_back(ch.receive() | ex::then([&](std::optional<int> value) {
+                PIKA_TEST(!value);
+                ++num_closed;
+            }) | ex::ensure_started());
+        }
+        PIKA_TEST_EQ(num_closed.load(), 0);
+
+        PIKA_TEST(!ch.is_closed());
+        ch.close();
+        PIKA_TEST(ch.is_closed());
+        PIKA_TEST_EQ(num_closed.load(), 3);
+        tt::sync_wait(ex::when_all_vector(std::move(senders)));
+
+        // Closing again has no effect
+        ch.close();
+        PIKA_TEST(ch.is_closed());
+    }
+
+    // Waiting senders fail, values in the channel can still be received
+    {
+        ex::async_channel<int> ch(2);
+        PIKA_TEST(ch.try_send(1));
+        PIKA_TEST(ch.try_send(2));
+
+        std::atomic<int> num_failed{0};
+        auto s = ch.send(3) | ex::then([&](bool sent) {
+            PIKA_TEST(!sent);
+            ++num_failed;
+        }) | ex::ensure_started();
+        PIKA_TEST_EQ(num_failed.load(), 0);
+
+        ch.close();
+        PIKA_TEST_EQ(num_failed.load(), 1);
+        tt::sync_wait(std::move(s));
+
+        PIKA_TEST(!ch.try_send(4));
+        PIKA_TEST(!tt::sync_wait(ch.send(4)));
+        PIKA_TEST(!ch.blocking_send(4));
+
+        PIKA_TEST_EQ(ch.try_receive().value(), 1);
+        PIKA_TEST_EQ(tt::sync_wait(ch.receive()).value(), 2);
+        PIKA_TEST(!tt::sync_wait(ch.receive()));
+        PIKA_TEST(!ch.blocking_receive());
+        PIKA_TEST(!ch.try_receive());
+    }
+
+    // Values left in the channel are destroyed with the channel
+    {
+        auto p = std::make_shared<int>(0);
+        {
+            ex::async_channel<std::shared_ptr<int>> ch(3);
+            PIKA_TEST(ch.try_send(std::shared_ptr<int>(p)));
+            PIKA_TEST(ch.try_send(std::shared_ptr<int>(p)));
+            PIKA_TEST_EQ(p.use_count(), 3);
+        }
+        PIKA_TEST_EQ(p.use_count(), 1);
+    }
+}
+
+// Values reported as sent by sends racing with close are received before receiving fails
+void test_close_concurrent()
+{
+    constexpr std::size_t num_repetitions = 100;
+    constexpr std::size_t num_senders = 4;
+    constexpr std::size_t num_receivers = 2;
+
+    ex::thread_pool_scheduler sched{};
+    for (std::size_t repetition = 0; repetition < num_repetitions; ++repetition)
+    {
+        // The channel never fills up, so sends only fail when the channel is closed
+        ex::async_channel<std::size_t> ch(num_senders);
+        std::atomic<std::size_t> num_sent{0};
+        std::atomic<std::size_t> num_received{0};
+
+        std::vector<ex::unique_any_sender<>> senders;
+        for (std::size_t i = 0; i < num_receivers; ++i)
+        {
+            senders.emplace_back(ex::schedule(sched) | ex::then([&] {
+                while (ch.blocking_receive()) { ++num_received; }
+            }) | ex::ensure_started());
+        }
+        for (std::size_t i = 0; i < num_senders; ++i)
+        {
+            senders.emplace_back(ex::schedule(sched) | ex::then([&, i] {
+                if (ch.try_send(std::size_t(i))) { ++num_sent; }
+            }) | ex::ensure_started());
+        }
+        senders.emplace_back(
+            ex::schedule(sched) | ex::then([&] { ch.close(); }) | ex::ensure_started());
+        tt::sync_wait(ex::when_all_vector(std::move(senders)));
+
+        PIKA_TEST_EQ(num_received.load(), num_sent.load());
+        PIKA_TEST(!ch.try_receive());
+    }
+}
+
+void test_zero_capacity()
+{
+    bool exception_thrown = false;
+    try
+    {
+        ex::async_channel<int> ch(0);
+        PIKA_TEST(false);
+    }
+    catch (pika::exception const& e)
+    {
+        PIKA_TEST_EQ(e.get_error(), pika::error::bad_parameter);
+        exception_thrown = true;
+    }
+    PIKA_TEST(exception_thrown);
+}
+
+// Multiple producers and consumers with a small capacity, mixing blocking and sender-based
+// operations
+void test_mpmc()
+{
+    constexpr std::size_t num_producers = 4;
+    constexpr std::size_t num_consumers = 4;
+    constexpr std::size_t num_values_per_producer = 2000;
+
+    ex::async_channel<std::size_t> ch(8);
+    ex::thread_pool_scheduler sched{};
+    std::atomic<std::size_t> num_received{0};
+    std::atomic<std::size_t> sum_received{0};
+
+    std::vector<ex::unique_any_sender<>> producers;
+    for (std::size_t p = 0; p < num_producers; ++p)
+    {
+        producers.emplace_back(ex::schedule(sched) | ex::then([&, p] {
+            for (std::size_t i = 0; i < num_values_per_producer; ++i)
+            {
+                std::size_t value = p * num_values_per_producer + i;
+                if (p % 2 == 0) { PIKA_TEST(ch.blocking_send(value)); }
+                else { PIKA_TEST(tt::sync_wait(ch.send(value))); }
+            }
+        }) | ex::ensure_started());
+    }
+
+    std::vector<ex::unique_any_sender<>> consumers;
+    for (std::size_t c = 0; c < num_consumers; ++c)
+    {
+        consumers.emplace_back(ex::schedule(sched) | ex::then([&, c] {
+            for (;;)
+            {
+                auto value = c % 2 == 0 ? ch.blocking_receive() : tt::sync_wait(ch.receive());
+                if (!value) { break; }
+                ++num_received;
+                sum_received += *value;
+            }
+        }) | ex::ensure_started());
+    }
+
+    tt::sync_wait(ex::when_all_vector(std::move(producers)));
+    ch.close();
+    tt::sync_wait(ex::when_all_vector(std::move(consumers)));
+
+    constexpr std::size_t num_values = num_producers * num_values_per_producer;
+    PIKA_TEST_EQ(num_received.load(), num_values);
+    PIKA_TEST_EQ(sum_received.load(), num_values * (num_values - 1) / 2);
+}
+
+int pika_main()
+{
+    test_try_send_receive();
+    test_send_receive();
+    test_waiting_senders();
+    test_waiting_receivers();
+    test_close();
+    test_close_concurrent();
+    test_zero_capacity();
+    test_mpmc();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ_MSG(pika::init(pika_main, argc, argv), 0, "pika main exited with non-zero status");
+
+    return 0;
+}
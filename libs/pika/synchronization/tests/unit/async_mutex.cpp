@@ -0,0 +1,280 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/mutex.hpp>
+#include <pika/stop_token.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+// Receiver recording which completion signal has been called
+struct signal_receiver
+{
+    PIKA_STDEXEC_RECEIVER_CONCEPT
+
+    std::atomic<std::size_t>& num_values;
+    std::atomic<std::size_t>& num_stopped;
+    pika::latch& l;
+
+    template <typename E>
+    friend void tag_invoke(ex::set_error_t, signal_receiver&&, E&&) noexcept
+    {
+        PIKA_TEST(false);
+    }
+
+    friend void tag_invoke(ex::set_stopped_t, signal_receiver&& r) noexcept
+    {
+        ++r.num_stopped;
+        r.l.count_down(1);
+    }
+
+    // The guard unlocks the mutex when this returns
+    template <typename... Ts>
+    void set_value(Ts&&...) && noexcept
+    {
+        ++num_values;
+        l.count_down(1);
+    }
+
+    constexpr ex::empty_env get_env() const& noexcept { return {}; }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+void test_exclusion()
+{
+    constexpr std::size_t num_tasks = 100;
+
+    ex::async_mutex m;
+    ex::thread_pool_scheduler sched{};
+    std::size_t count = 0;
+    std::atomic<std::size_t> num_locked{0};
+    std::atomic<std::size_t> num_violations{0};
+
+    std::vector<ex::unique_any_sender<>> senders;
+    for (std::size_t i = 0; i < num_tasks; ++i)
+    {
+        senders.emplace_back(m.lock() | ex::continues_on(sched) |
+            ex::then([&](ex::async_mutex_guard) {
+                if (++num_locked != 1) { ++num_violations; }
+                pika::this_thread::yield();
+                ++count;
+                --num_locked;
+            }) |
+            ex::ensure_started());
+    }
+    tt::sync_wait(ex::when_all_vector(std::move(senders)));
+
+    PIKA_TEST_EQ(num_violations.load(), std::size_t(0));
+    PIKA_TEST_EQ(count, num_tasks);
+    PIKA_TEST(m.try_lock());
+    m.unlock();
+}
+
+void test_try_lock()
+{
+    ex::async_mutex m;
+
+    PIKA_TEST(m.try_lock());
+    PIKA_TEST(!m.try_lock());
+    m.unlock();
+
+    {
+        auto guard = tt::sync_wait(m.lock());
+        PIKA_TEST(!m.try_lock());
+
+        // Moving the guard does not unlock the mutex
+        auto guard2 = std::move(guard);
+        PIKA_TEST(!m.try_lock());
+    }
+
+    PIKA_TEST(m.try_lock());
+    m.unlock();
+}
+
+// Waiting operations acquire the mutex in the order in which they are started
+void test_fifo()
+{
+    constexpr std::size_t num_waiters = 10;
+
+    ex::async_mutex m;
+    std::vector<std::size_t> order;
+
+    auto guard = tt::sync_wait(m.lock());
+
+    std::vector<ex::unique_any_sender<>> senders;
+    for (std::size_t i = 0; i < num_waiters; ++i)
+    {
+        senders.emplace_back(m.lock() |
+            ex::then([&order, i](ex::async_mutex_guard) { order.push_back(i); }) |
+            ex::ensure_started());
+    }
+
+    PIKA_TEST(order.empty());
+    { [[maybe_unused]] auto released_guard = std::move(guard); }
+    tt::sync_wait(ex::when_all_vector(std::move(senders)));
+
+    PIKA_TEST_EQ(order.size(), num_waiters);
+    for (std::size_t i = 0; i < order.size(); ++i) { PIKA_TEST_EQ(order[i], i); }
+}
+
+// Releasing the mutex in the continuation of a waiter grants the next waiter only after the
+// continuation has returned, a long queue of waiters does not overflow the stack
+void test_many_waiters()
+{
+    constexpr std::size_t num_waiters = 50000;
+
+    ex::async_mutex m;
+    std::size_t count = 0;
+    pika::latch l(num_waiters + 1);
+
+    auto guard = tt::sync_wait(m.lock());
+    for (std::size_t i = 0; i < num_waiters; ++i)
+    {
+        ex::start_detached(m.lock() | ex::then([&](ex::async_mutex_guard g) {
+            ++count;
+            { [[maybe_unused]] auto released_guard = std::move(g); }
+            l.count_down(1);
+        }));
+    }
+
+    // The waiters are granted the mutex on a thread with a small stack
+    PIKA_TEST_EQ(count, std::size_t(0));
+    tt::sync_wait(ex::schedule(ex::with_stacksize(ex::thread_pool_scheduler{},
+                      pika::execution::thread_stacksize::small_)) |
+        ex::then([&] { [[maybe_unused]] auto released_guard = std::move(guard); }));
+    l.arrive_and_wait();
+
+    PIKA_TEST_EQ(count, num_waiters);
+    PIKA_TEST(m.try_lock());
+    m.unlock();
+}
+
+void test_stop()
+{
+    ex::async_mutex m;
+    std::atomic<std::size_t> num_values{0};
+    std::atomic<std::size_t> num_stopped{0};
+
+    // Stop requested before the operation is started
+    {
+        pika::latch l(1);
+        pika::stop_source ss;
+        ss.request_stop();
+
+        auto os = ex::connect(m.lock(ss.get_token()), signal_receiver{num_values, num_stopped, l});
+        ex::start(os);
+        l.wait();
+        PIKA_TEST_EQ(num_values.load(), std::size_t(0));
+        PIKA_TEST_EQ(num_stopped.load(), std::size_t(1));
+    }
+
+    // Stop requested while waiting for the mutex
+    {
+        num_stopped = 0;
+        pika::latch l(1);
+        pika::stop_source ss;
+
+        auto guard = tt::sync_wait(m.lock());
+        auto os = ex::connect(m.lock(ss.get_token()), signal_receiver{num_values, num_stopped, l});
+        ex::start(os);
+        PIKA_TEST_EQ(num_stopped.load(), std::size_t(0));
+
+        ss.request_stop();
+        l.wait();
+        PIKA_TEST_EQ(num_values.load(), std::size_t(0));
+        PIKA_TEST_EQ(num_stopped.load(), std::size_t(1));
+    }
+
+    // The stopped operation did not take the lock
+    PIKA_TEST(m.try_lock());
+    m.unlock();
+
+    // Stop requested after the mutex has been locked
+    {
+        num_stopped = 0;
+        pika::latch l(1);
+        pika::stop_source ss;
+
+        auto os = ex::connect(m.lock(ss.get_token()), signal_receiver{num_values, num_stopped, l});
+        ex::start(os);
+        l.wait();
+        ss.request_stop();
+        PIKA_TEST_EQ(num_values.load(), std::size_t(1));
+        PIKA_TEST_EQ(num_stopped.load(), std::size_t(0));
+    }
+}
+
+// Stop requests racing with the mutex being locked and unlocked
+void test_stop_concurrent()
+{
+    constexpr std::size_t num_tasks = 100;
+
+    using operation_state_type =
+        decltype(ex::connect(std::declval<ex::async_mutex&>().lock(pika::stop_token{}),
+            std::declval<signal_receiver>()));
+    struct operation_state_holder
+    {
+        operation_state_type os;
+    };
+
+    ex::async_mutex m;
+    ex::thread_pool_scheduler sched{};
+    std::vector<pika::stop_source> stop_sources(num_tasks);
+    std::atomic<std::size_t> num_values{0};
+    std::atomic<std::size_t> num_stopped{0};
+    pika::latch l(num_tasks);
+
+    std::vector<std::unique_ptr<operation_state_holder>> op_states;
+    std::vector<ex::unique_any_sender<>> senders;
+    for (std::size_t i = 0; i < num_tasks; ++i)
+    {
+        op_states.emplace_back(new operation_state_holder{ex::connect(
+            m.lock(stop_sources[i].get_token()), signal_receiver{num_values, num_stopped, l})});
+        auto& os = op_states.back()->os;
+        senders.emplace_back(
+            ex::schedule(sched) | ex::then([&os] { ex::start(os); }) | ex::ensure_started());
+        senders.emplace_back(ex::schedule(sched) |
+            ex::then([&, i] { stop_sources[i].request_stop(); }) | ex::ensure_started());
+    }
+    tt::sync_wait(ex::when_all_vector(std::move(senders)));
+    l.wait();
+
+    PIKA_TEST_EQ(num_values + num_stopped, num_tasks);
+    PIKA_TEST(m.try_lock());
+    m.unlock();
+}
+
+int pika_main()
+{
+    test_exclusion();
+    test_try_lock();
+    test_fifo();
+    test_many_waiters();
+    test_stop();
+    test_stop_concurrent();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ_MSG(pika::init(pika_main, argc, argv), 0, "pika main exited with non-zero status");
+
+    return 0;
+}
@@ -14,6 +14,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdlib>
+#include <memory>
 #include <random>
 #include <type_traits>
 #include <utility>
@@ -280,6 +281,78 @@ void test_multiple_when_all(async_rw_mutex<ReadWriteT, ReadT> rwm)
     }
 }
 
+// Allocator counting the allocations and deallocations of shared states
+std::atomic<std::size_t> num_allocations{0};
+std::atomic<std::size_t> num_deallocations{0};
+
+template <typename T = int>
+struct counting_allocator
+{
+    using value_type = T;
+
+    counting_allocator() = default;
+
+    template <typename U>
+    counting_allocator(counting_allocator<U> const&) noexcept
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        ++num_allocations;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        ++num_deallocations;
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    friend bool operator==(counting_allocator const&, counting_allocator const&) { return true; }
+    friend bool operator!=(counting_allocator const&, counting_allocator const&) { return false; }
+};
+
+template <typename ReadWriteT>
+void test_recycled_states()
+{
+    num_allocations = 0;
+    num_deallocations = 0;
+
+    {
+        auto rwm = [] {
+            if constexpr (std::is_void_v<ReadWriteT>)
+            {
+                return async_rw_mutex<void, void, counting_allocator<>>{};
+            }
+            else { return async_rw_mutex<ReadWriteT, ReadWriteT, counting_allocator<>>{0}; }
+        }();
+
+        auto alternate_accesses = [&] {
+            sync_wait(rwm.readwrite() | then([](auto) {}));
+            sync_wait(when_all(rwm.read(), rwm.read()) | then([](auto, auto) {}));
+        };
+
+        // Once the first accesses have been released their shared states are
+        // reused for later accesses
+        for (std::size_t i = 0; i < 3; ++i) { alternate_accesses(); }
+        std::size_t const num_allocations_warmup = num_allocations;
+        for (std::size_t i = 0; i < 100; ++i) { alternate_accesses(); }
+        PIKA_TEST_EQ(num_allocations.load(), num_allocations_warmup);
+
+        if constexpr (!std::is_void_v<ReadWriteT>)
+        {
+            sync_wait(rwm.readwrite() | then([](auto x) { ++x.get(); }));
+            PIKA_TEST_EQ(
+                sync_wait(rwm.read() | then([](auto x) { return x.get(); })), ReadWriteT(1));
+        }
+    }
+
+    // All shared states are freed when the mutex and all accesses have been
+    // released
+    PIKA_TEST_EQ(num_deallocations.load(), num_allocations.load());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 int pika_main(pika::program_options::variables_map& vm)
 {
@@ -318,6 +391,9 @@ int pika_main(pika::program_options::variables_map& vm)
     test_multiple_when_all(async_rw_mutex<std::size_t>{0});
     test_multiple_when_all(async_rw_mutex<mytype, mytype_base>{mytype{}});
 
+    test_recycled_states<void>();
+    test_recycled_states<std::size_t>();
+
     pika::finalize();
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,206 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/semaphore.hpp>
+#include <pika/stop_token.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+// Receiver recording which completion signal has been called
+struct signal_receiver
+{
+    PIKA_STDEXEC_RECEIVER_CONCEPT
+
+    std::atomic<std::size_t>& num_values;
+    std::atomic<std::size_t>& num_stopped;
+    pika::latch& l;
+
+    template <typename E>
+    friend void tag_invoke(ex::set_error_t, signal_receiver&&, E&&) noexcept
+    {
+        PIKA_TEST(false);
+    }
+
+    friend void tag_invoke(ex::set_stopped_t, signal_receiver&& r) noexcept
+    {
+        ++r.num_stopped;
+        r.l.count_down(1);
+    }
+
+    // The guard releases the unit when this returns
+    template <typename... Ts>
+    void set_value(Ts&&...) && noexcept
+    {
+        ++num_values;
+        l.count_down(1);
+    }
+
+    constexpr ex::empty_env get_env() const& noexcept { return {}; }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+void test_bounded_concurrency()
+{
+    constexpr std::size_t num_tasks = 100;
+    constexpr std::ptrdiff_t max_concurrency = 3;
+
+    ex::async_counting_semaphore<> sem(max_concurrency);
+    ex::thread_pool_scheduler sched{};
+    std::atomic<std::ptrdiff_t> num_acquired{0};
+    std::atomic<std::ptrdiff_t> max_acquired{0};
+    std::atomic<std::size_t> count{0};
+
+    std::vector<ex::unique_any_sender<>> senders;
+    for (std::size_t i = 0; i < num_tasks; ++i)
+    {
+        senders.emplace_back(sem.acquire() | ex::continues_on(sched) |
+            ex::then([&](ex::async_semaphore_guard) {
+                std::ptrdiff_t n = ++num_acquired;
+                std::ptrdiff_t max = max_acquired.load();
+                while (n > max && !max_acquired.compare_exchange_weak(max, n)) {}
+                pika::this_thread::yield();
+                ++count;
+                --num_acquired;
+            }) |
+            ex::ensure_started());
+    }
+    tt::sync_wait(ex::when_all_vector(std::move(senders)));
+
+    PIKA_TEST_EQ(count.load(), num_tasks);
+    PIKA_TEST_LTE(max_acquired.load(), max_concurrency);
+    for (std::ptrdiff_t i = 0; i < max_concurrency; ++i) { PIKA_TEST(sem.try_acquire()); }
+    PIKA_TEST(!sem.try_acquire());
+    sem.release(max_concurrency);
+}
+
+void test_try_acquire()
+{
+    ex::async_counting_semaphore<2> sem(2);
+    PIKA_TEST_EQ((ex::async_counting_semaphore<2>::max)(), std::ptrdiff_t(2));
+
+    PIKA_TEST(sem.try_acquire());
+    PIKA_TEST(sem.try_acquire());
+    PIKA_TEST(!sem.try_acquire());
+    sem.release(2);
+
+    {
+        auto guard = tt::sync_wait(sem.acquire());
+        PIKA_TEST(sem.try_acquire());
+        PIKA_TEST(!sem.try_acquire());
+        sem.release();
+    }
+
+    PIKA_TEST(sem.try_acquire());
+    PIKA_TEST(sem.try_acquire());
+    sem.release(2);
+}
+
+// Releasing multiple units completes as many waiting operations, in the order in which they were
+// started
+void test_release_many()
+{
+    constexpr std::size_t num_waiters = 5;
+
+    ex::async_counting_semaphore<> sem(0);
+    std::vector<std::size_t> order;
+
+    std::vector<ex::unique_any_sender<>> senders;
+    for (std::size_t i = 0; i < num_waiters; ++i)
+    {
+        senders.emplace_back(sem.acquire() | ex::then([&order, i](ex::async_semaphore_guard g) {
+            // The semaphore is used for signalling, the units are not released again
+            g.dismiss();
+            order.push_back(i);
+        }) | ex::ensure_started());
+    }
+    PIKA_TEST(order.empty());
+
+    sem.release(3);
+    PIKA_TEST_EQ(order.size(), std::size_t(3));
+
+    sem.release(2);
+    PIKA_TEST_EQ(order.size(), num_waiters);
+    PIKA_TEST(!sem.try_acquire());
+
+    tt::sync_wait(ex::when_all_vector(std::move(senders)));
+    for (std::size_t i = 0; i < order.size(); ++i) { PIKA_TEST_EQ(order[i], i); }
+}
+
+void test_stop()
+{
+    ex::async_binary_semaphore sem(0);
+    std::atomic<std::size_t> num_values{0};
+    std::atomic<std::size_t> num_stopped{0};
+
+    // Stop requested while waiting for a unit
+    {
+        pika::latch l(1);
+        pika::stop_source ss;
+
+        auto os =
+            ex::connect(sem.acquire(ss.get_token()), signal_receiver{num_values, num_stopped, l});
+        ex::start(os);
+        PIKA_TEST_EQ(num_stopped.load(), std::size_t(0));
+
+        ss.request_stop();
+        l.wait();
+        PIKA_TEST_EQ(num_values.load(), std::size_t(0));
+        PIKA_TEST_EQ(num_stopped.load(), std::size_t(1));
+    }
+
+    // The stopped operation did not take the released unit
+    sem.release();
+    PIKA_TEST(sem.try_acquire());
+    PIKA_TEST(!sem.try_acquire());
+
+    // A waiting operation is completed when a unit is released from another thread
+    {
+        pika::latch l(1);
+        pika::stop_source ss;
+
+        auto os =
+            ex::connect(sem.acquire(ss.get_token()), signal_receiver{num_values, num_stopped, l});
+        ex::start(os);
+
+        tt::sync_wait(ex::schedule(ex::thread_pool_scheduler{}) | ex::then([&] { sem.release(); }));
+        l.wait();
+        ss.request_stop();
+        PIKA_TEST_EQ(num_values.load(), std::size_t(1));
+        PIKA_TEST_EQ(num_stopped.load(), std::size_t(1));
+    }
+
+    PIKA_TEST(sem.try_acquire());
+}
+
+int pika_main()
+{
+    test_bounded_concurrency();
+    test_try_acquire();
+    test_release_many();
+    test_stop();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ_MSG(pika::init(pika_main, argc, argv), 0, "pika main exited with non-zero status");
+
+    return 0;
+}
@@ -16,6 +16,8 @@
 #include <pika/testing.hpp>
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -251,6 +253,83 @@ struct test_timedlock
     }
 };
 
+template <typename M>
+struct test_contended_lock
+{
+    using mutex_type = M;
+    using lock_type = std::unique_lock<M>;
+
+    static constexpr std::size_t num_threads = 16;
+    static constexpr std::size_t num_iterations = 1000;
+
+    void operator()()
+    {
+        mutex_type mx;
+        std::size_t counter = 0;
+
+        // Some critical sections suspend or sleep for longer than the handoff
+        // threshold so that waiting threads are resumed, handed the mutex, and
+        // compete with running threads for it
+        std::vector<pika::thread> threads;
+        for (std::size_t i = 0; i < num_threads; ++i)
+        {
+            threads.emplace_back([&, i] {
+                for (std::size_t j = 0; j < num_iterations; ++j)
+                {
+                    lock_type lock(mx);
+                    ++counter;
+                    if (j % 100 == i)
+                    {
+                        pika::this_thread::sleep_for(std::chrono::milliseconds(2));
+                    }
+                    else if (j % 10 == 0) { pika::this_thread::yield(); }
+                }
+            });
+        }
+        for (auto& t : threads) { t.join(); }
+
+        PIKA_TEST_EQ(counter, num_threads * num_iterations);
+    }
+};
+
+// Gives access to the number of iterations pika::mutex spins for on average
+struct spin_count_mutex : pika::mutex
+{
+    std::uint32_t get_spin_count() const { return spin_count_.load(); }
+    void set_spin_count(std::uint32_t spin_count) { spin_count_.store(spin_count); }
+};
+
+// Spinning on a mutex protecting long critical sections fails, which lowers
+// the spin limit
+void test_spin_count_decay()
+{
+    static constexpr std::size_t num_threads = 4;
+    static constexpr std::size_t num_iterations = 5;
+    static constexpr std::uint32_t initial_spin_count = 40;
+
+    spin_count_mutex mx;
+    mx.set_spin_count(initial_spin_count);
+
+    for (std::size_t i = 0; i < num_iterations; ++i)
+    {
+        std::unique_lock<spin_count_mutex> lock(mx);
+
+        std::vector<pika::thread> threads;
+        for (std::size_t j = 0; j < num_threads; ++j)
+        {
+            threads.emplace_back([&] { std::lock_guard<spin_count_mutex> l(mx); });
+        }
+
+        // The waiting threads give up spinning while the lock is held
+        pika::this_thread::sleep_for(std::chrono::milliseconds(10));
+        lock.unlock();
+
+        for (auto& t : threads) { t.join(); }
+    }
+
+    PIKA_TEST_LT(mx.get_spin_count(), initial_spin_count);
+}
+
 template <typename M>
 struct test_recursive_lock
 {
@@ -269,6 +348,8 @@ void test_mutex()
 {
     test_lock<pika::mutex>()();
     test_trylock<pika::mutex>()();
+    test_contended_lock<pika::mutex>()();
+    test_spin_count_decay();
 }
 
 void test_timed_mutex()
@@ -276,6 +357,7 @@ void test_timed_mutex()
     test_lock<pika::timed_mutex>()();
     test_trylock<pika::timed_mutex>()();
     test_timedlock<pika::timed_mutex>()();
+    test_contended_lock<pika::timed_mutex>()();
 }
 
 //void test_recursive_mutex()
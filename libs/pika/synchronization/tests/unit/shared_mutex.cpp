@@ -0,0 +1,180 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/mutex.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+using preference = pika::shared_mutex::preference;
+
+///////////////////////////////////////////////////////////////////////////////
+// Writers update both values under an exclusive lock, readers check that they
+// never observe a partial update.
+void test_exclusion(preference p)
+{
+    constexpr std::size_t num_tasks = 64;
+    constexpr std::size_t num_iterations = 500;
+
+    pika::shared_mutex mtx(p);
+    std::size_t value1 = 0;
+    std::size_t value2 = 0;
+    std::atomic<std::size_t> num_inconsistent_reads(0);
+
+    auto sched = ex::thread_pool_scheduler{};
+    std::vector<ex::unique_any_sender<>> results;
+    for (std::size_t i = 0; i != num_tasks; ++i)
+    {
+        results.emplace_back(ex::schedule(sched) | ex::then([&, i] {
+            for (std::size_t j = 0; j != num_iterations; ++j)
+            {
+                if (i % 4 == 0)
+                {
+                    std::unique_lock<pika::shared_mutex> l(mtx);
+                    ++value1;
+                    pika::this_thread::yield();
+                    ++value2;
+                }
+                else
+                {
+                    std::shared_lock<pika::shared_mutex> l(mtx);
+                    std::size_t const v = value1;
+                    pika::this_thread::yield();
+                    if (v != value2) { ++num_inconsistent_reads; }
+                }
+            }
+        }) | ex::ensure_started());
+    }
+    tt::sync_wait(ex::when_all_vector(std::move(results)));
+
+    PIKA_TEST_EQ(num_inconsistent_reads.load(), std::size_t(0));
+    PIKA_TEST_EQ(value1, num_tasks / 4 * num_iterations);
+    PIKA_TEST_EQ(value2, num_tasks / 4 * num_iterations);
+}
+
+// Shared locks do not exclude each other
+void test_concurrent_readers(preference p)
+{
+    constexpr std::size_t num_tasks = 16;
+
+    pika::shared_mutex mtx(p);
+    std::atomic<std::size_t> num_readers(0);
+
+    auto sched = ex::thread_pool_scheduler{};
+    std::vector<ex::unique_any_sender<>> results;
+    for (std::size_t i = 0; i != num_tasks; ++i)
+    {
+        results.emplace_back(ex::schedule(sched) | ex::then([&] {
+            std::shared_lock<pika::shared_mutex> l(mtx);
+            ++num_readers;
+            // All readers hold the lock at the same time
+            while (num_readers.load() != num_tasks) { pika::this_thread::yield(); }
+        }) | ex::ensure_started());
+    }
+    tt::sync_wait(ex::when_all_vector(std::move(results)));
+
+    PIKA_TEST_EQ(num_readers.load(), num_tasks);
+}
+
+void test_try_lock(preference p)
+{
+    pika::shared_mutex mtx(p);
+
+    PIKA_TEST(mtx.try_lock());
+    PIKA_TEST(!mtx.try_lock());
+    PIKA_TEST(!mtx.try_lock_shared());
+    mtx.unlock();
+
+    PIKA_TEST(mtx.try_lock_shared());
+    PIKA_TEST(mtx.try_lock_shared());
+    PIKA_TEST(!mtx.try_lock());
+    mtx.unlock_shared();
+    PIKA_TEST(!mtx.try_lock());
+    mtx.unlock_shared();
+
+    PIKA_TEST(mtx.try_lock());
+    mtx.unlock();
+}
+
+// A shared lock may be released on a different worker thread than the one it
+// was acquired on
+void test_unlock_shared_elsewhere(preference p)
+{
+    pika::shared_mutex mtx(p);
+    auto sched = ex::thread_pool_scheduler{};
+
+    for (std::size_t i = 0; i != 100; ++i)
+    {
+        mtx.lock_shared();
+        tt::sync_wait(ex::schedule(sched) | ex::then([&] { mtx.unlock_shared(); }));
+        PIKA_TEST(mtx.try_lock());
+        mtx.unlock();
+    }
+}
+
+// A waiting writer blocks new readers only with preference::writers
+void test_preference(preference p)
+{
+    pika::shared_mutex mtx(p);
+    std::atomic<bool> writer_done(false);
+
+    mtx.lock_shared();
+
+    auto writer = ex::schedule(ex::thread_pool_scheduler{}) | ex::then([&] {
+        std::unique_lock<pika::shared_mutex> l(mtx);
+        writer_done = true;
+    }) | ex::ensure_started();
+
+    // Give the writer time to start waiting
+    pika::this_thread::sleep_for(std::chrono::milliseconds(100));
+    PIKA_TEST(!writer_done.load());
+
+    bool const acquired = mtx.try_lock_shared();
+    if (p == preference::writers) { PIKA_TEST(!acquired); }
+    else
+    {
+        PIKA_TEST(acquired);
+        mtx.unlock_shared();
+    }
+
+    mtx.unlock_shared();
+    tt::sync_wait(std::move(writer));
+    PIKA_TEST(writer_done.load());
+}
+
+int pika_main()
+{
+    for (auto p : {preference::writers, preference::readers})
+    {
+        test_exclusion(p);
+        test_concurrent_readers(p);
+        test_try_lock(p);
+        test_unlock_shared_elsewhere(p);
+        test_preference(p);
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ_MSG(pika::init(pika_main, argc, argv), 0, "pika main exited with non-zero status");
+    return 0;
+}
@@ -0,0 +1,223 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test verifies that timed waits on the synchronization primitives time
+// out, return early when notified, and that a waiting thread is resumed
+// exactly once by either the notification or the timeout.
+
+#include <pika/barrier.hpp>
+#include <pika/condition_variable.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/mutex.hpp>
+#include <pika/semaphore.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using pika::threads::detail::thread_restart_state;
+
+void test_condition_variable_timeout()
+{
+    pika::mutex mtx;
+    pika::condition_variable cv;
+
+    std::unique_lock<pika::mutex> l(mtx);
+    auto const start = std::chrono::steady_clock::now();
+    PIKA_TEST(cv.wait_for(l, 20ms) == pika::cv_status::timeout);
+    PIKA_TEST(std::chrono::steady_clock::now() - start >= 20ms);
+    PIKA_TEST(l.owns_lock());
+}
+
+void test_condition_variable_notify()
+{
+    pika::mutex mtx;
+    pika::condition_variable cv;
+    bool ready = false;
+
+    pika::thread t([&] {
+        pika::this_thread::sleep_for(10ms);
+        std::lock_guard<pika::mutex> l(mtx);
+        ready = true;
+        cv.notify_one();
+    });
+
+    auto const start = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<pika::mutex> l(mtx);
+        PIKA_TEST(cv.wait_for(l, 60s, [&] { return ready; }));
+    }
+    PIKA_TEST(std::chrono::steady_clock::now() - start < 30s);
+
+    t.join();
+}
+
+void test_condition_variable_exactly_once()
+{
+    // Notifications and timeouts race with each other. A waiter must not be
+    // resumed a second time after having returned from the wait, which would
+    // show up as a spurious wakeup of the suspension following the wait.
+    constexpr std::size_t num_waiters = 1000;
+
+    pika::mutex mtx;
+    pika::condition_variable cv;
+    std::atomic<std::size_t> num_spurious{0};
+    std::atomic<bool> done{false};
+    pika::latch l(num_waiters + 1);
+
+    for (std::size_t i = 0; i != num_waiters; ++i)
+    {
+        pika::thread([&, i] {
+            {
+                std::unique_lock<pika::mutex> lk(mtx);
+                cv.wait_for(lk, std::chrono::microseconds(100 * (i % 50)));
+            }
+
+            if (pika::this_thread::suspend(5ms) != thread_restart_state::timeout)
+            {
+                ++num_spurious;
+            }
+            l.count_down(1);
+        }).detach();
+    }
+
+    pika::thread notifier([&] {
+        while (!done)
+        {
+            cv.notify_one();
+            pika::this_thread::yield();
+        }
+    });
+
+    l.arrive_and_wait();
+    done = true;
+    notifier.join();
+
+    PIKA_TEST_EQ(num_spurious.load(), std::size_t(0));
+}
+
+void test_timed_mutex()
+{
+    pika::timed_mutex mtx;
+    mtx.lock();
+
+    pika::thread t1([&] { PIKA_TEST(!mtx.try_lock_for(10ms)); });
+    t1.join();
+
+    pika::thread t2([&] {
+        PIKA_TEST(mtx.try_lock_for(60s));
+        mtx.unlock();
+    });
+    pika::this_thread::sleep_for(10ms);
+    mtx.unlock();
+    t2.join();
+}
+
+void test_counting_semaphore()
+{
+    pika::counting_semaphore<> sem(0);
+
+    auto const start = std::chrono::steady_clock::now();
+    PIKA_TEST(!sem.try_acquire_for(10ms));
+    PIKA_TEST(std::chrono::steady_clock::now() - start >= 10ms);
+
+    pika::thread t([&] {
+        pika::this_thread::sleep_for(10ms);
+        sem.release();
+    });
+    PIKA_TEST(sem.try_acquire_for(60s));
+    t.join();
+}
+
+void test_latch()
+{
+    pika::latch l(1);
+    PIKA_TEST(!l.try_wait_for(10ms));
+
+    pika::thread t([&] {
+        pika::this_thread::sleep_for(10ms);
+        l.count_down(1);
+    });
+    PIKA_TEST(l.try_wait_for(60s));
+    t.join();
+}
+
+void test_barrier()
+{
+    pika::barrier<> b(2);
+    auto token = b.arrive();
+    auto token_copy = token;
+    PIKA_TEST(!b.try_wait_for(std::move(token_copy), 10ms));
+
+    pika::thread t([&] {
+        pika::this_thread::sleep_for(10ms);
+        b.arrive_and_drop();
+    });
+    auto const start = std::chrono::steady_clock::now();
+    PIKA_TEST(b.try_wait_for(std::move(token), 60s));
+    PIKA_TEST(std::chrono::steady_clock::now() - start < 30s);
+    t.join();
+}
+
+void test_barrier_phases()
+{
+    // Timed waiters park on the barrier and are woken up at the end of each
+    // phase
+    constexpr std::size_t num_threads = 4;
+    constexpr std::size_t num_phases = 100;
+    pika::barrier<> b(num_threads);
+
+    auto const start = std::chrono::steady_clock::now();
+    std::vector<pika::thread> threads;
+    for (std::size_t i = 0; i != num_threads; ++i)
+    {
+        threads.emplace_back([&] {
+            for (std::size_t phase = 0; phase != num_phases; ++phase)
+            {
+                PIKA_TEST(b.try_wait_for(b.arrive(), 60s));
+            }
+        });
+    }
+    for (auto& t : threads) { t.join(); }
+    PIKA_TEST(std::chrono::steady_clock::now() - start < 30s);
+
+    // Outside of pika threads timed waits poll the phase
+    pika::barrier<> b2(2);
+    std::thread t([&] { PIKA_TEST(b2.try_wait_for(b2.arrive(), 60s)); });
+    pika::this_thread::sleep_for(10ms);
+    b2.arrive_and_drop();
+    t.join();
+}
+
+int pika_main()
+{
+    test_condition_variable_timeout();
+    test_condition_variable_notify();
+    test_condition_variable_exactly_once();
+    test_timed_mutex();
+    test_counting_semaphore();
+    test_latch();
+    test_barrier();
+    test_barrier_phases();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv), 0);
+    return 0;
+}
@@ -14,6 +14,10 @@
 #include <pika/modules/errors.hpp>
 #include <pika/resource_partitioner/detail/partitioner.hpp>
 #include <pika/runtime_configuration/runtime_configuration.hpp>
+#include <pika/thread_manager/elasticity_controller.hpp>
+#include <pika/thread_manager/metrics_exporter.hpp>
+#include <pika/thread_manager/task_tracer.hpp>
+#include <pika/thread_manager/task_watchdog.hpp>
 #include <pika/thread_manager/thread_manager_fwd.hpp>
 #include <pika/thread_pools/scheduled_thread_pool.hpp>
 #include <pika/threading_base/scheduler_mode.hpp>
@@ -165,6 +169,10 @@ namespace pika::threads::detail {
 
         std::int64_t get_idle_core_count();
 
+        /// \brief return the number of tasks reported by the task watchdog for
+        ///        running longer than pika.watchdog.budget without yielding
+        std::int64_t get_long_running_task_count() const;
+
         mask_type get_idle_core_mask();
 
         // Enumerate all matching threads
@@ -347,6 +355,22 @@ namespace pika::threads::detail {
         pool_vector pools_;
 
         notification_policy_type& notifier_;
+
+        // Suspends and resumes processing units based on the load, only
+        // created when pika.elasticity.enable is set
+        std::unique_ptr<elasticity_controller> elasticity_controller_;
+
+        // Reports tasks running for too long without yielding, only created
+        // when pika.watchdog.enable is set
+        std::unique_ptr<task_watchdog> task_watchdog_;
+
+        // Periodically writes the scheduler metrics to a file, only created
+        // when pika.metrics.file is set
+        std::unique_ptr<metrics_exporter> metrics_exporter_;
+
+        // Records task execution and writes it to a trace file, only created
+        // when pika.trace.file is set
+        std::unique_ptr<task_tracer> task_tracer_;
     };
 }    // namespace pika::threads::detail
 
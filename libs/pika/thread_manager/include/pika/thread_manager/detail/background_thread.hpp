@@ -0,0 +1,67 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/functional/unique_function.hpp>
+#include <pika/runtime_configuration/runtime_configuration.hpp>
+#include <pika/util/get_entry_as.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace pika::threads::detail {
+    /// A thread, separate from the worker threads, which calls a function
+    /// periodically until it is stopped. Used by the components of the thread
+    /// manager which observe or control the thread pools from the outside.
+    class background_thread
+    {
+    public:
+        background_thread() = default;
+        ~background_thread();
+
+        background_thread(background_thread const&) = delete;
+        background_thread(background_thread&&) = delete;
+        background_thread& operator=(background_thread const&) = delete;
+        background_thread& operator=(background_thread&&) = delete;
+
+        /// Start calling f every interval on a new thread. The thread must not
+        /// be running.
+        void start(std::chrono::milliseconds interval, util::detail::unique_function<void()> f);
+
+        /// Stop the thread and wait for the current call of the function to
+        /// finish. Returns false if the thread was not running.
+        bool stop();
+
+        bool running() const noexcept { return thread_.joinable(); }
+
+    private:
+        void run();
+
+        std::chrono::milliseconds interval_{0};
+        util::detail::unique_function<void()> f_;
+
+        std::mutex mtx_;
+        std::condition_variable cond_;
+        bool stop_requested_ = false;
+        std::thread thread_;
+    };
+
+    /// Return the value of the given runtime configuration entry, or the
+    /// default value if it is not set, clamped to be at least one. Used for
+    /// intervals and sizes which must not be zero.
+    template <typename T>
+    T get_positive_entry_as(
+        pika::util::runtime_configuration const& rtcfg, std::string const& key, T default_value)
+    {
+        return (std::max)(T(1), pika::detail::get_entry_as<T>(rtcfg, key, default_value));
+    }
+}    // namespace pika::threads::detail
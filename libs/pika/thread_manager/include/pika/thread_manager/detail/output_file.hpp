@@ -0,0 +1,35 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/functional/function.hpp>
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace pika::threads::detail {
+    enum class escape_format
+    {
+        /// Escape a label value of the OpenMetrics text format
+        openmetrics,
+        /// Escape the contents of a JSON string literal
+        json,
+    };
+
+    /// Escape backslashes, double quotes, and line breaks or, for JSON, all
+    /// control characters in value
+    std::string escape_string(std::string_view value, escape_format format);
+
+    /// Write a file with the contents written by write to the stream. The
+    /// contents are first written to a temporary file which then replaces
+    /// file, so that readers polling the file never see partially written
+    /// contents. Failures are logged as warnings prefixed by component.
+    void write_file_atomically(std::string const& file, char const* component,
+        util::detail::function<void(std::ostream&)> const& write);
+}    // namespace pika::threads::detail
@@ -0,0 +1,94 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/runtime_configuration/runtime_configuration.hpp>
+#include <pika/thread_manager/detail/background_thread.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pika::threads::detail {
+    /// Parameters of the elasticity controller, see the [pika.elasticity]
+    /// section of the runtime configuration.
+    struct elasticity_parameters
+    {
+        /// Time between two samples of the thread pools
+        std::chrono::milliseconds interval{100};
+        /// Number of pending threads per active processing unit above which a
+        /// pool is considered overloaded
+        std::int64_t high_queue_length = 4;
+        /// Number of pending threads per active processing unit at or below
+        /// which a pool with idle processing units is considered underloaded
+        std::int64_t low_queue_length = 0;
+        /// Number of consecutive overloaded or underloaded samples required
+        /// before a processing unit is resumed or suspended
+        std::size_t hysteresis = 3;
+        /// Minimum number of processing units kept active in each pool
+        std::size_t min_threads = 1;
+
+        static elasticity_parameters from_config(pika::util::runtime_configuration const& rtcfg);
+    };
+
+    /// The elasticity controller periodically samples the queue lengths and
+    /// idle processing units of all thread pools that have
+    /// scheduler_mode::enable_elasticity set, and suspends or resumes single
+    /// processing units of those pools to track the load. A processing unit is
+    /// suspended after the pool has been underloaded for hysteresis
+    /// consecutive samples, and a processing unit suspended by the controller
+    /// is resumed after the pool has been overloaded for hysteresis
+    /// consecutive samples. Processing units suspended by other means are
+    /// never resumed by the controller. All decisions are logged at info
+    /// level.
+    ///
+    /// The controller does not wait for a processing unit to be suspended,
+    /// which happens only once the processing unit has no more work. The pool
+    /// is not sampled until then.
+    class elasticity_controller
+    {
+    public:
+        using pool_vector = std::vector<std::unique_ptr<thread_pool_base>>;
+
+        elasticity_controller(pool_vector const& pools, elasticity_parameters const& params);
+        ~elasticity_controller();
+
+        elasticity_controller(elasticity_controller const&) = delete;
+        elasticity_controller(elasticity_controller&&) = delete;
+        elasticity_controller& operator=(elasticity_controller const&) = delete;
+        elasticity_controller& operator=(elasticity_controller&&) = delete;
+
+        /// Start sampling the thread pools on a separate thread
+        void start();
+
+        /// Stop sampling the thread pools and resume all processing units
+        /// suspended by the controller
+        void stop();
+
+    private:
+        struct pool_data
+        {
+            // Processing units currently suspended by the controller
+            std::vector<bool> suspended;
+            std::size_t overloaded_samples = 0;
+            std::size_t underloaded_samples = 0;
+        };
+
+        void sample(thread_pool_base& pool, pool_data& data);
+        void resume_all();
+
+        pool_vector const& pools_;
+        elasticity_parameters const params_;
+        std::vector<pool_data> pool_data_;
+
+        background_thread thread_;
+    };
+}    // namespace pika::threads::detail
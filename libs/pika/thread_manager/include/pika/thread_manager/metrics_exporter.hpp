@@ -0,0 +1,85 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/runtime_configuration/runtime_configuration.hpp>
+#include <pika/thread_manager/detail/background_thread.hpp>
+#include <pika/threading_base/detail/scheduler_counters.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pika::threads::detail {
+    /// Parameters of the metrics exporter, see the [pika.metrics] section of
+    /// the runtime configuration and the --pika:metrics-file and
+    /// --pika:metrics-interval command line options.
+    struct metrics_exporter_parameters
+    {
+        /// The file the metrics are written to, the exporter is disabled if
+        /// empty
+        std::string file;
+        /// Time between two snapshots
+        std::chrono::milliseconds interval{1000};
+
+        static metrics_exporter_parameters from_config(
+            pika::util::runtime_configuration const& rtcfg);
+    };
+
+    /// The metrics exporter periodically writes a snapshot of the scheduler
+    /// metrics of all thread pools, per worker thread, to a file in the
+    /// OpenMetrics text format. Each snapshot is first written to a temporary
+    /// file which then replaces the metrics file, so that readers always see
+    /// a complete snapshot. Placing the file on a memory backed file system,
+    /// e.g. /dev/shm, makes it cheap for a sidecar process to poll.
+    ///
+    /// The exporter enables the scheduler counters while it is running, see
+    /// scheduler_counters_enabled. Idle rates and average queue wait times
+    /// are computed over the interval since the previous snapshot, the
+    /// other counters are totals.
+    class metrics_exporter
+    {
+    public:
+        using pool_vector = std::vector<std::unique_ptr<thread_pool_base>>;
+
+        metrics_exporter(pool_vector const& pools, metrics_exporter_parameters params);
+        ~metrics_exporter();
+
+        metrics_exporter(metrics_exporter const&) = delete;
+        metrics_exporter(metrics_exporter&&) = delete;
+        metrics_exporter& operator=(metrics_exporter const&) = delete;
+        metrics_exporter& operator=(metrics_exporter&&) = delete;
+
+        /// Start writing snapshots on a separate thread
+        void start();
+
+        /// Stop writing snapshots, a last snapshot is written before
+        /// returning. The scheduler counters are enabled or disabled again as
+        /// they were before start.
+        void stop();
+
+    private:
+        void write_snapshot();
+        void write_metrics(std::ostream& os);
+
+        pool_vector const& pools_;
+        metrics_exporter_parameters const params_;
+        // The counters of each worker thread of each pool at the previous
+        // snapshot
+        std::vector<std::vector<scheduler_counter_values>> previous_;
+        // Whether the scheduler counters were enabled before the exporter
+        // started, restored when it stops
+        bool counters_were_enabled_ = false;
+
+        background_thread thread_;
+    };
+}    // namespace pika::threads::detail
@@ -0,0 +1,100 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/runtime_configuration/runtime_configuration.hpp>
+#include <pika/thread_manager/detail/background_thread.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if !defined(PIKA_WINDOWS)
+# include <signal.h>
+#endif
+
+namespace pika::threads::detail {
+    /// Parameters of the task tracer, see the [pika.trace] section of the
+    /// runtime configuration
+    struct task_tracer_parameters
+    {
+        /// The file the trace is written to, tracing is disabled if empty
+        std::string file;
+        /// Number of events kept per worker thread, older events are
+        /// overwritten
+        std::size_t buffer_size = 65536;
+        /// A signal which writes the trace collected so far when raised, 0
+        /// to not install a signal handler
+        int flush_signal = 0;
+
+        static task_tracer_parameters from_config(pika::util::runtime_configuration const& rtcfg);
+    };
+
+    /// The task tracer records when tasks start, suspend, resume and
+    /// terminate, and when worker threads steal tasks, in per worker thread
+    /// ring buffers (see task_trace.hpp). The most recent events are written
+    /// to a file in the Chrome trace event format, which can be opened with
+    /// Perfetto or chrome://tracing, when the runtime stops and whenever the
+    /// flush signal is raised. Each worker thread is shown as a separate
+    /// thread, tasks are named by their annotation.
+    class task_tracer
+    {
+    public:
+        using pool_vector = std::vector<std::unique_ptr<thread_pool_base>>;
+
+        task_tracer(pool_vector const& pools, task_tracer_parameters params);
+        ~task_tracer();
+
+        task_tracer(task_tracer const&) = delete;
+        task_tracer(task_tracer&&) = delete;
+        task_tracer& operator=(task_tracer const&) = delete;
+        task_tracer& operator=(task_tracer&&) = delete;
+
+        /// Start recording events
+        void start();
+
+        /// Stop recording events and write the trace. Should be called after
+        /// the pools have been stopped so that the trace contains the end of
+        /// all tasks.
+        void stop();
+
+        /// Write the events recorded so far
+        void write_trace();
+
+    private:
+        bool install_flush_handler();
+        void restore_flush_handler();
+        void write_events(std::ostream& os);
+
+        pool_vector const& pools_;
+        task_tracer_parameters const params_;
+        bool started_ = false;
+        // The number of worker threads of each pool when tracing started, the
+        // pools no longer report them once stopped
+        std::vector<std::size_t> num_threads_;
+
+        // Serializes writing the trace
+        std::mutex write_mtx_;
+
+        // The action of the flush signal before the tracer installed its
+        // handler, restored when the tracer stops
+#if defined(PIKA_WINDOWS)
+        void (*previous_flush_handler_)(int) = nullptr;
+#else
+        struct sigaction previous_flush_action_ = {};
+#endif
+
+        // Polls for the flush signal
+        background_thread thread_;
+    };
+}    // namespace pika::threads::detail
@@ -0,0 +1,80 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/runtime_configuration/runtime_configuration.hpp>
+#include <pika/thread_manager/detail/background_thread.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pika::threads::detail {
+    /// Parameters of the task watchdog, see the [pika.watchdog] section of the
+    /// runtime configuration.
+    struct task_watchdog_parameters
+    {
+        /// Time between two scans of the worker threads
+        std::chrono::milliseconds interval{100};
+        /// Time a task may run without yielding before it is reported
+        std::chrono::milliseconds budget{1000};
+
+        static task_watchdog_parameters from_config(pika::util::runtime_configuration const& rtcfg);
+    };
+
+    /// The task watchdog periodically scans the tasks running on the worker
+    /// threads of all thread pools and reports tasks that have been running
+    /// without yielding for longer than the budget. Such tasks starve the
+    /// other tasks queued on the same worker thread. Each task is reported once
+    /// per invocation with its description and the number of tasks pending on
+    /// the worker thread, at warning level. Inline tasks, see
+    /// scheduler_base::schedule_inline_task, are scanned like other tasks.
+    ///
+    /// The worker threads only record their running tasks while a watchdog is
+    /// running, see running_task_tracking_enabled.
+    class task_watchdog
+    {
+    public:
+        using pool_vector = std::vector<std::unique_ptr<thread_pool_base>>;
+
+        task_watchdog(pool_vector const& pools, task_watchdog_parameters const& params);
+        ~task_watchdog();
+
+        task_watchdog(task_watchdog const&) = delete;
+        task_watchdog(task_watchdog&&) = delete;
+        task_watchdog& operator=(task_watchdog const&) = delete;
+        task_watchdog& operator=(task_watchdog&&) = delete;
+
+        /// Start scanning the worker threads on a separate thread
+        void start();
+
+        /// Stop scanning the worker threads
+        void stop();
+
+        /// Return the number of tasks that have exceeded the budget
+        std::int64_t get_long_running_task_count() const noexcept
+        {
+            return num_long_running_tasks_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        void scan(thread_pool_base& pool, std::vector<running_task>& reported);
+
+        pool_vector const& pools_;
+        task_watchdog_parameters const params_;
+        // The last task reported for each worker thread of each pool
+        std::vector<std::vector<running_task>> reported_;
+        std::atomic<std::int64_t> num_long_running_tasks_{0};
+
+        background_thread thread_;
+    };
+}    // namespace pika::threads::detail
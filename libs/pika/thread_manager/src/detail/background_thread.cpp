@@ -0,0 +1,56 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/functional/unique_function.hpp>
+#include <pika/thread_manager/detail/background_thread.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace pika::threads::detail {
+    background_thread::~background_thread() { stop(); }
+
+    void background_thread::start(
+        std::chrono::milliseconds interval, util::detail::unique_function<void()> f)
+    {
+        PIKA_ASSERT(!thread_.joinable());
+
+        interval_ = interval;
+        f_ = std::move(f);
+        stop_requested_ = false;
+        thread_ = std::thread([this] { run(); });
+    }
+
+    bool background_thread::stop()
+    {
+        if (!thread_.joinable()) { return false; }
+
+        {
+            std::lock_guard<std::mutex> l(mtx_);
+            stop_requested_ = true;
+        }
+        cond_.notify_one();
+        thread_.join();
+
+        f_.reset();
+        return true;
+    }
+
+    void background_thread::run()
+    {
+        std::unique_lock<std::mutex> l(mtx_);
+        while (!cond_.wait_for(l, interval_, [this] { return stop_requested_; }))
+        {
+            l.unlock();
+            f_();
+            l.lock();
+        }
+    }
+}    // namespace pika::threads::detail
@@ -0,0 +1,64 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/functional/function.hpp>
+#include <pika/logging.hpp>
+#include <pika/thread_manager/detail/output_file.hpp>
+
+#include <fmt/format.h>
+
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace pika::threads::detail {
+    std::string escape_string(std::string_view value, escape_format format)
+    {
+        std::string escaped;
+        escaped.reserve(value.size());
+        for (char c : value)
+        {
+            if (c == '\\') { escaped += "\\\\"; }
+            else if (c == '"') { escaped += "\\\""; }
+            else if (c == '\n') { escaped += "\\n"; }
+            else if (format == escape_format::json && static_cast<unsigned char>(c) < 0x20)
+            {
+                escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+            }
+            else { escaped += c; }
+        }
+        return escaped;
+    }
+
+    void write_file_atomically(std::string const& file, char const* component,
+        util::detail::function<void(std::ostream&)> const& write)
+    {
+        std::string const tmp_file = file + ".tmp";
+        {
+            std::ofstream os(tmp_file, std::ios::out | std::ios::trunc);
+            if (!os)
+            {
+                PIKA_LOG(warn, "{}: failed to open {}", component, tmp_file);
+                return;
+            }
+            write(os);
+            if (!os)
+            {
+                PIKA_LOG(warn, "{}: failed to write {}", component, tmp_file);
+                return;
+            }
+        }
+
+        // rename replaces the file atomically on POSIX systems
+        if (std::rename(tmp_file.c_str(), file.c_str()) != 0)
+        {
+            PIKA_LOG(warn, "{}: failed to rename {} to {}", component, tmp_file, file);
+        }
+    }
+}    // namespace pika::threads::detail
@@ -0,0 +1,225 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/execution_base/this_thread.hpp>
+#include <pika/logging.hpp>
+#include <pika/modules/errors.hpp>
+#include <pika/runtime_configuration/runtime_configuration.hpp>
+#include <pika/thread_manager/detail/background_thread.hpp>
+#include <pika/thread_manager/elasticity_controller.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+#include <pika/threading_base/scheduler_mode.hpp>
+#include <pika/threading_base/scheduler_state.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+#include <pika/util/get_entry_as.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace pika::threads::detail {
+    elasticity_parameters elasticity_parameters::from_config(
+        pika::util::runtime_configuration const& rtcfg)
+    {
+        elasticity_parameters params;
+        params.interval = std::chrono::milliseconds(get_positive_entry_as<std::int64_t>(
+            rtcfg, "pika.elasticity.interval", params.interval.count()));
+        params.high_queue_length = pika::detail::get_entry_as<std::int64_t>(
+            rtcfg, "pika.elasticity.high_queue_length", params.high_queue_length);
+        params.low_queue_length = pika::detail::get_entry_as<std::int64_t>(
+            rtcfg, "pika.elasticity.low_queue_length", params.low_queue_length);
+        params.hysteresis = get_positive_entry_as<std::size_t>(
+            rtcfg, "pika.elasticity.hysteresis", params.hysteresis);
+        params.min_threads = get_positive_entry_as<std::size_t>(
+            rtcfg, "pika.elasticity.min_threads", params.min_threads);
+        return params;
+    }
+
+    elasticity_controller::elasticity_controller(
+        pool_vector const& pools, elasticity_parameters const& params)
+      : pools_(pools)
+      , params_(params)
+      , pool_data_(pools.size())
+    {
+    }
+
+    elasticity_controller::~elasticity_controller() { stop(); }
+
+    void elasticity_controller::start()
+    {
+        PIKA_LOG(info,
+            "elasticity_controller: starting, interval {}ms, high_queue_length {}, "
+            "low_queue_length {}, hysteresis {}, min_threads {}",
+            params_.interval.count(), params_.high_queue_length, params_.low_queue_length,
+            params_.hysteresis, params_.min_threads);
+
+        thread_.start(params_.interval, [this] {
+            for (std::size_t i = 0; i != pools_.size(); ++i) { sample(*pools_[i], pool_data_[i]); }
+        });
+    }
+
+    void elasticity_controller::stop()
+    {
+        if (!thread_.stop()) { return; }
+
+        resume_all();
+        PIKA_LOG(info, "elasticity_controller: stopped");
+    }
+
+    void elasticity_controller::sample(thread_pool_base& pool, pool_data& data)
+    {
+        scheduler_base* sched = pool.get_scheduler();
+        if (sched == nullptr || !sched->has_scheduler_mode(scheduler_mode::enable_elasticity))
+        {
+            data.overloaded_samples = 0;
+            data.underloaded_samples = 0;
+            return;
+        }
+
+        std::size_t const num_threads = pool.get_os_thread_count();
+        data.suspended.resize(num_threads, false);
+
+        // Processing units that are running are candidates for suspension.
+        // The pool is left alone while it is starting, being suspended as a
+        // whole, or shutting down.
+        std::size_t num_active = 0;
+        for (std::size_t i = 0; i != num_threads; ++i)
+        {
+            runtime_state const state = pool.get_state(i);
+            if (state == runtime_state::running) { ++num_active; }
+            else if (state != runtime_state::sleeping) { return; }
+
+            // Forget processing units resumed by someone else
+            if (state == runtime_state::running) { data.suspended[i] = false; }
+        }
+
+        if (num_active == 0) { return; }
+
+        std::int64_t const queue_length = pool.get_queue_length(std::size_t(-1), false);
+
+        // Suspended processing units are counted as idle by the pool
+        std::int64_t const num_idle = (std::max)(std::int64_t(0),
+            pool.get_idle_core_count() - static_cast<std::int64_t>(num_threads - num_active));
+
+        bool const overloaded =
+            queue_length > params_.high_queue_length * static_cast<std::int64_t>(num_active);
+        bool const underloaded = num_idle > 0 &&
+            queue_length <= params_.low_queue_length * static_cast<std::int64_t>(num_active);
+
+        data.overloaded_samples = overloaded ? data.overloaded_samples + 1 : 0;
+        data.underloaded_samples = underloaded ? data.underloaded_samples + 1 : 0;
+
+        if (data.overloaded_samples >= params_.hysteresis)
+        {
+            data.overloaded_samples = 0;
+
+            auto const it = std::find(data.suspended.begin(), data.suspended.end(), true);
+            if (it == data.suspended.end()) { return; }
+
+            std::size_t const virt_core = std::size_t(it - data.suspended.begin());
+
+            PIKA_LOG(info,
+                "elasticity_controller: resuming processing unit {} of pool {} (queue length "
+                "{}, {} of {} processing units active)",
+                virt_core, pool.get_pool_name(), queue_length, num_active, num_threads);
+
+            error_code ec(throwmode::lightweight);
+            pool.resume_processing_unit_direct(virt_core, ec);
+            if (ec)
+            {
+                PIKA_LOG(warn,
+                    "elasticity_controller: failed to resume processing unit {} of pool {}: {}",
+                    virt_core, pool.get_pool_name(), ec.get_message());
+                return;
+            }
+            data.suspended[virt_core] = false;
+            pool.update_steal_orders();
+        }
+        else if (data.underloaded_samples >= params_.hysteresis)
+        {
+            data.underloaded_samples = 0;
+
+            if (num_active <= params_.min_threads) { return; }
+
+            // Suspend the last running processing unit that has no suspended
+            // threads, since a processing unit is only suspended once all
+            // threads on it have finished
+            std::size_t virt_core = num_threads;
+            for (std::size_t i = num_threads; i != 0; --i)
+            {
+                if (pool.get_state(i - 1) == runtime_state::running &&
+                    pool.get_thread_count(thread_schedule_state::suspended,
+                        execution::thread_priority::default_, i - 1, false) == 0)
+                {
+                    virt_core = i - 1;
+                    break;
+                }
+            }
+
+            if (virt_core == num_threads) { return; }
+
+            PIKA_LOG(info,
+                "elasticity_controller: suspending processing unit {} of pool {} (queue length "
+                "{}, {} idle, {} of {} processing units active)",
+                virt_core, pool.get_pool_name(), queue_length, num_idle, num_active, num_threads);
+
+            // The processing unit is suspended once its worker thread runs out
+            // of work. Until then the pool is left alone, as its state is not
+            // running.
+            error_code ec(throwmode::lightweight);
+            pool.suspend_processing_unit_nonblocking(virt_core, ec);
+            if (ec)
+            {
+                PIKA_LOG(warn,
+                    "elasticity_controller: failed to suspend processing unit {} of pool {}: {}",
+                    virt_core, pool.get_pool_name(), ec.get_message());
+                return;
+            }
+            data.suspended[virt_core] = true;
+
+            // The processing unit is pre_sleep from here on, so the other
+            // worker threads already steal from it last
+            pool.update_steal_orders();
+        }
+    }
+
+    void elasticity_controller::resume_all()
+    {
+        for (std::size_t i = 0; i != pools_.size(); ++i)
+        {
+            pool_data& data = pool_data_[i];
+            for (std::size_t virt_core = 0; virt_core != data.suspended.size(); ++virt_core)
+            {
+                if (!data.suspended[virt_core]) { continue; }
+
+                PIKA_LOG(info, "elasticity_controller: resuming processing unit {} of pool {}",
+                    virt_core, pools_[i]->get_pool_name());
+
+                // The processing unit may not have been suspended yet
+                util::yield_while(
+                    [&] { return pools_[i]->get_state(virt_core) == runtime_state::pre_sleep; },
+                    "elasticity_controller::resume_all");
+
+                error_code ec(throwmode::lightweight);
+                pools_[i]->resume_processing_unit_direct(virt_core, ec);
+                if (ec)
+                {
+                    PIKA_LOG(warn,
+                        "elasticity_controller: failed to resume processing unit {} of pool {}: "
+                        "{}",
+                        virt_core, pools_[i]->get_pool_name(), ec.get_message());
+                    continue;
+                }
+                data.suspended[virt_core] = false;
+                pools_[i]->update_steal_orders();
+            }
+            data.overloaded_samples = 0;
+            data.underloaded_samples = 0;
+        }
+    }
+}    // namespace pika::threads::detail
@@ -0,0 +1,168 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/logging.hpp>
+#include <pika/runtime_configuration/runtime_configuration.hpp>
+#include <pika/thread_manager/detail/background_thread.hpp>
+#include <pika/thread_manager/detail/output_file.hpp>
+#include <pika/thread_manager/metrics_exporter.hpp>
+#include <pika/threading_base/detail/scheduler_counters.hpp>
+#include <pika/threading_base/scheduler_state.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace pika::threads::detail {
+    metrics_exporter_parameters metrics_exporter_parameters::from_config(
+        pika::util::runtime_configuration const& rtcfg)
+    {
+        metrics_exporter_parameters params;
+        params.file = rtcfg.get_entry("pika.metrics.file", "");
+        params.interval = std::chrono::milliseconds(get_positive_entry_as<std::int64_t>(
+            rtcfg, "pika.metrics.interval", params.interval.count()));
+        return params;
+    }
+
+    metrics_exporter::metrics_exporter(pool_vector const& pools, metrics_exporter_parameters params)
+      : pools_(pools)
+      , params_(std::move(params))
+      , previous_(pools.size())
+    {
+    }
+
+    metrics_exporter::~metrics_exporter() { stop(); }
+
+    void metrics_exporter::start()
+    {
+        PIKA_ASSERT(!params_.file.empty());
+
+        PIKA_LOG(info, "metrics_exporter: starting, file {}, interval {}ms", params_.file,
+            params_.interval.count());
+
+        counters_were_enabled_ = get_scheduler_counters_enabled();
+        set_scheduler_counters_enabled(true);
+
+        thread_.start(params_.interval, [this] { write_snapshot(); });
+    }
+
+    void metrics_exporter::stop()
+    {
+        if (!thread_.stop()) { return; }
+
+        write_snapshot();
+        set_scheduler_counters_enabled(counters_were_enabled_);
+        PIKA_LOG(info, "metrics_exporter: stopped");
+    }
+
+    void metrics_exporter::write_snapshot()
+    {
+        write_file_atomically(
+            params_.file, "metrics_exporter", [this](std::ostream& os) { write_metrics(os); });
+    }
+
+    namespace {
+        struct worker_metrics
+        {
+            std::string labels;
+            bool active;
+            std::int64_t queue_length;
+            scheduler_counter_values total;
+            scheduler_counter_values interval;
+        };
+
+        scheduler_counter_values difference(
+            scheduler_counter_values const& current, scheduler_counter_values const& previous)
+        {
+            // The counters may have been reset since the previous snapshot
+            auto const diff = [](std::int64_t c, std::int64_t p) { return c >= p ? c - p : c; };
+
+            scheduler_counter_values values;
+            values.executed_threads = diff(current.executed_threads, previous.executed_threads);
+            values.executed_thread_phases =
+                diff(current.executed_thread_phases, previous.executed_thread_phases);
+            values.loop_time = diff(current.loop_time, previous.loop_time);
+            values.exec_time = diff(current.exec_time, previous.exec_time);
+            values.stolen_threads = diff(current.stolen_threads, previous.stolen_threads);
+            values.queue_wait_time = diff(current.queue_wait_time, previous.queue_wait_time);
+            values.queue_wait_count = diff(current.queue_wait_count, previous.queue_wait_count);
+            return values;
+        }
+
+        template <typename F>
+        void write_family(std::ostream& os, std::vector<worker_metrics> const& workers,
+            char const* name, char const* type, char const* help, F&& value)
+        {
+            fmt::print(os, "# TYPE {} {}\n# HELP {} {}\n", name, type, name, help);
+            char const* suffix = std::string_view(type) == "counter" ? "_total" : "";
+            for (worker_metrics const& w : workers)
+            {
+                fmt::print(os, "{}{}{{{}}} {}\n", name, suffix, w.labels, value(w));
+            }
+        }
+    }    // namespace
+
+    void metrics_exporter::write_metrics(std::ostream& os)
+    {
+        std::vector<worker_metrics> workers;
+        for (std::size_t i = 0; i != pools_.size(); ++i)
+        {
+            thread_pool_base& pool = *pools_[i];
+            std::size_t const num_threads = pool.get_os_thread_count();
+            previous_[i].resize(num_threads);
+
+            std::string const pool_name =
+                escape_string(pool.get_pool_name(), escape_format::openmetrics);
+            for (std::size_t t = 0; t != num_threads; ++t)
+            {
+                scheduler_counter_values const total = pool.get_scheduler_counters(t);
+                workers.push_back(worker_metrics{
+                    fmt::format("pool=\"{}\",worker=\"{}\"", pool_name, t),
+                    pool.get_state(t) == runtime_state::running,
+                    pool.get_queue_length(t, false), total, difference(total, previous_[i][t])});
+                previous_[i][t] = total;
+            }
+        }
+
+        write_family(os, workers, "pika_worker_active", "gauge",
+            "Whether the worker thread is running (1) or suspended or stopped (0).",
+            [](worker_metrics const& w) { return w.active ? 1 : 0; });
+        write_family(os, workers, "pika_queue_length", "gauge",
+            "Number of tasks queued on the worker thread.",
+            [](worker_metrics const& w) { return w.queue_length; });
+        write_family(os, workers, "pika_executed_tasks", "counter",
+            "Number of tasks that ran to completion on the worker thread.",
+            [](worker_metrics const& w) { return w.total.executed_threads; });
+        write_family(os, workers, "pika_executed_task_phases", "counter",
+            "Number of times the worker thread switched to a task.",
+            [](worker_metrics const& w) { return w.total.executed_thread_phases; });
+        write_family(os, workers, "pika_stolen_tasks", "counter",
+            "Number of tasks the worker thread took from the queues of other worker threads.",
+            [](worker_metrics const& w) { return w.total.stolen_threads; });
+        write_family(os, workers, "pika_idle_rate", "gauge",
+            "Fraction of time the worker thread did not execute tasks since the previous "
+            "snapshot.",
+            [](worker_metrics const& w) { return w.interval.idle_rate(); });
+        write_family(os, workers, "pika_average_queue_wait_seconds", "gauge",
+            "Average time tasks waited in the queues before running since the previous "
+            "snapshot.",
+            [](worker_metrics const& w) {
+                return static_cast<double>(w.interval.average_queue_wait_time()) * 1e-9;
+            });
+        os << "# EOF\n";
+    }
+}    // namespace pika::threads::detail
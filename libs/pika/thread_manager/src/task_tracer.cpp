@@ -0,0 +1,217 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/coroutines/thread_enums.hpp>
+#include <pika/logging.hpp>
+#include <pika/runtime_configuration/runtime_configuration.hpp>
+#include <pika/thread_manager/detail/background_thread.hpp>
+#include <pika/thread_manager/detail/output_file.hpp>
+#include <pika/thread_manager/task_tracer.hpp>
+#include <pika/threading_base/detail/task_trace.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+#include <pika/util/get_entry_as.hpp>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pika::threads::detail {
+    task_tracer_parameters task_tracer_parameters::from_config(
+        pika::util::runtime_configuration const& rtcfg)
+    {
+        task_tracer_parameters params;
+        params.file = rtcfg.get_entry("pika.trace.file", "");
+        params.buffer_size = get_positive_entry_as<std::size_t>(
+            rtcfg, "pika.trace.buffer_size", params.buffer_size);
+        params.flush_signal =
+            pika::detail::get_entry_as<int>(rtcfg, "pika.trace.flush_signal", params.flush_signal);
+        return params;
+    }
+
+    namespace {
+        // Set by the signal handler, polled by the tracer thread
+        volatile std::sig_atomic_t flush_requested = 0;
+
+        extern "C" void on_flush_signal(int) { flush_requested = 1; }
+
+        // How often the tracer thread checks whether the flush signal has been
+        // raised
+        constexpr std::chrono::milliseconds flush_poll_interval{50};
+    }    // namespace
+
+    task_tracer::task_tracer(pool_vector const& pools, task_tracer_parameters params)
+      : pools_(pools)
+      , params_(std::move(params))
+    {
+    }
+
+    task_tracer::~task_tracer() { stop(); }
+
+    void task_tracer::start()
+    {
+        PIKA_ASSERT(!started_);
+        PIKA_ASSERT(!params_.file.empty());
+
+        PIKA_LOG(info, "task_tracer: starting, file {}, buffer size {}, flush signal {}",
+            params_.file, params_.buffer_size, params_.flush_signal);
+
+        std::size_t num_threads = 0;
+        num_threads_.clear();
+        for (auto const& pool : pools_)
+        {
+            num_threads_.push_back(pool->get_os_thread_count());
+            num_threads =
+                (std::max)(num_threads, pool->get_thread_offset() + num_threads_.back());
+        }
+        enable_task_tracing(num_threads, params_.buffer_size);
+        started_ = true;
+
+        if (params_.flush_signal != 0)
+        {
+            flush_requested = 0;
+            if (!install_flush_handler())
+            {
+                PIKA_LOG(warn, "task_tracer: failed to install handler for signal {}",
+                    params_.flush_signal);
+                return;
+            }
+
+            thread_.start(flush_poll_interval, [this] {
+                if (flush_requested == 0) { return; }
+                flush_requested = 0;
+                write_trace();
+            });
+        }
+    }
+
+    void task_tracer::stop()
+    {
+        if (!started_) { return; }
+        started_ = false;
+
+        if (thread_.stop()) { restore_flush_handler(); }
+
+        disable_task_tracing();
+        write_trace();
+        PIKA_LOG(info, "task_tracer: stopped");
+    }
+
+    bool task_tracer::install_flush_handler()
+    {
+#if defined(PIKA_WINDOWS)
+        previous_flush_handler_ = std::signal(params_.flush_signal, on_flush_signal);
+        return previous_flush_handler_ != SIG_ERR;
+#else
+        struct sigaction action;
+        action.sa_handler = on_flush_signal;
+        sigemptyset(&action.sa_mask);
+        // Do not interrupt system calls of the application with EINTR
+        action.sa_flags = SA_RESTART;
+        return sigaction(params_.flush_signal, &action, &previous_flush_action_) == 0;
+#endif
+    }
+
+    void task_tracer::restore_flush_handler()
+    {
+        // The application or another library may have installed a handler for
+        // the signal before the tracer, it is reinstated as it was
+#if defined(PIKA_WINDOWS)
+        std::signal(params_.flush_signal, previous_flush_handler_);
+#else
+        sigaction(params_.flush_signal, &previous_flush_action_, nullptr);
+#endif
+    }
+
+    void task_tracer::write_trace()
+    {
+        std::lock_guard<std::mutex> l(write_mtx_);
+
+        write_file_atomically(
+            params_.file, "task_tracer", [this](std::ostream& os) { write_events(os); });
+    }
+
+    namespace {
+        std::string event_name(trace_event const& e)
+        {
+            if (e.description != nullptr)
+            {
+                return escape_string(e.description, escape_format::json);
+            }
+            if (e.data != 0) { return fmt::format("0x{:x}", e.data); }
+            return "<unknown>";
+        }
+    }    // namespace
+
+    void task_tracer::write_events(std::ostream& os)
+    {
+        constexpr int pid = 1;
+        char const* separator = "\n";
+
+        os << "{\"traceEvents\":[";
+        for (std::size_t i = 0; i != num_threads_.size(); ++i)
+        {
+            thread_pool_base const& pool = *pools_[i];
+            std::string const pool_name = escape_string(pool.get_pool_name(), escape_format::json);
+            for (std::size_t t = 0; t != num_threads_[i]; ++t)
+            {
+                std::size_t const tid = pool.get_thread_offset() + t;
+                trace_buffer const* buffer = get_task_trace_buffer(tid);
+                if (buffer == nullptr) { continue; }
+
+                fmt::print(os,
+                    "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},"
+                    "\"args\":{{\"name\":\"{}/worker-{}\"}}}}",
+                    separator, pid, tid, pool_name, t);
+                separator = ",\n";
+
+                // The oldest events in the buffer may have been overwritten,
+                // end events without a matching begin event are dropped
+                bool in_task = false;
+                buffer->for_each([&](trace_event const& e) {
+                    double const ts = static_cast<double>(e.timestamp) * 1e-3;
+                    switch (e.type)
+                    {
+                    case trace_event_type::begin:
+                        fmt::print(os,
+                            "{}{{\"name\":\"{}\",\"ph\":\"B\",\"ts\":{:.3f},\"pid\":{},"
+                            "\"tid\":{},\"args\":{{\"id\":\"{}\"}}}}",
+                            separator, event_name(e), ts, pid, tid, e.id);
+                        in_task = true;
+                        break;
+                    case trace_event_type::end:
+                        if (!in_task) { break; }
+                        fmt::print(os,
+                            "{}{{\"ph\":\"E\",\"ts\":{:.3f},\"pid\":{},\"tid\":{},"
+                            "\"args\":{{\"state\":\"{}\"}}}}",
+                            separator, ts, pid, tid,
+                            get_thread_state_name(static_cast<thread_schedule_state>(e.data)));
+                        in_task = false;
+                        break;
+                    case trace_event_type::steal:
+                        fmt::print(os,
+                            "{}{{\"name\":\"steal\",\"ph\":\"i\",\"s\":\"t\",\"ts\":{:.3f},"
+                            "\"pid\":{},\"tid\":{},\"args\":{{\"count\":{}}}}}",
+                            separator, ts, pid, tid, e.data);
+                        break;
+                    }
+                });
+            }
+        }
+        os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+}    // namespace pika::threads::detail
@@ -0,0 +1,106 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/logging.hpp>
+#include <pika/runtime_configuration/runtime_configuration.hpp>
+#include <pika/thread_manager/detail/background_thread.hpp>
+#include <pika/thread_manager/task_watchdog.hpp>
+#include <pika/threading_base/detail/running_task.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pika::threads::detail {
+    task_watchdog_parameters task_watchdog_parameters::from_config(
+        pika::util::runtime_configuration const& rtcfg)
+    {
+        task_watchdog_parameters params;
+        params.interval = std::chrono::milliseconds(get_positive_entry_as<std::int64_t>(
+            rtcfg, "pika.watchdog.interval", params.interval.count()));
+        params.budget = std::chrono::milliseconds(get_positive_entry_as<std::int64_t>(
+            rtcfg, "pika.watchdog.budget", params.budget.count()));
+        return params;
+    }
+
+    task_watchdog::task_watchdog(pool_vector const& pools, task_watchdog_parameters const& params)
+      : pools_(pools)
+      , params_(params)
+      , reported_(pools.size())
+    {
+    }
+
+    task_watchdog::~task_watchdog() { stop(); }
+
+    void task_watchdog::start()
+    {
+        PIKA_LOG(info, "task_watchdog: starting, interval {}ms, budget {}ms",
+            params_.interval.count(), params_.budget.count());
+
+        running_task_tracking_enabled.store(true, std::memory_order_relaxed);
+
+        thread_.start(params_.interval, [this] {
+            for (std::size_t i = 0; i != pools_.size(); ++i) { scan(*pools_[i], reported_[i]); }
+        });
+    }
+
+    void task_watchdog::stop()
+    {
+        if (!thread_.stop()) { return; }
+
+        running_task_tracking_enabled.store(false, std::memory_order_relaxed);
+
+        PIKA_LOG(info, "task_watchdog: stopped, {} long running tasks reported",
+            get_long_running_task_count());
+    }
+
+    void task_watchdog::scan(thread_pool_base& pool, std::vector<running_task>& reported)
+    {
+        std::size_t const num_threads = pool.get_os_thread_count();
+        reported.resize(num_threads);
+
+        auto const now = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i != num_threads; ++i)
+        {
+            running_task task;
+            if (!pool.get_running_task(i, task)) { continue; }
+
+            auto const duration = now - task.start_time;
+            if (duration <= params_.budget) { continue; }
+
+            // Report each invocation of a task only once
+            if (task.start_time == reported[i].start_time && task.id == reported[i].id)
+            {
+                continue;
+            }
+            reported[i] = task;
+            ++num_long_running_tasks_;
+
+            auto const duration_ms =
+                std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+            std::int64_t const queue_length = pool.get_queue_length(i, false);
+            if (task.description != nullptr)
+            {
+                PIKA_LOG(warn,
+                    "task_watchdog: task {} ({}) has been running for {}ms on worker thread {} "
+                    "of pool {} without yielding, {} tasks pending on the worker thread",
+                    task.id, task.description, duration_ms, i, pool.get_pool_name(),
+                    queue_length);
+            }
+            else
+            {
+                PIKA_LOG(warn,
+                    "task_watchdog: task {} (address {:#x}) has been running for {}ms on worker "
+                    "thread {} of pool {} without yielding, {} tasks pending on the worker thread",
+                    task.id, task.address, duration_ms, i, pool.get_pool_name(), queue_length);
+            }
+        }
+    }
+}    // namespace pika::threads::detail
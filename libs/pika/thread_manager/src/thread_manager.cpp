@@ -20,6 +20,7 @@
 #include <pika/runtime_configuration/runtime_configuration.hpp>
 #include <pika/thread_pools/scheduled_thread_pool.hpp>
 #include <pika/threading_base/detail/global_activity_count.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/set_thread_state.hpp>
 #include <pika/threading_base/thread_data.hpp>
 #include <pika/threading_base/thread_helpers.hpp>
@@ -119,6 +120,10 @@ namespace pika::threads::detail {
             "pika.thread_queue.max_terminated_threads", PIKA_THREAD_QUEUE_MAX_TERMINATED_THREADS);
         std::int64_t const init_threads_count = pika::detail::get_entry_as<std::int64_t>(
             rtcfg_, "pika.thread_queue.init_threads_count", PIKA_THREAD_QUEUE_INIT_THREADS_COUNT);
+        std::int64_t const max_run_next_count = pika::detail::get_entry_as<std::int64_t>(
+            rtcfg_, "pika.thread_queue.max_run_next_count", PIKA_THREAD_QUEUE_MAX_RUN_NEXT_COUNT);
+        std::int64_t const run_next_steal_delay = pika::detail::get_entry_as<std::int64_t>(rtcfg_,
+            "pika.thread_queue.run_next_steal_delay", PIKA_THREAD_QUEUE_RUN_NEXT_STEAL_DELAY);
         double const max_idle_backoff_time = pika::detail::get_entry_as<double>(
             rtcfg_, "pika.max_idle_backoff_time", PIKA_IDLE_BACKOFF_TIME_MAX);
 
@@ -131,7 +136,8 @@ namespace pika::threads::detail {
         thread_queue_init_parameters thread_queue_init(max_thread_count, min_tasks_to_steal_pending,
             min_tasks_to_steal_staged, min_add_new_count, max_add_new_count, min_delete_count,
             max_delete_count, max_terminated_threads, init_threads_count, max_idle_backoff_time,
-            small_stacksize, medium_stacksize, large_stacksize, huge_stacksize);
+            small_stacksize, medium_stacksize, large_stacksize, huge_stacksize, max_run_next_count,
+            run_next_steal_delay);
 
         // instantiate the pools
         for (size_t i = 0; i != num_pools; i++)
@@ -410,6 +416,73 @@ namespace pika::threads::detail {
                 break;
             }
 
+            case resource::work_stealing_priority:
+            {
+                // set parameters for scheduler and pool instantiation and
+                // perform compatibility checks
+                std::size_t num_high_priority_queues =
+                    pika::detail::get_entry_as<std::size_t>(rtcfg_,
+                        "pika.thread_queue.high_priority_queues", thread_pool_init.num_threads_);
+                check_num_high_priority_queues(
+                    thread_pool_init.num_threads_, num_high_priority_queues);
+
+                // instantiate the scheduler
+                using local_sched_type =
+                    pika::threads::detail::local_priority_queue_scheduler<std::mutex,
+                        pika::threads::detail::lockfree_work_stealing,
+                        pika::threads::detail::lockfree_work_stealing>;
+
+                local_sched_type::init_parameter_type init(thread_pool_init.num_threads_,
+                    thread_pool_init.affinity_data_, num_high_priority_queues, thread_queue_init,
+                    "core-work_stealing_priority_queue_scheduler");
+
+                std::unique_ptr<local_sched_type> sched(new local_sched_type(init));
+
+                // set the default scheduler flags
+                sched->set_scheduler_mode(thread_pool_init.mode_);
+                // conditionally set/unset this flag
+                sched->update_scheduler_mode(scheduler_mode::enable_stealing_numa, !numa_sensitive);
+
+                // instantiate the pool
+                std::unique_ptr<thread_pool_base> pool(
+                    new pika::threads::detail::scheduled_thread_pool<local_sched_type>(
+                        std::move(sched), thread_pool_init));
+                pools_.push_back(std::move(pool));
+                break;
+            }
+
+            case resource::edf:
+            {
+                // set parameters for scheduler and pool instantiation and
+                // perform compatibility checks
+                std::size_t num_high_priority_queues =
+                    pika::detail::get_entry_as<std::size_t>(rtcfg_,
+                        "pika.thread_queue.high_priority_queues", thread_pool_init.num_threads_);
+                check_num_high_priority_queues(
+                    thread_pool_init.num_threads_, num_high_priority_queues);
+
+                // instantiate the scheduler
+                using local_sched_type = pika::threads::detail::edf_queue_scheduler<>;
+
+                local_sched_type::init_parameter_type init(thread_pool_init.num_threads_,
+                    thread_pool_init.affinity_data_, num_high_priority_queues, thread_queue_init,
+                    "core-edf_queue_scheduler");
+
+                std::unique_ptr<local_sched_type> sched(new local_sched_type(init));
+
+                // set the default scheduler flags
+                sched->set_scheduler_mode(thread_pool_init.mode_);
+                // conditionally set/unset this flag
+                sched->update_scheduler_mode(scheduler_mode::enable_stealing_numa, !numa_sensitive);
+
+                // instantiate the pool
+                std::unique_ptr<thread_pool_base> pool(
+                    new pika::threads::detail::scheduled_thread_pool<local_sched_type>(
+                        std::move(sched), thread_pool_init));
+                pools_.push_back(std::move(pool));
+                break;
+            }
+
             case resource::shared_priority:
             {
                 // instantiate the scheduler
@@ -563,6 +636,11 @@ namespace pika::threads::detail {
         return total_count;
     }
 
+    std::int64_t thread_manager::get_long_running_task_count() const
+    {
+        return task_watchdog_ ? task_watchdog_->get_long_running_task_count() : 0;
+    }
+
     mask_type thread_manager::get_idle_core_mask()
     {
         mask_type mask = mask_type();
@@ -832,6 +910,9 @@ namespace pika::threads::detail {
         auto& rp = pika::resource::get_partitioner();
         init_tss(rp.get_num_threads());
 
+        set_scheduler_counters_enabled(
+            pika::detail::get_entry_as<bool>(rtcfg_, "pika.scheduler_counters", false));
+
         for (auto& pool_iter : pools_)
         {
             std::size_t num_threads_in_pool = rp.get_num_threads(pool_iter->get_pool_name());
@@ -847,6 +928,45 @@ namespace pika::threads::detail {
             // set all states of all schedulers to "running"
             scheduler_base* sched = pool_iter->get_scheduler();
             if (sched) sched->set_all_states(runtime_state::running);
+
+            // Processing units shared with other pools are only used by the
+            // pool they were first added to
+            bool suspended_processing_units = false;
+            for (std::size_t virt_core = 0; virt_core != num_threads_in_pool; ++virt_core)
+            {
+                if (rp.starts_suspended(pool_iter->get_pool_name(), virt_core))
+                {
+                    pool_iter->suspend_processing_unit_direct(virt_core);
+                    suspended_processing_units = true;
+                }
+            }
+            if (suspended_processing_units) { pool_iter->update_steal_orders(); }
+        }
+
+        if (pika::detail::get_entry_as<bool>(rtcfg_, "pika.elasticity.enable", false))
+        {
+            elasticity_controller_ = std::make_unique<elasticity_controller>(
+                pools_, elasticity_parameters::from_config(rtcfg_));
+            elasticity_controller_->start();
+        }
+
+        if (pika::detail::get_entry_as<bool>(rtcfg_, "pika.watchdog.enable", false))
+        {
+            task_watchdog_ = std::make_unique<task_watchdog>(
+                pools_, task_watchdog_parameters::from_config(rtcfg_));
+            task_watchdog_->start();
+        }
+
+        if (auto params = metrics_exporter_parameters::from_config(rtcfg_); !params.file.empty())
+        {
+            metrics_exporter_ = std::make_unique<metrics_exporter>(pools_, std::move(params));
+            metrics_exporter_->start();
+        }
+
+        if (auto params = task_tracer_parameters::from_config(rtcfg_); !params.file.empty())
+        {
+            task_tracer_ = std::make_unique<task_tracer>(pools_, std::move(params));
+            task_tracer_->start();
         }
 
         PIKA_LOG(info, "run: running");
@@ -857,9 +977,37 @@ namespace pika::threads::detail {
     {
         PIKA_LOG(info, "stop: blocking({})", blocking ? "true" : "false");
 
+        // Stop the elasticity controller first so that all processing units
+        // are running again when the pools are stopped
+        if (elasticity_controller_)
+        {
+            elasticity_controller_->stop();
+            elasticity_controller_.reset();
+        }
+
+        if (task_watchdog_)
+        {
+            task_watchdog_->stop();
+            task_watchdog_.reset();
+        }
+
+        if (metrics_exporter_)
+        {
+            metrics_exporter_->stop();
+            metrics_exporter_.reset();
+        }
+
         std::unique_lock<mutex_type> lk(mtx_);
         for (auto& pool_iter : pools_) { pool_iter->stop(lk, blocking); }
         deinit_tss();
+
+        // The trace is written once the pools have stopped so that it
+        // contains the end of all tasks
+        if (task_tracer_)
+        {
+            task_tracer_->stop();
+            task_tracer_.reset();
+        }
     }
 
     bool thread_manager::is_busy()
@@ -880,8 +1028,12 @@ namespace pika::threads::detail {
     {
         pika::util::yield_while(
             []() {
+                // the calling pika thread or inline task is itself counted
                 return pika::threads::detail::get_global_activity_count() >
-                    (threads::detail::get_self_ptr() != nullptr ? 1 : 0);
+                    (threads::detail::get_self_ptr() != nullptr ||
+                                threads::detail::scheduler_base::is_running_inline_task() ?
+                            1 :
+                            0);
             },
             "thread_manager::wait");
     }
@@ -0,0 +1,145 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The elasticity controller suspends processing units of an idle pool down to
+// pika.elasticity.min_threads and resumes them again when the pool is
+// overloaded.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/resource_partitioner.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/threading_base/scheduler_mode.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+
+std::size_t const max_threads =
+    (std::min)(std::size_t(4), std::size_t(pika::threads::detail::hardware_concurrency()));
+
+std::size_t get_num_active(pika::threads::detail::thread_pool_base& pool)
+{
+    std::size_t num_active = 0;
+    for (std::size_t i = 0; i < pool.get_os_thread_count(); ++i)
+    {
+        if (pool.get_state(i) == pika::runtime_state::running) { ++num_active; }
+    }
+    return num_active;
+}
+
+// Wait until f returns true or the timeout has passed, calling wait in
+// between
+template <typename F, typename Wait>
+bool wait_until(F&& f, Wait&& wait)
+{
+    auto const timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (!f())
+    {
+        if (std::chrono::steady_clock::now() > timeout) { return false; }
+        wait();
+    }
+    return true;
+}
+
+int pika_main()
+{
+    auto& pool = pika::resource::get_thread_pool("default");
+    std::size_t const num_threads = pool.get_os_thread_count();
+
+    // The controller never suspends the last processing unit
+    if (num_threads == 1)
+    {
+        pika::this_thread::sleep_for(std::chrono::milliseconds(100));
+        PIKA_TEST_EQ(get_num_active(pool), std::size_t(1));
+
+        pika::finalize();
+        return EXIT_SUCCESS;
+    }
+
+    // The pool is idle apart from this thread, all processing units but one
+    // are suspended
+    PIKA_TEST(wait_until([&] { return get_num_active(pool) == 1; },
+        [] { pika::this_thread::sleep_for(std::chrono::milliseconds(10)); }));
+
+    // The suspended processing units are stolen from last by the remaining
+    // worker thread
+    PIKA_TEST(wait_until(
+        [&] {
+            auto const steal_orders = pool.get_steal_orders();
+            for (std::size_t i = 0; i < num_threads; ++i)
+            {
+                if (pool.get_state(i) == pika::runtime_state::running)
+                {
+                    return (*steal_orders)[i].numa_local_count == 0;
+                }
+            }
+            return false;
+        },
+        [] { pika::this_thread::sleep_for(std::chrono::milliseconds(10)); }));
+
+    // Keep the pool overloaded until all processing units have been resumed
+    std::atomic<std::size_t> num_tasks_left{0};
+    auto spin = [&num_tasks_left] {
+        auto const end = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+        while (std::chrono::steady_clock::now() < end) {}
+        --num_tasks_left;
+    };
+
+    PIKA_TEST(wait_until([&] { return get_num_active(pool) == num_threads; },
+        [&] {
+            for (std::size_t i = 0; i < 100; ++i)
+            {
+                ++num_tasks_left;
+                ex::start_detached(ex::schedule(ex::thread_pool_scheduler{}) | ex::then(spin));
+            }
+            pika::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }));
+
+    while (num_tasks_left > 0) { pika::this_thread::yield(); }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+void test_scheduler(int argc, char* argv[], pika::resource::scheduling_policy scheduler)
+{
+    using ::pika::threads::scheduler_mode;
+
+    pika::init_params init_args;
+    init_args.cfg = {"pika.os_threads=" + std::to_string(max_threads),
+        "pika.elasticity.enable=1", "pika.elasticity.interval=10",
+        "pika.elasticity.high_queue_length=1", "pika.elasticity.hysteresis=2",
+        "pika.elasticity.min_threads=1"};
+    init_args.rp_callback = [scheduler](auto& rp, pika::program_options::variables_map const&) {
+        rp.create_thread_pool(
+            "default", scheduler, scheduler_mode::default_mode | scheduler_mode::enable_elasticity);
+    };
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<pika::resource::scheduling_policy> const schedulers = {
+        pika::resource::scheduling_policy::local,
+        pika::resource::scheduling_policy::local_priority_fifo,
+#if defined(PIKA_HAVE_CXX11_STD_ATOMIC_128BIT)
+        pika::resource::scheduling_policy::local_priority_lifo,
+#endif
+        pika::resource::scheduling_policy::work_stealing_priority,
+    };
+
+    for (auto const scheduler : schedulers) { test_scheduler(argc, argv, scheduler); }
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The metrics exporter periodically writes the scheduler metrics of all
+// thread pools to pika.metrics.file in the OpenMetrics text format.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/threading_base/detail/scheduler_counters.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+constexpr std::size_t num_tasks = 1000;
+
+std::size_t const max_threads =
+    (std::min)(std::size_t(4), std::size_t(pika::threads::detail::hardware_concurrency()));
+
+std::string const metrics_file = (std::filesystem::temp_directory_path() /
+    ("pika_metrics_exporter_test_" +
+        std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".txt"))
+                                     .string();
+
+std::string read_metrics()
+{
+    std::ifstream is(metrics_file);
+    std::stringstream ss;
+    ss << is.rdbuf();
+    return ss.str();
+}
+
+// Return the sum of the values of all samples of the given metric
+double sum_samples(std::string const& metrics, std::string const& name)
+{
+    double sum = 0;
+    std::istringstream is(metrics);
+    std::string line;
+    while (std::getline(is, line))
+    {
+        if (line.rfind(name + "{", 0) != 0) { continue; }
+        sum += std::stod(line.substr(line.rfind(' ') + 1));
+    }
+    return sum;
+}
+
+// Return true if the metrics contain a sample of the given metric for each
+// worker thread of the default pool
+bool has_samples(std::string const& metrics, std::string const& name)
+{
+    for (std::size_t i = 0; i != max_threads; ++i)
+    {
+        std::string const sample =
+            name + "{pool=\"default\",worker=\"" + std::to_string(i) + "\"} ";
+        if (metrics.find(sample) == std::string::npos) { return false; }
+    }
+    return true;
+}
+
+int pika_main()
+{
+    // The exporter enables the scheduler counters while it is running
+    PIKA_TEST(pika::threads::detail::get_scheduler_counters_enabled());
+
+    std::vector<ex::unique_any_sender<>> senders;
+    for (std::size_t i = 0; i < num_tasks; ++i)
+    {
+        senders.emplace_back(ex::schedule(ex::thread_pool_scheduler{}) | ex::then([] {}));
+    }
+    tt::sync_wait(ex::when_all_vector(std::move(senders)));
+
+    // Wait for at least one snapshot after the tasks have run
+    pika::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::string const metrics = read_metrics();
+    PIKA_TEST(has_samples(metrics, "pika_worker_active"));
+    PIKA_TEST(has_samples(metrics, "pika_queue_length"));
+    PIKA_TEST(has_samples(metrics, "pika_executed_tasks_total"));
+    PIKA_TEST(has_samples(metrics, "pika_executed_task_phases_total"));
+    PIKA_TEST(has_samples(metrics, "pika_stolen_tasks_total"));
+    PIKA_TEST(has_samples(metrics, "pika_idle_rate"));
+    PIKA_TEST(has_samples(metrics, "pika_average_queue_wait_seconds"));
+    PIKA_TEST_EQ(sum_samples(metrics, "pika_worker_active"), double(max_threads));
+    PIKA_TEST_LTE(double(num_tasks), sum_samples(metrics, "pika_executed_tasks_total"));
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    pika::init_params init_args;
+    init_args.cfg = {"pika.os_threads=" + std::to_string(max_threads),
+        "pika.metrics.file!=" + metrics_file, "pika.metrics.interval=10"};
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+
+    // The counters are disabled again, as they were before the exporter started
+    PIKA_TEST(!pika::threads::detail::get_scheduler_counters_enabled());
+
+    // A last snapshot is written when the runtime stops
+    std::string const metrics = read_metrics();
+    PIKA_TEST(metrics.size() >= 6 && metrics.compare(metrics.size() - 6, 6, "# EOF\n") == 0);
+    PIKA_TEST_LTE(double(num_tasks), sum_samples(metrics, "pika_executed_tasks_total"));
+
+    std::filesystem::remove(metrics_file);
+
+    return 0;
+}
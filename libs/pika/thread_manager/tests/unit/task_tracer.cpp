@@ -0,0 +1,141 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The task tracer records task execution on all worker threads and writes it
+// to pika.trace.file in the Chrome trace event format when the runtime stops.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(SIGUSR1)
+# include <signal.h>
+#endif
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+constexpr std::size_t num_tasks = 1000;
+
+std::size_t const max_threads =
+    (std::min)(std::size_t(4), std::size_t(pika::threads::detail::hardware_concurrency()));
+
+std::string const trace_file = (std::filesystem::temp_directory_path() /
+    ("pika_task_tracer_test_" +
+        std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".json"))
+                                   .string();
+
+std::string read_trace()
+{
+    std::ifstream is(trace_file);
+    std::stringstream ss;
+    ss << is.rdbuf();
+    return ss.str();
+}
+
+std::size_t count(std::string const& trace, std::string_view pattern)
+{
+    std::size_t n = 0;
+    for (auto pos = trace.find(pattern); pos != std::string::npos;
+         pos = trace.find(pattern, pos + pattern.size()))
+    {
+        ++n;
+    }
+    return n;
+}
+
+#if defined(SIGUSR1)
+extern "C" void on_application_signal(int) {}
+#endif
+
+int pika_main()
+{
+    std::vector<ex::unique_any_sender<>> senders;
+    for (std::size_t i = 0; i < num_tasks; ++i)
+    {
+        senders.emplace_back(ex::schedule(ex::thread_pool_scheduler{}) | ex::then([] {}));
+    }
+    tt::sync_wait(ex::when_all_vector(std::move(senders)));
+
+    // Tasks that suspend are recorded once per phase
+    pika::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+#if defined(SIGUSR1)
+    // Raising the flush signal writes the events recorded so far
+    std::raise(SIGUSR1);
+    for (int i = 0; i < 100 && !std::filesystem::exists(trace_file); ++i)
+    {
+        pika::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    PIKA_TEST_LTE(num_tasks, count(read_trace(), "\"ph\":\"B\""));
+#endif
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    pika::init_params init_args;
+    init_args.cfg = {"pika.os_threads=" + std::to_string(max_threads),
+        "pika.trace.file!=" + trace_file};
+#if defined(SIGUSR1)
+    init_args.cfg.push_back("pika.trace.flush_signal=" + std::to_string(SIGUSR1));
+
+    // The tracer restores the handler installed by the application when it
+    // stops
+    struct sigaction action = {};
+    action.sa_handler = on_application_signal;
+    sigemptyset(&action.sa_mask);
+    PIKA_TEST_EQ(sigaction(SIGUSR1, &action, nullptr), 0);
+#endif
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+
+#if defined(SIGUSR1)
+    struct sigaction restored_action = {};
+    PIKA_TEST_EQ(sigaction(SIGUSR1, nullptr, &restored_action), 0);
+    PIKA_TEST(restored_action.sa_handler == on_application_signal);
+#endif
+
+    std::string const trace = read_trace();
+    PIKA_TEST_EQ(trace.rfind("{\"traceEvents\":[", 0), std::size_t(0));
+    PIKA_TEST_EQ(trace.compare(trace.size() - 2, 2, "}\n"), 0);
+
+    // One thread name per worker thread
+    PIKA_TEST_EQ(count(trace, "\"name\":\"thread_name\""), max_threads);
+    for (std::size_t i = 0; i != max_threads; ++i)
+    {
+        PIKA_TEST_NEQ(trace.find("\"name\":\"default/worker-" + std::to_string(i) + "\""),
+            std::string::npos);
+    }
+
+    // Every task phase has a begin and an end, the pools have stopped before
+    // the trace is written
+    std::size_t const num_begin = count(trace, "\"ph\":\"B\"");
+    std::size_t const num_end = count(trace, "\"ph\":\"E\"");
+    PIKA_TEST_LTE(num_tasks, num_begin);
+    PIKA_TEST_EQ(num_begin, num_end);
+    PIKA_TEST_LTE(num_tasks, count(trace, "\"state\":\"terminated\""));
+    PIKA_TEST_LTE(std::size_t(1), count(trace, "\"state\":\"suspended\""));
+
+    std::filesystem::remove(trace_file);
+
+    return 0;
+}
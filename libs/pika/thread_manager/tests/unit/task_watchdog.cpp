@@ -0,0 +1,87 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The task watchdog reports tasks running for longer than pika.watchdog.budget
+// without yielding, once per task.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/thread_manager.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+std::size_t const max_threads =
+    (std::min)(std::size_t(4), std::size_t(pika::threads::detail::hardware_concurrency()));
+
+std::int64_t get_long_running_task_count()
+{
+    return pika::detail::get_runtime().get_thread_manager().get_long_running_task_count();
+}
+
+void spin(std::chrono::milliseconds duration)
+{
+    auto const end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {}
+}
+
+int pika_main()
+{
+    auto const sched = ex::with_annotation(ex::thread_pool_scheduler{}, "task_watchdog_test");
+
+    // Tasks within the budget are not reported
+    std::int64_t const count_before = get_long_running_task_count();
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        tt::sync_wait(ex::schedule(sched) | ex::then([] { spin(std::chrono::milliseconds(1)); }));
+    }
+    PIKA_TEST_EQ(get_long_running_task_count(), count_before);
+
+    // A task exceeding the budget is reported exactly once, even though the
+    // watchdog sees it running several times
+    tt::sync_wait(ex::schedule(sched) | ex::then([] { spin(std::chrono::milliseconds(500)); }));
+    PIKA_TEST_EQ(get_long_running_task_count(), count_before + 1);
+
+    // Tasks that yield in between are reported per invocation
+    tt::sync_wait(ex::schedule(sched) | ex::then([] {
+        spin(std::chrono::milliseconds(300));
+        pika::this_thread::yield();
+        spin(std::chrono::milliseconds(300));
+    }));
+    PIKA_TEST_EQ(get_long_running_task_count(), count_before + 3);
+
+    // Inline tasks, which run directly on the worker thread without a pika
+    // thread of their own, are reported as well
+    auto const inline_sched = ex::with_stacksize(sched, pika::execution::thread_stacksize::nostack);
+    tt::sync_wait(ex::schedule(inline_sched) | ex::then([] {
+        PIKA_TEST(pika::threads::detail::scheduler_base::is_running_inline_task());
+        spin(std::chrono::milliseconds(500));
+    }));
+    PIKA_TEST_EQ(get_long_running_task_count(), count_before + 4);
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    pika::init_params init_args;
+    init_args.cfg = {"pika.os_threads=" + std::to_string(max_threads), "pika.watchdog.enable=1",
+        "pika.watchdog.interval=10", "pika.watchdog.budget=100"};
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+
+    return 0;
+}
@@ -15,6 +15,7 @@
 #include <pika/modules/errors.hpp>
 #include <pika/thread_pools/scheduling_loop.hpp>
 #include <pika/threading_base/callback_notifier.hpp>
+#include <pika/threading_base/detail/running_task.hpp>
 #include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/thread_pool_base.hpp>
 #include <pika/topology/cpu_mask.hpp>
@@ -70,6 +71,7 @@ namespace pika::threads::detail {
         void create_thread(thread_init_data& data, thread_id_ref_type& id, error_code& ec) override;
 
         thread_id_ref_type create_work(thread_init_data& data, error_code& ec) override;
+        void create_work_bulk(thread_init_data* data, std::size_t count, error_code& ec) override;
 
         thread_state set_state(thread_id_type const& id, thread_schedule_state new_state,
             thread_restart_state new_state_ex, execution::thread_priority priority,
@@ -95,6 +97,8 @@ namespace pika::threads::detail {
 
         std::int64_t get_idle_core_count() const override;
 
+        bool get_running_task(std::size_t num_thread, running_task& task) const override;
+
         void get_idle_core_mask(mask_type&) const override;
 
         bool enumerate_threads(util::detail::function<bool(thread_id_type)> const& f,
@@ -123,11 +127,14 @@ namespace pika::threads::detail {
         void resume_direct(error_code& ec = throws) override;
 
     private:
-        void suspend_processing_unit_internal(std::size_t virt_core, error_code&);
+        void suspend_processing_unit_internal(
+            std::size_t virt_core, error_code&, bool blocking = true);
 
     public:
         void suspend_processing_unit_direct(
             std::size_t virt_core, error_code& = pika::throws) override;
+        void suspend_processing_unit_nonblocking(
+            std::size_t virt_core, error_code& = pika::throws) override;
         void resume_processing_unit_direct(
             std::size_t virt_core, error_code& = pika::throws) override;
 
@@ -321,6 +328,10 @@ namespace pika::threads::detail {
         std::vector<pika::concurrency::detail::cache_aligned_data<scheduling_counter_data>>
             counter_data_;
 
+        // tasks currently running on the worker threads, see running_task_slot
+        std::unique_ptr<pika::concurrency::detail::cache_aligned_data<running_task_slot>[]>
+            running_tasks_;
+
         std::atomic<long> thread_count_;
 
         std::size_t max_idle_loop_count_;
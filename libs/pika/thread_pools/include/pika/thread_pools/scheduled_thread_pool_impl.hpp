@@ -174,16 +174,22 @@ namespace pika::threads::detail {
     template <typename Scheduler>
     bool scheduled_thread_pool<Scheduler>::is_busy()
     {
-        // If we are currently on a pika thread, which runs on the current pool,
-        // we ignore it for the purposes of checking if the pool is busy (i.e.
+        // If we are currently on a pika thread or in an inline task, which runs
+        // on the current pool, we ignore it for the purposes of checking if the pool is busy (i.e.
         // this returns true only if there is *other* work left on this pool).
         std::int64_t pika_thread_offset =
             (threads::detail::get_self_ptr() && this_thread::get_pool() == this) ? 1 : 0;
         bool have_pika_threads =
             get_thread_count_unknown(std::size_t(-1), false) > pika_thread_offset;
         bool have_polling_work = sched_->Scheduler::get_polling_work_count() > 0;
-
-        return have_pika_threads || have_polling_work;
+        std::size_t inline_task_offset =
+            (Scheduler::is_running_inline_task() &&
+                threads::detail::get_thread_pool_num_tss() == get_pool_index()) ?
+            1 :
+            0;
+        bool have_inline_tasks = sched_->Scheduler::get_inline_task_count() > inline_task_offset;
+
+        return have_pika_threads || have_polling_work || have_inline_tasks;
     }
 
     template <typename Scheduler>
@@ -218,7 +224,7 @@ namespace pika::threads::detail {
             sched_->Scheduler::set_all_states_at_least(runtime_state::stopping);
 
             // make sure we're not waiting
-            sched_->Scheduler::do_some_work(std::size_t(-1));
+            sched_->Scheduler::do_all_work();
 
             if (blocking)
             {
@@ -230,7 +236,7 @@ namespace pika::threads::detail {
                     // make sure no OS thread is waiting
                     PIKA_LOG(info, "pool \"{}\" notify_all", id_.name());
 
-                    sched_->Scheduler::do_some_work(std::size_t(-1));
+                    sched_->Scheduler::do_all_work();
 
                     PIKA_LOG(info, "pool \"{}\" join:{}", id_.name(), i);
 
@@ -457,7 +463,8 @@ namespace pika::threads::detail {
                 scheduling_counters counters(counter_data.executed_threads_,
                     counter_data.executed_thread_phases_, counter_data.tfunc_times_,
                     counter_data.exec_times_, counter_data.idle_loop_counts_,
-                    counter_data.busy_loop_counts_, counter_data.tasks_active_);
+                    counter_data.busy_loop_counts_, counter_data.tasks_active_,
+                    running_tasks_[thread_num].data_);
 
                 scheduling_callbacks callbacks(
                     util::detail::deferred_call(    //-V107
@@ -550,6 +557,23 @@ namespace pika::threads::detail {
         return id;
     }
 
+    template <typename Scheduler>
+    void scheduled_thread_pool<Scheduler>::create_work_bulk(
+        thread_init_data* data, std::size_t count, error_code& ec)
+    {
+        // verify state
+        if (thread_count_ == 0 && !sched_->Scheduler::is_state(runtime_state::running))
+        {
+            // thread-manager is not currently running
+            PIKA_THROWS_IF(ec, pika::error::invalid_status,
+                "thread_pool<Scheduler>::create_work_bulk",
+                "invalid state: thread pool is not running");
+            return;
+        }
+
+        threads::detail::create_work_bulk(sched_.get(), data, count, ec);
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     template <typename Scheduler>
     thread_state scheduled_thread_pool<Scheduler>::set_state(thread_id_type const& id,
@@ -1269,6 +1293,14 @@ namespace pika::threads::detail {
         return count;
     }
 
+    template <typename Scheduler>
+    bool scheduled_thread_pool<Scheduler>::get_running_task(
+        std::size_t num_thread, running_task& task) const
+    {
+        if (num_thread >= counter_data_.size()) { return false; }
+        return running_tasks_[num_thread].data_.read(task);
+    }
+
     template <typename Scheduler>
     void scheduled_thread_pool<Scheduler>::get_idle_core_mask(mask_type& mask) const
     {
@@ -1285,6 +1317,8 @@ namespace pika::threads::detail {
     void scheduled_thread_pool<Scheduler>::init_perf_counter_data(std::size_t pool_threads)
     {
         counter_data_.resize(pool_threads);
+        running_tasks_.reset(
+            new pika::concurrency::detail::cache_aligned_data<running_task_slot>[pool_threads]);
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -1368,7 +1402,7 @@ namespace pika::threads::detail {
 
     template <typename Scheduler>
     void scheduled_thread_pool<Scheduler>::suspend_processing_unit_internal(
-        std::size_t virt_core, error_code& ec)
+        std::size_t virt_core, error_code& ec, bool blocking)
     {
         // Yield to other pika threads if lock is not available to avoid
         // deadlocks when multiple pika threads try to resume or suspend pus.
@@ -1398,6 +1432,8 @@ namespace pika::threads::detail {
         PIKA_ASSERT(expected == runtime_state::running || expected == runtime_state::pre_sleep ||
             expected == runtime_state::sleeping);
 
+        if (!blocking) { return; }
+
         util::yield_while([&state]() { return state.load() == runtime_state::pre_sleep; },
             "scheduled_thread_pool::suspend_processing_unit_internal");
     }
@@ -1426,6 +1462,21 @@ namespace pika::threads::detail {
         suspend_processing_unit_internal(virt_core, ec);
     }
 
+    template <typename Scheduler>
+    void scheduled_thread_pool<Scheduler>::suspend_processing_unit_nonblocking(
+        std::size_t virt_core, error_code& ec)
+    {
+        if (!get_scheduler()->has_scheduler_mode(scheduler_mode::enable_elasticity))
+        {
+            PIKA_THROWS_IF(ec, pika::error::invalid_status,
+                "scheduled_thread_pool<Scheduler>::suspend_processing_unit_nonblocking",
+                "this thread pool does not support suspending processing units");
+            return;
+        }
+
+        suspend_processing_unit_internal(virt_core, ec, false);
+    }
+
     template <typename Scheduler>
     void scheduled_thread_pool<Scheduler>::resume_processing_unit_direct(
         std::size_t virt_core, error_code& ec)
@@ -10,6 +10,9 @@
 #include <pika/assert.hpp>
 #include <pika/functional/unique_function.hpp>
 #include <pika/logging.hpp>
+#include <pika/threading_base/detail/running_task.hpp>
+#include <pika/threading_base/detail/scheduler_counters.hpp>
+#include <pika/threading_base/detail/task_trace.hpp>
 #include <pika/threading_base/external_timer.hpp>
 #include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/scheduler_state.hpp>
@@ -208,13 +211,90 @@ namespace pika::threads::detail {
         bool& is_active_;
     };
 
+    ///////////////////////////////////////////////////////////////////////////
+    // Records the running thread in the running task slot of the worker thread
+    // while running task tracking is enabled
+    struct running_task_wrapper
+    {
+        running_task_wrapper(running_task_slot& slot, thread_data* thrd)
+          : slot_(running_task_tracking_enabled.load(std::memory_order_relaxed) ? &slot : nullptr)
+        {
+            if (slot_) { slot_->start(thrd, thrd->get_description()); }
+        }
+        ~running_task_wrapper()
+        {
+            if (slot_) { slot_->stop(); }
+        }
+
+        running_task_slot* slot_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Updates the queue wait time, execution time and executed phases of the
+    // scheduler counters of the worker thread while they are enabled
+    struct scheduler_counters_wrapper
+    {
+        scheduler_counters_wrapper(scheduler_counters& counters, thread_data* thrd)
+          : counters_(
+                scheduler_counters_enabled.load(std::memory_order_relaxed) ? &counters : nullptr)
+        {
+            if (counters_)
+            {
+                start_ = scheduler_counters_timestamp();
+                std::int64_t const ready_time = thrd->exchange_ready_time();
+                if (ready_time != 0 && ready_time <= start_)
+                {
+                    counters_->add_queue_wait_time(start_ - ready_time);
+                }
+            }
+        }
+        ~scheduler_counters_wrapper()
+        {
+            if (counters_)
+            {
+                counters_->add_exec_time(scheduler_counters_timestamp() - start_);
+                counters_->add_executed_thread_phase();
+            }
+        }
+
+        scheduler_counters* counters_;
+        std::int64_t start_ = 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Records the begin and end of a task phase in the trace buffer of the
+    // worker thread while task tracing is enabled
+    struct task_trace_wrapper
+    {
+        task_trace_wrapper(thread_data* thrd, switch_status const& status)
+          : thrd_(task_tracing_enabled.load(std::memory_order_relaxed) ? thrd : nullptr)
+          , status_(status)
+        {
+            if (thrd_)
+            {
+                record_task_trace_event(trace_event_type::begin, thrd_, thrd_->get_description());
+            }
+        }
+        ~task_trace_wrapper()
+        {
+            if (thrd_)
+            {
+                record_task_trace_event(trace_event_type::end, thrd_,
+                    static_cast<std::size_t>(status_.get_previous()));
+            }
+        }
+
+        thread_data* thrd_;
+        switch_status const& status_;
+    };
+
     ///////////////////////////////////////////////////////////////////////////
     struct scheduling_counters
     {
         // NOLINTBEGIN(bugprone-easily-swappable-parameters)
         scheduling_counters(std::int64_t& executed_threads, std::int64_t& executed_thread_phases,
             std::int64_t& tfunc_time, std::int64_t& exec_time, std::int64_t& idle_loop_count,
-            std::int64_t& busy_loop_count, bool& is_active)
+            std::int64_t& busy_loop_count, bool& is_active, running_task_slot& running_task)
           // NOLINTEND(bugprone-easily-swappable-parameters)
           : executed_threads_(executed_threads)
           , executed_thread_phases_(executed_thread_phases)
@@ -223,6 +303,7 @@ namespace pika::threads::detail {
           , idle_loop_count_(idle_loop_count)
           , busy_loop_count_(busy_loop_count)
           , is_active_(is_active)
+          , running_task_(running_task)
         {
         }
 
@@ -233,6 +314,7 @@ namespace pika::threads::detail {
         std::int64_t& idle_loop_count_;
         std::int64_t& busy_loop_count_;
         bool& is_active_;
+        running_task_slot& running_task_;
     };
 
     struct scheduling_callbacks
@@ -268,6 +350,9 @@ namespace pika::threads::detail {
         std::int64_t& idle_loop_count = counters.idle_loop_count_;
         std::int64_t& busy_loop_count = counters.busy_loop_count_;
 
+        scheduler_counters& runtime_counters = scheduler.get_scheduler_counters(num_thread);
+        std::int64_t last_loop_timestamp = 0;
+
         idle_collect_rate idle_rate(counters.tfunc_time_, counters.exec_time_);
         tfunc_time_wrapper tfunc_time_collector(idle_rate);
 
@@ -286,6 +371,19 @@ namespace pika::threads::detail {
             // NOLINTNEXTLINE(bugprone-use-after-move)
             thread_id_ref_type thrd = std::move(next_thrd);
 
+            // the scheduler counters are switched on and off at runtime, the
+            // loop time is accumulated only while they stay enabled
+            if (PIKA_UNLIKELY(scheduler_counters_enabled.load(std::memory_order_relaxed)))
+            {
+                std::int64_t const now = scheduler_counters_timestamp();
+                if (last_loop_timestamp != 0)
+                {
+                    runtime_counters.add_loop_time(now - last_loop_timestamp);
+                }
+                last_loop_timestamp = now;
+            }
+            else { last_loop_timestamp = 0; }
+
             // Get the next pika thread from the queue
             bool running = this_state.load(std::memory_order_relaxed) < runtime_state::pre_sleep;
 
@@ -343,6 +441,11 @@ namespace pika::threads::detail {
                                 // and add to aggregate execution time.
                                 exec_time_wrapper exec_time_collector(idle_rate);
 
+                                running_task_wrapper running_task(counters.running_task_, thrdptr);
+                                scheduler_counters_wrapper scheduler_counters_collector(
+                                    runtime_counters, thrdptr);
+                                task_trace_wrapper task_trace(thrdptr, thrd_stat);
+
 #if defined(PIKA_HAVE_APEX)
                                 // get the APEX data pointer, in case we are resuming the
                                 // thread and have to restore any leaf timers from
@@ -437,6 +540,7 @@ namespace pika::threads::detail {
 
                         // schedule this thread again, make sure it ends up at
                         // the end of the queue
+                        get_thread_id_data(thrd)->set_ready_time();
                         scheduler.SchedulingPolicy::schedule_thread_last(std::move(thrd),
                             execution::thread_schedule_hint(static_cast<std::int16_t>(num_thread)),
                             true);
@@ -445,6 +549,7 @@ namespace pika::threads::detail {
                     else if (PIKA_UNLIKELY(state_val == thread_schedule_state::pending_boost))
                     {
                         get_thread_id_data(thrd)->set_state(thread_schedule_state::pending);
+                        get_thread_id_data(thrd)->set_ready_time();
 
                         if (PIKA_LIKELY(next_thrd == nullptr))
                         {
@@ -508,6 +613,10 @@ namespace pika::threads::detail {
 #ifdef PIKA_HAVE_THREAD_CUMULATIVE_COUNTS
                     ++counters.executed_threads_;
 #endif
+                    if (PIKA_UNLIKELY(scheduler_counters_enabled.load(std::memory_order_relaxed)))
+                    {
+                        runtime_counters.add_executed_thread();
+                    }
                     thrd = thread_id_type();
                 }
             }
@@ -520,21 +629,39 @@ namespace pika::threads::detail {
                 if (scheduler.SchedulingPolicy::wait_or_add_new(
                         num_thread, running, idle_loop_count, enable_stealing_staged, added))
                 {
+                    // The state is read before the inline task count, see
+                    // scheduler_base::schedule_inline_task
+                    bool const pre_sleep = this_state.load() == runtime_state::pre_sleep;
+
                     // Clean up terminated threads before trying to exit
                     bool can_exit = !running &&
                         scheduler.SchedulingPolicy::cleanup_terminated(num_thread, true) &&
-                        scheduler.SchedulingPolicy::get_queue_length(num_thread) == 0;
-
-                    if (this_state.load() == runtime_state::pre_sleep)
+                        scheduler.SchedulingPolicy::get_queue_length(num_thread) == 0 &&
+                        scheduler.get_inline_task_count(num_thread) == 0;
+
+                    // Pending timers do not prevent suspending this worker: they are polled by
+                    // the remaining workers, or after the pool has been resumed. When stopping,
+                    // timers which can be stopped (e.g. those of timed senders) are completed
+                    // early instead of waiting for their deadline. The remaining timers belong
+                    // to suspended threads and keep the worker alive until they expire.
+                    if (pre_sleep)
                     {
                         if (can_exit) { scheduler.SchedulingPolicy::suspend(num_thread); }
                     }
                     else
                     {
+                        // Stopped timers may have scheduled more work
+                        if (!running && scheduler.stop_timers() != 0)
+                        {
+                            can_exit = false;
+                            idle_loop_count = 0;
+                        }
+
                         can_exit = can_exit &&
                             scheduler.SchedulingPolicy::get_thread_count(
                                 thread_schedule_state::suspended,
-                                execution::thread_priority::default_, num_thread) == 0;
+                                execution::thread_priority::default_, num_thread) == 0 &&
+                            scheduler.get_timer_wheel().empty();
 
                         if (can_exit)
                         {
@@ -557,6 +684,23 @@ namespace pika::threads::detail {
                 idle_loop_count = 0;
             }
 
+            // run continuations that don't need a pika thread of their own,
+            // recording them in the running task slot like other tasks
+            if (scheduler.run_inline_tasks(num_thread, enable_stealing,
+                    running_task_tracking_enabled.load(std::memory_order_relaxed) ?
+                        &counters.running_task_ :
+                        nullptr) == pika::threads::detail::polling_status::busy)
+            {
+                idle_loop_count = 0;
+                may_exit = false;
+            }
+
+            // wake up threads whose timed suspension has expired
+            if (scheduler.poll_timers() == pika::threads::detail::polling_status::busy)
+            {
+                idle_loop_count = 0;
+            }
+
             // something went badly wrong, give up
             if (PIKA_UNLIKELY(this_state.load() == runtime_state::terminating)) break;
 
@@ -575,15 +719,19 @@ namespace pika::threads::detail {
                 // break if we were idling after 'may_exit'
                 if (may_exit)
                 {
+                    // The state is read before the inline task count, see
+                    // scheduler_base::schedule_inline_task
                     PIKA_ASSERT(this_state.load() != runtime_state::pre_sleep);
 
                     {
-                        bool can_exit = !running &&
+                        bool can_exit = this_state.load() > runtime_state::pre_sleep &&
                             scheduler.SchedulingPolicy::cleanup_terminated(true) &&
                             scheduler.SchedulingPolicy::get_thread_count(
                                 thread_schedule_state::suspended,
                                 execution::thread_priority::default_, num_thread) == 0 &&
-                            scheduler.SchedulingPolicy::get_queue_length(num_thread) == 0;
+                            scheduler.SchedulingPolicy::get_queue_length(num_thread) == 0 &&
+                            scheduler.get_inline_task_count(num_thread) == 0 &&
+                            scheduler.get_timer_wheel().empty();
 
                         if (can_exit)
                         {
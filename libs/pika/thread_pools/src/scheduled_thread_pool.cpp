@@ -5,6 +5,7 @@
 //  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
 #include <pika/config.hpp>
+#include <pika/schedulers/edf_queue_scheduler.hpp>
 #include <pika/schedulers/local_priority_queue_scheduler.hpp>
 #include <pika/schedulers/local_queue_scheduler.hpp>
 #include <pika/schedulers/shared_priority_queue_scheduler.hpp>
@@ -48,6 +49,20 @@ template class PIKA_EXPORT pika::threads::detail::scheduled_thread_pool<pika::th
         local_priority_queue_scheduler<std::mutex, pika::threads::detail::lockfree_abp_lifo>>;
 #endif
 
+template class PIKA_EXPORT pika::threads::detail::local_priority_queue_scheduler<std::mutex,
+    pika::threads::detail::lockfree_work_stealing, pika::threads::detail::lockfree_work_stealing>;
+template class PIKA_EXPORT pika::threads::detail::scheduled_thread_pool<
+    pika::threads::detail::local_priority_queue_scheduler<std::mutex,
+        pika::threads::detail::lockfree_work_stealing,
+        pika::threads::detail::lockfree_work_stealing>>;
+
+template class PIKA_EXPORT pika::threads::detail::local_priority_queue_scheduler<std::mutex,
+    pika::threads::detail::edf, pika::threads::detail::lockfree_fifo,
+    pika::threads::detail::lockfree_fifo>;
+template class PIKA_EXPORT pika::threads::detail::edf_queue_scheduler<>;
+template class PIKA_EXPORT pika::threads::detail::scheduled_thread_pool<
+    pika::threads::detail::edf_queue_scheduler<>>;
+
 template class PIKA_EXPORT pika::threads::detail::shared_priority_queue_scheduler<>;
 template class PIKA_EXPORT pika::threads::detail::scheduled_thread_pool<
     pika::threads::detail::shared_priority_queue_scheduler<>>;
@@ -11,7 +11,14 @@
 #include <pika/threading_base/thread_init_data.hpp>
 #include <pika/threading_base/threading_base_fwd.hpp>
 
+#include <cstddef>
+
 namespace pika::threads::detail {
     PIKA_EXPORT thread_id_ref_type create_work(
         scheduler_base* scheduler, thread_init_data& data, error_code& ec = throws);
+
+    // Create count threads at once, the threads are moved from data. All
+    // threads must have 'pending' as their initial state.
+    PIKA_EXPORT void create_work_bulk(scheduler_base* scheduler, thread_init_data* data,
+        std::size_t count, error_code& ec = throws);
 }    // namespace pika::threads::detail
@@ -12,6 +12,7 @@
 
 namespace pika::threads::detail {
     PIKA_EXPORT void increment_global_activity_count();
+    PIKA_EXPORT void increment_global_activity_count(std::size_t count);
     PIKA_EXPORT void decrement_global_activity_count();
     PIKA_EXPORT std::size_t get_global_activity_count();
 }    // namespace pika::threads::detail
@@ -0,0 +1,92 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/threading_base/thread_description.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace pika::threads::detail {
+    /// Set when worker threads should record their running tasks in their
+    /// running_task_slot. Only enabled while something, e.g. the task
+    /// watchdog, reads the slots.
+    PIKA_EXPORT extern std::atomic<bool> running_task_tracking_enabled;
+
+    /// A snapshot of the task running on a worker thread
+    struct running_task
+    {
+        std::chrono::steady_clock::time_point start_time;
+        // Only used for identifying the task, never dereferenced
+        void const* id = nullptr;
+        // The annotation of the task, or nullptr if only the address of the
+        // task function is known
+        char const* description = nullptr;
+        std::size_t address = 0;
+    };
+
+    /// Records the task currently running on a worker thread. The worker
+    /// thread writes the slot when it switches to and from a task, and other
+    /// threads may read it concurrently. The start time doubles as a sequence
+    /// number, a snapshot is only valid if the start time did not change while
+    /// reading the slot.
+    class running_task_slot
+    {
+    public:
+        void start(void const* id, ::pika::detail::thread_description const& desc) noexcept
+        {
+            start_time_.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            id_.store(id, std::memory_order_relaxed);
+            if (desc.kind() == ::pika::detail::thread_description::data_type_description)
+            {
+                description_.store(desc.get_description(), std::memory_order_relaxed);
+                address_.store(0, std::memory_order_relaxed);
+            }
+            else
+            {
+                description_.store(nullptr, std::memory_order_relaxed);
+                address_.store(desc.get_address(), std::memory_order_relaxed);
+            }
+
+            std::int64_t const now = std::chrono::steady_clock::now().time_since_epoch().count();
+            start_time_.store(now != 0 ? now : 1, std::memory_order_release);
+        }
+
+        void stop() noexcept { start_time_.store(0, std::memory_order_release); }
+
+        /// Read the task currently running on the worker thread. Returns false
+        /// if no task is running, or if the worker thread switched tasks while
+        /// reading the slot.
+        bool read(running_task& task) const noexcept
+        {
+            std::int64_t const start_time = start_time_.load(std::memory_order_acquire);
+            if (start_time == 0) { return false; }
+
+            task.id = id_.load(std::memory_order_relaxed);
+            task.description = description_.load(std::memory_order_relaxed);
+            task.address = address_.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (start_time_.load(std::memory_order_relaxed) != start_time) { return false; }
+
+            task.start_time = std::chrono::steady_clock::time_point(
+                std::chrono::steady_clock::duration(start_time));
+            return true;
+        }
+
+    private:
+        std::atomic<std::int64_t> start_time_{0};
+        std::atomic<void const*> id_{nullptr};
+        std::atomic<char const*> description_{nullptr};
+        std::atomic<std::size_t> address_{0};
+    };
+}    // namespace pika::threads::detail
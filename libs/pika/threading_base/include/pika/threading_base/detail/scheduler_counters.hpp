@@ -0,0 +1,138 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace pika::threads::detail {
+    /// Set when worker threads should update their scheduler_counters. Unlike
+    /// the counters enabled with PIKA_WITH_THREAD_IDLE_RATES and friends the
+    /// scheduler counters are always compiled in. While disabled they cost a
+    /// relaxed load of this flag per scheduling loop iteration, per task
+    /// execution, per steal, and per task made ready. Defaults to the value of
+    /// pika.scheduler_counters.
+    ///
+    /// The compile time counters are independent of this flag and keep
+    /// counting whenever they are compiled in. They are more detailed, e.g.
+    /// they separate pending and staged threads and creation and cleanup
+    /// times, and are exposed through the corresponding thread_pool_base
+    /// member functions.
+    PIKA_EXPORT extern std::atomic<bool> scheduler_counters_enabled;
+
+    PIKA_EXPORT void set_scheduler_counters_enabled(bool enabled);
+    PIKA_EXPORT bool get_scheduler_counters_enabled();
+
+    /// Timestamp in nanoseconds used by the scheduler counters
+    inline std::int64_t scheduler_counters_timestamp() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /// A snapshot of the scheduler counters of one or more worker threads.
+    /// Times are in nanoseconds.
+    struct scheduler_counter_values
+    {
+        /// Number of pika threads that ran to completion
+        std::int64_t executed_threads = 0;
+        /// Number of times pika threads were switched to
+        std::int64_t executed_thread_phases = 0;
+        /// Time spent in the scheduling loop
+        std::int64_t loop_time = 0;
+        /// Time spent executing pika threads
+        std::int64_t exec_time = 0;
+        /// Number of pika threads taken from the queues of other worker
+        /// threads
+        std::int64_t stolen_threads = 0;
+        /// Time pika threads spent queued before being executed, and the
+        /// number of pika threads the time was measured for
+        std::int64_t queue_wait_time = 0;
+        std::int64_t queue_wait_count = 0;
+
+        /// Fraction of loop_time not spent executing pika threads, in [0, 1]
+        double idle_rate() const noexcept
+        {
+            if (loop_time <= 0) { return 0.0; }
+            double const rate = 1.0 - static_cast<double>(exec_time) / loop_time;
+            return rate < 0.0 ? 0.0 : rate;
+        }
+
+        /// Average time a pika thread spent queued before being executed
+        std::int64_t average_queue_wait_time() const noexcept
+        {
+            return queue_wait_count == 0 ? 0 : queue_wait_time / queue_wait_count;
+        }
+
+        scheduler_counter_values& operator+=(scheduler_counter_values const& other) noexcept
+        {
+            executed_threads += other.executed_threads;
+            executed_thread_phases += other.executed_thread_phases;
+            loop_time += other.loop_time;
+            exec_time += other.exec_time;
+            stolen_threads += other.stolen_threads;
+            queue_wait_time += other.queue_wait_time;
+            queue_wait_count += other.queue_wait_count;
+            return *this;
+        }
+    };
+
+    /// The scheduler counters of a single worker thread. The counters are
+    /// only written by the worker thread they belong to, and may be read and
+    /// reset concurrently from any thread.
+    class scheduler_counters
+    {
+    public:
+        void add_executed_thread() noexcept { add(executed_threads_, 1); }
+        void add_executed_thread_phase() noexcept { add(executed_thread_phases_, 1); }
+        void add_loop_time(std::int64_t t) noexcept { add(loop_time_, t); }
+        void add_exec_time(std::int64_t t) noexcept { add(exec_time_, t); }
+        void add_stolen_threads(std::int64_t num) noexcept { add(stolen_threads_, num); }
+        void add_queue_wait_time(std::int64_t t) noexcept
+        {
+            add(queue_wait_time_, t);
+            add(queue_wait_count_, 1);
+        }
+
+        scheduler_counter_values get(bool reset) noexcept
+        {
+            scheduler_counter_values values;
+            values.executed_threads = get(executed_threads_, reset);
+            values.executed_thread_phases = get(executed_thread_phases_, reset);
+            values.loop_time = get(loop_time_, reset);
+            values.exec_time = get(exec_time_, reset);
+            values.stolen_threads = get(stolen_threads_, reset);
+            values.queue_wait_time = get(queue_wait_time_, reset);
+            values.queue_wait_count = get(queue_wait_count_, reset);
+            return values;
+        }
+
+    private:
+        static void add(std::atomic<std::int64_t>& counter, std::int64_t value) noexcept
+        {
+            counter.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        static std::int64_t get(std::atomic<std::int64_t>& counter, bool reset) noexcept
+        {
+            return reset ? counter.exchange(0, std::memory_order_relaxed) :
+                           counter.load(std::memory_order_relaxed);
+        }
+
+        std::atomic<std::int64_t> executed_threads_{0};
+        std::atomic<std::int64_t> executed_thread_phases_{0};
+        std::atomic<std::int64_t> loop_time_{0};
+        std::atomic<std::int64_t> exec_time_{0};
+        std::atomic<std::int64_t> stolen_threads_{0};
+        std::atomic<std::int64_t> queue_wait_time_{0};
+        std::atomic<std::int64_t> queue_wait_count_{0};
+    };
+}    // namespace pika::threads::detail
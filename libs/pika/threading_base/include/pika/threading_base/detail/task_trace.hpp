@@ -0,0 +1,155 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/threading_base/thread_description.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace pika::threads::detail {
+    enum class trace_event_type : std::uint8_t
+    {
+        // A worker thread switched to a task, i.e. the task started or resumed
+        begin = 0,
+        // A task returned to the worker thread, the state tells whether it
+        // terminated, suspended or yielded
+        end = 1,
+        // A worker thread took tasks from the queue of another worker thread
+        steal = 2,
+    };
+
+    /// A single event read from a trace_buffer
+    struct trace_event
+    {
+        std::int64_t timestamp = 0;    // nanoseconds, steady_clock
+        trace_event_type type = trace_event_type::begin;
+        // The task the event refers to, only used for identifying the task,
+        // never dereferenced
+        void const* id = nullptr;
+        // The annotation of the task, or nullptr if only the address of the
+        // task function is known
+        char const* description = nullptr;
+        // The address of the task function, the thread_schedule_state the
+        // task returned with for end events, or the number of stolen tasks
+        // for steal events
+        std::size_t data = 0;
+    };
+
+    /// A fixed size ring buffer of the trace events of a single worker
+    /// thread. Only the worker thread writes to the buffer, and it never
+    /// blocks. When the buffer is full the oldest events are overwritten.
+    /// The buffer may be read concurrently, events overwritten while reading
+    /// are dropped.
+    class trace_buffer
+    {
+    public:
+        PIKA_EXPORT explicit trace_buffer(std::size_t capacity);
+
+        trace_buffer(trace_buffer const&) = delete;
+        trace_buffer(trace_buffer&&) = delete;
+        trace_buffer& operator=(trace_buffer const&) = delete;
+        trace_buffer& operator=(trace_buffer&&) = delete;
+
+        void record(trace_event_type type, void const* id, char const* description,
+            std::size_t data) noexcept
+        {
+            std::uint64_t const head = head_.load(std::memory_order_relaxed);
+            slot& s = slots_[head % capacity_];
+
+            // Invalidate the slot while it is being written
+            s.sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            s.timestamp.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::steady_clock::now().time_since_epoch())
+                                  .count(),
+                std::memory_order_relaxed);
+            s.type.store(type, std::memory_order_relaxed);
+            s.id.store(id, std::memory_order_relaxed);
+            s.description.store(description, std::memory_order_relaxed);
+            s.data.store(data, std::memory_order_relaxed);
+
+            s.sequence.store(head + 1, std::memory_order_release);
+            head_.store(head + 1, std::memory_order_release);
+        }
+
+        /// Call f with each event still in the buffer, oldest first
+        template <typename F>
+        void for_each(F&& f) const
+        {
+            std::uint64_t const head = head_.load(std::memory_order_acquire);
+            std::uint64_t const begin = head > capacity_ ? head - capacity_ : 0;
+            for (std::uint64_t i = begin; i != head; ++i)
+            {
+                slot const& s = slots_[i % capacity_];
+                if (s.sequence.load(std::memory_order_acquire) != i + 1) { continue; }
+
+                trace_event e;
+                e.timestamp = s.timestamp.load(std::memory_order_relaxed);
+                e.type = s.type.load(std::memory_order_relaxed);
+                e.id = s.id.load(std::memory_order_relaxed);
+                e.description = s.description.load(std::memory_order_relaxed);
+                e.data = s.data.load(std::memory_order_relaxed);
+
+                // Drop the event if it was overwritten while reading it
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.sequence.load(std::memory_order_relaxed) != i + 1) { continue; }
+
+                f(e);
+            }
+        }
+
+        /// Return the total number of events recorded, including overwritten
+        /// events
+        std::uint64_t size() const noexcept { return head_.load(std::memory_order_acquire); }
+
+    private:
+        struct slot
+        {
+            // The index of the event in the slot plus one, 0 while the slot is
+            // being written
+            std::atomic<std::uint64_t> sequence{0};
+            std::atomic<std::int64_t> timestamp{0};
+            std::atomic<trace_event_type> type{trace_event_type::begin};
+            std::atomic<void const*> id{nullptr};
+            std::atomic<char const*> description{nullptr};
+            std::atomic<std::size_t> data{0};
+        };
+
+        std::size_t const capacity_;
+        std::unique_ptr<slot[]> slots_;
+        std::atomic<std::uint64_t> head_{0};
+    };
+
+    /// Set while task tracing is enabled, see enable_task_tracing
+    PIKA_EXPORT extern std::atomic<bool> task_tracing_enabled;
+
+    /// Allocate one trace buffer of the given capacity per worker thread and
+    /// start recording events. Must not be called while tracing is enabled.
+    PIKA_EXPORT void enable_task_tracing(std::size_t num_threads, std::size_t capacity);
+
+    /// Stop recording events. The buffers stay available for reading until
+    /// tracing is enabled again, since worker threads that have not yet
+    /// observed the change may still be recording events.
+    PIKA_EXPORT void disable_task_tracing();
+
+    /// Return the trace buffer of the given worker thread, or nullptr if
+    /// there is none
+    PIKA_EXPORT trace_buffer* get_task_trace_buffer(std::size_t global_thread_num);
+
+    /// Record an event in the trace buffer of the calling worker thread if
+    /// tracing is enabled
+    PIKA_EXPORT void record_task_trace_event(trace_event_type type, void const* id,
+        ::pika::detail::thread_description const& desc);
+    PIKA_EXPORT void record_task_trace_event(
+        trace_event_type type, void const* id, std::size_t data);
+}    // namespace pika::threads::detail
@@ -0,0 +1,199 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/functional/unique_function.hpp>
+#include <pika/memory/intrusive_ptr.hpp>
+#include <pika/thread_support/atomic_count.hpp>
+#include <pika/thread_support/spinlock.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <pika/config/warnings_prefix.hpp>
+
+namespace pika::threads::detail {
+    class timer_wheel;
+
+    /// A single timer registered with a \a timer_wheel. Entries are reference
+    /// counted: the wheel holds one reference while the timer is armed and
+    /// each \a timer_handle holds another one.
+    struct timer_entry
+    {
+        using callback_type = util::detail::unique_function<void()>;
+
+        timer_entry(std::uint64_t tick, callback_type&& f, callback_type&& on_stop)
+          : tick_(tick)
+          , f_(std::move(f))
+          , on_stop_(std::move(on_stop))
+          , count_(0)
+        {
+        }
+
+        PIKA_NON_COPYABLE(timer_entry);
+
+        friend void intrusive_ptr_add_ref(timer_entry* p) { ++p->count_; }
+
+        friend void intrusive_ptr_release(timer_entry* p)
+        {
+            PIKA_ASSERT(p->count_ != 0);
+            if (--p->count_ == 0) { delete p; }
+        }
+
+    private:
+        friend class timer_wheel;
+
+        // all members below are protected by the mutex of the owning wheel
+        std::uint64_t tick_;
+        timer_entry* prev_ = nullptr;
+        timer_entry* next_ = nullptr;
+        timer_entry** list_ = nullptr;
+        std::uint8_t level_ = 0;
+        std::uint8_t slot_ = 0;
+        bool armed_ = false;
+
+        callback_type f_;
+        callback_type on_stop_;
+        ::pika::detail::atomic_count count_;
+    };
+
+    /// A handle to a timer armed on a \a timer_wheel. The handle can be used to
+    /// cancel the timer before it has expired. Letting a handle go out of scope
+    /// does not cancel the timer.
+    class timer_handle
+    {
+    public:
+        timer_handle() = default;
+
+        timer_handle(timer_wheel* wheel, pika::memory::intrusive_ptr<timer_entry> entry) noexcept
+          : wheel_(wheel)
+          , entry_(std::move(entry))
+        {
+        }
+
+        explicit operator bool() const noexcept { return entry_ != nullptr; }
+
+        /// Cancel the timer. Returns \a true if the timer was disarmed before
+        /// its callback was invoked, in which case the callback will never be
+        /// invoked. Returns \a false if the callback has already been invoked,
+        /// is currently being invoked, or if the handle is empty.
+        inline bool cancel();
+
+        void reset() noexcept
+        {
+            wheel_ = nullptr;
+            entry_.reset();
+        }
+
+    private:
+        timer_wheel* wheel_ = nullptr;
+        pika::memory::intrusive_ptr<timer_entry> entry_;
+    };
+
+    /// A hierarchical timing wheel holding one-shot timers. Timers are only
+    /// fired when \a poll is called, which is done from the scheduling loop of
+    /// the thread pool owning the wheel. Expired callbacks are invoked on the
+    /// polling thread outside of any locks and must not throw.
+    ///
+    /// The wheel has \a num_levels levels of \a num_slots slots each. A timer
+    /// is placed on the level of the most significant digit (in base
+    /// \a num_slots) in which its expiry tick differs from the current tick,
+    /// and cascades to lower levels as time advances. Timers too far in the
+    /// future for the top level are kept in an overflow list which is
+    /// re-examined whenever the top level wraps around. Timers never fire
+    /// before their deadline, but may fire up to one \a resolution late.
+    class PIKA_EXPORT timer_wheel
+    {
+    public:
+        using clock_type = std::chrono::steady_clock;
+        using callback_type = timer_entry::callback_type;
+
+        static constexpr std::size_t slot_bits = 6;
+        static constexpr std::size_t num_slots = std::size_t(1) << slot_bits;
+        static constexpr std::size_t num_levels = 4;
+        static constexpr clock_type::duration resolution =
+            std::chrono::microseconds(PIKA_TIMER_WHEEL_RESOLUTION);
+
+        timer_wheel();
+        ~timer_wheel();
+
+        PIKA_NON_COPYABLE(timer_wheel);
+
+        /// Arm a new timer which invokes \a f once \a deadline has passed.
+        /// Deadlines in the past are fired on the next call to \a poll. If
+        /// \a on_stop is given, the timer is disarmed and \a on_stop is
+        /// invoked instead of \a f when the wheel is stopped before the
+        /// deadline, see \a stop.
+        timer_handle add(clock_type::time_point deadline, callback_type&& f,
+            callback_type&& on_stop = callback_type());
+
+        /// Disarm all timers which have been armed with an \a on_stop
+        /// callback and invoke those callbacks on the calling thread, outside
+        /// of any locks. Timers without an \a on_stop callback stay armed.
+        /// Returns the number of callbacks invoked.
+        std::size_t stop();
+
+        /// Disarm the timer referenced by \a e. See \a timer_handle::cancel.
+        bool cancel(timer_entry& e);
+
+        /// Invoke the callbacks of all timers which have expired at \a now.
+        /// Returns the number of callbacks invoked. If another thread is
+        /// already polling the wheel this returns immediately.
+        std::size_t poll(clock_type::time_point now = clock_type::now());
+
+        /// Returns a time at which the earliest armed timer is due or
+        /// earlier, or \a clock_type::time_point::max() if no timers are
+        /// armed. Polling the wheel at the returned time either fires the
+        /// earliest timer or moves it closer to expiring.
+        clock_type::time_point next_expiry() const;
+
+        /// Returns whether no timers are armed on this wheel.
+        bool empty() const noexcept { return size() == 0; }
+
+        /// Returns the number of armed timers.
+        std::size_t size() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+    private:
+        static std::uint64_t to_tick_ceil(clock_type::time_point t) noexcept;
+        static std::uint64_t to_tick_floor(clock_type::time_point t) noexcept;
+
+        void link(timer_entry* e) noexcept;
+        void unlink(timer_entry* e) noexcept;
+        void push_front(timer_entry** list, timer_entry* e) noexcept;
+        timer_entry* take_list(timer_entry** list) noexcept;
+        void cascade(std::size_t level, std::uint64_t tick) noexcept;
+        timer_entry* advance(std::uint64_t target) noexcept;
+
+        mutable ::pika::detail::spinlock mtx_;
+        std::atomic<std::uint64_t> current_tick_;
+        std::atomic<std::size_t> count_;
+        std::atomic<bool> has_expired_;
+
+        // all members below are protected by mtx_
+        std::uint64_t occupied_[num_levels];
+        timer_entry* slots_[num_levels][num_slots];
+        timer_entry* overflow_;
+        timer_entry* expired_;
+    };
+
+    bool timer_handle::cancel()
+    {
+        if (!entry_) { return false; }
+
+        PIKA_ASSERT(wheel_ != nullptr);
+        bool cancelled = wheel_->cancel(*entry_);
+        reset();
+        return cancelled;
+    }
+}    // namespace pika::threads::detail
+
+#include <pika/config/warnings_suffix.hpp>
@@ -196,6 +196,47 @@ namespace pika::threads::detail {
     {
         return register_work(data, get_self_or_default_pool(), ec);
     }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Create a batch of new work items using the given data.
+    ///
+    /// The work items are distributed to the worker threads according to
+    /// their schedule hints and enqueued with as few operations as possible,
+    /// which is considerably cheaper than calling \a register_work for each
+    /// work item. As with \a register_work, high priority work items are
+    /// created right away instead of being staged.
+    ///
+    /// \param data       [in] Pointer to the first of \a count elements of data
+    ///                   to use for creating the work items. The data is
+    ///                   moved from.
+    /// \param count      [in] The number of work items to create.
+    /// \param pool       [in] The thread pool to use for launching the work.
+    /// \param ec         [in,out] This represents the error status on exit,
+    ///                   if this is pre-initialized to \a pika#throws
+    ///                   the function will throw on error instead.
+    ///
+    /// \throws invalid_status if the runtime system has not been started yet.
+    /// \throws bad_parameter if the initial state of a work item is not
+    ///         pending.
+    ///
+    /// \note             As long as \a ec is not pre-initialized to
+    ///                   \a pika#throws this function doesn't
+    ///                   throw but returns the result code using the
+    ///                   parameter \a ec. Otherwise it throws an instance
+    ///                   of pika#exception.
+    inline void register_work_bulk(
+        thread_init_data* data, std::size_t count, thread_pool_base* pool, error_code& ec = throws)
+    {
+        PIKA_ASSERT(pool);
+        pool->create_work_bulk(data, count, ec);
+    }
+
+    /// \copydoc register_work_bulk
+    inline void register_work_bulk(
+        thread_init_data* data, std::size_t count, error_code& ec = throws)
+    {
+        register_work_bulk(data, count, get_self_or_default_pool(), ec);
+    }
 }    // namespace pika::threads::detail
 
 /// \endcond
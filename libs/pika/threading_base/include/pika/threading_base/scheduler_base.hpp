@@ -10,7 +10,12 @@
 #include <pika/assert.hpp>
 #include <pika/concurrency/cache_line_data.hpp>
 #include <pika/functional/function.hpp>
+#include <pika/functional/unique_function.hpp>
 #include <pika/modules/errors.hpp>
+#include <pika/threading_base/detail/running_task.hpp>
+#include <pika/threading_base/detail/scheduler_counters.hpp>
+#include <pika/threading_base/detail/task_trace.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
 #include <pika/threading_base/scheduler_mode.hpp>
 #include <pika/threading_base/scheduler_state.hpp>
 #include <pika/threading_base/thread_data.hpp>
@@ -64,7 +69,7 @@ namespace pika::threads::detail {
             thread_queue_init_parameters thread_queue_init = {},
             scheduler_mode mode = scheduler_mode::nothing_special);
 
-        virtual ~scheduler_base() = default;
+        virtual ~scheduler_base();
 
         threads::detail::thread_pool_base* get_parent_pool() const
         {
@@ -93,9 +98,15 @@ namespace pika::threads::detail {
         void idle_callback(std::size_t num_thread);
 
         /// This function gets called by the thread-manager whenever new work
-        /// has been added, allowing the scheduler to reactivate one or more of
-        /// possibly idling OS threads
-        void do_some_work(std::size_t);
+        /// has been added, allowing the scheduler to reactivate one of the
+        /// possibly idling OS threads. The given worker thread is woken up if
+        /// it is idling, otherwise the idling worker thread closest to it (or
+        /// to the calling worker thread if no valid worker thread is given).
+        void do_some_work(std::size_t num_thread);
+
+        /// Wake up all idling OS threads, e.g. when the scheduler mode
+        /// changes or when the pool is being stopped.
+        void do_all_work();
 
         virtual void suspend(std::size_t num_thread);
         virtual void resume(std::size_t num_thread);
@@ -114,6 +125,35 @@ namespace pika::threads::detail {
         bool is_state(pika::runtime_state s) const;
         std::pair<pika::runtime_state, pika::runtime_state> get_minmax_state() const;
 
+        ///////////////////////////////////////////////////////////////////////
+        // access the scheduler counters of the worker threads, see
+        // scheduler_counters_enabled
+        scheduler_counters& get_scheduler_counters(std::size_t num_thread) noexcept
+        {
+            PIKA_ASSERT(num_thread < counters_.size());
+            return counters_[num_thread].data_;
+        }
+
+        // return the counters of the given worker thread, or the sum over all
+        // worker threads if num_thread is std::size_t(-1)
+        scheduler_counter_values get_scheduler_counter_values(std::size_t num_thread, bool reset);
+
+        // called by schedulers when the given worker thread took num pika
+        // threads from the queues of other worker threads
+        void add_stolen_threads(std::size_t num_thread, std::size_t num = 1) noexcept
+        {
+            if (PIKA_UNLIKELY(scheduler_counters_enabled.load(std::memory_order_relaxed)) &&
+                num_thread < counters_.size())
+            {
+                counters_[num_thread].data_.add_stolen_threads(static_cast<std::int64_t>(num));
+            }
+
+            if (PIKA_UNLIKELY(task_tracing_enabled.load(std::memory_order_relaxed)))
+            {
+                record_task_trace_event(trace_event_type::steal, nullptr, num);
+            }
+        }
+
         ///////////////////////////////////////////////////////////////////////
         // get/set scheduler mode
         scheduler_mode get_scheduler_mode() const
@@ -201,6 +241,13 @@ namespace pika::threads::detail {
         virtual void create_thread(threads::detail::thread_init_data& data,
             threads::detail::thread_id_ref_type* id, error_code& ec) = 0;
 
+        // Create count staged threads at once, the threads are moved from
+        // data. Schedulers may override this to enqueue the threads with a
+        // single operation per queue, by default the threads are created one
+        // by one.
+        virtual void create_threads(
+            threads::detail::thread_init_data* data, std::size_t count, error_code& ec);
+
         virtual bool get_next_thread(std::size_t num_thread, bool running,
             threads::detail::thread_id_ref_type& thrd, bool enable_stealing) = 0;
 
@@ -312,6 +359,78 @@ namespace pika::threads::detail {
             return status;
         }
 
+        /// Return the timer wheel used for timed suspension of the threads
+        /// managed by this scheduler
+        timer_wheel& get_timer_wheel() noexcept { return timers_; }
+        timer_wheel const& get_timer_wheel() const noexcept { return timers_; }
+
+        /// Arm a timer on the timer wheel of this scheduler which invokes f
+        /// once deadline has passed. Timers should be armed through this
+        /// function rather than directly on the wheel: a worker thread
+        /// sleeping in idle backoff is woken up if needed so that the new
+        /// timer is polled in time. If on_stop is given it is invoked
+        /// instead of f when the scheduler stops before deadline, see
+        /// stop_timers.
+        timer_handle add_timer(timer_wheel::clock_type::time_point deadline,
+            timer_wheel::callback_type&& f,
+            timer_wheel::callback_type&& on_stop = timer_wheel::callback_type());
+
+        /// Disarm all timers which have been armed with an on_stop callback
+        /// and invoke those callbacks. This is called from the scheduling
+        /// loop of each worker thread once the scheduler is stopping, so that
+        /// pending timers do not delay shutdown until their deadline.
+        /// Returns the number of stopped timers.
+        std::size_t stop_timers() { return timers_.stop(); }
+
+        /// Fire all expired timers of this scheduler. This is called from the
+        /// scheduling loop of each worker thread.
+        polling_status poll_timers()
+        {
+            return timers_.poll() != 0 ? polling_status::busy : polling_status::idle;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Tasks that run to completion directly on the worker threads, without
+        // creating a pika thread. Inline tasks are not allowed to suspend, they
+        // are meant for short continuations scheduled with
+        // thread_stacksize::nostack. Like on stackless threads, an attempt to
+        // suspend an inline task, e.g. by waiting on a contended
+        // synchronization primitive, reports an error instead of blocking the
+        // worker thread.
+        using inline_task_type = util::detail::unique_function<void()>;
+
+        /// Enqueue an inline task on the worker thread given by the hint, or
+        /// on the calling worker thread if no worker thread is given. Returns
+        /// false, leaving f untouched, if the selected worker thread is not
+        /// running.
+        bool schedule_inline_task(inline_task_type&& f, execution::thread_schedule_hint hint = {});
+
+        /// Run the inline tasks queued on the given worker thread. Inline
+        /// tasks queued on other worker threads are stolen if the worker
+        /// thread has none and stealing is enabled. Each inline task is
+        /// recorded in running_task while it runs, if given, and in the task
+        /// trace while tracing is enabled. Exceptions escaping an inline task
+        /// are reported to the thread pool like those escaping a pika thread,
+        /// the worker thread keeps running.
+        polling_status run_inline_tasks(std::size_t num_thread, bool enable_stealing,
+            running_task_slot* running_task = nullptr);
+
+        /// Return the number of inline tasks that are queued or running
+        std::size_t get_inline_task_count() const noexcept
+        {
+            return inline_task_count_.data_.load(std::memory_order_acquire);
+        }
+
+        /// Return the number of inline tasks queued on the given worker
+        /// thread. Tasks running on or stolen by other worker threads are not
+        /// counted, so that they do not prevent the given worker thread from
+        /// suspending or idling.
+        std::size_t get_inline_task_count(std::size_t num_thread) const noexcept;
+
+        /// Return whether the calling OS thread is currently running an
+        /// inline task
+        static bool is_running_inline_task() noexcept;
+
         std::size_t get_polling_work_count() const
         {
             std::size_t work_count = 0;
@@ -329,15 +448,34 @@ namespace pika::threads::detail {
         pika::concurrency::detail::cache_line_data<std::atomic<scheduler_mode>> mode_;
 
 #if defined(PIKA_HAVE_THREAD_MANAGER_IDLE_BACKOFF)
-        // support for suspension on idle queues
-        pu_mutex_type mtx_;
-        std::condition_variable cond_;
+        // support for suspension on idle queues, each worker thread sleeps in
+        // its own parking slot to allow waking up a single worker thread
         struct idle_backoff_data
         {
-            std::uint32_t wait_count_;
-            double max_idle_backoff_time_;
+            std::uint32_t wait_count_ = 0;
+            double max_idle_backoff_time_ = 0.0;
+
+            pu_mutex_type mtx_;
+            std::condition_variable cond_;
+            // sleeping_ is only set while the worker thread is waiting on
+            // cond_, notified_ is protected by mtx_
+            std::atomic<bool> sleeping_{false};
+            bool notified_ = false;
         };
         std::vector<pika::concurrency::detail::cache_line_data<idle_backoff_data>> wait_counts_;
+
+        // the number of worker threads currently sleeping in idle_callback,
+        // allows skipping the wakeup altogether if no worker thread is idling
+        pika::concurrency::detail::cache_line_data<std::atomic<std::size_t>> num_sleepers_;
+
+        // the worker thread sleeping until the earliest armed timer is due,
+        // or std::size_t(-1), and the time at which it wakes up
+        pika::concurrency::detail::cache_line_data<std::atomic<std::size_t>> timer_thread_;
+        pika::concurrency::detail::cache_line_data<
+            std::atomic<timer_wheel::clock_type::time_point>>
+            timer_wakeup_;
+
+        bool wake_idle_thread(std::size_t num_thread);
 #endif
 
         // support for suspension of pus
@@ -347,6 +485,9 @@ namespace pika::threads::detail {
         std::vector<pu_mutex_type> pu_mtxs_;
 
         std::vector<std::atomic<pika::runtime_state>> states_;
+
+        // always available counters of the worker threads
+        std::vector<pika::concurrency::detail::cache_line_data<scheduler_counters>> counters_;
         char const* description_;
 
         thread_queue_init_parameters thread_queue_init_;
@@ -359,6 +500,17 @@ namespace pika::threads::detail {
         std::atomic<polling_work_count_function_ptr> polling_work_count_function_mpi_;
         std::atomic<polling_work_count_function_ptr> polling_work_count_function_cuda_;
 
+        // timers for timed suspension of threads
+        timer_wheel timers_;
+
+        // queues of inline tasks, one per worker thread
+        struct inline_task_queue;
+        std::vector<std::unique_ptr<inline_task_queue>> inline_tasks_;
+        pika::concurrency::detail::cache_line_data<std::atomic<std::size_t>> inline_task_count_;
+        // worker thread for the next inline task scheduled without a hint
+        // from outside of this scheduler
+        std::atomic<std::size_t> next_inline_thread_{0};
+
 #if defined(PIKA_HAVE_SCHEDULER_LOCAL_STORAGE)
     public:
         // manage scheduler-local data
@@ -10,6 +10,7 @@
 #include <pika/coroutines/coroutine.hpp>
 #include <pika/modules/errors.hpp>
 #include <pika/modules/timing.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
 #include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/set_thread_state.hpp>
 #include <pika/threading_base/threading_base_fwd.hpp>
@@ -19,14 +20,17 @@
 namespace pika::threads::detail {
 
     /// Set a timer to set the state of the given \a thread to the given
-    /// new value after it expired (at the given time)
-    PIKA_EXPORT thread_id_ref_type set_thread_state_timed(scheduler_base* scheduler,
+    /// new value after it expired (at the given time). The timer is armed on
+    /// the timer wheel of \a scheduler and only takes effect if the thread is
+    /// still in the suspension it was in (or was about to enter) when the
+    /// timer was set.
+    PIKA_EXPORT timer_handle set_thread_state_timed(scheduler_base* scheduler,
         pika::chrono::steady_time_point const& abs_time, thread_id_type const& thrd,
         thread_schedule_state newstate, thread_restart_state newstate_ex,
         execution::thread_priority priority, execution::thread_schedule_hint schedulehint,
         std::atomic<bool>* started, bool retry_on_active, error_code& ec);
 
-    inline thread_id_ref_type set_thread_state_timed(scheduler_base* scheduler,
+    inline timer_handle set_thread_state_timed(scheduler_base* scheduler,
         pika::chrono::steady_time_point const& abs_time, thread_id_type const& id,
         std::atomic<bool>* started, bool retry_on_active, error_code& ec)
     {
@@ -37,7 +41,7 @@ namespace pika::threads::detail {
 
     // Set a timer to set the state of the given \a thread to the given
     // new value after it expired (after the given duration)
-    inline thread_id_ref_type set_thread_state_timed(scheduler_base* scheduler,
+    inline timer_handle set_thread_state_timed(scheduler_base* scheduler,
         pika::chrono::steady_duration const& rel_time, thread_id_type const& thrd,
         thread_schedule_state newstate, thread_restart_state newstate_ex,
         execution::thread_priority priority, execution::thread_schedule_hint schedulehint,
@@ -47,7 +51,7 @@ namespace pika::threads::detail {
             priority, schedulehint, started, retry_on_active, ec);
     }
 
-    inline thread_id_ref_type set_thread_state_timed(scheduler_base* scheduler,
+    inline timer_handle set_thread_state_timed(scheduler_base* scheduler,
         pika::chrono::steady_duration const& rel_time, thread_id_type const& thrd,
         std::atomic<bool>* started, bool retry_on_active, error_code& ec)
     {
@@ -21,6 +21,7 @@
 #include <pika/modules/errors.hpp>
 #include <pika/modules/memory.hpp>
 #include <pika/thread_support/atomic_count.hpp>
+#include <pika/threading_base/detail/scheduler_counters.hpp>
 #include <pika/threading_base/thread_description.hpp>
 #include <pika/threading_base/thread_init_data.hpp>
 #if defined(PIKA_HAVE_APEX)
@@ -28,6 +29,7 @@
 #endif
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <forward_list>
@@ -382,6 +384,12 @@ namespace pika::threads::detail {
         constexpr execution::thread_priority get_priority() const noexcept { return priority_; }
         void set_priority(execution::thread_priority priority) noexcept { priority_ = priority; }
 
+        std::chrono::steady_clock::time_point get_deadline() const noexcept { return deadline_; }
+        void set_deadline(std::chrono::steady_clock::time_point deadline) noexcept
+        {
+            deadline_ = deadline;
+        }
+
         // handle thread interruption
         bool interruption_requested() const noexcept
         {
@@ -427,6 +435,25 @@ namespace pika::threads::detail {
 
         scheduler_base* get_scheduler_base() const noexcept { return scheduler_base_; }
 
+        /// Record the time at which the thread was made ready to run, used
+        /// for the queue wait time of the scheduler counters. The time is
+        /// only taken while scheduler_counters_enabled is set.
+        void set_ready_time() noexcept
+        {
+            ready_time_ = scheduler_counters_enabled.load(std::memory_order_relaxed) ?
+                scheduler_counters_timestamp() :
+                0;
+        }
+
+        /// Return and clear the time at which the thread was made ready to
+        /// run, or 0 if it was not recorded
+        std::int64_t exchange_ready_time() noexcept
+        {
+            std::int64_t const ready_time = ready_time_;
+            ready_time_ = 0;
+            return ready_time;
+        }
+
         std::size_t get_last_worker_thread_num() const noexcept
         {
             return last_worker_thread_num_.load(std::memory_order_relaxed);
@@ -522,6 +549,7 @@ namespace pika::threads::detail {
 #endif
         ///////////////////////////////////////////////////////////////////////
         execution::thread_priority priority_;
+        std::chrono::steady_clock::time_point deadline_;
 
         bool requested_interrupt_;
         bool enabled_interrupt_;
@@ -534,6 +562,9 @@ namespace pika::threads::detail {
         // reference to scheduler which created/manages this thread
         scheduler_base* scheduler_base_;
         std::atomic<std::size_t> last_worker_thread_num_;
+        // see set_ready_time, only accessed by the thread scheduling and the
+        // thread running this thread
+        std::int64_t ready_time_;
 
         std::ptrdiff_t stacksize_;
         execution::thread_stacksize stacksize_enum_;
@@ -14,6 +14,7 @@
 #include <pika/functional/unique_function.hpp>
 #include <pika/lock_registration/detail/register_locks.hpp>
 #include <pika/modules/errors.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
 #include <pika/threading_base/register_thread.hpp>
 #include <pika/threading_base/scheduler_mode.hpp>
 #include <pika/threading_base/thread_description.hpp>
@@ -74,14 +75,16 @@ namespace pika::threads::detail {
     ///         thread_id \a id.
     ///
     /// Set a timer to set the state of the given \a thread to the given
-    /// new value after it expired (at the given time)
+    /// new value after it expired (at the given time). The timer only takes
+    /// effect if the thread is still in (or has not yet reached) the
+    /// suspension it was in or about to enter when the timer was set.
     ///
     /// \param id         [in] The thread id of the thread the state should
     ///                   be modified for.
     /// \param abs_time   [in] Absolute point in time for the new thread to be
     ///                   run
-    /// \param started    [in,out] A helper variable allowing to track the
-    ///                   state of the timer helper thread
+    /// \param started    [in,out] A helper variable which is set to true
+    ///                   once the timer has been armed
     /// \param state      [in] The new state to be set for the thread
     ///                   referenced by the \a id parameter.
     /// \param stateex    [in] The new extended state to be set for the
@@ -91,21 +94,22 @@ namespace pika::threads::detail {
     ///                   if this is pre-initialized to \a pika#throws
     ///                   the function will throw on error instead.
     ///
-    /// \returns
+    /// \returns          A handle to the armed timer which can be used to
+    ///                   cancel it.
     ///
     /// \note             As long as \a ec is not pre-initialized to
     ///                   \a pika#throws this function doesn't
     ///                   throw but returns the result code using the
     ///                   parameter \a ec. Otherwise it throws an instance
     ///                   of pika#exception.
-    PIKA_EXPORT thread_id_ref_type set_thread_state(thread_id_type const& id,
+    PIKA_EXPORT timer_handle set_thread_state(thread_id_type const& id,
         pika::chrono::steady_time_point const& abs_time, std::atomic<bool>* started,
         thread_schedule_state state = thread_schedule_state::pending,
         thread_restart_state stateex = thread_restart_state::timeout,
         execution::thread_priority priority = execution::thread_priority::normal,
         bool retry_on_active = true, error_code& ec = throws);
 
-    inline thread_id_ref_type set_thread_state(thread_id_type const& id,
+    inline timer_handle set_thread_state(thread_id_type const& id,
         pika::chrono::steady_time_point const& abs_time,
         thread_schedule_state state = thread_schedule_state::pending,
         thread_restart_state stateex = thread_restart_state::timeout,
@@ -143,7 +147,7 @@ namespace pika::threads::detail {
     ///                   throw but returns the result code using the
     ///                   parameter \a ec. Otherwise it throws an instance
     ///                   of pika#exception.
-    inline thread_id_ref_type set_thread_state(thread_id_type const& id,
+    inline timer_handle set_thread_state(thread_id_type const& id,
         pika::chrono::steady_duration const& rel_time,
         thread_schedule_state state = thread_schedule_state::pending,
         thread_restart_state stateex = thread_restart_state::timeout,
@@ -154,6 +158,35 @@ namespace pika::threads::detail {
             id, rel_time.from_now(), state, stateex, priority, retry_on_active, ec);
     }
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Arm a timer on the scheduler of the \a thread referenced by
+    ///         the thread_id \a id.
+    ///
+    /// The callback \a f is invoked once \a abs_time has passed. It is
+    /// invoked from the scheduling loop of a worker thread of the pool the
+    /// thread belongs to, and must therefore neither throw nor suspend.
+    ///
+    /// \param id         [in] The thread id of the thread whose scheduler
+    ///                   should be used.
+    /// \param abs_time   [in] Absolute point in time at which the callback
+    ///                   should be invoked
+    /// \param f          [in] The callback to invoke once the timer expired
+    /// \param ec         [in,out] this represents the error status on exit,
+    ///                   if this is pre-initialized to \a pika#throws
+    ///                   the function will throw on error instead.
+    ///
+    /// \returns          A handle to the armed timer which can be used to
+    ///                   cancel it.
+    ///
+    /// \note             As long as \a ec is not pre-initialized to
+    ///                   \a pika#throws this function doesn't
+    ///                   throw but returns the result code using the
+    ///                   parameter \a ec. Otherwise it throws an instance
+    ///                   of pika#exception.
+    PIKA_EXPORT timer_handle add_timer(thread_id_type const& id,
+        pika::chrono::steady_time_point const& abs_time, timer_wheel::callback_type&& f,
+        error_code& ec = throws);
+
     ///////////////////////////////////////////////////////////////////////////
     /// The function get_thread_backtrace is part of the thread related API
     /// allows to query the currently stored thread back trace (which is
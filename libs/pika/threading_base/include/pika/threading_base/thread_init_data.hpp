@@ -16,6 +16,7 @@
 #endif
 #include <pika/type_support/unused.hpp>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -39,6 +40,7 @@ namespace pika::threads::detail {
           , timer_data(nullptr)
 #endif
           , priority(execution::thread_priority::normal)
+          , deadline((std::chrono::steady_clock::time_point::max)())
           , schedulehint()
           , stacksize(execution::thread_stacksize::default_)
           , initial_state(thread_schedule_state::pending)
@@ -57,6 +59,7 @@ namespace pika::threads::detail {
         {
             func = std::move(rhs.func);
             priority = rhs.priority;
+            deadline = rhs.deadline;
             schedulehint = rhs.schedulehint;
             stacksize = rhs.stacksize;
             initial_state = rhs.initial_state;
@@ -92,6 +95,7 @@ namespace pika::threads::detail {
           , timer_data(pika::detail::external_timer::new_task(description, parent_id))
 #endif
           , priority(rhs.priority)
+          , deadline(rhs.deadline)
           , schedulehint(rhs.schedulehint)
           , stacksize(rhs.stacksize)
           , initial_state(rhs.initial_state)
@@ -122,6 +126,7 @@ namespace pika::threads::detail {
           , timer_data(pika::detail::external_timer::new_task(description, parent_id))
 #endif
           , priority(priority_)
+          , deadline((std::chrono::steady_clock::time_point::max)())
           , schedulehint(os_thread)
           , stacksize(stacksize_)
           , initial_state(initial_state_)
@@ -164,6 +169,9 @@ namespace pika::threads::detail {
 #endif
 
         execution::thread_priority priority;
+        // only used by schedulers ordering threads by deadline, the maximum
+        // time point means no deadline
+        std::chrono::steady_clock::time_point deadline;
         execution::thread_schedule_hint schedulehint;
         execution::thread_stacksize stacksize;
         thread_schedule_state initial_state;
@@ -10,9 +10,12 @@
 #include <pika/config.hpp>
 #include <pika/affinity/affinity_data.hpp>
 #include <pika/concurrency/barrier.hpp>
+#include <pika/concurrency/spinlock.hpp>
 #include <pika/functional/function.hpp>
 #include <pika/modules/errors.hpp>
 #include <pika/threading_base/callback_notifier.hpp>
+#include <pika/threading_base/detail/running_task.hpp>
+#include <pika/threading_base/detail/scheduler_counters.hpp>
 #include <pika/threading_base/scheduler_mode.hpp>
 #include <pika/threading_base/scheduler_state.hpp>
 #include <pika/threading_base/thread_init_data.hpp>
@@ -22,6 +25,7 @@
 
 #include <fmt/format.h>
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
@@ -127,6 +131,16 @@ namespace pika::threads::detail {
         virtual void suspend_processing_unit_direct(
             std::size_t virt_core, error_code& ec = throws) = 0;
 
+        /// Requests the given processing unit to be suspended. Returns without
+        /// waiting for the processing unit to be suspended, which happens once
+        /// its worker thread has no more work.
+        ///
+        /// \param virt_core [in] The processing unit on the the pool to be
+        ///                  suspended. The processing units are indexed
+        ///                  starting from 0.
+        virtual void suspend_processing_unit_nonblocking(
+            std::size_t virt_core, error_code& ec = throws) = 0;
+
         /// Resumes the given processing unit. Blocks until the processing unit
         /// has been resumed.
         ///
@@ -168,6 +182,7 @@ namespace pika::threads::detail {
         virtual void create_thread(
             thread_init_data& data, thread_id_ref_type& id, error_code& ec) = 0;
         virtual thread_id_ref_type create_work(thread_init_data& data, error_code& ec) = 0;
+        virtual void create_work_bulk(thread_init_data* data, std::size_t count, error_code& ec);
 
         virtual thread_state set_state(thread_id_type const& id, thread_schedule_state new_state,
             thread_restart_state new_state_ex, execution::thread_priority priority,
@@ -182,6 +197,30 @@ namespace pika::threads::detail {
         mask_type get_used_processing_units() const;
         hwloc_bitmap_ptr get_numa_domain_bitmap() const;
 
+        /// The other worker threads of a pool in the order in which a worker
+        /// thread should try to steal work from them. Threads on the same
+        /// core come first, followed by threads sharing the L3 cache, the
+        /// NUMA domain, the socket, and finally all remaining threads.
+        /// Suspended worker threads, e.g. on processing units currently used
+        /// by another pool, come last. The first numa_local_count threads
+        /// are running and in the same NUMA domain.
+        struct steal_order
+        {
+            std::vector<std::uint32_t> threads;
+            std::size_t numa_local_count = 0;
+        };
+
+        /// Return the steal orders of all worker threads of this pool, or an
+        /// empty pointer if the pool has not been initialized. Updating the
+        /// steal orders replaces them, the returned steal orders stay valid
+        /// and unchanged for as long as the pointer is held.
+        std::shared_ptr<std::vector<steal_order> const> get_steal_orders() const;
+
+        /// Recompute the steal orders of all worker threads of this pool.
+        /// This has to be called when worker threads of the pool have been
+        /// suspended or resumed.
+        void update_steal_orders();
+
         // performance counters
 #if defined(PIKA_HAVE_THREAD_CUMULATIVE_COUNTS)
         virtual std::int64_t get_executed_threads(std::size_t /*thread_num*/, bool /*reset*/)
@@ -295,6 +334,22 @@ namespace pika::threads::detail {
 
         virtual void get_idle_core_mask(mask_type&) const {}
 
+        /// Return the scheduler counters of the given worker thread, or the
+        /// sum over all worker threads of the pool if num_thread is
+        /// std::size_t(-1). The counters are only updated while
+        /// scheduler_counters_enabled is set.
+        scheduler_counter_values get_scheduler_counters(
+            std::size_t num_thread = std::size_t(-1), bool reset = false);
+
+        /// Read the task currently running on the given worker thread. Returns
+        /// false if no task is running, if running task tracking is disabled,
+        /// or if the pool does not track running tasks. See
+        /// running_task_tracking_enabled.
+        virtual bool get_running_task(std::size_t /*num_thread*/, running_task& /*task*/) const
+        {
+            return false;
+        }
+
         std::int64_t get_thread_count_unknown(std::size_t num_thread, bool reset)
         {
             return get_thread_count(thread_schedule_state::unknown,
@@ -361,6 +416,7 @@ namespace pika::threads::detail {
     protected:
         /// \cond NOINTERNAL
         void init_pool_time_scale();
+        void init_steal_orders(std::size_t num_threads);
         /// \endcond
 
     protected:
@@ -379,6 +435,14 @@ namespace pika::threads::detail {
         // scale timestamps to nanoseconds
         double timestamp_scale_;
 
+        // the steal order for each worker thread of this pool. Replaced steal
+        // orders are freed once the last user has released them.
+        // steal_orders_mtx_ serializes updates, steal_orders_ptr_mtx_ only
+        // protects copying and replacing the pointer.
+        std::shared_ptr<std::vector<steal_order> const> steal_orders_;
+        std::mutex steal_orders_mtx_;
+        mutable pika::concurrency::detail::spinlock steal_orders_ptr_mtx_;
+
         // callback functions to invoke at start, stop, and error
         threads::callback_notifier& notifier_;
         /// \endcond
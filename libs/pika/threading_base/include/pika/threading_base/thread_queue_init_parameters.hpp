@@ -34,7 +34,10 @@ namespace pika::threads::detail {
             std::ptrdiff_t small_stacksize = PIKA_SMALL_STACK_SIZE,
             std::ptrdiff_t medium_stacksize = PIKA_MEDIUM_STACK_SIZE,
             std::ptrdiff_t large_stacksize = PIKA_LARGE_STACK_SIZE,
-            std::ptrdiff_t huge_stacksize = PIKA_HUGE_STACK_SIZE)
+            std::ptrdiff_t huge_stacksize = PIKA_HUGE_STACK_SIZE,
+            std::int64_t max_run_next_count = std::int64_t(PIKA_THREAD_QUEUE_MAX_RUN_NEXT_COUNT),
+            std::int64_t run_next_steal_delay = std::int64_t(
+                PIKA_THREAD_QUEUE_RUN_NEXT_STEAL_DELAY))
           // NOLINTEND(bugprone-easily-swappable-parameters)
           : max_thread_count_(max_thread_count)
           , min_tasks_to_steal_pending_(min_tasks_to_steal_pending)
@@ -51,6 +54,8 @@ namespace pika::threads::detail {
           , large_stacksize_(large_stacksize)
           , huge_stacksize_(huge_stacksize)
           , nostack_stacksize_((std::numeric_limits<std::ptrdiff_t>::max)())
+          , max_run_next_count_(max_run_next_count)
+          , run_next_steal_delay_(run_next_steal_delay)
         {
         }
 
@@ -69,5 +74,7 @@ namespace pika::threads::detail {
         std::ptrdiff_t const large_stacksize_;
         std::ptrdiff_t const huge_stacksize_;
         std::ptrdiff_t const nostack_stacksize_;
+        std::int64_t const max_run_next_count_;
+        std::int64_t const run_next_steal_delay_;
     };
 }    // namespace pika::threads::detail
@@ -14,73 +14,89 @@
 #include <pika/threading_base/thread_init_data.hpp>
 
 namespace pika::threads::detail {
-    thread_id_ref_type create_work(
-        scheduler_base* scheduler, thread_init_data& data, error_code& ec)
-    {
-        // verify parameters
-        switch (data.initial_state)
+    namespace {
+        // Validate the given thread_init_data and fill in the defaults, returns
+        // false if the data is invalid.
+        bool prepare_work(scheduler_base* scheduler, thread_init_data& data, thread_self* self,
+            char const* function_name, error_code& ec)
         {
-        case thread_schedule_state::pending:
-        case thread_schedule_state::pending_do_not_schedule:
-        case thread_schedule_state::pending_boost:
-        case thread_schedule_state::suspended: break;
+            // verify parameters
+            switch (data.initial_state)
+            {
+            case thread_schedule_state::pending:
+            case thread_schedule_state::pending_do_not_schedule:
+            case thread_schedule_state::pending_boost:
+            case thread_schedule_state::suspended: break;
 
-        default:
-        {
-            PIKA_THROWS_IF(ec, pika::error::bad_parameter, "thread::detail::create_work",
-                "invalid initial state: {}", data.initial_state);
-            return invalid_thread_id;
-        }
-        }
+            default:
+            {
+                PIKA_THROWS_IF(ec, pika::error::bad_parameter, function_name,
+                    "invalid initial state: {}", data.initial_state);
+                return false;
+            }
+            }
 
 #ifdef PIKA_HAVE_THREAD_DESCRIPTION
-        if (!data.description)
-        {
-            PIKA_THROWS_IF(ec, pika::error::bad_parameter, "thread::detail::create_work",
-                "description is nullptr");
-            return invalid_thread_id;
-        }
+            if (!data.description)
+            {
+                PIKA_THROWS_IF(
+                    ec, pika::error::bad_parameter, function_name, "description is nullptr");
+                return false;
+            }
 #endif
 
-        PIKA_LOG(info,
-            "create_work: pool({}), scheduler({}), initial_state({}), thread_priority({}), "
-            "description({})",
-            *scheduler->get_parent_pool(), *scheduler, get_thread_state_name(data.initial_state),
-            execution::detail::get_thread_priority_name(data.priority), data.get_description());
-
-        thread_self* self = get_self_ptr();
+            PIKA_LOG(info,
+                "create_work: pool({}), scheduler({}), initial_state({}), thread_priority({}), "
+                "description({})",
+                *scheduler->get_parent_pool(), *scheduler,
+                get_thread_state_name(data.initial_state),
+                execution::detail::get_thread_priority_name(data.priority),
+                data.get_description());
 
 #ifdef PIKA_HAVE_THREAD_PARENT_REFERENCE
-        if (nullptr == data.parent_id)
-        {
-            if (self)
+            if (nullptr == data.parent_id)
             {
-                data.parent_id = get_thread_id_data(self->get_thread_id());
-                data.parent_phase = self->get_thread_phase();
+                if (self)
+                {
+                    data.parent_id = get_thread_id_data(self->get_thread_id());
+                    data.parent_phase = self->get_thread_phase();
+                }
             }
-        }
 #endif
 
-        if (nullptr == data.scheduler_base) data.scheduler_base = scheduler;
+            if (nullptr == data.scheduler_base) data.scheduler_base = scheduler;
 
-        // Pass recursive high priority from parent to child.
-        if (self)
-        {
-            if (data.priority == execution::thread_priority::default_ &&
-                execution::thread_priority::high_recursive ==
-                    get_thread_id_data(self->get_thread_id())->get_priority())
+            // Pass recursive high priority from parent to child.
+            if (self)
             {
-                data.priority = execution::thread_priority::high_recursive;
+                if (data.priority == execution::thread_priority::default_ &&
+                    execution::thread_priority::high_recursive ==
+                        get_thread_id_data(self->get_thread_id())->get_priority())
+                {
+                    data.priority = execution::thread_priority::high_recursive;
+                }
             }
-        }
 
-        // create the new thread
-        if (data.priority == execution::thread_priority::default_)
-            data.priority = execution::thread_priority::normal;
+            // create the new thread
+            if (data.priority == execution::thread_priority::default_)
+                data.priority = execution::thread_priority::normal;
+
+            data.run_now = (execution::thread_priority::high == data.priority ||
+                execution::thread_priority::high_recursive == data.priority ||
+                execution::thread_priority::boost == data.priority);
+
+            return true;
+        }
+    }    // namespace
 
-        data.run_now = (execution::thread_priority::high == data.priority ||
-            execution::thread_priority::high_recursive == data.priority ||
-            execution::thread_priority::boost == data.priority);
+    thread_id_ref_type create_work(
+        scheduler_base* scheduler, thread_init_data& data, error_code& ec)
+    {
+        thread_self* self = get_self_ptr();
+        if (!prepare_work(scheduler, data, self, "thread::detail::create_work", ec))
+        {
+            return invalid_thread_id;
+        }
 
         thread_id_ref_type id = invalid_thread_id;
         scheduler->create_thread(data, data.run_now ? &id : nullptr, ec);
@@ -91,4 +107,42 @@ namespace pika::threads::detail {
 
         return id;
     }
+
+    void create_work_bulk(
+        scheduler_base* scheduler, thread_init_data* data, std::size_t count, error_code& ec)
+    {
+        if (count == 0) { return; }
+
+        thread_self* self = get_self_ptr();
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            if (!prepare_work(scheduler, data[i], self, "thread::detail::create_work_bulk", ec))
+            {
+                return;
+            }
+
+            // Threads that are not scheduled right away would go out of scope
+            // immediately as no ids are returned
+            if (data[i].initial_state != thread_schedule_state::pending)
+            {
+                PIKA_THROWS_IF(ec, pika::error::bad_parameter, "thread::detail::create_work_bulk",
+                    "bulk created threads must have 'pending' as their initial state");
+                return;
+            }
+        }
+
+        scheduler->create_threads(data, count, ec);
+
+        // Wake up as many worker threads as there are threads, or all of
+        // them if there are more threads than worker threads
+        std::size_t const num_threads = scheduler->get_parent_pool()->get_os_thread_count();
+        if (count >= num_threads) { scheduler->do_all_work(); }
+        else
+        {
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                scheduler->do_some_work(data[i].schedulehint.hint);
+            }
+        }
+    }
 }    // namespace pika::threads::detail
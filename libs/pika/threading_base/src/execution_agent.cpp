@@ -16,6 +16,7 @@
 #include <pika/threading_base/execution_agent.hpp>
 #include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/set_thread_state.hpp>
+#include <pika/threading_base/set_thread_state_timed.hpp>
 #include <pika/threading_base/thread_description.hpp>
 
 #ifdef PIKA_HAVE_THREAD_BACKTRACE_ON_SUSPENSION
@@ -88,19 +89,34 @@ namespace pika::threads::detail {
     void execution_agent::sleep_until(
         pika::chrono::steady_time_point const& sleep_time, char const* desc)
     {
-        // Just yield until time has passed by...
-        auto now = std::chrono::steady_clock::now();
+        thread_id_type id = self_.get_thread_id();
+        if (PIKA_UNLIKELY(!id))
+        {
+            PIKA_THROW_EXCEPTION(pika::error::null_thread_id, "execution_agent::sleep_until",
+                "null thread id encountered (is this executed on a pika-thread?)");
+        }
 
-        // Note: we yield at least once to allow for other threads to
-        // make progress in any case. We also use yield instead of yield_k
-        // for the same reason.
-        std::size_t k = 0;
+        // Suspend the thread and let the timer wheel of the scheduler wake it
+        // up once the time has passed by. The thread may be resumed early by
+        // other means, in which case the timer is cancelled and the thread is
+        // suspended again until the deadline is reached.
+        //
+        // Note: we suspend at least once to allow for other threads to make
+        // progress in any case.
+        scheduler_base* scheduler = get_thread_id_data(id)->get_scheduler_base();
         do {
-            if (k < 32 || k & 1) { do_yield(desc, thread_schedule_state::pending_boost); }
-            else { do_yield(desc, thread_schedule_state::pending); }
-            ++k;
-            now = std::chrono::steady_clock::now();
-        } while (now < sleep_time.value());
+            timer_handle timer = set_thread_state_timed(scheduler, sleep_time, id,
+                thread_schedule_state::pending, thread_restart_state::timeout,
+                execution::thread_priority::boost,
+                execution::thread_schedule_hint(
+                    static_cast<std::int16_t>(pika::get_local_worker_thread_num())),
+                nullptr, true, throws);
+
+            if (do_yield(desc, thread_schedule_state::suspended) != thread_restart_state::timeout)
+            {
+                timer.cancel();
+            }
+        } while (std::chrono::steady_clock::now() < sleep_time.value());
     }
 
 #if defined(PIKA_HAVE_VERIFY_LOCKS)
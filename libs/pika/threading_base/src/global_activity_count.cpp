@@ -17,6 +17,11 @@ namespace pika::threads::detail {
         global_activity_count.fetch_add(1, std::memory_order_acquire);
     }
 
+    void increment_global_activity_count(std::size_t count)
+    {
+        global_activity_count.fetch_add(count, std::memory_order_acquire);
+    }
+
     void decrement_global_activity_count()
     {
         global_activity_count.fetch_sub(1, std::memory_order_release);
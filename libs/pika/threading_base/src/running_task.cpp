@@ -0,0 +1,13 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/threading_base/detail/running_task.hpp>
+
+#include <atomic>
+
+namespace pika::threads::detail {
+    std::atomic<bool> running_task_tracking_enabled{false};
+}    // namespace pika::threads::detail
@@ -6,11 +6,20 @@
 
 #include <pika/config.hpp>
 #include <pika/assert.hpp>
+#include <pika/concurrency/concurrentqueue.hpp>
+#include <pika/errors/throw_exception.hpp>
+#include <pika/execution_base/agent_base.hpp>
+#include <pika/execution_base/context_base.hpp>
 #include <pika/execution_base/this_thread.hpp>
+#include <pika/threading_base/detail/global_activity_count.hpp>
+#include <pika/threading_base/detail/running_task.hpp>
+#include <pika/threading_base/detail/task_trace.hpp>
 #include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/scheduler_mode.hpp>
 #include <pika/threading_base/scheduler_state.hpp>
+#include <pika/threading_base/thread_description.hpp>
 #include <pika/threading_base/thread_init_data.hpp>
+#include <pika/threading_base/thread_num_tss.hpp>
 #include <pika/threading_base/thread_pool_base.hpp>
 #if defined(PIKA_HAVE_SCHEDULER_LOCAL_STORAGE)
 # include <pika/coroutines/detail/tss.hpp>
@@ -35,12 +44,21 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 namespace pika::threads::detail {
+    struct scheduler_base::inline_task_queue
+    {
+        pika::concurrency::detail::ConcurrentQueue<inline_task_type> tasks;
+        // The number of tasks in the queue, incremented before enqueueing and
+        // decremented after dequeueing a task
+        std::atomic<std::size_t> count{0};
+    };
+
     scheduler_base::scheduler_base(std::size_t num_threads, char const* description,
         thread_queue_init_parameters thread_queue_init, scheduler_mode mode)
       : suspend_mtxs_(num_threads)
       , suspend_conds_(num_threads)
       , pu_mtxs_(num_threads)
       , states_(num_threads)
+      , counters_(num_threads)
       , description_(description)
       , thread_queue_init_(thread_queue_init)
       , parent_pool_(nullptr)
@@ -54,15 +72,47 @@ namespace pika::threads::detail {
 #if defined(PIKA_HAVE_THREAD_MANAGER_IDLE_BACKOFF)
         double max_time = thread_queue_init.max_idle_backoff_time_;
 
-        wait_counts_.resize(num_threads);
-        for (auto&& data : wait_counts_)
+        wait_counts_ = decltype(wait_counts_)(num_threads);
+        for (auto&& data : wait_counts_) { data.data_.max_idle_backoff_time_ = max_time; }
+        num_sleepers_.data_.store(0, std::memory_order_relaxed);
+        timer_thread_.data_.store(std::size_t(-1), std::memory_order_relaxed);
+        timer_wakeup_.data_.store(
+            timer_wheel::clock_type::time_point::max(), std::memory_order_relaxed);
+#endif
+
+        for (std::size_t i = 0; i != num_threads; ++i) states_[i].store(runtime_state::initialized);
+
+        inline_tasks_.reserve(num_threads);
+        for (std::size_t i = 0; i != num_threads; ++i)
         {
-            data.data_.wait_count_ = 0;
-            data.data_.max_idle_backoff_time_ = max_time;
+            inline_tasks_.push_back(std::make_unique<inline_task_queue>());
+        }
+        inline_task_count_.data_.store(0, std::memory_order_relaxed);
+    }
+
+    scheduler_base::~scheduler_base() = default;
+
+    timer_handle scheduler_base::add_timer(timer_wheel::clock_type::time_point deadline,
+        timer_wheel::callback_type&& f, timer_wheel::callback_type&& on_stop)
+    {
+        timer_handle timer = timers_.add(deadline, std::move(f), std::move(on_stop));
+
+#if defined(PIKA_HAVE_THREAD_MANAGER_IDLE_BACKOFF)
+        // One worker thread sleeping in idle backoff waits for the earliest
+        // timer, see idle_callback. It only has to be woken up if the new
+        // timer is due before it wakes up by itself. Without such a worker
+        // thread any sleeping worker thread is woken up to take its place.
+        if (deadline < timer_wakeup_.data_.load(std::memory_order_seq_cst))
+        {
+            std::size_t const timer_thread = timer_thread_.data_.load(std::memory_order_seq_cst);
+            if (timer_thread == std::size_t(-1) || !wake_idle_thread(timer_thread))
+            {
+                do_some_work(std::size_t(-1));
+            }
         }
 #endif
 
-        for (std::size_t i = 0; i != num_threads; ++i) states_[i].store(runtime_state::initialized);
+        return timer;
     }
 
     void scheduler_base::idle_callback(std::size_t num_thread)
@@ -79,33 +129,380 @@ namespace pika::threads::detail {
             double exponent = (std::min)(
                 double(data.wait_count_), double(std::numeric_limits<double>::max_exponent - 1));
 
-            std::chrono::milliseconds period(
+            std::chrono::steady_clock::duration period = std::chrono::milliseconds(
                 std::lround((std::min)(data.max_idle_backoff_time_, std::pow(2.0, exponent))));
 
             ++data.wait_count_;
 
-            std::unique_lock<pu_mutex_type> l(mtx_);
-            if (cond_.wait_for(l, period) == std::cv_status::no_timeout)
+            std::unique_lock<pu_mutex_type> l(data.mtx_);
+            data.notified_ = false;
+            data.sleeping_.store(true, std::memory_order_relaxed);
+
+            // Announce the sleeper before checking the queue one last time.
+            // Producers enqueue work before checking for sleepers, i.e.
+            // either the producer sees this thread sleeping or this thread
+            // sees the new work. The same holds for the first timer armed on
+            // an empty wheel, see add_timer.
+            num_sleepers_.data_.fetch_add(1, std::memory_order_seq_cst);
+
+            // Armed timers are only fired while polling. One sleeping worker
+            // thread sleeps at most until the earliest timer is due, the
+            // others keep backing off. The wakeup time is announced after
+            // taking over the timers so that add_timer either sees it or the
+            // new timer is included in it.
+            std::size_t expected_timer_thread = std::size_t(-1);
+            bool const waits_for_timers = !timers_.empty() &&
+                timer_thread_.data_.compare_exchange_strong(
+                    expected_timer_thread, num_thread, std::memory_order_seq_cst);
+            if (waits_for_timers)
+            {
+                auto const next_expiry = timers_.next_expiry();
+                timer_wakeup_.data_.store(next_expiry, std::memory_order_seq_cst);
+
+                auto const now = timer_wheel::clock_type::now();
+                period = next_expiry <= now ?
+                    std::chrono::steady_clock::duration::zero() :
+                    (std::min)(period,
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            next_expiry - now));
+            }
+
+            if (get_queue_length(num_thread) == 0 && get_inline_task_count(num_thread) == 0)
+            {
+                if (data.cond_.wait_for(l, period, [&] { return data.notified_; }))
+                {
+                    // reset counter if thread was woken up
+                    data.wait_count_ = 0;
+                }
+            }
+
+            if (waits_for_timers)
+            {
+                timer_wakeup_.data_.store(
+                    timer_wheel::clock_type::time_point::max(), std::memory_order_seq_cst);
+                timer_thread_.data_.store(std::size_t(-1), std::memory_order_seq_cst);
+            }
+            data.sleeping_.store(false, std::memory_order_relaxed);
+            num_sleepers_.data_.fetch_sub(1, std::memory_order_relaxed);
+        }
+#else
+        (void) num_thread;
+#endif
+    }
+
+#if defined(PIKA_HAVE_THREAD_MANAGER_IDLE_BACKOFF)
+    // Wake up the worker thread num_thread if it is sleeping. Returns false if
+    // the worker thread is not sleeping.
+    bool scheduler_base::wake_idle_thread(std::size_t num_thread)
+    {
+        idle_backoff_data& data = wait_counts_[num_thread].data_;
+        if (!data.sleeping_.load(std::memory_order_relaxed)) { return false; }
+
+        {
+            std::lock_guard<pu_mutex_type> l(data.mtx_);
+            if (!data.sleeping_.load(std::memory_order_relaxed) || data.notified_) { return false; }
+
+            // make sure no other producer wakes up the same worker thread
+            data.sleeping_.store(false, std::memory_order_relaxed);
+            data.notified_ = true;
+        }
+        data.cond_.notify_one();
+
+        return true;
+    }
+#endif
+
+    void scheduler_base::do_some_work(std::size_t num_thread)
+    {
+#if defined(PIKA_HAVE_THREAD_MANAGER_IDLE_BACKOFF)
+        if (has_scheduler_mode(scheduler_mode::enable_idle_backoff))
+        {
+            // Pairs with the increment of num_sleepers_ in idle_callback. The
+            // work has already been enqueued at this point. The acquire load
+            // makes the sleeping_ flag stored before the increment visible
+            // when the increment is observed.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (num_sleepers_.data_.load(std::memory_order_acquire) == 0) { return; }
+
+            std::size_t const num_threads = wait_counts_.size();
+            if (num_thread >= num_threads)
             {
-                // reset counter if thread was woken up
-                data.wait_count_ = 0;
+                // wake up a worker thread close to the producer, if the
+                // producer is a worker thread of this pool
+                num_thread = 0;
+                if (parent_pool_ != nullptr &&
+                    get_thread_pool_num_tss() == parent_pool_->get_pool_index())
+                {
+                    std::size_t const local_thread_num = get_local_thread_num_tss();
+                    if (local_thread_num < num_threads) { num_thread = local_thread_num; }
+                }
+            }
+
+            // Worker threads with neighboring indices are assumed to be close
+            // to each other, the search starts at the given worker thread.
+            // The worker thread waiting for the timers is woken up last, so
+            // that it keeps waiting for them if possible.
+            std::size_t const timer_thread = timer_thread_.data_.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i != num_threads; ++i)
+            {
+                std::size_t const thread_num = (num_thread + i) % num_threads;
+                if (thread_num != timer_thread && wake_idle_thread(thread_num)) { return; }
             }
+            if (timer_thread < num_threads) { wake_idle_thread(timer_thread); }
         }
 #else
         (void) num_thread;
 #endif
     }
 
-    /// This function gets called by the thread-manager whenever new work
-    /// has been added, allowing the scheduler to reactivate one or more of
-    /// possibly idling OS threads
-    void scheduler_base::do_some_work(std::size_t)
+    void scheduler_base::do_all_work()
     {
 #if defined(PIKA_HAVE_THREAD_MANAGER_IDLE_BACKOFF)
-        if (has_scheduler_mode(scheduler_mode::enable_idle_backoff)) { cond_.notify_all(); }
+        for (std::size_t i = 0; i != wait_counts_.size(); ++i) { wake_idle_thread(i); }
 #endif
     }
 
+    void scheduler_base::create_threads(
+        threads::detail::thread_init_data* data, std::size_t count, error_code& ec)
+    {
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            create_thread(data[i], nullptr, ec);
+            if (ec) { return; }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    namespace {
+        thread_local bool running_inline_task = false;
+
+        // The maximum number of inline tasks run by a worker thread before it
+        // looks for pika threads again
+        constexpr std::size_t max_inline_tasks_per_poll = 64;
+
+        struct inline_task_context : ::pika::execution::detail::context_base
+        {
+            ::pika::execution::detail::resource_base const& resource() const override
+            {
+                return resource_;
+            }
+            ::pika::execution::detail::resource_base resource_;
+        };
+
+        // The execution agent of inline tasks. Inline tasks run on the stack
+        // of the worker thread and can not be suspended. Suspending would
+        // block the worker thread, so it is reported as an error instead.
+        // Spinning and yielding are forwarded to the default agent of the
+        // worker thread.
+        struct inline_task_agent : ::pika::execution::detail::agent_base
+        {
+            std::string description() const override { return "<inline task>"; }
+
+            inline_task_context const& context() const override { return context_; }
+
+            void yield(char const* desc) override
+            {
+                ::pika::execution::detail::get_default_agent().yield(desc);
+            }
+
+            void yield_k(std::size_t k, char const* desc) override
+            {
+                ::pika::execution::detail::get_default_agent().yield_k(k, desc);
+            }
+
+            void spin_k(std::size_t k, char const* desc) override
+            {
+                ::pika::execution::detail::get_default_agent().spin_k(k, desc);
+            }
+
+            void suspend(char const* desc) override { throw_cannot_suspend(desc); }
+
+            // An inline task is never suspended, there is nothing to resume
+            void resume(char const*) override {}
+            void abort(char const*) override {}
+
+            void sleep_for(pika::chrono::steady_duration const&, char const* desc) override
+            {
+                throw_cannot_suspend(desc);
+            }
+
+            void sleep_until(pika::chrono::steady_time_point const&, char const* desc) override
+            {
+                throw_cannot_suspend(desc);
+            }
+
+        private:
+            [[noreturn]] static void throw_cannot_suspend(char const* desc)
+            {
+                PIKA_THROW_EXCEPTION(pika::error::invalid_status, "inline_task_agent::suspend",
+                    "inline tasks can not suspend ({}), schedule work which may suspend with a "
+                    "thread_stacksize other than nostack",
+                    desc != nullptr ? desc : "<unknown>");
+            }
+
+            inline_task_context context_;
+        };
+
+        inline_task_agent& get_inline_task_agent()
+        {
+            static thread_local inline_task_agent agent;
+            return agent;
+        }
+
+        struct run_inline_task_helper
+        {
+            scheduler_base::inline_task_type& f;
+            std::atomic<std::size_t>& count;
+            running_task_slot* running_task;
+            bool const tracing;
+            ::pika::execution::this_thread::detail::reset_agent agent;
+
+            run_inline_task_helper(scheduler_base::inline_task_type& f,
+                std::atomic<std::size_t>& count, running_task_slot* running_task)
+              : f(f)
+              , count(count)
+              , running_task(running_task)
+              , tracing(task_tracing_enabled.load(std::memory_order_relaxed))
+              , agent(get_inline_task_agent())
+            {
+                running_inline_task = true;
+                if (running_task || tracing)
+                {
+                    ::pika::detail::thread_description const desc(f, "<inline task>");
+                    if (running_task) { running_task->start(&f, desc); }
+                    if (tracing) { record_task_trace_event(trace_event_type::begin, &f, desc); }
+                }
+            }
+
+            run_inline_task_helper(run_inline_task_helper const&) = delete;
+            run_inline_task_helper(run_inline_task_helper&&) = delete;
+            run_inline_task_helper& operator=(run_inline_task_helper const&) = delete;
+            run_inline_task_helper& operator=(run_inline_task_helper&&) = delete;
+
+            ~run_inline_task_helper()
+            {
+                // The task is only considered done once everything it captured
+                // has been destroyed
+                f.reset();
+                if (running_task) { running_task->stop(); }
+                if (tracing)
+                {
+                    record_task_trace_event(trace_event_type::end, &f,
+                        static_cast<std::size_t>(thread_schedule_state::terminated));
+                }
+                running_inline_task = false;
+                count.fetch_sub(1, std::memory_order_release);
+                decrement_global_activity_count();
+            }
+        };
+    }    // namespace
+
+    bool scheduler_base::schedule_inline_task(
+        inline_task_type&& f, execution::thread_schedule_hint hint)
+    {
+        std::size_t const num_threads = inline_tasks_.size();
+        std::size_t num_thread = std::size_t(-1);
+
+        if (hint.mode == execution::thread_schedule_hint_mode::thread && hint.hint >= 0)
+        {
+            num_thread = std::size_t(hint.hint) % num_threads;
+        }
+        else if (parent_pool_ != nullptr &&
+            get_thread_pool_num_tss() == parent_pool_->get_pool_index())
+        {
+            // keep the continuation on the worker thread that spawned it
+            std::size_t const local_thread_num = get_local_thread_num_tss();
+            if (local_thread_num < num_threads) { num_thread = local_thread_num; }
+        }
+
+        if (num_thread == std::size_t(-1))
+        {
+            num_thread = next_inline_thread_.fetch_add(1, std::memory_order_relaxed) % num_threads;
+        }
+
+        // The worker thread may be suspended or the pool may not be running.
+        // The task is announced in the queue count before the state is
+        // checked. The worker thread checks the count after it has seen the
+        // state change when suspending or stopping, so either the task is
+        // rejected here or the worker thread runs it before going away.
+        inline_task_queue& queue = *inline_tasks_[num_thread];
+        queue.count.fetch_add(1, std::memory_order_seq_cst);
+        if (states_[num_thread].load(std::memory_order_seq_cst) != runtime_state::running)
+        {
+            queue.count.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        increment_global_activity_count();
+        inline_task_count_.data_.fetch_add(1, std::memory_order_release);
+        queue.tasks.enqueue(std::move(f));
+
+        do_some_work(num_thread);
+        return true;
+    }
+
+    polling_status scheduler_base::run_inline_tasks(
+        std::size_t num_thread, bool enable_stealing, running_task_slot* running_task)
+    {
+        if (inline_task_count_.data_.load(std::memory_order_relaxed) == 0)
+        {
+            return polling_status::idle;
+        }
+
+        std::atomic<std::size_t>& count = inline_task_count_.data_;
+        inline_task_type f;
+        std::size_t num_run = 0;
+
+        inline_task_queue& queue = *inline_tasks_[num_thread];
+        // Exceptions escaping an inline task are reported like those escaping
+        // a pika thread, but the worker thread keeps running
+        auto run = [&]() {
+            try
+            {
+                run_inline_task_helper helper(f, count, running_task);
+                f();
+            }
+            catch (...)
+            {
+                PIKA_ASSERT(parent_pool_ != nullptr);
+                parent_pool_->report_error(
+                    local_to_global_thread_index(num_thread), std::current_exception());
+            }
+        };
+
+        while (num_run != max_inline_tasks_per_poll && queue.tasks.try_dequeue(f))
+        {
+            queue.count.fetch_sub(1, std::memory_order_relaxed);
+            run();
+            ++num_run;
+        }
+
+        if (num_run == 0 && enable_stealing)
+        {
+            std::size_t const num_threads = inline_tasks_.size();
+            for (std::size_t i = 1; i != num_threads; ++i)
+            {
+                inline_task_queue& victim = *inline_tasks_[(num_thread + i) % num_threads];
+                if (victim.tasks.try_dequeue(f))
+                {
+                    victim.count.fetch_sub(1, std::memory_order_relaxed);
+                    run();
+                    ++num_run;
+                    break;
+                }
+            }
+        }
+
+        return num_run != 0 ? polling_status::busy : polling_status::idle;
+    }
+
+    std::size_t scheduler_base::get_inline_task_count(std::size_t num_thread) const noexcept
+    {
+        return inline_tasks_[num_thread]->count.load(std::memory_order_seq_cst);
+    }
+
+    bool scheduler_base::is_running_inline_task() noexcept { return running_inline_task; }
+
     void scheduler_base::suspend(std::size_t num_thread)
     {
         PIKA_ASSERT(num_thread < suspend_conds_.size());
@@ -288,12 +685,26 @@ namespace pika::threads::detail {
         return result;
     }
 
+    scheduler_counter_values scheduler_base::get_scheduler_counter_values(
+        std::size_t num_thread, bool reset)
+    {
+        if (num_thread != std::size_t(-1))
+        {
+            PIKA_ASSERT(num_thread < counters_.size());
+            return counters_[num_thread].data_.get(reset);
+        }
+
+        scheduler_counter_values values;
+        for (auto& counters : counters_) { values += counters.data_.get(reset); }
+        return values;
+    }
+
     // get/set scheduler mode
     void scheduler_base::set_scheduler_mode(scheduler_mode mode)
     {
         // distribute the same value across all cores
         mode_.data_.store(mode, std::memory_order_release);
-        do_some_work(std::size_t(-1));
+        do_all_work();
     }
 
     void scheduler_base::add_scheduler_mode(scheduler_mode mode)
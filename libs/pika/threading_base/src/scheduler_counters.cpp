@@ -0,0 +1,23 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/threading_base/detail/scheduler_counters.hpp>
+
+#include <atomic>
+
+namespace pika::threads::detail {
+    std::atomic<bool> scheduler_counters_enabled{false};
+
+    void set_scheduler_counters_enabled(bool enabled)
+    {
+        scheduler_counters_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool get_scheduler_counters_enabled()
+    {
+        return scheduler_counters_enabled.load(std::memory_order_relaxed);
+    }
+}    // namespace pika::threads::detail
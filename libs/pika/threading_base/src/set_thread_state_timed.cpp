@@ -7,170 +7,123 @@
 #include <pika/config.hpp>
 #include <pika/assert.hpp>
 #include <pika/coroutines/coroutine.hpp>
-#include <pika/functional/bind.hpp>
-#include <pika/functional/bind_front.hpp>
 #include <pika/modules/errors.hpp>
-#include <pika/threading_base/create_thread.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
 #include <pika/threading_base/set_thread_state_timed.hpp>
+#include <pika/threading_base/thread_data.hpp>
 #include <pika/threading_base/threading_base_fwd.hpp>
 
 #include <atomic>
 #include <chrono>
-#include <functional>
-#include <memory>
-#include <system_error>
+#include <cstdint>
 #include <utility>
 
 namespace pika::threads::detail {
-    /// This thread function is used by the at_timer thread below to trigger
-    /// the required action.
-    thread_result_type wake_timer_thread(thread_id_ref_type const& thrd,
-        thread_schedule_state /*newstate*/, thread_restart_state /*newstate_ex*/,
-        execution::thread_priority /*priority*/, thread_id_type timer_id,
-        std::shared_ptr<std::atomic<bool>> const& triggered, bool retry_on_active,
-        thread_restart_state my_statex)
-    {
-        if (PIKA_UNLIKELY(!thrd))
-        {
-            PIKA_THROW_EXCEPTION(pika::error::null_thread_id, "threads::detail::wake_timer_thread",
-                "null thread id encountered (id)");
-            return thread_result_type(thread_schedule_state::terminated, invalid_thread_id);
-        }
-
-        if (PIKA_UNLIKELY(!timer_id))
-        {
-            PIKA_THROW_EXCEPTION(pika::error::null_thread_id, "threads::detail::wake_timer_thread",
-                "null thread id encountered (timer_id)");
-            return thread_result_type(thread_schedule_state::terminated, invalid_thread_id);
-        }
-
-        PIKA_ASSERT(
-            my_statex == thread_restart_state::abort || my_statex == thread_restart_state::timeout);
-
-        if (!triggered->load())
+    namespace {
+        /// Return the tag the state of a thread currently in \a state will
+        /// have once the thread is (or while it still is) suspended. The tag
+        /// of a thread state is incremented on every change of the scheduling
+        /// state, i.e. a pending thread is suspended two changes later.
+        std::int64_t get_suspension_tag(thread_state state) noexcept
         {
-            error_code ec(throwmode::lightweight);    // do not throw
-            set_thread_state(timer_id, thread_schedule_state::pending, my_statex,
-                execution::thread_priority::boost, execution::thread_schedule_hint(),
-                retry_on_active, ec);
+            switch (state.state())
+            {
+            case thread_schedule_state::suspended: return state.tag();
+            case thread_schedule_state::active: return state.tag() + 1;
+            default: return state.tag() + 2;
+            }
         }
 
-        return thread_result_type(thread_schedule_state::terminated, invalid_thread_id);
-    }
-
-    /// This thread function initiates the required set_state action (on
-    /// behalf of one of the threads#detail#set_thread_state functions).
-    thread_result_type at_timer(scheduler_base* scheduler,
-        std::chrono::steady_clock::time_point& /*abs_time*/, thread_id_ref_type const& thrd,
-        thread_schedule_state newstate, thread_restart_state newstate_ex,
-        execution::thread_priority priority, std::atomic<bool>* /*started*/, bool retry_on_active)
-    {
-        if (PIKA_UNLIKELY(!thrd))
+        /// This function object is invoked from the timer wheel when the timer
+        /// expires. It changes the state of the thread only if the thread is
+        /// still in the suspension the timer has been set for. This makes sure
+        /// that a thread woken up by other means in the meantime does not
+        /// receive a spurious wakeup in a later suspension.
+        struct wake_timer
         {
-            PIKA_THROW_EXCEPTION(pika::error::null_thread_id, "threads::detail::at_timer",
-                "null thread id encountered");
-            return thread_result_type(thread_schedule_state::terminated, invalid_thread_id);
-        }
-
-        // create a new thread in suspended state, which will execute the
-        // requested set_state when timer fires and will re-awaken this thread,
-        // allowing the deadline_timer to go out of scope gracefully
-        thread_id_ref_type self_id = get_self_id();    // keep alive
-
-        std::shared_ptr<std::atomic<bool>> triggered(std::make_shared<std::atomic<bool>>(false));
-
-        thread_init_data data(
-            util::detail::bind_front(&wake_timer_thread, thrd, newstate, newstate_ex, priority,
-                self_id.noref(), triggered, retry_on_active),
-            "wake_timer", priority, execution::thread_schedule_hint(),
-            execution::thread_stacksize::small_, thread_schedule_state::suspended, true);
-
-        thread_id_ref_type wake_id = invalid_thread_id;
-        create_thread(scheduler, data, wake_id);
-
-        PIKA_THROW_EXCEPTION(
-            pika::error::invalid_status, "at_timer", "Timed suspension is currently not supported");
-        // // create timer firing in correspondence with given time
-        // using deadline_timer =
-        //     asio::basic_waitable_timer<std::chrono::steady_clock>;
-
-        // asio::io_context* s = get_default_timer_service();
-        // PIKA_ASSERT(s);
-        // deadline_timer t(*s, abs_time);
-
-        // // let the timer invoke the set_state on the new (suspended) thread
-        // t.async_wait([wake_id = std::move(wake_id), priority, retry_on_active](
-        //                  std::error_code const& ec) {
-        //     if (ec == std::make_error_code(std::errc::operation_canceled))
-        //     {
-        //            set_thread_state(wake_id.noref(), thread_schedule_state::pending,
-        //                thread_restart_state::abort, priority,
-        //                execution::thread_schedule_hint(), retry_on_active, throws);
-        //     }
-        //     else
-        //     {
-        //         set_thread_state(wake_id.noref(),
-        //             thread_schedule_state::pending,
-        //             thread_restart_state::timeout, priority,
-        //             execution::thread_schedule_hint(), retry_on_active, throws);
-        //     }
-        // });
-
-        // if (started != nullptr)
-        // {
-        //     started->store(true);
-        // }
-
-        // // this waits for the thread to be reactivated when the timer fired
-        // // if it returns signaled the timer has been canceled, otherwise
-        // // the timer fired and the wake_timer_thread above has been executed
-        // thread_restart_state statex = get_self().yield(thread_result_type(
-        //     thread_schedule_state::suspended, invalid_thread_id));
-
-        // PIKA_ASSERT(statex == thread_restart_state::abort ||
-        //     statex == thread_restart_state::timeout);
-
-        // // NOLINTNEXTLINE(bugprone-branch-clone)
-        // if (thread_restart_state::timeout != statex)    //-V601
-        // {
-        //     triggered->store(true);
-        //     // wake_timer_thread has not been executed yet, cancel timer
-        //     t.cancel();
-        // }
-        // else
-        // {
-        //     set_thread_state(
-        //         thrd.noref(), newstate, newstate_ex, priority);
-        // }
-
-        return thread_result_type(thread_schedule_state::terminated, invalid_thread_id);
-    }
+            scheduler_base* scheduler_;
+            thread_id_ref_type thrd_;
+            std::int64_t tag_;
+            thread_schedule_state newstate_;
+            thread_restart_state newstate_ex_;
+            execution::thread_schedule_hint schedulehint_;
+            bool retry_on_active_;
+
+            void operator()()
+            {
+                thread_data* thrd_data = get_thread_id_data(thrd_);
+
+                thread_state previous_state;
+                do {
+                    previous_state = thrd_data->get_state();
+
+                    // the thread has already left the suspension this timer
+                    // was set for
+                    if (previous_state.tag() > tag_) { return; }
+
+                    if (previous_state.tag() < tag_)
+                    {
+                        // the thread has not been suspended yet, try again
+                        // one tick of the timer wheel later. Re-arming the
+                        // timer with a deadline in the past would fire it on
+                        // every poll until the thread has been suspended.
+                        if (retry_on_active_)
+                        {
+                            scheduler_->add_timer(
+                                timer_wheel::clock_type::now() + timer_wheel::resolution,
+                                std::move(*this));
+                        }
+                        return;
+                    }
+
+                    // the thread has terminated or yielded without being
+                    // suspended
+                    if (previous_state.state() != thread_schedule_state::suspended) { return; }
+                } while (!thrd_data->restore_state(newstate_, newstate_ex_, previous_state));
+
+                if (newstate_ == thread_schedule_state::pending ||
+                    newstate_ == thread_schedule_state::pending_boost)
+                {
+                    scheduler_->schedule_thread(
+                        thrd_, schedulehint_, false, thrd_data->get_priority());
+                    scheduler_->do_some_work(schedulehint_.hint);
+                }
+            }
+        };
+    }    // namespace
 
     /// Set a timer to set the state of the given \a thread to the given
     /// new value after it expired (at the given time)
-    thread_id_ref_type set_thread_state_timed(scheduler_base* scheduler,
+    timer_handle set_thread_state_timed(scheduler_base* scheduler,
         pika::chrono::steady_time_point const& abs_time, thread_id_type const& thrd,
         thread_schedule_state newstate, thread_restart_state newstate_ex,
-        execution::thread_priority priority, execution::thread_schedule_hint schedulehint,
+        execution::thread_priority /*priority*/, execution::thread_schedule_hint schedulehint,
         std::atomic<bool>* started, bool retry_on_active, error_code& ec)
     {
         if (PIKA_UNLIKELY(!thrd))
         {
             PIKA_THROWS_IF(ec, pika::error::null_thread_id, "threads::detail::set_thread_state",
                 "null thread id encountered");
-            return invalid_thread_id;
+            return timer_handle();
         }
 
-        // this creates a new thread which creates the timer and handles the
-        // requested actions
-        thread_init_data data(
-            util::detail::bind(&at_timer, scheduler, abs_time.value(), thread_id_ref_type(thrd),
-                newstate, newstate_ex, priority, started, retry_on_active),
-            "at_timer (expire at)", priority, schedulehint, execution::thread_stacksize::small_,
-            thread_schedule_state::pending, true);
-
-        thread_id_ref_type newid = invalid_thread_id;
-        create_thread(scheduler, data, newid, ec);    //-V601
-        return newid;
+        PIKA_ASSERT(scheduler != nullptr);
+
+        timer_handle timer;
+        thread_state previous_state = get_thread_id_data(thrd)->get_state();
+        if (previous_state.state() != thread_schedule_state::terminated)
+        {
+            timer = scheduler->add_timer(abs_time.value(),
+                wake_timer{scheduler, thread_id_ref_type(thrd),
+                    get_suspension_tag(previous_state), newstate, newstate_ex, schedulehint,
+                    retry_on_active});
+        }
+
+        if (started != nullptr) { started->store(true); }
+
+        if (&ec != &throws) ec = make_success_code();
+
+        return timer;
     }
 }    // namespace pika::threads::detail
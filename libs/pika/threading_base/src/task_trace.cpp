@@ -0,0 +1,80 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/threading_base/detail/task_trace.hpp>
+#include <pika/threading_base/thread_description.hpp>
+#include <pika/threading_base/thread_num_tss.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace pika::threads::detail {
+    trace_buffer::trace_buffer(std::size_t capacity)
+      : capacity_(capacity == 0 ? 1 : capacity)
+      , slots_(new slot[capacity_])
+    {
+    }
+
+    std::atomic<bool> task_tracing_enabled{false};
+
+    namespace {
+        // Only modified while tracing is disabled, read by the worker threads
+        // while tracing is enabled
+        std::vector<std::unique_ptr<trace_buffer>>& trace_buffers()
+        {
+            static std::vector<std::unique_ptr<trace_buffer>> buffers;
+            return buffers;
+        }
+    }    // namespace
+
+    void enable_task_tracing(std::size_t num_threads, std::size_t capacity)
+    {
+        PIKA_ASSERT(!task_tracing_enabled.load(std::memory_order_relaxed));
+
+        auto& buffers = trace_buffers();
+        buffers.clear();
+        buffers.reserve(num_threads);
+        for (std::size_t i = 0; i != num_threads; ++i)
+        {
+            buffers.push_back(std::make_unique<trace_buffer>(capacity));
+        }
+
+        task_tracing_enabled.store(true, std::memory_order_release);
+    }
+
+    void disable_task_tracing() { task_tracing_enabled.store(false, std::memory_order_release); }
+
+    trace_buffer* get_task_trace_buffer(std::size_t global_thread_num)
+    {
+        auto& buffers = trace_buffers();
+        return global_thread_num < buffers.size() ? buffers[global_thread_num].get() : nullptr;
+    }
+
+    void record_task_trace_event(trace_event_type type, void const* id,
+        ::pika::detail::thread_description const& desc)
+    {
+        trace_buffer* buffer = get_task_trace_buffer(get_global_thread_num_tss());
+        if (buffer == nullptr) { return; }
+
+        if (desc.kind() == ::pika::detail::thread_description::data_type_description)
+        {
+            buffer->record(type, id, desc.get_description(), 0);
+        }
+        else { buffer->record(type, id, nullptr, desc.get_address()); }
+    }
+
+    void record_task_trace_event(trace_event_type type, void const* id, std::size_t data)
+    {
+        trace_buffer* buffer = get_task_trace_buffer(get_global_thread_num_tss());
+        if (buffer == nullptr) { return; }
+
+        buffer->record(type, id, nullptr, data);
+    }
+}    // namespace pika::threads::detail
@@ -47,12 +47,14 @@ namespace pika::threads::detail {
       , backtrace_(nullptr)
 #endif
       , priority_(init_data.priority)
+      , deadline_(init_data.deadline)
       , requested_interrupt_(false)
       , enabled_interrupt_(true)
       , ran_exit_funcs_(false)
       , is_stackless_(is_stackless)
       , scheduler_base_(init_data.scheduler_base)
       , last_worker_thread_num_(std::size_t(-1))
+      , ready_time_(0)
       , stacksize_(stacksize)
       , stacksize_enum_(init_data.stacksize)
       , queue_(queue)
@@ -61,6 +63,8 @@ namespace pika::threads::detail {
 
         PIKA_ASSERT(stacksize_enum_ != execution::thread_stacksize::current);
 
+        if (init_data.initial_state == thread_schedule_state::pending) { set_ready_time(); }
+
 #ifdef PIKA_HAVE_THREAD_PARENT_REFERENCE
         // store the thread id of the parent thread, mainly for debugging
         // purposes
@@ -182,12 +186,15 @@ namespace pika::threads::detail {
         backtrace_ = nullptr;
 #endif
         priority_ = init_data.priority;
+        deadline_ = init_data.deadline;
         requested_interrupt_ = false;
         enabled_interrupt_ = true;
         ran_exit_funcs_ = false;
         exit_funcs_.clear();
         scheduler_base_ = init_data.scheduler_base;
         last_worker_thread_num_.store(std::size_t(-1), std::memory_order_relaxed);
+        ready_time_ = 0;
+        if (init_data.initial_state == thread_schedule_state::pending) { set_ready_time(); }
 
         // We explicitly set the logical stack size again as it can be different
         // from what the previous use required. However, the physical stack size
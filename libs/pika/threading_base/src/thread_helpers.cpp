@@ -51,7 +51,7 @@ namespace pika::threads::detail {
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    thread_id_ref_type set_thread_state(thread_id_type const& id,
+    timer_handle set_thread_state(thread_id_type const& id,
         pika::chrono::steady_time_point const& abs_time, std::atomic<bool>* timer_started,
         thread_schedule_state state, thread_restart_state stateex,
         execution::thread_priority priority, bool retry_on_active, error_code& ec)
@@ -61,6 +61,23 @@ namespace pika::threads::detail {
             retry_on_active, ec);
     }
 
+    timer_handle add_timer(thread_id_type const& id,
+        pika::chrono::steady_time_point const& abs_time, timer_wheel::callback_type&& f,
+        error_code& ec)
+    {
+        if (PIKA_UNLIKELY(!id))
+        {
+            PIKA_THROWS_IF(ec, pika::error::null_thread_id, "threads::detail::add_timer",
+                "null thread id encountered");
+            return timer_handle();
+        }
+
+        if (&ec != &throws) ec = make_success_code();
+
+        return get_thread_id_data(id)->get_scheduler_base()->add_timer(
+            abs_time.value(), std::move(f));
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     thread_state get_thread_state(thread_id_type const& id, error_code& /* ec */)
     {
@@ -402,9 +419,8 @@ namespace pika::this_thread {
 #ifdef PIKA_HAVE_THREAD_BACKTRACE_ON_SUSPENSION
             threads::detail::reset_backtrace bt(id, ec);
 #endif
-            std::atomic<bool> timer_started(false);
-            threads::detail::thread_id_ref_type timer_id =
-                threads::detail::set_thread_state(id.noref(), abs_time, &timer_started,
+            threads::detail::timer_handle timer =
+                threads::detail::set_thread_state(id.noref(), abs_time, nullptr,
                     threads::detail::thread_schedule_state::pending,
                     pika::threads::detail::thread_restart_state::timeout,
                     execution::thread_priority::boost, true, ec);
@@ -428,17 +444,14 @@ namespace pika::this_thread {
                     threads::detail::thread_schedule_state::suspended, std::move(nextid)));
             }
 
+            // Release the timer early if we were woken up by other means. If
+            // the timer is already expiring concurrently it will notice that
+            // this thread is no longer in the suspension it was armed for.
             if (statex != pika::threads::detail::thread_restart_state::timeout)
             {
                 PIKA_ASSERT(statex == pika::threads::detail::thread_restart_state::abort ||
                     statex == pika::threads::detail::thread_restart_state::signaled);
-                error_code ec1(throwmode::lightweight);    // do not throw
-                pika::util::yield_while(
-                    [&timer_started]() { return !timer_started.load(); }, "set_thread_state_timed");
-                threads::detail::set_thread_state(timer_id.noref(),
-                    threads::detail::thread_schedule_state::pending,
-                    pika::threads::detail::thread_restart_state::abort,
-                    execution::thread_priority::boost, true, ec1);
+                timer.cancel();
             }
         }
 
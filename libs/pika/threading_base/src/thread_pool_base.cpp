@@ -6,6 +6,7 @@
 
 #include <pika/affinity/affinity_data.hpp>
 #include <pika/assert.hpp>
+#include <pika/concurrency/spinlock.hpp>
 #include <pika/functional/bind.hpp>
 #include <pika/modules/errors.hpp>
 #include <pika/threading_base/callback_notifier.hpp>
@@ -15,6 +16,8 @@
 #include <pika/timing/detail/timestamp.hpp>
 #include <pika/topology/topology.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -23,6 +26,8 @@
 #include <ostream>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace pika::threads::detail {
     ///////////////////////////////////////////////////////////////////////////
@@ -63,6 +68,16 @@ namespace pika::threads::detail {
         return topo.cpuset_to_nodeset(used_processing_units);
     }
 
+    void thread_pool_base::create_work_bulk(
+        thread_init_data* data, std::size_t count, error_code& ec)
+    {
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            create_work(data[i], ec);
+            if (ec) { return; }
+        }
+    }
+
     std::size_t thread_pool_base::get_active_os_thread_count() const
     {
         std::size_t active_os_thread_count = 0;
@@ -78,6 +93,14 @@ namespace pika::threads::detail {
         return active_os_thread_count;
     }
 
+    scheduler_counter_values thread_pool_base::get_scheduler_counters(
+        std::size_t num_thread, bool reset)
+    {
+        scheduler_base* sched = get_scheduler();
+        if (sched == nullptr) { return {}; }
+        return sched->get_scheduler_counter_values(num_thread, reset);
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     void thread_pool_base::init_pool_time_scale()
     {
@@ -103,8 +126,99 @@ namespace pika::threads::detail {
         }
     }
 
-    void thread_pool_base::init(std::size_t /* pool_threads */, std::size_t threads_offset)
+    void thread_pool_base::init_steal_orders(std::size_t num_threads)
+    {
+        // The worker thread states are read under the lock so that concurrent
+        // updates can not store outdated steal orders
+        std::lock_guard<std::mutex> l(steal_orders_mtx_);
+
+        auto const& topo = get_topology();
+
+        // Lower values mean that two worker threads share more resources.
+        // Values up to numa_local_distance mean the same NUMA domain.
+        constexpr int numa_local_distance = 2;
+        constexpr int suspended_distance = 5;
+        auto distance = [&](std::size_t pu_a, std::size_t pu_b) {
+            if (topo.get_core_number(pu_a) == topo.get_core_number(pu_b)) { return 0; }
+            if (topo.get_numa_node_number(pu_a) != topo.get_numa_node_number(pu_b))
+            {
+                return topo.get_socket_number(pu_a) == topo.get_socket_number(pu_b) ? 3 : 4;
+            }
+            if (topo.get_l3_cache_number(pu_a) == topo.get_l3_cache_number(pu_b)) { return 1; }
+            return numa_local_distance;
+        };
+
+        // Worker threads are suspended when the pool is suspended as a whole,
+        // when their processing unit is used by another pool, or when the
+        // elasticity controller scales the pool down. Only the latter two are
+        // reflected in the steal orders.
+        std::vector<std::size_t> pus(num_threads);
+        std::vector<bool> suspended(num_threads, false);
+        for (std::size_t thread_num = 0; thread_num < num_threads; ++thread_num)
+        {
+            pus[thread_num] = affinity_data_.get_pu_num(thread_num + thread_offset_);
+
+            runtime_state const state = get_state(thread_num);
+            suspended[thread_num] =
+                state == runtime_state::pre_sleep || state == runtime_state::sleeping;
+        }
+
+        auto thread_distance = [&](std::size_t thread_num, std::size_t other_thread_num) {
+            if (suspended[other_thread_num]) { return suspended_distance; }
+            return distance(pus[thread_num], pus[other_thread_num]);
+        };
+
+        auto steal_orders = std::make_unique<std::vector<steal_order>>(num_threads);
+        for (std::size_t thread_num = 0; thread_num < num_threads; ++thread_num)
+        {
+            auto& order = (*steal_orders)[thread_num];
+
+            // Threads at the same distance are visited in round-robin
+            // order starting from the next thread, so that not all threads
+            // steal from the same victim first.
+            order.threads.reserve(num_threads - 1);
+            for (std::size_t offset = 1; offset < num_threads; ++offset)
+            {
+                order.threads.push_back(
+                    static_cast<std::uint32_t>((thread_num + offset) % num_threads));
+            }
+            std::stable_sort(order.threads.begin(), order.threads.end(),
+                [&](std::uint32_t lhs, std::uint32_t rhs) {
+                    return thread_distance(thread_num, lhs) < thread_distance(thread_num, rhs);
+                });
+
+            order.numa_local_count = static_cast<std::size_t>(
+                std::count_if(order.threads.begin(), order.threads.end(), [&](std::uint32_t t) {
+                    return thread_distance(thread_num, t) <= numa_local_distance;
+                }));
+        }
+
+        // The previous steal orders are freed outside of the lock, or by the
+        // last bulk operation still using them
+        std::shared_ptr<std::vector<steal_order> const> previous_steal_orders(
+            std::move(steal_orders));
+        {
+            std::lock_guard<pika::concurrency::detail::spinlock> lp(steal_orders_ptr_mtx_);
+            std::swap(steal_orders_, previous_steal_orders);
+        }
+    }
+
+    std::shared_ptr<std::vector<thread_pool_base::steal_order> const>
+    thread_pool_base::get_steal_orders() const
+    {
+        std::lock_guard<pika::concurrency::detail::spinlock> l(steal_orders_ptr_mtx_);
+        return steal_orders_;
+    }
+
+    void thread_pool_base::update_steal_orders()
+    {
+        auto const steal_orders = get_steal_orders();
+        if (steal_orders) { init_steal_orders(steal_orders->size()); }
+    }
+
+    void thread_pool_base::init(std::size_t pool_threads, std::size_t threads_offset)
     {
         thread_offset_ = threads_offset;
+        init_steal_orders(pool_threads);
     }
 }    // namespace pika::threads::detail
@@ -0,0 +1,405 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace pika::threads::detail {
+    namespace {
+        constexpr std::uint64_t slot_mask = timer_wheel::num_slots - 1;
+    }
+
+    timer_wheel::timer_wheel()
+      : current_tick_(to_tick_floor(clock_type::now()))
+      , count_(0)
+      , has_expired_(false)
+      , overflow_(nullptr)
+      , expired_(nullptr)
+    {
+        for (std::size_t level = 0; level != num_levels; ++level)
+        {
+            occupied_[level] = 0;
+            std::fill(std::begin(slots_[level]), std::end(slots_[level]), nullptr);
+        }
+    }
+
+    timer_wheel::~timer_wheel()
+    {
+        // Timers which have not expired yet are dropped without invoking their
+        // callbacks.
+        auto release_all = [](timer_entry* e) {
+            while (e != nullptr)
+            {
+                timer_entry* next = e->next_;
+                e->armed_ = false;
+                e->list_ = nullptr;
+                intrusive_ptr_release(e);
+                e = next;
+            }
+        };
+
+        for (std::size_t level = 0; level != num_levels; ++level)
+        {
+            for (timer_entry* e : slots_[level]) { release_all(e); }
+        }
+        release_all(overflow_);
+        release_all(expired_);
+    }
+
+    std::uint64_t timer_wheel::to_tick_ceil(clock_type::time_point t) noexcept
+    {
+        auto const since_epoch = t.time_since_epoch().count();
+        if (since_epoch <= 0) { return 0; }
+        return (static_cast<std::uint64_t>(since_epoch) + resolution.count() - 1) /
+            resolution.count();
+    }
+
+    std::uint64_t timer_wheel::to_tick_floor(clock_type::time_point t) noexcept
+    {
+        auto const since_epoch = t.time_since_epoch().count();
+        if (since_epoch <= 0) { return 0; }
+        return static_cast<std::uint64_t>(since_epoch) / resolution.count();
+    }
+
+    void timer_wheel::push_front(timer_entry** list, timer_entry* e) noexcept
+    {
+        e->prev_ = nullptr;
+        e->next_ = *list;
+        if (e->next_ != nullptr) { e->next_->prev_ = e; }
+        *list = e;
+        e->list_ = list;
+    }
+
+    timer_entry* timer_wheel::take_list(timer_entry** list) noexcept
+    {
+        timer_entry* head = *list;
+        *list = nullptr;
+        return head;
+    }
+
+    void timer_wheel::link(timer_entry* e) noexcept
+    {
+        std::uint64_t const current = current_tick_.load(std::memory_order_relaxed);
+        if (e->tick_ <= current)
+        {
+            push_front(&expired_, e);
+            has_expired_.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        // The level is given by the most significant digit in which the
+        // expiry tick differs from the current tick.
+        std::uint64_t const diff = e->tick_ ^ current;
+        std::size_t level = 0;
+        while (level != num_levels && (diff >> ((level + 1) * slot_bits)) != 0) { ++level; }
+
+        if (level == num_levels)
+        {
+            push_front(&overflow_, e);
+            return;
+        }
+
+        auto const slot = static_cast<std::size_t>((e->tick_ >> (level * slot_bits)) & slot_mask);
+        e->level_ = static_cast<std::uint8_t>(level);
+        e->slot_ = static_cast<std::uint8_t>(slot);
+        push_front(&slots_[level][slot], e);
+        occupied_[level] |= std::uint64_t(1) << slot;
+    }
+
+    void timer_wheel::unlink(timer_entry* e) noexcept
+    {
+        PIKA_ASSERT(e->list_ != nullptr);
+
+        if (e->prev_ != nullptr) { e->prev_->next_ = e->next_; }
+        else { *e->list_ = e->next_; }
+        if (e->next_ != nullptr) { e->next_->prev_ = e->prev_; }
+
+        timer_entry** slot = &slots_[e->level_][e->slot_];
+        if (e->list_ == slot && *slot == nullptr)
+        {
+            occupied_[e->level_] &= ~(std::uint64_t(1) << e->slot_);
+        }
+
+        e->prev_ = nullptr;
+        e->next_ = nullptr;
+        e->list_ = nullptr;
+    }
+
+    void timer_wheel::cascade(std::size_t level, std::uint64_t tick) noexcept
+    {
+        timer_entry* e = nullptr;
+        if (level == num_levels) { e = take_list(&overflow_); }
+        else
+        {
+            auto const slot = static_cast<std::size_t>((tick >> (level * slot_bits)) & slot_mask);
+            e = take_list(&slots_[level][slot]);
+            occupied_[level] &= ~(std::uint64_t(1) << slot);
+        }
+
+        while (e != nullptr)
+        {
+            timer_entry* next = e->next_;
+            link(e);
+            e = next;
+        }
+    }
+
+    timer_entry* timer_wheel::advance(std::uint64_t target) noexcept
+    {
+        std::uint64_t current = current_tick_.load(std::memory_order_relaxed);
+        timer_entry* fired = nullptr;
+
+        while (current < target && count_.load(std::memory_order_relaxed) != 0)
+        {
+            // Skip directly to the end of the current rotation of the lowest
+            // level if there is nothing to fire in it.
+            if (occupied_[0] == 0 && (current & slot_mask) != slot_mask)
+            {
+                current = (std::min)(target, current | slot_mask);
+                continue;
+            }
+
+            ++current;
+            current_tick_.store(current, std::memory_order_relaxed);
+
+            if ((current & slot_mask) == 0)
+            {
+                std::size_t level = 1;
+                for (; level != num_levels; ++level)
+                {
+                    cascade(level, current);
+                    if (((current >> (level * slot_bits)) & slot_mask) != 0) { break; }
+                }
+                if (level == num_levels) { cascade(num_levels, current); }
+            }
+
+            auto const slot = static_cast<std::size_t>(current & slot_mask);
+            timer_entry* e = take_list(&slots_[0][slot]);
+            occupied_[0] &= ~(std::uint64_t(1) << slot);
+            while (e != nullptr)
+            {
+                timer_entry* next = e->next_;
+                PIKA_ASSERT(e->tick_ == current);
+                e->armed_ = false;
+                e->list_ = nullptr;
+                e->prev_ = nullptr;
+                e->next_ = fired;
+                fired = e;
+                count_.fetch_sub(1, std::memory_order_relaxed);
+                e = next;
+            }
+        }
+
+        current_tick_.store((std::max)(current, target), std::memory_order_relaxed);
+
+        // Entries which were already due when they were added (or cascaded)
+        // are fired together with the ones expiring in this step.
+        timer_entry* e = take_list(&expired_);
+        has_expired_.store(false, std::memory_order_relaxed);
+        while (e != nullptr)
+        {
+            timer_entry* next = e->next_;
+            e->armed_ = false;
+            e->list_ = nullptr;
+            e->prev_ = nullptr;
+            e->next_ = fired;
+            fired = e;
+            count_.fetch_sub(1, std::memory_order_relaxed);
+            e = next;
+        }
+
+        return fired;
+    }
+
+    timer_handle timer_wheel::add(
+        clock_type::time_point deadline, callback_type&& f, callback_type&& on_stop)
+    {
+        pika::memory::intrusive_ptr<timer_entry> entry(
+            new timer_entry(to_tick_ceil(deadline), std::move(f), std::move(on_stop)));
+        std::uint64_t const now = to_tick_floor(clock_type::now());
+
+        {
+            std::lock_guard<::pika::detail::spinlock> l(mtx_);
+
+            // An empty wheel can jump ahead to the current time directly
+            // instead of stepping through all ticks on the next poll.
+            bool const empty = count_.load(std::memory_order_relaxed) == 0;
+            if (empty && current_tick_.load(std::memory_order_relaxed) < now)
+            {
+                current_tick_.store(now, std::memory_order_relaxed);
+            }
+
+            // the wheel holds its own reference while the timer is armed
+            intrusive_ptr_add_ref(entry.get());
+            entry->armed_ = true;
+            link(entry.get());
+            count_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return timer_handle(this, std::move(entry));
+    }
+
+    bool timer_wheel::cancel(timer_entry& e)
+    {
+        callback_type f;
+        callback_type on_stop;
+        {
+            std::lock_guard<::pika::detail::spinlock> l(mtx_);
+            if (!e.armed_) { return false; }
+
+            unlink(&e);
+            e.armed_ = false;
+            count_.fetch_sub(1, std::memory_order_relaxed);
+            f = std::move(e.f_);
+            on_stop = std::move(e.on_stop_);
+        }
+
+        // The caller still holds a reference through its handle, so this
+        // never deletes the entry.
+        intrusive_ptr_release(&e);
+        return true;
+    }
+
+    std::size_t timer_wheel::stop()
+    {
+        if (count_.load(std::memory_order_relaxed) == 0) { return 0; }
+
+        timer_entry* stopped = nullptr;
+        {
+            std::lock_guard<::pika::detail::spinlock> l(mtx_);
+
+            auto take_stoppable = [&](timer_entry** list) {
+                timer_entry* e = *list;
+                while (e != nullptr)
+                {
+                    timer_entry* next = e->next_;
+                    if (e->on_stop_)
+                    {
+                        unlink(e);
+                        e->armed_ = false;
+                        e->next_ = stopped;
+                        stopped = e;
+                        count_.fetch_sub(1, std::memory_order_relaxed);
+                    }
+                    e = next;
+                }
+            };
+
+            for (std::size_t level = 0; level != num_levels; ++level)
+            {
+                for (timer_entry*& slot : slots_[level]) { take_stoppable(&slot); }
+            }
+            take_stoppable(&overflow_);
+            take_stoppable(&expired_);
+        }
+
+        std::size_t count = 0;
+        while (stopped != nullptr)
+        {
+            timer_entry* next = stopped->next_;
+            stopped->next_ = nullptr;
+
+            // The timer callback is dropped without being invoked.
+            callback_type on_stop = std::move(stopped->on_stop_);
+            callback_type f = std::move(stopped->f_);
+            intrusive_ptr_release(stopped);
+            on_stop();
+
+            stopped = next;
+            ++count;
+        }
+
+        return count;
+    }
+
+    timer_wheel::clock_type::time_point timer_wheel::next_expiry() const
+    {
+        if (count_.load(std::memory_order_relaxed) == 0) { return clock_type::time_point::max(); }
+
+        std::lock_guard<::pika::detail::spinlock> l(mtx_);
+
+        std::uint64_t const current = current_tick_.load(std::memory_order_relaxed);
+        auto const to_time_point = [](std::uint64_t tick) {
+            return clock_type::time_point(tick * resolution);
+        };
+
+        if (count_.load(std::memory_order_relaxed) == 0)
+        {
+            return clock_type::time_point::max();
+        }
+        if (expired_ != nullptr) { return to_time_point(current); }
+
+        // Timers on a level expire after the current tick, in a slot after
+        // the digit of the current tick on that level. The earliest timer on
+        // the lowest occupied level expires no earlier than the start of the
+        // first occupied slot.
+        for (std::size_t level = 0; level != num_levels; ++level)
+        {
+            if (occupied_[level] == 0) { continue; }
+
+            std::size_t const shift = level * slot_bits;
+            auto const digit = static_cast<std::size_t>((current >> shift) & slot_mask);
+            std::uint64_t const later_slots = occupied_[level] & ~((std::uint64_t(2) << digit) - 1);
+            if (later_slots != occupied_[level]) { return to_time_point(current); }
+
+            std::uint64_t slot = 0;
+            while ((later_slots & (std::uint64_t(1) << slot)) == 0) { ++slot; }
+            std::uint64_t const base = (current >> (shift + slot_bits)) << (shift + slot_bits);
+            return to_time_point(base | (slot << shift));
+        }
+
+        // Timers in the overflow list are re-examined when the top level
+        // wraps around
+        std::size_t const overflow_shift = num_levels * slot_bits;
+        return to_time_point(((current >> overflow_shift) + 1) << overflow_shift);
+    }
+
+    std::size_t timer_wheel::poll(clock_type::time_point now)
+    {
+        if (count_.load(std::memory_order_relaxed) == 0) { return 0; }
+
+        std::uint64_t const target = to_tick_floor(now);
+        if (target <= current_tick_.load(std::memory_order_relaxed) &&
+            !has_expired_.load(std::memory_order_relaxed))
+        {
+            return 0;
+        }
+
+        timer_entry* fired = nullptr;
+        {
+            std::unique_lock<::pika::detail::spinlock> l(mtx_, std::try_to_lock);
+            if (!l.owns_lock()) { return 0; }
+
+            fired = advance(target);
+        }
+
+        std::size_t count = 0;
+        while (fired != nullptr)
+        {
+            timer_entry* next = fired->next_;
+            fired->next_ = nullptr;
+
+            callback_type f = std::move(fired->f_);
+            callback_type on_stop = std::move(fired->on_stop_);
+            intrusive_ptr_release(fired);
+            f();
+
+            fired = next;
+            ++count;
+        }
+
+        return count;
+    }
+}    // namespace pika::threads::detail
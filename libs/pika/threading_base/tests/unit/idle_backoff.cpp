@@ -0,0 +1,179 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test verifies that worker threads sleeping in the idle backoff are woken
+// up when new work arrives. Bursts of tasks that can only complete when all
+// worker threads run them concurrently are spawned after the worker threads
+// have been idling for a while. Timers armed from outside of the runtime must
+// also wake up the worker threads, also if a later timer is already armed.
+
+#include <pika/condition_variable.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/mutex.hpp>
+#include <pika/runtime.hpp>
+#include <pika/semaphore.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/threading_base/scheduler_base.hpp>
+#include <pika/threading_base/thread_data.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace ex = pika::execution::experimental;
+
+void test_burst_after_idle(std::chrono::milliseconds idle_time)
+{
+    // Let the worker threads back off
+    pika::this_thread::sleep_for(idle_time);
+
+    std::size_t const num_threads = pika::get_num_worker_threads();
+    std::atomic<std::size_t> num_arrived{0};
+    std::atomic<std::size_t> num_timed_out{0};
+    pika::latch l(num_threads + 1);
+
+    for (std::size_t i = 0; i != num_threads; ++i)
+    {
+        ex::start_detached(ex::schedule(ex::thread_pool_scheduler{}) | ex::then([&] {
+            // The tasks block their worker threads until all tasks are
+            // running, i.e. all worker threads have to be woken up.
+            ++num_arrived;
+            auto const start = std::chrono::steady_clock::now();
+            while (num_arrived.load() != num_threads)
+            {
+                if (std::chrono::steady_clock::now() - start > 20s)
+                {
+                    ++num_timed_out;
+                    break;
+                }
+            }
+            l.count_down(1);
+        }));
+    }
+
+    l.arrive_and_wait();
+    PIKA_TEST_EQ(num_timed_out.load(), std::size_t(0));
+}
+
+void test_many_tasks()
+{
+    constexpr std::size_t num_tasks = 10000;
+    pika::latch l(num_tasks + 1);
+
+    for (std::size_t i = 0; i != num_tasks; ++i)
+    {
+        ex::start_detached(
+            ex::schedule(ex::thread_pool_scheduler{}) | ex::then([&] { l.count_down(1); }));
+    }
+
+    l.arrive_and_wait();
+}
+
+void test_timer_from_external_thread()
+{
+    // No timers are armed while the worker threads back off, pika_main waits
+    // on a semaphore
+    ex::thread_pool_scheduler sched{};
+    pika::binary_semaphore<> sem{0};
+    std::chrono::steady_clock::duration elapsed{};
+
+    std::thread t([&] {
+        std::this_thread::sleep_for(2s);
+
+        auto const start = std::chrono::steady_clock::now();
+        pika::this_thread::experimental::sync_wait(ex::schedule_after(sched, 10ms));
+        elapsed = std::chrono::steady_clock::now() - start;
+
+        sem.release();
+    });
+
+    sem.acquire();
+    t.join();
+
+    // The timer would fire only once a worker thread wakes up by itself if
+    // arming it did not wake up a worker thread
+    PIKA_TEST(elapsed < 1s);
+}
+
+void test_timer_before_armed_timer()
+{
+    // A worker thread backing off waits for the timeout of the condition
+    // variable. It has to be woken up for an earlier timer armed later.
+    ex::thread_pool_scheduler sched{};
+    pika::mutex mtx;
+    pika::condition_variable cond;
+    bool done = false;
+    pika::binary_semaphore<> sem{0};
+    std::chrono::steady_clock::duration elapsed{};
+
+    auto waiter = ex::schedule(sched) | ex::then([&] {
+        std::unique_lock<pika::mutex> l(mtx);
+        cond.wait_for(l, 60s, [&] { return done; });
+    }) | ex::ensure_started();
+
+    std::thread t([&] {
+        std::this_thread::sleep_for(2s);
+
+        auto const start = std::chrono::steady_clock::now();
+        pika::this_thread::experimental::sync_wait(ex::schedule_after(sched, 10ms));
+        elapsed = std::chrono::steady_clock::now() - start;
+
+        sem.release();
+    });
+
+    sem.acquire();
+    t.join();
+
+    {
+        std::lock_guard<pika::mutex> l(mtx);
+        done = true;
+    }
+    cond.notify_all();
+    pika::this_thread::experimental::sync_wait(std::move(waiter));
+
+    PIKA_TEST(elapsed < 1s);
+}
+
+int pika_main()
+{
+    using pika::threads::scheduler_mode;
+    auto const sched = pika::threads::detail::get_self_id_data()->get_scheduler_base();
+    sched->add_scheduler_mode(scheduler_mode::enable_idle_backoff);
+
+    for (auto idle_time : {0ms, 10ms, 100ms, 500ms})
+    {
+        test_burst_after_idle(idle_time);
+        test_many_tasks();
+    }
+
+    test_timer_from_external_thread();
+    test_timer_before_armed_timer();
+
+    // The worker threads are still backing off when the runtime is stopped
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    // Allow worker threads to back off for long enough that missed wakeups
+    // show up as timeouts
+    pika::init_params init_args;
+    init_args.cfg = {"pika.max_idle_backoff_time=" + std::to_string(60000)};
+
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv, init_args), 0);
+    return 0;
+}
@@ -0,0 +1,144 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The scheduler counters can be switched on and off at runtime and are only
+// updated while enabled.
+
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/resource_partitioner.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/threading_base/detail/scheduler_counters.hpp>
+#include <pika/threading_base/thread_pool_base.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace tt = pika::this_thread::experimental;
+
+constexpr std::size_t num_tasks = 1000;
+
+using pika::threads::detail::scheduler_counter_values;
+
+void spin(std::chrono::microseconds duration)
+{
+    auto const end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {}
+}
+
+template <typename Scheduler>
+void run_tasks(Scheduler const& sched, std::chrono::microseconds duration)
+{
+    std::vector<ex::unique_any_sender<>> senders;
+    for (std::size_t i = 0; i < num_tasks; ++i)
+    {
+        senders.emplace_back(ex::schedule(sched) | ex::then([duration] { spin(duration); }));
+    }
+    tt::sync_wait(ex::when_all_vector(std::move(senders)));
+}
+
+void run_tasks() { run_tasks(ex::thread_pool_scheduler{}, std::chrono::microseconds(10)); }
+
+scheduler_counter_values sum_worker_counters(pika::threads::detail::thread_pool_base& pool)
+{
+    scheduler_counter_values sum;
+    for (std::size_t i = 0; i != pool.get_os_thread_count(); ++i)
+    {
+        sum += pool.get_scheduler_counters(i);
+    }
+    return sum;
+}
+
+void test_sum(scheduler_counter_values const& sum, scheduler_counter_values const& values)
+{
+    PIKA_TEST_EQ(sum.executed_threads, values.executed_threads);
+    PIKA_TEST_EQ(sum.executed_thread_phases, values.executed_thread_phases);
+    PIKA_TEST_EQ(sum.loop_time, values.loop_time);
+    PIKA_TEST_EQ(sum.exec_time, values.exec_time);
+    PIKA_TEST_EQ(sum.stolen_threads, values.stolen_threads);
+    PIKA_TEST_EQ(sum.queue_wait_time, values.queue_wait_time);
+    PIKA_TEST_EQ(sum.queue_wait_count, values.queue_wait_count);
+}
+
+int pika_main()
+{
+    using pika::threads::detail::set_scheduler_counters_enabled;
+
+    auto& pool = pika::resource::get_thread_pool("default");
+
+    // Disabled by default, nothing is counted
+    pool.get_scheduler_counters(std::size_t(-1), true);
+    run_tasks();
+    scheduler_counter_values values = pool.get_scheduler_counters();
+    PIKA_TEST_EQ(values.executed_threads, std::int64_t(0));
+    PIKA_TEST_EQ(values.executed_thread_phases, std::int64_t(0));
+    PIKA_TEST_EQ(values.exec_time, std::int64_t(0));
+    PIKA_TEST_EQ(values.queue_wait_count, std::int64_t(0));
+
+    set_scheduler_counters_enabled(true);
+    run_tasks();
+    // The tasks are counted as executed only after they have signaled
+    // completion, give the worker threads time to finish them
+    pika::this_thread::sleep_for(std::chrono::milliseconds(100));
+    set_scheduler_counters_enabled(false);
+    // Let worker threads that have seen the counters enabled finish their
+    // updates so that the counters no longer change
+    pika::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // The sum over all worker threads matches the per worker thread counters
+    values = pool.get_scheduler_counters();
+    test_sum(sum_worker_counters(pool), values);
+
+    values = pool.get_scheduler_counters(std::size_t(-1), true);
+    PIKA_TEST_LTE(std::int64_t(num_tasks), values.executed_threads);
+    PIKA_TEST_LTE(values.executed_threads, values.executed_thread_phases);
+    PIKA_TEST_LT(std::int64_t(0), values.exec_time);
+    PIKA_TEST_LTE(std::int64_t(num_tasks), values.queue_wait_count);
+    PIKA_TEST_LTE(std::int64_t(0), values.average_queue_wait_time());
+    PIKA_TEST_LTE(0.0, values.idle_rate());
+    PIKA_TEST_LTE(values.idle_rate(), 1.0);
+
+    // Resetting clears the counters of all worker threads
+    PIKA_TEST_EQ(sum_worker_counters(pool).executed_threads, std::int64_t(0));
+
+    run_tasks();
+    values = pool.get_scheduler_counters();
+    PIKA_TEST_EQ(values.executed_threads, std::int64_t(0));
+
+    // Tasks hinted to the first worker thread are stolen by the other, idle,
+    // worker threads
+    if (pool.get_os_thread_count() > 1)
+    {
+        set_scheduler_counters_enabled(true);
+        run_tasks(ex::with_hint(ex::thread_pool_scheduler{},
+                      pika::execution::thread_schedule_hint(std::int16_t(0))),
+            std::chrono::microseconds(100));
+        pika::this_thread::sleep_for(std::chrono::milliseconds(100));
+        set_scheduler_counters_enabled(false);
+        pika::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        values = pool.get_scheduler_counters();
+        PIKA_TEST_LT(std::int64_t(0), values.stolen_threads);
+        PIKA_TEST_LTE(values.stolen_threads, values.executed_threads);
+        test_sum(sum_worker_counters(pool), values);
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv), 0);
+    return 0;
+}
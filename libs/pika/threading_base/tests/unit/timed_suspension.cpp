@@ -0,0 +1,172 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test verifies that timed suspension of pika threads is driven by the
+// timer wheel of the scheduler, that a thread is woken up exactly once, and
+// that timers can be cancelled.
+
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/testing.hpp>
+#include <pika/thread.hpp>
+#include <pika/threading_base/detail/timer_wheel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+using pika::threads::detail::thread_restart_state;
+using pika::threads::detail::thread_schedule_state;
+using pika::threads::detail::timer_wheel;
+
+void test_timer_wheel()
+{
+    timer_wheel wheel;
+    auto const start = timer_wheel::clock_type::now();
+    auto const resolution = timer_wheel::resolution;
+
+    // Deadlines spanning all levels of the wheel as well as the overflow list
+    std::vector<timer_wheel::clock_type::duration> const delays = {resolution, 3 * resolution,
+        63 * resolution, 64 * resolution, 65 * resolution, 4097 * resolution,
+        300000 * resolution, 20000000 * resolution};
+
+    std::vector<int> fired(delays.size(), 0);
+    for (std::size_t i = 0; i != delays.size(); ++i)
+    {
+        wheel.add(start + delays[i], [&fired, i] { ++fired[i]; });
+    }
+    PIKA_TEST_EQ(wheel.size(), delays.size());
+
+    for (std::size_t i = 0; i != delays.size(); ++i)
+    {
+        // nothing fires before the deadline...
+        wheel.poll(start + delays[i] - resolution);
+        PIKA_TEST_EQ(fired[i], 0);
+
+        // ...and everything up to the deadline fires exactly once
+        wheel.poll(start + delays[i] + resolution);
+        for (std::size_t j = 0; j != delays.size(); ++j) { PIKA_TEST_EQ(fired[j], j <= i ? 1 : 0); }
+    }
+    PIKA_TEST(wheel.empty());
+    PIKA_TEST(wheel.next_expiry() == timer_wheel::clock_type::time_point::max());
+
+    // Polling at the next expiry of the wheel fires each timer after a few
+    // polls, the next expiry is never after the earliest deadline
+    {
+        timer_wheel expiry_wheel;
+        auto const expiry_start = timer_wheel::clock_type::now();
+
+        std::fill(fired.begin(), fired.end(), 0);
+        for (std::size_t i = 0; i != delays.size(); ++i)
+        {
+            expiry_wheel.add(expiry_start + delays[i], [&fired, i] { ++fired[i]; });
+        }
+        for (std::size_t i = 0; i != delays.size(); ++i)
+        {
+            std::size_t num_polls = 0;
+            while (fired[i] == 0 && num_polls != 2 * timer_wheel::num_levels + 2)
+            {
+                auto const next_expiry = expiry_wheel.next_expiry();
+                PIKA_TEST(next_expiry <= expiry_start + delays[i] + resolution);
+                expiry_wheel.poll(next_expiry);
+                ++num_polls;
+            }
+            for (std::size_t j = 0; j != delays.size(); ++j)
+            {
+                PIKA_TEST_EQ(fired[j], j <= i ? 1 : 0);
+            }
+        }
+        PIKA_TEST(expiry_wheel.empty());
+    }
+
+    // Cancelled timers never fire, and cancelling an expired timer fails
+    int count = 0;
+    auto h1 = wheel.add(start + 10 * resolution, [&count] { ++count; });
+    auto h2 = wheel.add(start + 10 * resolution, [&count] { ++count; });
+    PIKA_TEST(h1.cancel());
+    PIKA_TEST(!h1.cancel());
+    PIKA_TEST_EQ(wheel.size(), std::size_t(1));
+    wheel.poll(start + 20 * resolution);
+    PIKA_TEST_EQ(count, 1);
+    PIKA_TEST(!h2.cancel());
+
+    // Deadlines in the past fire on the next poll
+    wheel.add(start - resolution, [&count] { ++count; });
+    wheel.poll(start);
+    PIKA_TEST_EQ(count, 2);
+}
+
+void test_suspend_timeout()
+{
+    auto const start = std::chrono::steady_clock::now();
+    auto statex = pika::this_thread::suspend(std::chrono::milliseconds(50));
+    PIKA_TEST(statex == thread_restart_state::timeout);
+    PIKA_TEST(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(50));
+}
+
+void test_suspend_signaled()
+{
+    // A thread resumed before its deadline must not be woken up again by the
+    // expired timer while it is suspended without a timeout later.
+    std::atomic<bool> resumed_by_signal{false};
+    auto id = pika::threads::detail::get_self_id();
+
+    pika::thread t([&, id] {
+        pika::this_thread::suspend(std::chrono::milliseconds(5));
+        pika::threads::detail::set_thread_state(
+            id, thread_schedule_state::pending, thread_restart_state::signaled);
+
+        pika::this_thread::suspend(std::chrono::milliseconds(200));
+        resumed_by_signal = true;
+        pika::threads::detail::set_thread_state(
+            id, thread_schedule_state::pending, thread_restart_state::signaled);
+    });
+
+    auto statex = pika::this_thread::suspend(std::chrono::milliseconds(50));
+    PIKA_TEST(statex == thread_restart_state::signaled);
+
+    statex = pika::this_thread::suspend(thread_schedule_state::suspended);
+    PIKA_TEST(statex == thread_restart_state::signaled);
+    PIKA_TEST(resumed_by_signal.load());
+
+    t.join();
+}
+
+void test_many_sleepers()
+{
+    constexpr std::size_t num_threads = 1000;
+    pika::latch l(num_threads + 1);
+
+    for (std::size_t i = 0; i != num_threads; ++i)
+    {
+        pika::thread([&l, i] {
+            pika::this_thread::suspend(std::chrono::milliseconds(i % 20));
+            l.count_down(1);
+        }).detach();
+    }
+
+    l.arrive_and_wait();
+}
+
+int pika_main()
+{
+    test_timer_wheel();
+    test_suspend_timeout();
+    test_suspend_signaled();
+    test_many_sleepers();
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    PIKA_TEST_EQ(pika::init(pika_main, argc, argv), 0);
+    return 0;
+}
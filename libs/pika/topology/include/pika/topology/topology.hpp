@@ -229,6 +229,15 @@ namespace pika::threads::detail {
             return core_numbers_[num_thread % num_of_pus_];
         }
 
+        /// \brief Return the number of the L3 cache shared by the processing
+        ///        unit the given thread is running on. If the processing unit
+        ///        has no L3 cache a number identifying its socket is returned
+        ///        instead, which is distinct from all L3 cache numbers.
+        std::size_t get_l3_cache_number(std::size_t num_thread) const
+        {
+            return l3_cache_numbers_[num_thread % num_of_pus_];
+        }
+
         std::size_t get_pu_number(
             std::size_t num_core, std::size_t num_pu, error_code& ec = throws) const;
 
@@ -294,6 +303,8 @@ namespace pika::threads::detail {
             return init_node_number(num_thread, use_pus_as_cores_ ? HWLOC_OBJ_PU : HWLOC_OBJ_CORE);
         }
 
+        std::size_t init_l3_cache_number(std::size_t num_thread);
+
         void extract_node_mask(hwloc_obj_t parent, mask_type& mask) const;
 
         std::size_t extract_node_count(
@@ -337,6 +348,7 @@ namespace pika::threads::detail {
         std::vector<std::size_t> socket_numbers_;
         std::vector<std::size_t> numa_node_numbers_;
         std::vector<std::size_t> core_numbers_;
+        std::vector<std::size_t> l3_cache_numbers_;
 
         // Affinity masks: vectors of bitmasks
         // - Length of the vector: number of PUs of the machine
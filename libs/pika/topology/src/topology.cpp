@@ -248,6 +248,7 @@ namespace pika::threads::detail {
         socket_numbers_.reserve(num_of_pus_);
         numa_node_numbers_.reserve(num_of_pus_);
         core_numbers_.reserve(num_of_pus_);
+        l3_cache_numbers_.reserve(num_of_pus_);
 
         // Initialize each set of data entirely, as some of the initialization
         // routines rely on access to other pieces of topology data. The
@@ -283,6 +284,11 @@ namespace pika::threads::detail {
             core_numbers_.push_back(core_number);
         }
 
+        for (std::size_t i = 0; i < num_of_pus_; ++i)
+        {
+            l3_cache_numbers_.push_back(init_l3_cache_number(i));
+        }
+
         machine_affinity_mask_ = init_machine_affinity_mask();
         socket_affinity_masks_.reserve(num_of_pus_);
         numa_node_affinity_masks_.reserve(num_of_pus_);
@@ -333,6 +339,7 @@ namespace pika::threads::detail {
         detail::write_to_log("socket_number", socket_numbers_);
         detail::write_to_log("numa_node_number", numa_node_numbers_);
         detail::write_to_log("core_number", core_numbers_);
+        detail::write_to_log("l3_cache_number", l3_cache_numbers_);
 
         detail::write_to_log_mask("machine_affinity_mask", machine_affinity_mask_);
 
@@ -625,6 +632,36 @@ namespace pika::threads::detail {
         return 0;
     }    // }}}
 
+    std::size_t topology::init_l3_cache_number(std::size_t num_thread)
+    {    // {{{
+        std::size_t num_pu = (num_thread + pu_offset) % num_of_pus_;
+
+        hwloc_obj_t obj;
+        {
+            std::unique_lock<mutex_type> lk(topo_mtx);
+            obj = hwloc_get_obj_by_type(topo, HWLOC_OBJ_PU, static_cast<unsigned>(num_pu));
+            PIKA_ASSERT(num_pu == detail::get_index(obj));
+        }
+
+        while (obj)
+        {
+#if HWLOC_API_VERSION >= 0x0002'0000
+            if (obj->type == HWLOC_OBJ_L3CACHE) { return detail::get_index(obj); }
+#else
+            if (obj->type == HWLOC_OBJ_CACHE && obj->attr->cache.depth == 3)
+            {
+                return detail::get_index(obj);
+            }
+#endif
+            obj = obj->parent;
+        }
+
+        // Without an L3 cache the socket is the closest shared resource. The
+        // socket numbers are counted down from the largest value so that they
+        // can not be confused with the index of an L3 cache.
+        return std::size_t(-1) - get_socket_number(num_thread);
+    }    // }}}
+
     void topology::extract_node_mask(hwloc_obj_t parent, mask_type& mask) const
     {    // {{{
         hwloc_obj_t obj;
@@ -1501,6 +1538,8 @@ namespace pika::threads::detail {
         print_vector(os, numa_node_numbers_);
         os << "core                  : \n";
         print_vector(os, core_numbers_);
+        os << "L3 cache              : \n";
+        print_vector(os, l3_cache_numbers_);
         //os << "PUs (/threads)        : \n";
         //print_vector(os, pu_numbers_);
     }
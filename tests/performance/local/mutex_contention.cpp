@@ -0,0 +1,165 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the cost of locking and unlocking a mutex shared by tasks running on all
+// worker threads. Each task repeatedly locks the mutex, does a configurable amount of work while
+// holding it, and a configurable amount of work after releasing it. With no work outside the
+// critical section the mutex is highly contended, with a lot of work outside the critical section
+// it is mostly uncontended. pika::mutex is compared to a plain spinlock.
+
+#include <pika/config.hpp>
+#include <pika/assert.hpp>
+#include <pika/concurrency/spinlock.hpp>
+#include <pika/execution.hpp>
+#include <pika/init.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/mutex.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ex = pika::execution::experimental;
+namespace po = pika::program_options;
+namespace tt = pika::this_thread::experimental;
+
+// Busy work which the compiler can not optimize away
+void work(std::uint64_t iterations)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) { PIKA_SMT_PAUSE; }
+}
+
+template <typename Mutex>
+double test_mutex(std::uint64_t num_tasks, std::uint64_t loops, std::uint64_t critical_work,
+    std::uint64_t outside_work)
+{
+    Mutex mtx;
+    std::uint64_t counter = 0;
+
+    pika::chrono::detail::high_resolution_timer timer;
+
+    std::vector<ex::unique_any_sender<>> senders;
+    senders.reserve(num_tasks);
+    for (std::uint64_t i = 0; i < num_tasks; ++i)
+    {
+        senders.emplace_back(ex::schedule(ex::thread_pool_scheduler{}) | ex::then([&] {
+            for (std::uint64_t j = 0; j < loops; ++j)
+            {
+                {
+                    std::lock_guard<Mutex> l(mtx);
+                    ++counter;
+                    work(critical_work);
+                }
+                work(outside_work);
+            }
+        }));
+    }
+    tt::sync_wait(ex::when_all_vector(std::move(senders)));
+
+    double const time_s = timer.elapsed();
+
+    PIKA_ASSERT(counter == num_tasks * loops);
+
+    return time_s;
+}
+
+template <typename Mutex>
+void run_benchmark(std::string const& name, pika::util::detail::json_perf_times& json,
+    po::variables_map& vm)
+{
+    auto const tasks_per_thread = vm["tasks-per-thread"].as<std::uint64_t>();
+    auto const loops = vm["loops"].as<std::uint64_t>();
+    auto const critical_work = vm["critical-work"].as<std::uint64_t>();
+    auto const outside_work = vm["outside-work"].as<std::uint64_t>();
+    auto const repetitions = vm["repetitions"].as<std::uint64_t>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+
+    std::uint64_t const num_threads = pika::get_num_worker_threads();
+    std::uint64_t const num_tasks = num_threads * tasks_per_thread;
+
+    double time_avg_s = 0.0;
+    double time_min_s = std::numeric_limits<double>::max();
+    double time_max_s = std::numeric_limits<double>::min();
+
+    for (std::uint64_t i = 0; i < repetitions; ++i)
+    {
+        double const time_s = test_mutex<Mutex>(num_tasks, loops, critical_work, outside_work);
+        time_avg_s += time_s;
+        time_max_s = (std::max)(time_max_s, time_s);
+        time_min_s = (std::min)(time_min_s, time_s);
+    }
+
+    time_avg_s /= repetitions;
+
+    // Time per lock and unlock
+    double const num_locks = static_cast<double>(num_tasks * loops);
+    double const time_avg_ns = time_avg_s * 1e9 / num_locks;
+    double const time_min_ns = time_min_s * 1e9 / num_locks;
+    double const time_max_ns = time_max_s * 1e9 / num_locks;
+
+    if (perftest_json)
+    {
+        json.add(fmt::format("mutex_contention - {} - {} threads - {}:{}", name, num_threads,
+                     critical_work, outside_work),
+            time_avg_ns);
+    }
+    else
+    {
+        fmt::print("{},{},{},{},{},{},{:.2f},{:.2f},{:.2f}\n", name, num_threads, num_tasks,
+            loops, critical_work, outside_work, time_avg_ns, time_min_ns, time_max_ns);
+    }
+}
+
+int pika_main(po::variables_map& vm)
+{
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+
+    pika::util::detail::json_perf_times json;
+    if (!perftest_json)
+    {
+        fmt::print("mutex,threads,tasks,loops,critical_work,outside_work,time_avg_ns,time_min_ns,"
+                   "time_max_ns\n");
+    }
+
+    run_benchmark<pika::mutex>("pika::mutex", json, vm);
+    run_benchmark<pika::concurrency::detail::spinlock>("spinlock", json, vm);
+
+    if (perftest_json) { std::cout << json; }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("tasks-per-thread", po::value<std::uint64_t>()->default_value(4), "number of tasks locking the mutex per worker thread")
+        ("loops", po::value<std::uint64_t>()->default_value(10000), "number of times each task locks the mutex")
+        ("critical-work", po::value<std::uint64_t>()->default_value(10), "number of pause instructions executed while holding the mutex")
+        ("outside-work", po::value<std::uint64_t>()->default_value(0), "number of pause instructions executed after releasing the mutex")
+        ("repetitions", po::value<std::uint64_t>()->default_value(10), "number of repetitions of the benchmark")
+        ("perftest-json", po::bool_switch(), "print final task size in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}
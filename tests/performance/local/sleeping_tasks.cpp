@@ -0,0 +1,142 @@
+//  Copyright (c) 2024 ETH Zurich
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the throughput of short tasks while a large number
+// of other tasks are sleeping concurrently. Sleeping tasks should be suspended
+// and not occupy the worker threads, i.e. the throughput should be largely
+// independent of the number of sleeping tasks.
+
+#include <pika/config.hpp>
+#include <pika/execution.hpp>
+#include <pika/execution_base/this_thread.hpp>
+#include <pika/init.hpp>
+#include <pika/latch.hpp>
+#include <pika/modules/timing.hpp>
+#include <pika/runtime.hpp>
+#include <pika/testing/performance.hpp>
+
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <utility>
+
+namespace ex = pika::execution::experimental;
+namespace po = pika::program_options;
+
+void spawn_sleepers(std::uint64_t num_sleepers, std::chrono::milliseconds sleep_duration,
+    std::atomic<bool>& stop, pika::latch& done)
+{
+    for (std::uint64_t i = 0; i < num_sleepers; ++i)
+    {
+        ex::start_detached(ex::schedule(ex::thread_pool_scheduler{}) |
+            ex::then([sleep_duration, &stop, &done]() {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    pika::execution::this_thread::detail::sleep_for(sleep_duration);
+                }
+                done.count_down(1);
+            }));
+    }
+}
+
+double test_throughput(std::uint64_t num_tasks)
+{
+    pika::latch l(num_tasks + 1);
+    pika::chrono::detail::high_resolution_timer timer;
+
+    for (std::uint64_t i = 0; i < num_tasks; ++i)
+    {
+        ex::start_detached(
+            ex::schedule(ex::thread_pool_scheduler{}) | ex::then([&l]() { l.count_down(1); }));
+    }
+    l.arrive_and_wait();
+
+    return timer.elapsed();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int pika_main(po::variables_map& vm)
+{
+    auto const num_sleepers = vm["num-sleepers"].as<std::uint64_t>();
+    auto const sleep_duration =
+        std::chrono::milliseconds(vm["sleep-duration-ms"].as<std::uint64_t>());
+    auto const num_tasks = vm["num-tasks"].as<std::uint64_t>();
+    auto const repetitions = vm["repetitions"].as<std::uint64_t>();
+    auto const perftest_json = vm["perftest-json"].as<bool>();
+
+    std::atomic<bool> stop{false};
+    pika::latch sleepers_done(num_sleepers + 1);
+    spawn_sleepers(num_sleepers, sleep_duration, stop, sleepers_done);
+
+    double time_avg_s = 0.0;
+    double time_min_s = std::numeric_limits<double>::max();
+    double time_max_s = std::numeric_limits<double>::min();
+
+    for (std::uint64_t i = 0; i < repetitions; ++i)
+    {
+        double time_s = test_throughput(num_tasks);
+
+        time_avg_s += time_s;
+        time_max_s = (std::max)(time_max_s, time_s);
+        time_min_s = (std::min)(time_min_s, time_s);
+    }
+
+    stop = true;
+    sleepers_done.arrive_and_wait();
+
+    time_avg_s /= repetitions;
+
+    double const time_avg_us = time_avg_s * 1e6 / num_tasks;
+    double const time_min_us = time_min_s * 1e6 / num_tasks;
+    double const time_max_us = time_max_s * 1e6 / num_tasks;
+
+    if (perftest_json)
+    {
+        pika::util::detail::json_perf_times t;
+        t.add(fmt::format("sleeping_tasks - {} threads - {} sleepers",
+                  pika::get_num_worker_threads(), num_sleepers),
+            time_avg_us);
+        std::cout << t;
+    }
+    else
+    {
+        fmt::print("num_sleepers,repetitions,time_avg_us,time_min_us,time_max_us\n");
+        fmt::print("{},{},{},{},{}\n", num_sleepers, repetitions, time_avg_us, time_min_us,
+            time_max_us);
+    }
+
+    pika::finalize();
+    return EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    po::options_description cmdline("usage: " PIKA_APPLICATION_STRING " [options]");
+
+    // clang-format off
+    cmdline.add_options()
+        ("num-sleepers", po::value<std::uint64_t>()->default_value(10000), "number of concurrently sleeping tasks")
+        ("sleep-duration-ms", po::value<std::uint64_t>()->default_value(100), "duration of a single sleep in milliseconds")
+        ("num-tasks", po::value<std::uint64_t>()->default_value(100000), "number of short tasks per repetition")
+        ("repetitions", po::value<std::uint64_t>()->default_value(10), "number of repetitions of the benchmark")
+        ("perftest-json", po::bool_switch(), "print final task size in json format for use with performance CI")
+        // clang-format on
+        ;
+
+    // Initialize and run pika.
+    pika::init_params init_args;
+    init_args.desc_cmdline = cmdline;
+
+    return pika::init(pika_main, argc, argv, init_args);
+}